@@ -0,0 +1,35 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             BenchMain.cpp
+--
+-- PROGRAM:                 kgp_bench
+--
+-- FUNCTIONS:               int main(int argc, char *argv[])
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Entry point of the benchmark suite. A QCoreApplication is created
+--                          so that benchmarks can use Qt networking and the event loop.
+--                          Results can be written as JSON with
+--                              kgp_bench --benchmark_out=results.json --benchmark_out_format=json
+---------------------------------------------------------------------------------------*/
+#include <benchmark/benchmark.h>
+
+#include <QCoreApplication>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,125 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             BenchUtil.h
+--
+-- PROGRAM:                 kgp_bench
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Helpers shared by the benchmarks.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include <QByteArray>
+#include <QFile>
+
+#include "SlidingWindow.h"
+
+namespace kgp
+{
+    namespace bench
+    {
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::bench::BufferScratchFile
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               bool kgp::bench::BufferScratchFile(SlidingWindow& window, const quint64 size)
+        --                              window: The window to buffer the file into.
+        --                              size: The size of the scratch file in bytes.
+        --
+        -- RETURN:                  True if the file was buffered, false otherwise.
+        --
+        -- NOTES:
+        --                          Writes a scratch file of size bytes once and buffers it into window.
+        --------------------------------------------------------------------------------------------------*/
+        inline bool BufferScratchFile(SlidingWindow& window, const quint64 size)
+        {
+            const std::string name = "kgp_bench_" + std::to_string(size) + ".bin";
+            QFile file(name.c_str());
+            if (file.size() != (qint64)size)
+            {
+                if (!file.open(QIODevice::WriteOnly)) return false;
+                file.write(QByteArray((int)size, 'k'));
+                file.close();
+            }
+            return window.BufferFile(file);
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::bench::Cycles
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::bench::Cycles()
+        --
+        -- RETURN:                  The time stamp counter of the CPU, 0 on CPUs without one.
+        --------------------------------------------------------------------------------------------------*/
+        inline quint64 Cycles()
+        {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#else
+            return 0;
+#endif
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::bench::SetCyclesPerPacket
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               void kgp::bench::SetCyclesPerPacket(benchmark::State& state, const quint64 start, const quint64 packets)
+        --                              state: The state of the running benchmark.
+        --                              start: What Cycles returned before the first packet.
+        --                              packets: The number of packets handled since.
+        --
+        -- NOTES:
+        --                          Reports the cycles spent per packet as the cycles/packet counter so
+        --                          benchmarks of two ways to handle a packet can be compared directly.
+        --                          Nothing is reported on CPUs without a time stamp counter.
+        --------------------------------------------------------------------------------------------------*/
+        inline void SetCyclesPerPacket(benchmark::State& state, const quint64 start, const quint64 packets)
+        {
+            const quint64 end = Cycles();
+            if (end == 0 || packets == 0) return;
+            state.counters["cycles/packet"] = (double)(end - start) / packets;
+        }
+    }
+}
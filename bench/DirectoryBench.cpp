@@ -0,0 +1,163 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             DirectoryBench.cpp
+--
+-- PROGRAM:                 kgp_bench
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Sends a directory of small files over a simulated link of RTT
+--                          milliseconds, once as a single directory and once as one transfer per
+--                          file, which is what sending a directory took before. The receiver writes
+--                          the files to disk in both. Every benchmark reports items per second of
+--                          real time where an item is one file, and sim_files_per_s, the files per
+--                          second of simulated time, which is what the handshakes cost on a real
+--                          link. The range argument is the number of files.
+---------------------------------------------------------------------------------------*/
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <QByteArray>
+#include <QDir>
+#include <QFile>
+#include <QHostAddress>
+
+#include "DirectoryBatch.h"
+#include "Simulation.h"
+
+namespace
+{
+    const QHostAddress SENDER(QString("10.0.0.1"));
+    const QHostAddress RECEIVER(QString("10.0.0.2"));
+    // Round trip of the link in milliseconds, and the bytes of every file
+    constexpr quint64 RTT = 20;
+    constexpr int FILE_SIZE = 2000;
+    constexpr quint64 TIME_LIMIT = 24 * 60 * 60 * 1000;
+    const char *TARGET = "kgp_bench_directory_copy";
+
+    kgp::EmulatedLink::Config cleanLink()
+    {
+        kgp::EmulatedLink::Config config;
+        memset(&config, 0, sizeof(config));
+        config.seed = 1;
+        config.delay = RTT / 2;
+        return config;
+    }
+
+    // Writes a directory of count files spread over a few subdirectories once and lists them
+    QString scratchDirectory(const int count, std::vector<QString>& files)
+    {
+        const QString directory = QString("kgp_bench_directory_%1").arg(count);
+        const bool exists = QDir(directory).exists();
+        files.clear();
+        for (int i = 0; i < count; i++)
+        {
+            const QString sub = QString("dir%1").arg(i % 16);
+            files.push_back(directory + "/" + sub + QString("/file%1.bin").arg(i));
+            if (exists) continue;
+
+            QDir(directory).mkpath(sub);
+            QFile file(files.back());
+            if (!file.open(QIODevice::WriteOnly)) continue;
+            file.write(QByteArray(FILE_SIZE, (char)('a' + i % 26)));
+            file.close();
+        }
+        return directory;
+    }
+
+    void report(benchmark::State& state, const quint64 files, const quint64 simulated)
+    {
+        state.SetItemsProcessed(files);
+        state.counters["sim_files_per_s"] = simulated > 0 ? files * 1000.0 / simulated : 0;
+    }
+}
+
+// The whole directory behind one handshake, the receiver creates the files in batches
+static void BM_DirectoryBatch(benchmark::State& state)
+{
+    std::vector<QString> files;
+    const QString directory = scratchDirectory((int)state.range(0), files);
+    quint64 filesReceived = 0;
+    quint64 simulated = 0;
+
+    for (auto _ : state)
+    {
+        QDir(TARGET).removeRecursively();
+        kgp::Simulation simulation(cleanLink());
+        kgp::IoEngine *sender = simulation.CreateEngine(SENDER);
+        kgp::IoEngine *receiver = simulation.CreateEngine(RECEIVER);
+        sender->SetFeatures(kgp::Feature::CHECKSUM | kgp::Feature::EARLY);
+        receiver->SetFeatures(kgp::Feature::CHECKSUM | kgp::Feature::EARLY | kgp::Feature::BATCH);
+
+        kgp::DirectoryWriter writer(TARGET);
+        QObject::connect(receiver, &kgp::IoEngine::fileStarted, [&](const quint64&, const QString& name, const quint64& size) { writer.StartFile(name, size); });
+        QObject::connect(receiver, &kgp::IoEngine::dataRead, [&](const char *data, const size_t& size) { writer.Write(data, size); });
+        QObject::connect(receiver, &kgp::IoEngine::fileFinished, [&](const quint64&) { writer.FinishFile(); });
+
+        if (!sender->StartDirectorySend(directory.toStdString(), RECEIVER.toString().toStdString(), kgp::PORT))
+        {
+            state.SkipWithError("Could not pack the directory");
+            return;
+        }
+        simulation.RunUntil([&]() { return sender->IsIdle() && receiver->IsIdle(); }, TIME_LIMIT);
+        writer.Flush();
+
+        filesReceived += writer.Written();
+        simulated += simulation.Now();
+    }
+
+    report(state, filesReceived, simulated);
+}
+BENCHMARK(BM_DirectoryBatch)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond);
+
+// One transfer with its own handshake per file, the receiver creates every file as it starts
+static void BM_FilePerTransfer(benchmark::State& state)
+{
+    std::vector<QString> files;
+    scratchDirectory((int)state.range(0), files);
+    quint64 filesReceived = 0;
+    quint64 simulated = 0;
+
+    for (auto _ : state)
+    {
+        QDir(TARGET).removeRecursively();
+        QDir(TARGET).mkpath(".");
+        kgp::Simulation simulation(cleanLink());
+        kgp::IoEngine *sender = simulation.CreateEngine(SENDER);
+        kgp::IoEngine *receiver = simulation.CreateEngine(RECEIVER);
+        sender->SetFeatures(kgp::Feature::CHECKSUM | kgp::Feature::EARLY);
+        receiver->SetFeatures(kgp::Feature::CHECKSUM | kgp::Feature::EARLY);
+
+        QFile file;
+        quint64 index = 0;
+        QObject::connect(receiver, &kgp::IoEngine::transferStarted, [&](const quint64&) {
+            file.setFileName(QString(TARGET) + QString("/file%1.bin").arg(index++));
+            file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+        });
+        QObject::connect(receiver, &kgp::IoEngine::dataRead, [&](const char *data, const size_t& size) { file.write(data, (qint64)size); });
+
+        for (const QString& name : files)
+        {
+            if (!sender->StartFileSend(name.toStdString(), RECEIVER.toString().toStdString(), kgp::PORT)) continue;
+            simulation.RunUntil([&]() { return sender->IsIdle() && receiver->IsIdle(); }, TIME_LIMIT);
+            file.close();
+        }
+
+        filesReceived += index;
+        simulated += simulation.Now();
+    }
+
+    report(state, filesReceived, simulated);
+}
+BENCHMARK(BM_FilePerTransfer)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond);
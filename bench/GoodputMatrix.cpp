@@ -0,0 +1,700 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             GoodputMatrix.cpp
+--
+-- PROGRAM:                 kgp_goodput
+--
+-- FUNCTIONS:               int main(int argc, char *argv[])
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Added the --features and --data options
+--                          and the wire ratio.
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          End to end goodput benchmark. Runs complete sender to receiver
+--                          transfers over an emulated link on simulated time for every
+--                          combination of loss rate, round trip time, window size and file size,
+--                          and records goodput, completion time, retransmission ratio and CPU
+--                          time per byte. Results are written as CSV and JSON, and can be
+--                          compared against a stored baseline so that protocol changes are judged
+--                          on numbers instead of intuition.
+--
+--                          Goodput and completion time are in simulated time so they are the
+--                          same on every machine, only the CPU time depends on the host.
+---------------------------------------------------------------------------------------*/
+#include <cstdio>
+#include <ctime>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <QByteArray>
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QHostAddress>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+#include <QTextStream>
+
+#include "DependencyManager.h"
+#include "res.h"
+#include "Simulation.h"
+
+namespace
+{
+    const QHostAddress SENDER(QString("10.0.0.1"));
+    const QHostAddress RECEIVER(QString("10.0.0.2"));
+
+    // Longest simulated time a single transfer may take before it counts as failed
+    constexpr quint64 TIME_LIMIT = 7ull * 24 * 60 * 60 * 1000;
+
+    // Largest file the sliding window can buffer in memory
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    constexpr quint64 MAX_FILE_SIZE = std::numeric_limits<qsizetype>::max();
+#else
+    constexpr quint64 MAX_FILE_SIZE = std::numeric_limits<int>::max() - 64;
+#endif
+
+    struct Scenario
+    {
+        double lossRate;
+        // Round trip time in milliseconds
+        quint64 rtt;
+        // Receive window in frames
+        quint64 window;
+        // File size in bytes
+        quint64 size;
+    };
+
+    struct Result
+    {
+        Scenario scenario;
+        quint64 runs;
+        quint64 failures;
+        bool skipped;
+        // Averages over the runs that completed
+        double completionMs;
+        double goodput;
+        double retransmissionRatio;
+        double cpuNsPerByte;
+        // Payload bytes put on the wire per payload byte sent, below 1 if compression helped
+        double wireRatio;
+    };
+
+    struct Run
+    {
+        bool completed;
+        quint64 completionMs;
+        quint64 framesSent;
+        quint64 framesResent;
+        quint64 bytesSent;
+        quint64 bytesSaved;
+        double cpuSeconds;
+    };
+
+    /*--------------------------------------------------------------------------------------------------
+    -- FUNCTION:                key
+    --
+    -- DATE:                    October 19, 2026
+    --
+    -- REVISIONS:               N/A
+    --
+    -- DESIGNER:                Benny Wang
+    --
+    -- PROGRAMMER:              Benny Wang
+    --
+    -- INTERFACE:               QString key(const Scenario& scenario)
+    --                              scenario: The scenario to name.
+    --
+    -- RETURN:                  A string that identifies the scenario in the baseline.
+    --------------------------------------------------------------------------------------------------*/
+    QString key(const Scenario& scenario)
+    {
+        return QString::number(scenario.lossRate) + "/" + QString::number(scenario.rtt) + "/"
+            + QString::number(scenario.window) + "/" + QString::number(scenario.size);
+    }
+
+    /*--------------------------------------------------------------------------------------------------
+    -- FUNCTION:                parseSize
+    --
+    -- DATE:                    October 19, 2026
+    --
+    -- REVISIONS:               N/A
+    --
+    -- DESIGNER:                Benny Wang
+    --
+    -- PROGRAMMER:              Benny Wang
+    --
+    -- INTERFACE:               bool parseSize(QString text, quint64& size)
+    --                              text: A size in bytes with an optional K, M or G suffix.
+    --                              size: Set to the size in bytes.
+    --
+    -- RETURN:                  True if the size could be parsed, false otherwise.
+    --------------------------------------------------------------------------------------------------*/
+    bool parseSize(QString text, quint64& size)
+    {
+        quint64 unit = 1;
+        text = text.trimmed().toUpper();
+        if (text.endsWith("K")) unit = 1024;
+        else if (text.endsWith("M")) unit = 1024 * 1024;
+        else if (text.endsWith("G")) unit = 1024 * 1024 * 1024;
+        if (unit != 1) text.chop(1);
+
+        bool ok = false;
+        size = text.toULongLong(&ok) * unit;
+        return ok && size > 0;
+    }
+
+    /*--------------------------------------------------------------------------------------------------
+    -- FUNCTION:                parseList
+    --
+    -- DATE:                    October 19, 2026
+    --
+    -- REVISIONS:               N/A
+    --
+    -- DESIGNER:                Benny Wang
+    --
+    -- PROGRAMMER:              Benny Wang
+    --
+    -- INTERFACE:               bool parseList(const QString& text, std::vector<T>& values, Parse parse)
+    --                              text: A comma separated list.
+    --                              values: Filled with the parsed values.
+    --                              parse: Parses a single value, returns false if it is invalid.
+    --
+    -- RETURN:                  True if every value could be parsed, false otherwise.
+    --------------------------------------------------------------------------------------------------*/
+    template<typename T, typename Parse>
+    bool parseList(const QString& text, std::vector<T>& values, Parse parse)
+    {
+        values.clear();
+        for (const QString& item : text.split(','))
+        {
+            T value;
+            if (!parse(item, value)) return false;
+            values.push_back(value);
+        }
+        return !values.empty();
+    }
+
+    /*--------------------------------------------------------------------------------------------------
+    -- FUNCTION:                writeScratchFile
+    --
+    -- DATE:                    October 19, 2026
+    --
+    -- REVISIONS:               N/A
+    --
+    -- DESIGNER:                Benny Wang
+    --
+    -- PROGRAMMER:              Benny Wang
+    --
+    -- INTERFACE:               bool writeScratchFile(const QString& name, const quint64 size, const QString& content)
+    --                              name: The name of the file.
+    --                              size: The size of the file in bytes.
+    --                              content: "pattern" for a repeating byte pattern, "text" for CSV
+    --                                       log lines or "random" for data that does not compress.
+    --
+    -- RETURN:                  True if the file exists with the right size, false otherwise.
+    --
+    -- NOTES:
+    --                          Writes the file in chunks so large files do not have to fit in memory
+    --                          twice. An existing file of the right size is reused.
+    --------------------------------------------------------------------------------------------------*/
+    bool writeScratchFile(const QString& name, const quint64 size, const QString& content)
+    {
+        QFile file(name);
+        if (file.size() == (qint64)size) return true;
+        if (!file.open(QIODevice::WriteOnly)) return false;
+
+        QByteArray chunk;
+        quint32 state = 2463534242u;
+        while (chunk.size() < 1024 * 1024)
+        {
+            // xorshift, so every run writes the same file
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+
+            if (content == "text")
+            {
+                chunk.append(QString("2026-10-19T12:%1:%2,%3,frame %4 sent to 10.0.0.2\n")
+                    .arg(state % 60).arg(state / 60 % 60).arg(state % 7 == 0 ? "WARN" : "INFO").arg(chunk.size())
+                    .toLatin1());
+            }
+            else if (content == "random")
+            {
+                chunk.append((char)state);
+            }
+            else
+            {
+                chunk.append((char)(chunk.size() % 251));
+            }
+        }
+
+        for (quint64 written = 0; written < size; written += chunk.size())
+        {
+            const quint64 length = std::min<quint64>(chunk.size(), size - written);
+            if (file.write(chunk.constData(), length) != (qint64)length) return false;
+        }
+
+        file.close();
+        return true;
+    }
+
+    /*--------------------------------------------------------------------------------------------------
+    -- FUNCTION:                runTransfer
+    --
+    -- DATE:                    October 19, 2026
+    --
+    -- REVISIONS:               October 19, 2026 - Benny Wang: Stops once a session is held open after
+    --                          the file.
+    --
+    -- DESIGNER:                Benny Wang
+    --
+    -- PROGRAMMER:              Benny Wang
+    --
+    -- INTERFACE:               Run runTransfer(const Scenario& scenario, const quint32 seed, const quint64 bandwidth, const quint64 features, const QString& file)
+    --                              scenario: The link and transfer to run.
+    --                              seed: The seed of the link.
+    --                              bandwidth: The bandwidth of the link in bytes per second.
+    --                              features: The features both engines support.
+    --                              file: The scratch file to send.
+    --
+    -- RETURN:                  The measurements of the transfer.
+    --
+    -- NOTES:
+    --                          Sends the file over a fresh simulation. The transfer completes when
+    --                          the receiver has read every byte, and the run continues until the
+    --                          sender has finished so late retransmissions are counted as well.
+    --------------------------------------------------------------------------------------------------*/
+    Run runTransfer(const Scenario& scenario, const quint32 seed, const quint64 bandwidth, const quint64 features, const QString& file)
+    {
+        kgp::EmulatedLink::Config config;
+        memset(&config, 0, sizeof(config));
+        config.seed = seed;
+        config.lossRate = scenario.lossRate;
+        // The delay applies in each direction
+        config.delay = scenario.rtt / 2;
+        config.bandwidth = bandwidth;
+
+        Run run;
+        memset(&run, 0, sizeof(run));
+
+        const std::clock_t cpuStart = std::clock();
+        {
+            kgp::Simulation simulation(config);
+            kgp::IoEngine *sender = simulation.CreateEngine(SENDER);
+            kgp::IoEngine *receiver = simulation.CreateEngine(RECEIVER);
+            receiver->SetReceiveWindowSize(scenario.window * kgp::Size::DATA);
+            sender->SetFeatures(features);
+            receiver->SetFeatures(features);
+
+            quint64 received = 0;
+            quint64 finished = 0;
+            QObject::connect(receiver, &kgp::IoEngine::dataRead, [&](const char *data, const size_t& size)
+            {
+                Q_UNUSED(data);
+                received += size;
+                if (received == scenario.size) finished = simulation.Now();
+            });
+
+            const quint64 start = simulation.Now();
+            if (sender->StartFileSend(file.toStdString(), RECEIVER.toString().toStdString(), kgp::PORT))
+            {
+                // A session is held open after the file, the run is over all the same
+                simulation.RunUntil([&]() { return received == scenario.size && (sender->IsIdle() || sender->IsSessionOpen()); }, TIME_LIMIT);
+            }
+
+            const kgp::IoEngine::Stats stats = sender->GetStats();
+            run.completed = received == scenario.size;
+            run.completionMs = finished - start;
+            run.framesSent = stats.framesSent;
+            run.framesResent = stats.framesResent;
+            run.bytesSent = stats.bytesSent;
+            run.bytesSaved = stats.bytesSaved;
+        }
+        run.cpuSeconds = (double)(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+        return run;
+    }
+
+    /*--------------------------------------------------------------------------------------------------
+    -- FUNCTION:                runScenario
+    --
+    -- DATE:                    October 19, 2026
+    --
+    -- REVISIONS:               N/A
+    --
+    -- DESIGNER:                Benny Wang
+    --
+    -- PROGRAMMER:              Benny Wang
+    --
+    -- INTERFACE:               Result runScenario(const Scenario& scenario, const quint64 seeds, const quint64 bandwidth, const quint64 features, const QString& content)
+    --                              scenario: The scenario to run.
+    --                              seeds: The number of seeds to run the scenario with.
+    --                              bandwidth: The bandwidth of the link in bytes per second.
+    --                              features: The features both engines support.
+    --                              content: The kind of data to send, see writeScratchFile.
+    --
+    -- RETURN:                  The averaged result of the scenario.
+    --
+    -- NOTES:
+    --                          Runs the scenario once per seed and averages the runs that completed.
+    --                          A lost SYN or SYN-ACK aborts a transfer, those runs are counted as
+    --                          failures instead of being averaged in. Goodput is measured with
+    --                          millisecond resolution, a transfer that finishes within the same
+    --                          millisecond it started is counted as taking one.
+    --------------------------------------------------------------------------------------------------*/
+    Result runScenario(const Scenario& scenario, const quint64 seeds, const quint64 bandwidth, const quint64 features, const QString& content)
+    {
+        Result result;
+        memset(&result, 0, sizeof(result));
+        result.scenario = scenario;
+
+        const QString file = "kgp_goodput_" + content + "_" + QString::number(scenario.size) + ".bin";
+        if (scenario.size > MAX_FILE_SIZE || !writeScratchFile(file, scenario.size, content))
+        {
+            result.skipped = true;
+            return result;
+        }
+
+        quint64 completed = 0;
+        for (quint64 seed = 1; seed <= seeds; seed++)
+        {
+            const Run run = runTransfer(scenario, (quint32)seed, bandwidth, features, file);
+            result.runs++;
+            if (!run.completed)
+            {
+                result.failures++;
+                continue;
+            }
+
+            completed++;
+            result.completionMs += run.completionMs;
+            result.goodput += scenario.size * 1000.0 / std::max<quint64>(run.completionMs, 1);
+            result.retransmissionRatio += run.framesSent > 0 ? (double)run.framesResent / run.framesSent : 0;
+            result.cpuNsPerByte += run.cpuSeconds * 1e9 / scenario.size;
+            result.wireRatio += run.bytesSent > 0 ? (double)(run.bytesSent - run.bytesSaved) / run.bytesSent : 1;
+        }
+
+        if (completed > 0)
+        {
+            result.completionMs /= completed;
+            result.goodput /= completed;
+            result.retransmissionRatio /= completed;
+            result.cpuNsPerByte /= completed;
+            result.wireRatio /= completed;
+        }
+
+        return result;
+    }
+
+    /*--------------------------------------------------------------------------------------------------
+    -- FUNCTION:                toJson
+    --
+    -- DATE:                    October 19, 2026
+    --
+    -- REVISIONS:               N/A
+    --
+    -- DESIGNER:                Benny Wang
+    --
+    -- PROGRAMMER:              Benny Wang
+    --
+    -- INTERFACE:               QJsonObject toJson(const Result& result)
+    --                              result: The result to convert.
+    --
+    -- RETURN:                  The result as a JSON object.
+    --------------------------------------------------------------------------------------------------*/
+    QJsonObject toJson(const Result& result)
+    {
+        QJsonObject object;
+        object["loss"] = result.scenario.lossRate;
+        object["rtt_ms"] = (double)result.scenario.rtt;
+        object["window_frames"] = (double)result.scenario.window;
+        object["size_bytes"] = (double)result.scenario.size;
+        object["runs"] = (double)result.runs;
+        object["failures"] = (double)result.failures;
+        object["skipped"] = result.skipped;
+        object["completion_ms"] = result.completionMs;
+        object["goodput_bytes_per_s"] = result.goodput;
+        object["retransmission_ratio"] = result.retransmissionRatio;
+        object["cpu_ns_per_byte"] = result.cpuNsPerByte;
+        object["wire_ratio"] = result.wireRatio;
+        return object;
+    }
+
+    /*--------------------------------------------------------------------------------------------------
+    -- FUNCTION:                writeResults
+    --
+    -- DATE:                    October 19, 2026
+    --
+    -- REVISIONS:               N/A
+    --
+    -- DESIGNER:                Benny Wang
+    --
+    -- PROGRAMMER:              Benny Wang
+    --
+    -- INTERFACE:               bool writeResults(const std::vector<Result>& results, const QString& prefix, const QJsonObject& settings)
+    --                              results: The results to write.
+    --                              prefix: Written to prefix.csv and prefix.json.
+    --                              settings: The settings of the run, stored with the JSON results.
+    --
+    -- RETURN:                  True if both files were written, false otherwise.
+    --------------------------------------------------------------------------------------------------*/
+    bool writeResults(const std::vector<Result>& results, const QString& prefix, const QJsonObject& settings)
+    {
+        QFile csv(prefix + ".csv");
+        if (!csv.open(QIODevice::WriteOnly)) return false;
+
+        QTextStream out(&csv);
+        out << "loss,rtt_ms,window_frames,size_bytes,runs,failures,skipped,completion_ms,"
+            << "goodput_bytes_per_s,retransmission_ratio,cpu_ns_per_byte,wire_ratio\n";
+        for (const Result& result : results)
+        {
+            out << result.scenario.lossRate << ',' << result.scenario.rtt << ',' << result.scenario.window << ','
+                << result.scenario.size << ',' << result.runs << ',' << result.failures << ','
+                << (result.skipped ? 1 : 0) << ',' << result.completionMs << ',' << result.goodput << ','
+                << result.retransmissionRatio << ',' << result.cpuNsPerByte << ',' << result.wireRatio << '\n';
+        }
+        out.flush();
+        csv.close();
+
+        QJsonArray array;
+        for (const Result& result : results) array.append(toJson(result));
+
+        QJsonObject root = settings;
+        root["results"] = array;
+
+        QFile json(prefix + ".json");
+        if (!json.open(QIODevice::WriteOnly)) return false;
+        json.write(QJsonDocument(root).toJson());
+        json.close();
+
+        return true;
+    }
+
+    /*--------------------------------------------------------------------------------------------------
+    -- FUNCTION:                compareBaseline
+    --
+    -- DATE:                    October 19, 2026
+    --
+    -- REVISIONS:               N/A
+    --
+    -- DESIGNER:                Benny Wang
+    --
+    -- PROGRAMMER:              Benny Wang
+    --
+    -- INTERFACE:               int compareBaseline(const std::vector<Result>& results, const QString& path, const double threshold)
+    --                              results: The results of this run.
+    --                              path: The JSON file written by an earlier run.
+    --                              threshold: The largest drop in goodput in percent that is not
+    --                                         a regression.
+    --
+    -- RETURN:                  The number of regressions, or -1 if the baseline could not be read.
+    --
+    -- NOTES:
+    --                          Prints the change in goodput, retransmission ratio and CPU time for
+    --                          every scenario found in the baseline. A scenario regresses if its
+    --                          goodput dropped by more than the threshold or if it failed more often.
+    --                          CPU time is only reported since it depends on the machine.
+    --------------------------------------------------------------------------------------------------*/
+    int compareBaseline(const std::vector<Result>& results, const QString& path, const double threshold)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly))
+        {
+            fprintf(stderr, "Could not open the baseline %s\n", path.toStdString().c_str());
+            return -1;
+        }
+
+        QJsonParseError error;
+        const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+        file.close();
+        if (error.error != QJsonParseError::NoError || !document.isObject())
+        {
+            fprintf(stderr, "Could not parse the baseline %s\n", path.toStdString().c_str());
+            return -1;
+        }
+
+        std::map<QString, QJsonObject> baseline;
+        for (const auto& value : document.object().value("results").toArray())
+        {
+            const QJsonObject object = value.toObject();
+            Scenario scenario;
+            scenario.lossRate = object["loss"].toDouble();
+            scenario.rtt = (quint64)object["rtt_ms"].toDouble();
+            scenario.window = (quint64)object["window_frames"].toDouble();
+            scenario.size = (quint64)object["size_bytes"].toDouble();
+            baseline[key(scenario)] = object;
+        }
+
+        int regressions = 0;
+        printf("\n%-28s %12s %12s %10s %10s %10s\n", "scenario", "goodput", "baseline", "change", "retx", "cpu/B");
+        for (const Result& result : results)
+        {
+            const auto found = baseline.find(key(result.scenario));
+            if (result.skipped || found == baseline.end()) continue;
+
+            const QJsonObject& before = found->second;
+            const double goodput = before["goodput_bytes_per_s"].toDouble();
+            const double change = goodput > 0 ? (result.goodput - goodput) * 100.0 / goodput : 0;
+            const double retransmission = result.retransmissionRatio - before["retransmission_ratio"].toDouble();
+            const double cpu = result.cpuNsPerByte - before["cpu_ns_per_byte"].toDouble();
+            const bool regressed = change < -threshold || result.failures > (quint64)before["failures"].toDouble();
+            if (regressed) regressions++;
+
+            printf("%-28s %12.0f %12.0f %+9.1f%% %+10.4f %+10.2f%s\n", key(result.scenario).toStdString().c_str(),
+                result.goodput, goodput, change, retransmission, cpu, regressed ? "  REGRESSION" : "");
+        }
+
+        return regressions;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    kgp::DependencyManager::Instance().Logger().SetEnabled(false);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Runs complete transfers over an emulated link for every combination of the given "
+        "loss rates, round trip times, window sizes and file sizes.");
+    parser.addHelpOption();
+
+    QCommandLineOption lossOption("loss", "Comma separated loss rates.", "rates", "0,0.01,0.05,0.1");
+    QCommandLineOption rttOption("rtt", "Comma separated round trip times in milliseconds.", "ms", "0,20,100,200");
+    QCommandLineOption windowOption("window", "Comma separated receive windows in frames.", "frames", "10,64,256");
+    QCommandLineOption sizeOption("size", "Comma separated file sizes, K, M and G suffixes are allowed.", "bytes", "1K,64K,1M,16M");
+    QCommandLineOption seedsOption("seeds", "Number of seeds each scenario is run with.", "count", "3");
+    QCommandLineOption bandwidthOption("bandwidth", "Bandwidth of the link in bytes per second, 0 for unlimited.", "bytes", "12500000");
+    QCommandLineOption featuresOption("features", "Comma separated features both sides support: checksum, fec, compress, verify, pmtu, early, session.", "features", "checksum");
+    QCommandLineOption dataOption("data", "Data that is sent: pattern, text or random.", "kind", "pattern");
+    QCommandLineOption outOption("out", "Results are written to <prefix>.csv and <prefix>.json.", "prefix", "goodput");
+    QCommandLineOption baselineOption("baseline", "JSON results of an earlier run to compare against.", "file");
+    QCommandLineOption thresholdOption("threshold", "Largest drop in goodput in percent that is not a regression.", "percent", "5");
+    parser.addOption(lossOption);
+    parser.addOption(rttOption);
+    parser.addOption(windowOption);
+    parser.addOption(sizeOption);
+    parser.addOption(seedsOption);
+    parser.addOption(bandwidthOption);
+    parser.addOption(featuresOption);
+    parser.addOption(dataOption);
+    parser.addOption(outOption);
+    parser.addOption(baselineOption);
+    parser.addOption(thresholdOption);
+    parser.process(app);
+
+    std::vector<double> losses;
+    std::vector<quint64> rtts;
+    std::vector<quint64> windows;
+    std::vector<quint64> sizes;
+    bool valid = parseList(parser.value(lossOption), losses, [](const QString& text, double& value)
+    {
+        bool ok = false;
+        value = text.toDouble(&ok);
+        return ok && value >= 0 && value < 1;
+    });
+    valid = valid && parseList(parser.value(rttOption), rtts, [](const QString& text, quint64& value)
+    {
+        bool ok = false;
+        value = text.toULongLong(&ok);
+        return ok;
+    });
+    valid = valid && parseList(parser.value(windowOption), windows, [](const QString& text, quint64& value)
+    {
+        bool ok = false;
+        value = text.toULongLong(&ok);
+        return ok && value > 0;
+    });
+    valid = valid && parseList(parser.value(sizeOption), sizes, parseSize);
+
+    bool ok = false;
+    const quint64 seeds = parser.value(seedsOption).toULongLong(&ok);
+    valid = valid && ok && seeds > 0;
+    const quint64 bandwidth = parser.value(bandwidthOption).toULongLong(&ok);
+    valid = valid && ok;
+    const double threshold = parser.value(thresholdOption).toDouble(&ok);
+    valid = valid && ok;
+
+    quint64 features = 0;
+    for (const QString& feature : parser.value(featuresOption).split(','))
+    {
+        if (feature.trimmed() == "checksum") features |= kgp::Feature::CHECKSUM;
+        else if (feature.trimmed() == "fec") features |= kgp::Feature::FEC;
+        else if (feature.trimmed() == "compress") features |= kgp::Feature::COMPRESS;
+        else if (feature.trimmed() == "verify") features |= kgp::Feature::VERIFY;
+        else if (feature.trimmed() == "pmtu") features |= kgp::Feature::PMTU;
+        else if (feature.trimmed() == "early") features |= kgp::Feature::EARLY;
+        else if (feature.trimmed() == "session") features |= kgp::Feature::SESSION;
+        else if (feature.trimmed() != "none") valid = false;
+    }
+    const QString content = parser.value(dataOption);
+    valid = valid && (content == "pattern" || content == "text" || content == "random");
+
+    if (!valid)
+    {
+        fprintf(stderr, "Invalid arguments, see --help\n");
+        return 1;
+    }
+
+    std::vector<Result> results;
+    printf("%-28s %6s %12s %14s %10s %10s %8s\n", "scenario", "failed", "time (ms)", "goodput (B/s)", "retx", "cpu ns/B", "wire");
+    for (const quint64 size : sizes)
+    {
+        for (const double loss : losses)
+        {
+            for (const quint64 rtt : rtts)
+            {
+                for (const quint64 window : windows)
+                {
+                    const Scenario scenario = { loss, rtt, window, size };
+                    results.push_back(runScenario(scenario, seeds, bandwidth, features, content));
+
+                    const Result& result = results.back();
+                    if (result.skipped)
+                    {
+                        printf("%-28s skipped, larger than the window can buffer\n", key(scenario).toStdString().c_str());
+                        continue;
+                    }
+                    printf("%-28s %3llu/%-2llu %12.0f %14.0f %10.4f %10.2f %8.3f\n", key(scenario).toStdString().c_str(),
+                        (unsigned long long)result.failures, (unsigned long long)result.runs, result.completionMs,
+                        result.goodput, result.retransmissionRatio, result.cpuNsPerByte, result.wireRatio);
+                    fflush(stdout);
+                }
+            }
+        }
+    }
+
+    QJsonObject settings;
+    settings["seeds"] = (double)seeds;
+    settings["bandwidth_bytes_per_s"] = (double)bandwidth;
+    settings["features"] = parser.value(featuresOption);
+    settings["data"] = content;
+
+    const QString prefix = parser.value(outOption);
+    if (!writeResults(results, prefix, settings))
+    {
+        fprintf(stderr, "Could not write the results to %s\n", prefix.toStdString().c_str());
+        return 1;
+    }
+    printf("\nResults written to %s.csv and %s.json\n", prefix.toStdString().c_str(), prefix.toStdString().c_str());
+
+    if (parser.isSet(baselineOption))
+    {
+        const int regressions = compareBaseline(results, parser.value(baselineOption), threshold);
+        if (regressions < 0) return 1;
+        printf("%d regression(s) beyond %.1f%%\n", regressions, threshold);
+        if (regressions > 0) return 2;
+    }
+
+    return 0;
+}
@@ -0,0 +1,403 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             PacketBench.cpp
+--
+-- PROGRAM:                 kgp_bench
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Added BM_PacketParse.
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Microbenchmarks for the packet path. Packets are built and parsed the
+--                          same way IoEngine::sendFrames and IoEngine::newDataHandler do, and the
+--                          loopback benchmarks push them through a real UDP socket pair. The
+--                          benchmarks that build packets report the cycles spent per packet, compare
+--                          the copy into a packet with the frame descriptor that replaced it.
+---------------------------------------------------------------------------------------*/
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <vector>
+
+#include <QByteArray>
+#include <QHostAddress>
+#include <QNetworkDatagram>
+#include <QUdpSocket>
+
+#include "BenchUtil.h"
+#include "Compression.h"
+#include "Crc32c.h"
+#include "DependencyManager.h"
+#include "PacketView.h"
+#include "res.h"
+#include "SlidingWindow.h"
+#include "UdpTransport.h"
+
+namespace
+{
+    /*--------------------------------------------------------------------------------------------------
+    -- FUNCTION:                encodeFrame
+    --
+    -- DATE:                    October 19, 2026
+    --
+    -- REVISIONS:               N/A
+    --
+    -- DESIGNER:                Benny Wang
+    --
+    -- PROGRAMMER:              Benny Wang
+    --
+    -- INTERFACE:               void encodeFrame(const kgp::SlidingWindow::Frame& frame, kgp::Packet& packet)
+    --                              frame: The frame to encode.
+    --                              packet: The packet to encode into.
+    --
+    -- NOTES:
+    --                          Mirrors the per frame work IoEngine::sendFrames did before frames were
+    --                          sent from where they are, the whole packet is cleared and the data
+    --                          copied in behind the header.
+    --------------------------------------------------------------------------------------------------*/
+    inline void encodeFrame(const kgp::SlidingWindow::Frame& frame, kgp::Packet& packet)
+    {
+        memset(&packet, 0, sizeof(packet));
+        packet.Header.PacketType = kgp::PacketType::DATA;
+        packet.Header.SequenceNumber = frame.seqNum;
+        packet.Header.AckNumber = 0;
+        packet.Header.WindowSize = kgp::Size::WINDOW;
+        packet.Header.DataSize = frame.size;
+        memcpy(packet.Data, frame.data, frame.size);
+    }
+
+    // A datagram as it is handed to the transport, the header and the data where they are kept
+    struct FrameDescriptor
+    {
+        const char *parts[2];
+        size_t sizes[2];
+    };
+
+    /*--------------------------------------------------------------------------------------------------
+    -- FUNCTION:                encodeDescriptor
+    --
+    -- DATE:                    October 19, 2026
+    --
+    -- REVISIONS:               N/A
+    --
+    -- DESIGNER:                Benny Wang
+    --
+    -- PROGRAMMER:              Benny Wang
+    --
+    -- INTERFACE:               void encodeDescriptor(const kgp::SlidingWindow::Frame& frame, kgp::PacketHeader& header, FrameDescriptor& descriptor)
+    --                              frame: The frame to encode.
+    --                              header: The header that was built once for all frames.
+    --                              descriptor: The descriptor to point at the header and data.
+    --
+    -- NOTES:
+    --                          Mirrors the per frame work done by IoEngine::sendFrames, only the fields
+    --                          of the header that differ between frames are filled in.
+    --------------------------------------------------------------------------------------------------*/
+    inline void encodeDescriptor(const kgp::SlidingWindow::Frame& frame, kgp::PacketHeader& header, FrameDescriptor& descriptor)
+    {
+        header.SequenceNumber = frame.seqNum;
+        header.DataSize = frame.size;
+        descriptor.parts[0] = (const char *)&header;
+        descriptor.sizes[0] = kgp::Size::HEADER;
+        descriptor.parts[1] = frame.data;
+        descriptor.sizes[1] = frame.size;
+    }
+
+    // Header built once for every frame, as IoEngine::sendFrames does
+    inline kgp::PacketHeader dataHeader()
+    {
+        kgp::PacketHeader header;
+        memset(&header, 0, sizeof(header));
+        header.PacketType = kgp::PacketType::DATA;
+        header.WindowSize = kgp::Size::WINDOW;
+        return header;
+    }
+
+    // Window of frames shared by the packet benchmarks
+    struct FrameFixture
+    {
+        kgp::SlidingWindow window;
+        std::vector<kgp::SlidingWindow::Frame> frames;
+
+        FrameFixture()
+            : window(kgp::Size::WINDOW)
+        {
+            kgp::bench::BufferScratchFile(window, kgp::Size::WINDOW);
+            window.GetNextFrames(frames);
+        }
+    };
+
+    // Reads count datagrams off the receiver, returns the number that arrived before it went quiet
+    // for a second
+    size_t receiveWindow(QUdpSocket& receiver, const size_t count)
+    {
+        size_t received = 0;
+        while (received < count)
+        {
+            if (!receiver.hasPendingDatagrams() && !receiver.waitForReadyRead(1000)) break;
+            while (receiver.hasPendingDatagrams())
+            {
+                QNetworkDatagram datagram = receiver.receiveDatagram();
+                kgp::Packet buffer;
+                memcpy(&buffer, datagram.data().data(), datagram.data().size());
+                benchmark::DoNotOptimize(buffer.Header.SequenceNumber);
+                received++;
+            }
+        }
+        return received;
+    }
+}
+
+// Header and payload encode of a single DATA packet by copying the payload into a cleared packet
+static void BM_PacketEncode(benchmark::State& state)
+{
+    FrameFixture fixture;
+    kgp::Packet packet;
+    size_t i = 0;
+    const quint64 start = kgp::bench::Cycles();
+
+    for (auto _ : state)
+    {
+        encodeFrame(fixture.frames[i++ % fixture.frames.size()], packet);
+        benchmark::DoNotOptimize(&packet);
+        benchmark::ClobberMemory();
+    }
+
+    kgp::bench::SetCyclesPerPacket(state, start, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * sizeof(kgp::Packet));
+}
+BENCHMARK(BM_PacketEncode);
+
+// The same packet as a descriptor of the prebuilt header and the payload where the window keeps
+// it, the difference in cycles/packet to BM_PacketEncode is what IoEngine::sendFrames saves
+static void BM_FrameDescriptorEncode(benchmark::State& state)
+{
+    FrameFixture fixture;
+    kgp::PacketHeader header = dataHeader();
+    FrameDescriptor descriptor;
+    size_t i = 0;
+    const quint64 start = kgp::bench::Cycles();
+
+    for (auto _ : state)
+    {
+        encodeDescriptor(fixture.frames[i++ % fixture.frames.size()], header, descriptor);
+        benchmark::DoNotOptimize(&descriptor);
+        benchmark::DoNotOptimize(&header);
+        benchmark::ClobberMemory();
+    }
+
+    kgp::bench::SetCyclesPerPacket(state, start, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * (kgp::Size::HEADER + kgp::Size::DATA));
+}
+BENCHMARK(BM_FrameDescriptorEncode);
+
+// Decode of a received datagram by copying it into a packet buffer, as newDataHandler did before
+// it read packets in place, compare against BM_PacketParse
+static void BM_PacketDecode(benchmark::State& state)
+{
+    FrameFixture fixture;
+    kgp::Packet packet;
+    encodeFrame(fixture.frames[0], packet);
+    const QByteArray datagram((const char *)&packet, sizeof(packet));
+
+    for (auto _ : state)
+    {
+        kgp::Packet buffer;
+        memcpy(&buffer, datagram.data(), datagram.size());
+        benchmark::DoNotOptimize(buffer.Header.SequenceNumber);
+        benchmark::DoNotOptimize(buffer.Header.DataSize);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PacketDecode);
+
+// Parse of a received datagram in place as done by IoEngine::newDataHandler
+static void BM_PacketParse(benchmark::State& state)
+{
+    FrameFixture fixture;
+    kgp::Packet packet;
+    encodeFrame(fixture.frames[0], packet);
+    const QByteArray datagram((const char *)&packet, (int)(kgp::Size::HEADER + packet.Header.DataSize));
+
+    for (auto _ : state)
+    {
+        kgp::PacketView view;
+        benchmark::DoNotOptimize(kgp::PacketView::Parse(datagram.constData(), datagram.size(), view));
+        benchmark::DoNotOptimize(view.Header.SequenceNumber);
+        benchmark::DoNotOptimize(view.Data);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PacketParse);
+
+// Compression of a single frame as done by IoEngine::sendFrames when compression is negotiated
+static void BM_FrameCompress(benchmark::State& state)
+{
+    FrameFixture fixture;
+    kgp::Compressor compressor;
+    QByteArray compressed;
+    size_t i = 0;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(compressor.Compress(fixture.frames[i++ % fixture.frames.size()], compressed));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * kgp::Size::DATA);
+}
+BENCHMARK(BM_FrameCompress);
+
+// Uncompressing a received frame before it is delivered
+static void BM_FrameDecompress(benchmark::State& state)
+{
+    FrameFixture fixture;
+    kgp::Compressor compressor;
+    QByteArray compressed;
+    if (!compressor.Compress(fixture.frames[0], compressed))
+    {
+        state.SkipWithError("Frame did not compress");
+        return;
+    }
+    QByteArray frame;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(kgp::Compressor::Decompress(compressed.constData(), compressed.size(), kgp::Size::DATA, frame));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * kgp::Size::DATA);
+}
+BENCHMARK(BM_FrameDecompress);
+
+// Checksum of a full DATA packet as done by IoEngine::send and checked by IoEngine::newDataHandler,
+// compare against BM_PacketEncode and BM_LoopbackWindow for its share of the per packet work
+static void BM_PacketChecksum(benchmark::State& state)
+{
+    FrameFixture fixture;
+    kgp::Packet packet;
+    encodeFrame(fixture.frames[0], packet);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(kgp::Crc32c::ComputePacket(packet));
+    }
+
+    state.SetLabel(kgp::Crc32c::IsAccelerated() ? "accelerated" : "table");
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * sizeof(kgp::Packet));
+}
+BENCHMARK(BM_PacketChecksum);
+
+// The slice-by-8 fallback used on CPUs without CRC instructions
+static void BM_PacketChecksumTable(benchmark::State& state)
+{
+    FrameFixture fixture;
+    kgp::Packet packet;
+    encodeFrame(fixture.frames[0], packet);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(kgp::Crc32c::ComputeTable(&packet, sizeof(packet)));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * sizeof(kgp::Packet));
+}
+BENCHMARK(BM_PacketChecksumTable);
+
+// Cost of the per packet logging done by IoEngine::send and IoEngine::newDataHandler
+static void BM_PacketLog(benchmark::State& state)
+{
+    FrameFixture fixture;
+    kgp::Packet packet;
+    encodeFrame(fixture.frames[0], packet);
+    const QHostAddress address(QHostAddress::LocalHost);
+
+    for (auto _ : state)
+    {
+        kgp::DependencyManager::Instance().Logger().LogPacket(packet, address);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PacketLog);
+
+// Encode, send over loopback UDP, receive and decode a whole window of frames
+static void BM_LoopbackWindow(benchmark::State& state)
+{
+    FrameFixture fixture;
+    QUdpSocket sender;
+    QUdpSocket receiver;
+    if (!receiver.bind(QHostAddress::LocalHost, 0))
+    {
+        state.SkipWithError("Could not bind loopback socket");
+        return;
+    }
+    const quint16 port = receiver.localPort();
+    kgp::Packet packet;
+    size_t frameCount = 0;
+    const quint64 start = kgp::bench::Cycles();
+
+    for (auto _ : state)
+    {
+        for (const auto& frame : fixture.frames)
+        {
+            encodeFrame(frame, packet);
+            sender.writeDatagram((const char *)&packet, kgp::Size::HEADER + frame.size, QHostAddress::LocalHost, port);
+        }
+
+        frameCount += receiveWindow(receiver, fixture.frames.size());
+    }
+
+    kgp::bench::SetCyclesPerPacket(state, start, frameCount);
+    state.SetItemsProcessed(frameCount);
+    state.SetBytesProcessed(frameCount * kgp::Size::DATA);
+}
+BENCHMARK(BM_LoopbackWindow)->UseRealTime();
+
+// The same window sent as frame descriptors, the header and payload go to the socket as two
+// buffers of one datagram through kgp::UdpTransport::SendGather
+static void BM_LoopbackWindowGather(benchmark::State& state)
+{
+    FrameFixture fixture;
+    kgp::UdpTransport sender;
+    QUdpSocket receiver;
+    if (!receiver.bind(QHostAddress::LocalHost, 0) || !sender.Bind(QHostAddress::LocalHost, 0))
+    {
+        state.SkipWithError("Could not bind loopback socket");
+        return;
+    }
+    const quint16 port = receiver.localPort();
+    kgp::PacketHeader header = dataHeader();
+    FrameDescriptor descriptor;
+    size_t frameCount = 0;
+    const quint64 start = kgp::bench::Cycles();
+
+    for (auto _ : state)
+    {
+        for (const auto& frame : fixture.frames)
+        {
+            encodeDescriptor(frame, header, descriptor);
+            sender.SendGather(descriptor.parts[0], descriptor.sizes[0], descriptor.parts[1], descriptor.sizes[1], QHostAddress::LocalHost, port);
+        }
+
+        frameCount += receiveWindow(receiver, fixture.frames.size());
+    }
+
+    kgp::bench::SetCyclesPerPacket(state, start, frameCount);
+    state.SetItemsProcessed(frameCount);
+    state.SetBytesProcessed(frameCount * kgp::Size::DATA);
+}
+BENCHMARK(BM_LoopbackWindowGather)->UseRealTime();
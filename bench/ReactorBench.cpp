@@ -0,0 +1,339 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             ReactorBench.cpp
+--
+-- PROGRAM:                 kgp_bench
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Compares handling packets on the Qt event loop with handling them on the
+--                          epoll reactor, over real sockets on the loopback address. The round trip
+--                          benchmarks time one small datagram there and back, the burst benchmarks
+--                          report the bytes per second a burst of full sized datagrams is read at,
+--                          and the transfer benchmarks send a file of range bytes between two
+--                          engines, once the way the GUI did before with the packets on the event
+--                          loop and the timeouts on a spinning thread, and once on two I/O threads.
+--                          The I/O thread transfer is also run without logging the packets, which
+--                          is most of the time spent per packet otherwise, and reports the share of
+--                          the CPU time both engines spent on the checksums of their packets.
+--                          Only built on Linux.
+---------------------------------------------------------------------------------------*/
+#include <benchmark/benchmark.h>
+
+#if defined(__linux__)
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <mutex>
+
+#include <time.h>
+
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QFile>
+#include <QHostAddress>
+
+#include "Crc32c.h"
+#include "DependencyManager.h"
+#include "IoEngine.h"
+#include "IoThread.h"
+#include "Reactor.h"
+#include "ReactorTransport.h"
+#include "res.h"
+#include "UdpTransport.h"
+
+namespace
+{
+    const QHostAddress LOCALHOST(QHostAddress::LocalHost);
+    // Ports of the transports, away from the protocol port and the ports of the tests
+    constexpr short PORT_A = 18101;
+    constexpr short PORT_B = 18102;
+    // Datagrams sent before waiting for them to be read, few enough to fit the receive buffer
+    constexpr int BURST = 32;
+    // Time after which a datagram or a transfer is taken to be lost
+    constexpr auto TIME_LIMIT = std::chrono::seconds(5);
+    const char *SCRATCH = "kgp_bench_reactor.bin";
+    // Features of the engines of the transfer benchmarks, the defaults without resuming
+    constexpr quint64 FEATURES = kgp::Feature::CHECKSUM | kgp::Feature::PMTU;
+
+    // Calls turn until done is true, false if the time limit passed first
+    bool runUntil(const std::function<void()>& turn, const std::function<bool()>& done)
+    {
+        const auto end = std::chrono::steady_clock::now() + TIME_LIMIT;
+        while (!done())
+        {
+            if (std::chrono::steady_clock::now() > end) return false;
+            turn();
+        }
+        return true;
+    }
+
+    // Sends a small datagram from a to b and back again every iteration
+    void roundTrip(benchmark::State& state, kgp::Transport& a, kgp::Transport& b, const std::function<void()>& turn)
+    {
+        if (!a.Bind(LOCALHOST, PORT_A) || !b.Bind(LOCALHOST, PORT_B))
+        {
+            state.SkipWithError("Could not bind the loopback ports");
+            return;
+        }
+
+        bool answered = false;
+        QObject::connect(&b, &kgp::Transport::readyRead, [&]() {
+            while (b.HasPendingDatagrams())
+            {
+                const QByteArray data = b.Receive().data();
+                b.Send(data.constData(), data.size(), LOCALHOST, PORT_A);
+            }
+        });
+        QObject::connect(&a, &kgp::Transport::readyRead, [&]() {
+            while (a.HasPendingDatagrams()) a.Receive();
+            answered = true;
+        });
+
+        const char ping[kgp::Size::HEADER] = {};
+        for (auto _ : state)
+        {
+            answered = false;
+            a.Send(ping, sizeof(ping), LOCALHOST, PORT_B);
+            if (!runUntil(turn, [&]() { return answered; }))
+            {
+                state.SkipWithError("The datagram was lost");
+                return;
+            }
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    // Sends bursts of full sized datagrams from a to b and waits for b to read each burst
+    void burst(benchmark::State& state, kgp::Transport& a, kgp::Transport& b, const std::function<void()>& turn)
+    {
+        if (!a.Bind(LOCALHOST, PORT_A) || !b.Bind(LOCALHOST, PORT_B))
+        {
+            state.SkipWithError("Could not bind the loopback ports");
+            return;
+        }
+
+        int read = 0;
+        QObject::connect(&b, &kgp::Transport::readyRead, [&]() {
+            while (b.HasPendingDatagrams())
+            {
+                b.Receive();
+                read++;
+            }
+        });
+
+        const QByteArray packet(kgp::Size::PACKET, 'k');
+        for (auto _ : state)
+        {
+            read = 0;
+            for (int i = 0; i < BURST; i++) a.Send(packet.constData(), packet.size(), LOCALHOST, PORT_B);
+            if (!runUntil(turn, [&]() { return read == BURST; }))
+            {
+                state.SkipWithError("A datagram of the burst was lost");
+                return;
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * BURST);
+        state.SetBytesProcessed(state.iterations() * BURST * packet.size());
+    }
+
+    // CPU time of every thread of the process in nanoseconds
+    quint64 processTime()
+    {
+        timespec time;
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+        return (quint64)time.tv_sec * 1000000000 + (quint64)time.tv_nsec;
+    }
+
+    // Nanoseconds the checksum of a packet with size bytes of data takes, averaged over many
+    double checksumTime(const quint64 size)
+    {
+        constexpr int COUNT = 100000;
+        kgp::Packet packet;
+        memset(&packet, 'k', sizeof(packet));
+        packet.Header.DataSize = size;
+
+        quint32 crc = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < COUNT; i++)
+        {
+            packet.Header.SequenceNumber = (quint64)i;
+            crc ^= kgp::Crc32c::ComputePacket(packet);
+        }
+        const auto end = std::chrono::steady_clock::now();
+        benchmark::DoNotOptimize(crc);
+        return std::chrono::duration<double, std::nano>(end - start).count() / COUNT;
+    }
+
+    // Writes the file sent by the transfer benchmarks
+    bool scratchFile(const qint64 size)
+    {
+        QFile file(SCRATCH);
+        if (file.exists() && file.size() == size) return true;
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+        file.write(QByteArray((int)size, 'k'));
+        file.close();
+        return true;
+    }
+}
+
+// A datagram there and back with both sockets read from the Qt event loop
+static void BM_QtLoopRoundTrip(benchmark::State& state)
+{
+    kgp::UdpTransport a;
+    kgp::UdpTransport b;
+    roundTrip(state, a, b, []() { QCoreApplication::processEvents(); });
+}
+BENCHMARK(BM_QtLoopRoundTrip)->Unit(benchmark::kMicrosecond);
+
+// A datagram there and back with both sockets waited on by the reactor
+static void BM_ReactorRoundTrip(benchmark::State& state)
+{
+    kgp::Reactor reactor;
+    kgp::ReactorTransport a(reactor);
+    kgp::ReactorTransport b(reactor);
+    roundTrip(state, a, b, [&]() { reactor.RunOnce(1); });
+}
+BENCHMARK(BM_ReactorRoundTrip)->Unit(benchmark::kMicrosecond);
+
+// Bursts of full sized datagrams read from the Qt event loop
+static void BM_QtLoopBurst(benchmark::State& state)
+{
+    kgp::UdpTransport a;
+    kgp::UdpTransport b;
+    burst(state, a, b, []() { QCoreApplication::processEvents(); });
+}
+BENCHMARK(BM_QtLoopBurst)->Unit(benchmark::kMicrosecond);
+
+// Bursts of full sized datagrams read by the reactor
+static void BM_ReactorBurst(benchmark::State& state)
+{
+    kgp::Reactor reactor;
+    kgp::ReactorTransport a(reactor);
+    kgp::ReactorTransport b(reactor);
+    burst(state, a, b, [&]() { reactor.RunOnce(1); });
+}
+BENCHMARK(BM_ReactorBurst)->Unit(benchmark::kMicrosecond);
+
+// A file between two engines whose packets are handled on the event loop of this thread and whose
+// timeouts are checked by a thread of their own each
+static void BM_QtLoopTransfer(benchmark::State& state)
+{
+    if (!scratchFile(state.range(0)))
+    {
+        state.SkipWithError("Could not write the file to send");
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        kgp::UdpTransport receiveSocket;
+        kgp::UdpTransport sendSocket;
+        kgp::IoEngine receiver(&receiveSocket);
+        kgp::IoEngine sender(&sendSocket);
+        // Both engines bind the protocol port, the sender moves off it
+        sendSocket.Close();
+        sendSocket.Bind(QHostAddress::Any, PORT_A);
+        // Every iteration sends the whole file instead of resuming the last one
+        receiver.SetFeatures(FEATURES);
+        sender.SetFeatures(FEATURES);
+
+        qint64 received = 0;
+        QObject::connect(&receiver, &kgp::IoEngine::dataRead, [&](const char *, const size_t& size) { received += (qint64)size; });
+        state.ResumeTiming();
+
+        sender.StartFileSend(SCRATCH, "127.0.0.1", kgp::PORT);
+        if (!runUntil([]() { QCoreApplication::processEvents(); }, [&]() { return received >= state.range(0); }))
+        {
+            state.SkipWithError("The transfer did not finish");
+            return;
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_QtLoopTransfer)->Arg(1 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// A file between two engines that run on an I/O thread each. Every packet is checksummed once by
+// the engine that sends it and once by the one that receives it, which are the data frames of the
+// sender and the ACKs of the receiver. Their checksums are timed on their own afterwards and
+// reported as checksum% of the CPU time of the transfers. The second argument is whether the
+// packets are logged
+static void BM_IoThreadTransfer(benchmark::State& state)
+{
+    if (!scratchFile(state.range(0)))
+    {
+        state.SkipWithError("Could not write the file to send");
+        return;
+    }
+    kgp::DependencyManager::Instance().Logger().SetEnabled(state.range(1) != 0);
+
+    quint64 cpu = 0;
+    quint64 packets = 0;
+    quint64 frames = 0;
+    quint64 payload = 0;
+    quint64 acks = 0;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        // Declared before the threads so that they outlive them
+        std::mutex mutex;
+        std::condition_variable finished;
+        qint64 received = 0;
+
+        kgp::IoThread receiver(kgp::PORT);
+        kgp::IoThread sender(PORT_A);
+        receiver.Engine().SetFeatures(FEATURES);
+        sender.Engine().SetFeatures(FEATURES);
+        QObject::connect(&receiver.Engine(), &kgp::IoEngine::dataRead, [&](const char *, const size_t& size) {
+            std::lock_guard<std::mutex> locker(mutex);
+            received += (qint64)size;
+            if (received >= state.range(0)) finished.notify_one();
+        });
+        receiver.Start();
+        sender.Start();
+        state.ResumeTiming();
+
+        const quint64 start = processTime();
+        sender.Post([&]() { sender.Engine().StartFileSend(SCRATCH, "127.0.0.1", kgp::PORT); });
+        std::unique_lock<std::mutex> locker(mutex);
+        if (!finished.wait_for(locker, TIME_LIMIT, [&]() { return received >= state.range(0); }))
+        {
+            kgp::DependencyManager::Instance().Logger().SetEnabled(true);
+            state.SkipWithError("The transfer did not finish");
+            return;
+        }
+        locker.unlock();
+        cpu += processTime() - start;
+
+        state.PauseTiming();
+        sender.Stop();
+        receiver.Stop();
+        const kgp::IoEngine::Stats sent = sender.Engine().GetStats();
+        packets += sent.packetsSent;
+        frames += sent.framesSent + sent.framesResent;
+        payload += sent.bytesSent;
+        acks += receiver.Engine().GetStats().packetsSent;
+        state.ResumeTiming();
+    }
+    kgp::DependencyManager::Instance().Logger().SetEnabled(true);
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+
+    if (cpu == 0 || frames == 0) return;
+    // The control packets of the sender are few and are counted as data frames
+    const double checksums = 2 * (packets * checksumTime(payload / frames) + acks * checksumTime(0));
+    state.counters["checksum%"] = 100 * checksums / cpu;
+}
+BENCHMARK(BM_IoThreadTransfer)->Args({1 << 20, 1})->Args({1 << 20, 0})->Unit(benchmark::kMillisecond)->UseRealTime();
+
+#endif
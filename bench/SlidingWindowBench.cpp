@@ -0,0 +1,209 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             SlidingWindowBench.cpp
+--
+-- PROGRAM:                 kgp_bench
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Microbenchmarks for the sliding window. Every benchmark reports items
+--                          per second where an item is one frame, so per frame cost can be
+--                          compared across window sizes. The range argument is the window size
+--                          in frames.
+---------------------------------------------------------------------------------------*/
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "BenchUtil.h"
+#include "Clock.h"
+#include "DependencyManager.h"
+#include "RttEstimator.h"
+#include "SlidingWindow.h"
+
+namespace
+{
+    // Large enough that a window can slide many times before the buffer has to be reloaded
+    constexpr quint64 BUFFER_SIZE = 64 * 1024 * 1024;
+
+    void rebuffer(benchmark::State& state, kgp::SlidingWindow& window)
+    {
+        state.PauseTiming();
+        kgp::bench::BufferScratchFile(window, BUFFER_SIZE);
+        state.ResumeTiming();
+    }
+}
+
+// Frame generation with a fresh result vector per call, as IoEngine::sendWindow does
+static void BM_GetNextFrames(benchmark::State& state)
+{
+    kgp::SlidingWindow window(state.range(0) * kgp::Size::DATA);
+    kgp::bench::BufferScratchFile(window, BUFFER_SIZE);
+    size_t frameCount = 0;
+
+    for (auto _ : state)
+    {
+        std::vector<kgp::SlidingWindow::Frame> frames;
+        window.GetNextFrames(frames);
+        if (frames.empty())
+        {
+            rebuffer(state, window);
+            continue;
+        }
+        frameCount += frames.size();
+        // Slide the whole window forward
+        window.AckFrame(frames.back().seqNum + frames.back().size);
+        benchmark::DoNotOptimize(frames.data());
+    }
+
+    state.SetItemsProcessed(frameCount);
+    state.SetBytesProcessed(frameCount * kgp::Size::DATA);
+}
+BENCHMARK(BM_GetNextFrames)->RangeMultiplier(4)->Range(4, 1024);
+
+// Frame generation reusing the result vector, the lower bound without allocation
+static void BM_GetNextFramesReused(benchmark::State& state)
+{
+    kgp::SlidingWindow window(state.range(0) * kgp::Size::DATA);
+    kgp::bench::BufferScratchFile(window, BUFFER_SIZE);
+    std::vector<kgp::SlidingWindow::Frame> frames;
+    frames.reserve(state.range(0));
+    size_t frameCount = 0;
+
+    for (auto _ : state)
+    {
+        frames.clear();
+        window.GetNextFrames(frames);
+        if (frames.empty())
+        {
+            rebuffer(state, window);
+            continue;
+        }
+        frameCount += frames.size();
+        window.AckFrame(frames.back().seqNum + frames.back().size);
+        benchmark::DoNotOptimize(frames.data());
+    }
+
+    state.SetItemsProcessed(frameCount);
+}
+BENCHMARK(BM_GetNextFramesReused)->RangeMultiplier(4)->Range(4, 1024);
+
+// Recutting the pending frames of a full window, as done when the path stops carrying the frame size
+static void BM_GetPendingFrames(benchmark::State& state)
+{
+    kgp::SlidingWindow window(state.range(0) * kgp::Size::DATA);
+    kgp::bench::BufferScratchFile(window, BUFFER_SIZE);
+    std::vector<kgp::SlidingWindow::Frame> frames;
+    window.GetNextFrames(frames);
+    size_t frameCount = 0;
+
+    for (auto _ : state)
+    {
+        std::vector<kgp::SlidingWindow::Frame> pending;
+        window.GetPendingFrames(pending);
+        frameCount += pending.size();
+        benchmark::DoNotOptimize(pending.data());
+    }
+
+    state.SetItemsProcessed(frameCount);
+}
+BENCHMARK(BM_GetPendingFrames)->RangeMultiplier(4)->Range(4, 1024);
+
+// Resending a full window after the first frame in it timed out
+static void BM_GetExpiredFrames(benchmark::State& state)
+{
+    kgp::SimulatedClock clock;
+    kgp::DependencyManager::Instance().SetClock(&clock);
+    kgp::RttEstimator rtt;
+    kgp::SlidingWindow window(state.range(0) * kgp::Size::DATA);
+    kgp::bench::BufferScratchFile(window, BUFFER_SIZE);
+    std::vector<kgp::SlidingWindow::Frame> frames;
+    window.GetNextFrames(frames);
+    size_t frameCount = 0;
+
+    for (auto _ : state)
+    {
+        // Every frame backs off to the receive timeout, which is also the largest one
+        clock.Advance(kgp::Timeout::RCV + 1);
+        frames.clear();
+        window.GetExpiredFrames(rtt, frames);
+        frameCount += frames.size();
+        benchmark::DoNotOptimize(frames.data());
+    }
+
+    kgp::DependencyManager::Instance().SetClock(nullptr);
+    state.SetItemsProcessed(frameCount);
+}
+BENCHMARK(BM_GetExpiredFrames)->RangeMultiplier(4)->Range(4, 1024);
+
+// ACK patterns used by the ACK processing benchmark
+enum AckPattern
+{
+    // One ACK for every frame, in order
+    ACK_EVERY_FRAME,
+    // One cumulative ACK for the whole window
+    ACK_CUMULATIVE,
+    // Every ACK is delivered twice
+    ACK_DUPLICATED,
+    // ACKs for every frame arrive in reverse order
+    ACK_REVERSED
+};
+
+// ACK processing for different window sizes (range 0) and ACK patterns (range 1)
+static void BM_AckFrame(benchmark::State& state)
+{
+    const AckPattern pattern = (AckPattern)state.range(1);
+    kgp::SlidingWindow window(state.range(0) * kgp::Size::DATA);
+    kgp::bench::BufferScratchFile(window, BUFFER_SIZE);
+    std::vector<kgp::SlidingWindow::Frame> frames;
+    size_t ackCount = 0;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        frames.clear();
+        window.GetNextFrames(frames);
+        if (frames.empty())
+        {
+            kgp::bench::BufferScratchFile(window, BUFFER_SIZE);
+            state.ResumeTiming();
+            continue;
+        }
+        state.ResumeTiming();
+
+        switch (pattern)
+        {
+        case ACK_EVERY_FRAME:
+            for (const auto& frame : frames) window.AckFrame(frame.seqNum + frame.size);
+            ackCount += frames.size();
+            break;
+        case ACK_CUMULATIVE:
+            window.AckFrame(frames.back().seqNum + frames.back().size);
+            ackCount++;
+            break;
+        case ACK_DUPLICATED:
+            for (const auto& frame : frames)
+            {
+                window.AckFrame(frame.seqNum + frame.size);
+                window.AckFrame(frame.seqNum + frame.size);
+            }
+            ackCount += frames.size() * 2;
+            break;
+        case ACK_REVERSED:
+            for (auto it = frames.rbegin(); it != frames.rend(); it++) window.AckFrame(it->seqNum + it->size);
+            ackCount += frames.size();
+            break;
+        }
+    }
+
+    state.SetItemsProcessed(ackCount);
+}
+BENCHMARK(BM_AckFrame)->ArgsProduct({ { 4, 64, 1024 }, { ACK_EVERY_FRAME, ACK_CUMULATIVE, ACK_DUPLICATED, ACK_REVERSED } });
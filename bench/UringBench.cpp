@@ -0,0 +1,283 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             UringBench.cpp
+--
+-- PROGRAM:                 kgp_bench
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Compares moving datagrams and file data one system call at a time on the
+--                          epoll reactor with moving them through an io_uring. Every benchmark
+--                          reports the system calls it took per gigabyte moved as syscalls/GB next
+--                          to its throughput. The burst benchmarks send bursts of full sized
+--                          datagrams over loopback, the transfer benchmarks send a file between two
+--                          I/O threads and write what arrives to disk through the transport of the
+--                          receiver, and the read benchmarks buffer a file like a send does. Only
+--                          built on Linux, the io_uring benchmarks are skipped where the kernel
+--                          cannot run a ring.
+---------------------------------------------------------------------------------------*/
+#include <benchmark/benchmark.h>
+
+#if defined(__linux__)
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+#include <QByteArray>
+#include <QFile>
+#include <QHostAddress>
+
+#include "IoEngine.h"
+#include "IoThread.h"
+#include "IoUring.h"
+#include "Reactor.h"
+#include "ReactorTransport.h"
+#include "res.h"
+#include "UringTransport.h"
+
+namespace
+{
+    const QHostAddress LOCALHOST(QHostAddress::LocalHost);
+    // Ports of the transports, away from the protocol port and the ports of the tests
+    constexpr short PORT_A = 18101;
+    constexpr short PORT_B = 18102;
+    // Datagrams sent before waiting for them to be read, few enough to fit the receive buffer
+    constexpr int BURST = 32;
+    // Time after which a burst or a transfer is taken to be lost
+    constexpr auto TIME_LIMIT = std::chrono::seconds(10);
+    const char *SCRATCH = "kgp_bench_uring.bin";
+    const char *OUTPUT = "kgp_bench_uring.out";
+    // Features of the engines of the transfer benchmarks, the defaults without resuming
+    constexpr quint64 FEATURES = kgp::Feature::CHECKSUM | kgp::Feature::PMTU;
+
+    // Reports the system calls made per gigabyte moved
+    void setSyscallsPerGigabyte(benchmark::State& state, const quint64 syscalls, const quint64 bytes)
+    {
+        if (bytes == 0) return;
+        state.counters["syscalls/GB"] = (double)syscalls * 1e9 / bytes;
+    }
+
+    // Makes a transport of the backend, nullptr if the kernel cannot run it
+    std::unique_ptr<kgp::ReactorTransport> makeTransport(kgp::Reactor& reactor, const kgp::IoThread::Backend backend)
+    {
+        if (backend == kgp::IoThread::EPOLL) return std::unique_ptr<kgp::ReactorTransport>(new kgp::ReactorTransport(reactor));
+        if (!kgp::IoUring::IsSupported()) return nullptr;
+        return std::unique_ptr<kgp::ReactorTransport>(new kgp::UringTransport(reactor));
+    }
+
+    // Writes the file sent and read by the benchmarks
+    bool scratchFile(const qint64 size)
+    {
+        QFile file(SCRATCH);
+        if (file.exists() && file.size() == size) return true;
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+        file.write(QByteArray((int)size, 'k'));
+        file.close();
+        return true;
+    }
+
+    // Sends bursts of full sized datagrams from one transport of backend to another and waits for
+    // each burst to be read
+    void burst(benchmark::State& state, const kgp::IoThread::Backend backend)
+    {
+        kgp::Reactor reactor;
+        std::unique_ptr<kgp::ReactorTransport> a = makeTransport(reactor, backend);
+        std::unique_ptr<kgp::ReactorTransport> b = makeTransport(reactor, backend);
+        if (!a || !b)
+        {
+            state.SkipWithError("io_uring is not supported here");
+            return;
+        }
+        if (!a->Bind(LOCALHOST, PORT_A) || !b->Bind(LOCALHOST, PORT_B))
+        {
+            state.SkipWithError("Could not bind the loopback ports");
+            return;
+        }
+
+        int read = 0;
+        QObject::connect(b.get(), &kgp::Transport::readyRead, [&]() {
+            while (b->HasPendingDatagrams())
+            {
+                b->Receive();
+                read++;
+            }
+        });
+
+        const QByteArray packet(kgp::Size::PACKET, 'k');
+        const quint64 before = reactor.Syscalls() + a->Syscalls() + b->Syscalls();
+        for (auto _ : state)
+        {
+            read = 0;
+            for (int i = 0; i < BURST; i++) a->Send(packet.constData(), packet.size(), LOCALHOST, PORT_B);
+            a->Flush();
+
+            const auto end = std::chrono::steady_clock::now() + TIME_LIMIT;
+            while (read < BURST)
+            {
+                if (std::chrono::steady_clock::now() > end)
+                {
+                    state.SkipWithError("A datagram of the burst was lost");
+                    return;
+                }
+                reactor.RunOnce(1);
+            }
+        }
+
+        const quint64 bytes = state.iterations() * BURST * packet.size();
+        state.SetItemsProcessed(state.iterations() * BURST);
+        state.SetBytesProcessed(bytes);
+        setSyscallsPerGigabyte(state, reactor.Syscalls() + a->Syscalls() + b->Syscalls() - before, bytes);
+    }
+
+    // Sends a file of range bytes between two I/O threads of backend, the receiver writes it to disk
+    // through its transport
+    void transfer(benchmark::State& state, const kgp::IoThread::Backend backend)
+    {
+        if (backend == kgp::IoThread::URING && !kgp::IoUring::IsSupported())
+        {
+            state.SkipWithError("io_uring is not supported here");
+            return;
+        }
+        if (!scratchFile(state.range(0)))
+        {
+            state.SkipWithError("Could not write the file to send");
+            return;
+        }
+
+        quint64 syscalls = 0;
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            // Declared before the threads so that they outlive them
+            std::mutex mutex;
+            std::condition_variable finished;
+            qint64 received = 0;
+            QFile output(OUTPUT);
+            output.open(QIODevice::ReadWrite | QIODevice::Truncate);
+
+            kgp::IoThread receiver(kgp::PORT, backend);
+            kgp::IoThread sender(PORT_A, backend);
+            receiver.Engine().SetFeatures(FEATURES);
+            sender.Engine().SetFeatures(FEATURES);
+            QObject::connect(&receiver.Engine(), &kgp::IoEngine::dataRead, [&](const char *data, const size_t& size) {
+                receiver.GetTransport().WriteFile(output, received, data, (qint64)size);
+                std::lock_guard<std::mutex> locker(mutex);
+                received += (qint64)size;
+                if (received >= state.range(0)) finished.notify_one();
+            });
+            receiver.Start();
+            sender.Start();
+            state.ResumeTiming();
+
+            sender.Post([&]() { sender.Engine().StartFileSend(SCRATCH, "127.0.0.1", kgp::PORT); });
+            std::unique_lock<std::mutex> locker(mutex);
+            if (!finished.wait_for(locker, TIME_LIMIT, [&]() { return received >= state.range(0); }))
+            {
+                state.SkipWithError("The transfer did not finish");
+                return;
+            }
+            locker.unlock();
+
+            // The writes still queued are part of the transfer
+            receiver.Stop();
+            state.PauseTiming();
+            sender.Stop();
+            syscalls += sender.Syscalls() + receiver.Syscalls();
+            state.ResumeTiming();
+        }
+
+        const quint64 bytes = state.iterations() * state.range(0);
+        state.SetBytesProcessed(bytes);
+        setSyscallsPerGigabyte(state, syscalls, bytes);
+    }
+
+    // Buffers a file of range bytes into a window, through a transport of backend or with readAll
+    void readFile(benchmark::State& state, const kgp::IoThread::Backend backend, const bool throughTransport)
+    {
+        kgp::Reactor reactor;
+        std::unique_ptr<kgp::ReactorTransport> transport = makeTransport(reactor, backend);
+        if (!transport)
+        {
+            state.SkipWithError("io_uring is not supported here");
+            return;
+        }
+        if (!scratchFile(state.range(0)))
+        {
+            state.SkipWithError("Could not write the file to send");
+            return;
+        }
+
+        kgp::SlidingWindow window;
+        if (throughTransport) window.SetFileReader([&](QFile& file, QByteArray& data) { return transport->ReadFile(file, data); });
+
+        const quint64 before = transport->Syscalls();
+        for (auto _ : state)
+        {
+            QFile file(SCRATCH);
+            if (!window.BufferFile(file))
+            {
+                state.SkipWithError("Could not read the file");
+                return;
+            }
+            benchmark::DoNotOptimize(window.GetSize());
+        }
+
+        const quint64 bytes = state.iterations() * state.range(0);
+        state.SetBytesProcessed(bytes);
+        if (throughTransport) setSyscallsPerGigabyte(state, transport->Syscalls() - before, bytes);
+    }
+}
+
+// Bursts of full sized datagrams sent and received one system call at a time
+static void BM_EpollBurst(benchmark::State& state)
+{
+    burst(state, kgp::IoThread::EPOLL);
+}
+BENCHMARK(BM_EpollBurst)->Unit(benchmark::kMicrosecond);
+
+// Bursts of full sized datagrams queued on an io_uring and submitted together
+static void BM_UringBurst(benchmark::State& state)
+{
+    burst(state, kgp::IoThread::URING);
+}
+BENCHMARK(BM_UringBurst)->Unit(benchmark::kMicrosecond);
+
+// A file between two I/O threads on epoll, written to disk through QFile
+static void BM_EpollTransfer(benchmark::State& state)
+{
+    transfer(state, kgp::IoThread::EPOLL);
+}
+BENCHMARK(BM_EpollTransfer)->Arg(8 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// A file between two I/O threads on io_uring, written to disk through registered buffers
+static void BM_UringTransfer(benchmark::State& state)
+{
+    transfer(state, kgp::IoThread::URING);
+}
+BENCHMARK(BM_UringTransfer)->Arg(8 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// A file buffered with one blocking readAll
+static void BM_ReadAllFile(benchmark::State& state)
+{
+    readFile(state, kgp::IoThread::EPOLL, false);
+}
+BENCHMARK(BM_ReadAllFile)->Arg(64 << 20)->Unit(benchmark::kMillisecond);
+
+// A file buffered with reads that are all in flight on an io_uring at once
+static void BM_UringReadFile(benchmark::State& state)
+{
+    readFile(state, kgp::IoThread::URING, true);
+}
+BENCHMARK(BM_UringReadFile)->Arg(64 << 20)->Unit(benchmark::kMillisecond);
+
+#endif
@@ -0,0 +1,157 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             PacketViewFuzz.cpp
+--
+-- PROGRAM:                 kgp_fuzz_packet
+--
+-- FUNCTIONS:               int LLVMFuzzerInitialize(int *argc, char ***argv)
+--                          int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          libFuzzer target for the receive path. Every input is first parsed as a
+--                          single datagram, a packet that parses has to point inside the input and
+--                          all of its data is read so the sanitizers catch a read past the end.
+--
+--                          The input is then split into datagrams and sent to a receiving engine
+--                          over the emulated link, so whatever gets past the parser is handled by
+--                          the state machine as it would be off the network. The first two bytes
+--                          are the features of the receiver, every datagram after them is a two
+--                          byte little endian length and that many bytes. Each input gets a new
+--                          engine so runs do not depend on each other.
+---------------------------------------------------------------------------------------*/
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QHostAddress>
+
+#include "Crc32c.h"
+#include "DependencyManager.h"
+#include "EmulatedLink.h"
+#include "IoEngine.h"
+#include "PacketView.h"
+#include "Simulation.h"
+
+namespace
+{
+    // Simulated time every input runs for after its datagrams are sent, long enough for the
+    // receiver to answer and time out
+    constexpr quint64 RUN_TIME = 2 * kgp::Timeout::RCV;
+
+    /*--------------------------------------------------------------------------------------------------
+    -- FUNCTION:                checkParse
+    --
+    -- DATE:                    October 19, 2026
+    --
+    -- REVISIONS:               N/A
+    --
+    -- DESIGNER:                Benny Wang
+    --
+    -- PROGRAMMER:              Benny Wang
+    --
+    -- INTERFACE:               void checkParse(const char *bytes, const size_t size)
+    --                              bytes: A datagram.
+    --                              size: The size of the datagram.
+    --
+    -- NOTES:
+    --                          Parses the datagram and stops the fuzzer if a packet it let through
+    --                          does not keep to what the engine relies on.
+    --------------------------------------------------------------------------------------------------*/
+    void checkParse(const char *bytes, const size_t size)
+    {
+        kgp::PacketView view;
+        if (kgp::PacketView::Parse(bytes, size, view) != kgp::PacketView::Status::VALID) return;
+
+        if (size < kgp::Size::HEADER || view.Data != bytes + kgp::Size::HEADER) __builtin_trap();
+        if (view.Header.DataSize > size - kgp::Size::HEADER || view.Header.DataSize > kgp::Size::MAX_DATA) __builtin_trap();
+        // Reads every byte of data, as the checksum of the engine does
+        volatile quint32 crc = kgp::Crc32c::ComputePacket(view.Header, view.Data);
+        (void)crc;
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                LLVMFuzzerInitialize
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               int LLVMFuzzerInitialize(int *argc, char ***argv)
+--                              argc: The number of command line arguments.
+--                              argv: The command line arguments.
+--
+-- RETURN:                  0.
+--
+-- NOTES:
+--                          Creates the application the engines need and turns off regular log
+--                          messages, which would otherwise be most of the time spent per input.
+--------------------------------------------------------------------------------------------------*/
+extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv)
+{
+    static QCoreApplication app(*argc, *argv);
+    kgp::DependencyManager::Instance().Logger().SetEnabled(false);
+    return 0;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                LLVMFuzzerTestOneInput
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+--                              data: The input.
+--                              size: The size of the input.
+--
+-- RETURN:                  0.
+--------------------------------------------------------------------------------------------------*/
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    // Parsed from a buffer of its own so a read past the end is caught
+    QByteArray whole((const char *)data, (int)size);
+    checkParse(whole.constData(), (size_t)whole.size());
+
+    if (size < 2) return 0;
+
+    kgp::EmulatedLink::Config config;
+    memset(&config, 0, sizeof(config));
+    config.seed = 1;
+    config.delay = 1;
+
+    kgp::Simulation simulation(config);
+    kgp::IoEngine *receiver = simulation.CreateEngine(QHostAddress(QString("10.0.0.2")));
+    receiver->SetFeatures(data[0] | (data[1] << 8));
+    kgp::EmulatedTransport *peer = simulation.Link().CreateEndpoint(QHostAddress(QString("10.0.0.1")));
+    peer->Bind(QHostAddress::Any, 18001);
+
+    for (size_t at = 2; at + 2 <= size;)
+    {
+        const size_t length = std::min<size_t>(data[at] | (data[at + 1] << 8), size - at - 2);
+        at += 2;
+        peer->Send((const char *)data + at, (qint64)length, QHostAddress(QString("10.0.0.2")), kgp::PORT);
+        at += length;
+    }
+
+    simulation.RunUntil([]() { return false; }, RUN_TIME);
+    return 0;
+}
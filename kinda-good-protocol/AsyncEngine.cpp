@@ -0,0 +1,322 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             AsyncEngine.cpp
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Sends and receives over an IoEngine from coroutines.
+---------------------------------------------------------------------------------------*/
+#include "AsyncEngine.h"
+
+#if defined(__cpp_impl_coroutine)
+
+#include "DependencyManager.h"
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::AsyncEngine::Operation::Operation
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::AsyncEngine::Operation::Operation(AsyncEngine *owner, const std::function<bool()>& start, const bool receive, const Sink& sink)
+--                              owner: The AsyncEngine the transfer runs over.
+--                              start: Starts the transfer on the engine, false if it would not.
+--                                     Empty for a receive, which waits for a sender.
+--                              receive: Whether the transfer is received rather than sent.
+--                              sink: Where received data goes, may be empty.
+--
+-- NOTES:
+--                          Constructor for the Operation. Nothing happens until it is awaited.
+--------------------------------------------------------------------------------------------------*/
+kgp::AsyncEngine::Operation::Operation(AsyncEngine *owner, const std::function<bool()>& start, const bool receive, const Sink& sink)
+    : mOwner(owner)
+    , mStart(start)
+    , mReceive(receive)
+    , mSink(sink)
+    , mAwaiting()
+    , mResult({ 0, 0, TransferError::NONE })
+{
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::AsyncEngine::Operation::await_suspend
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::AsyncEngine::Operation::await_suspend(std::coroutine_handle<> awaiting)
+--                              awaiting: The coroutine to resume once the transfer has finished.
+--
+-- NOTES:
+--                          Hands the operation to the thread of the engine, which may be another
+--                          thread than the one the coroutine was running on.
+--------------------------------------------------------------------------------------------------*/
+void kgp::AsyncEngine::Operation::await_suspend(std::coroutine_handle<> awaiting)
+{
+    mAwaiting = awaiting;
+    AsyncEngine *owner = mOwner;
+    owner->mExecutor([owner, this]() { owner->begin(this); });
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::AsyncEngine::AsyncEngine
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::AsyncEngine::AsyncEngine(IoEngine& engine, const Executor& executor)
+--                              engine: The engine to transfer over. Must outlive the AsyncEngine.
+--                              executor: Runs tasks on the thread of the engine, such as Post of
+--                                        its IoThread or a queued call on its Qt event loop.
+--
+-- NOTES:
+--                          Constructor for the AsyncEngine. The engine is followed from its own thread,
+--                          a receive starts with the first transferStarted or data of a transfer
+--                          and every operation ends with the transferFinished of its transfer.
+--------------------------------------------------------------------------------------------------*/
+kgp::AsyncEngine::AsyncEngine(IoEngine& engine, const Executor& executor)
+    : mEngine(engine)
+    , mExecutor(executor)
+    , mContext()
+    , mPending(nullptr)
+    , mStarted(false)
+    , mStartTime(0)
+    , mStartBytes(0)
+    , mReceived(0)
+{
+    QObject::connect(&mEngine, &IoEngine::transferStarted, &mContext, [this](const quint64&)
+    {
+        if (!mPending || !mPending->mReceive || mStarted) return;
+        mStarted = true;
+        mStartTime = DependencyManager::Instance().Clock().Now();
+    }, Qt::DirectConnection);
+
+    QObject::connect(&mEngine, &IoEngine::dataRead, &mContext, [this](const char *data, const size_t& size)
+    {
+        if (!mPending || !mPending->mReceive) return;
+        if (!mStarted)
+        {
+            mStarted = true;
+            mStartTime = DependencyManager::Instance().Clock().Now();
+        }
+        mReceived += size;
+        if (mPending->mSink) mPending->mSink(data, size);
+    }, Qt::DirectConnection);
+
+    QObject::connect(&mEngine, &IoEngine::transferFinished, &mContext, [this](const bool& complete)
+    {
+        if (!mPending || !mStarted) return;
+        finish(complete ? TransferError::NONE : TransferError::DROPPED);
+    }, Qt::DirectConnection);
+}
+
+#if defined(__linux__)
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::AsyncEngine::AsyncEngine
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::AsyncEngine::AsyncEngine(IoThread& thread, const size_t index)
+--                              thread: The I/O thread that runs the engine. Must outlive the
+--                                      AsyncEngine.
+--                              index: The engine of the thread to transfer over.
+--
+-- NOTES:
+--                          Constructor for the AsyncEngine over an engine of an I/O thread, whose tasks
+--                          are posted to the thread.
+--------------------------------------------------------------------------------------------------*/
+kgp::AsyncEngine::AsyncEngine(IoThread& thread, const size_t index)
+    : AsyncEngine(thread.Engine(index), [&thread](const std::function<void()>& task) { thread.Post(task); })
+{
+}
+#endif
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::AsyncEngine::Send
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               Operation kgp::AsyncEngine::Send(const std::string& filename, const std::string& address, const short port)
+--                              filename: The file to send.
+--                              address: The address of the receiver.
+--                              port: The port of the receiver.
+--
+-- RETURN:                  The send to co_await. It resumes once the receiver has everything and the
+--                          engine is idle again, a file sent as part of an open session once the
+--                          session is closed.
+--------------------------------------------------------------------------------------------------*/
+kgp::AsyncEngine::Operation kgp::AsyncEngine::Send(const std::string& filename, const std::string& address, const short port)
+{
+    return Operation(this, [this, filename, address, port]() { return mEngine.StartFileSend(filename, address, port); }, false, nullptr);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::AsyncEngine::Receive
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               Operation kgp::AsyncEngine::Receive(const Sink& sink)
+--                              sink: Called with the data of the transfer as it is delivered, on the
+--                                    thread of the engine.
+--
+-- RETURN:                  The receive to co_await. It waits for the next transfer that starts and
+--                          resumes once that one ends.
+--------------------------------------------------------------------------------------------------*/
+kgp::AsyncEngine::Operation kgp::AsyncEngine::Receive(const Sink& sink)
+{
+    return Operation(this, nullptr, true, sink);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::AsyncEngine::Cancel
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::AsyncEngine::Cancel()
+--
+-- NOTES:
+--                          Drops the transfer of the pending operation, which resumes as cancelled.
+--                          The peer is not told and finds out through its own timeouts. Safe to
+--                          call from any thread, does nothing when no operation is pending.
+--------------------------------------------------------------------------------------------------*/
+void kgp::AsyncEngine::Cancel()
+{
+    mExecutor([this]()
+    {
+        if (!mPending) return;
+
+        // The transferFinished of the reset is not the end of the operation
+        mStarted = false;
+        mEngine.Reset();
+        finish(TransferError::CANCELLED);
+    });
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::AsyncEngine::begin
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::AsyncEngine::begin(Operation *operation)
+--                              operation: The operation that was awaited.
+--
+-- NOTES:
+--                          Starts an operation on the thread of the engine. The engine runs one
+--                          transfer at a time, so an operation awaited while another is pending
+--                          resumes right away as busy. A send is only under way once the engine
+--                          took it, closing a session that was left open on the way does not end it.
+--------------------------------------------------------------------------------------------------*/
+void kgp::AsyncEngine::begin(Operation *operation)
+{
+    if (mPending)
+    {
+        operation->mResult = { 0, 0, TransferError::BUSY };
+        operation->mAwaiting.resume();
+        return;
+    }
+
+    mPending = operation;
+    mStarted = false;
+    mStartTime = DependencyManager::Instance().Clock().Now();
+    mStartBytes = mEngine.GetStats().bytesSent;
+    mReceived = 0;
+    if (operation->mReceive) return;
+
+    if (!operation->mStart())
+    {
+        finish(TransferError::START_FAILED);
+        return;
+    }
+    mStarted = true;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::AsyncEngine::finish
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::AsyncEngine::finish(const TransferError error)
+--                              error: What became of the transfer.
+--
+-- NOTES:
+--                          Ends the pending operation. The coroutine is resumed by a task of its
+--                          own rather than from inside the engine, which is still resetting, so
+--                          it is free to start the next transfer.
+--------------------------------------------------------------------------------------------------*/
+void kgp::AsyncEngine::finish(const TransferError error)
+{
+    Operation *operation = mPending;
+    mPending = nullptr;
+    mStarted = false;
+
+    const quint64 now = DependencyManager::Instance().Clock().Now();
+    operation->mResult.bytes = operation->mReceive ? mReceived : mEngine.GetStats().bytesSent - mStartBytes;
+    operation->mResult.duration = now > mStartTime ? now - mStartTime : 0;
+    operation->mResult.error = error;
+
+    const std::coroutine_handle<> awaiting = operation->mAwaiting;
+    mExecutor([awaiting]() { awaiting.resume(); });
+}
+
+#endif
@@ -0,0 +1,123 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             AsyncEngine.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Sends and receives over an IoEngine from coroutines. Send and Receive
+--                          return operations to co_await that resume with what became of the
+--                          transfer once the engine goes back to idle. Everything runs on the
+--                          executor it is given, which has to run tasks on the thread of the engine,
+--                          so that a coroutine awaiting an operation always resumes there. Many of
+--                          them, each over an engine of its own, can share one IoThread.
+--                          Only built with a compiler that supports C++20 coroutines.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#if defined(__cpp_impl_coroutine)
+
+#include <coroutine>
+#include <functional>
+#include <string>
+
+#include <QObject>
+
+#include "IoEngine.h"
+#if defined(__linux__)
+#include "IoThread.h"
+#endif
+
+namespace kgp
+{
+    // What became of a transfer
+    enum class TransferError
+    {
+        NONE,
+        // The engine would not start the send
+        START_FAILED,
+        // The transfer ended before everything was delivered, the peer went away or timed out
+        DROPPED,
+        // Cancel was called
+        CANCELLED,
+        // Another operation over the engine had not finished yet
+        BUSY
+    };
+
+    struct TransferResult
+    {
+        // Payload bytes sent, resends included, or handed to the sink
+        quint64 bytes;
+        // Milliseconds from the start of the transfer to its end
+        quint64 duration;
+        TransferError error;
+    };
+
+    class AsyncEngine
+    {
+    public:
+        // Runs a task on the thread of the engine, later rather than right away
+        using Executor = std::function<void(const std::function<void()>&)>;
+        // Receives the data of a transfer in order, only valid during the call
+        using Sink = std::function<void(const char *data, const size_t size)>;
+
+        // A transfer to co_await, it starts once awaited
+        class Operation
+        {
+            friend class AsyncEngine;
+
+        private:
+            AsyncEngine *mOwner;
+            std::function<bool()> mStart;
+            bool mReceive;
+            Sink mSink;
+            std::coroutine_handle<> mAwaiting;
+            TransferResult mResult;
+
+            Operation(AsyncEngine *owner, const std::function<bool()>& start, const bool receive, const Sink& sink);
+
+        public:
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> awaiting);
+            TransferResult await_resume() const { return mResult; }
+        };
+
+    private:
+        IoEngine& mEngine;
+        Executor mExecutor;
+        // Context of the connections to the engine, so that they go away with it
+        QObject mContext;
+
+        Operation *mPending;
+        // Set once the transfer of the pending operation is under way
+        bool mStarted;
+        quint64 mStartTime;
+        quint64 mStartBytes;
+        quint64 mReceived;
+
+        void begin(Operation *operation);
+        void finish(const TransferError error);
+
+    public:
+        AsyncEngine(IoEngine& engine, const Executor& executor);
+#if defined(__linux__)
+        AsyncEngine(IoThread& thread, const size_t index = 0);
+#endif
+        ~AsyncEngine() = default;
+
+        Operation Send(const std::string& filename, const std::string& address, const short port);
+        Operation Receive(const Sink& sink = nullptr);
+        void Cancel();
+    };
+}
+
+#endif
@@ -0,0 +1,323 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             Checkpoint.cpp
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          The checkpoint is a text file with a line per transfer: the ID, the size
+--                          of the file and then the start and end of every committed range. It is
+--                          written to a temporary file that replaces the old one, so a crash while
+--                          saving leaves the previous checkpoint behind.
+---------------------------------------------------------------------------------------*/
+#include "Checkpoint.h"
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStringList>
+
+#include "DependencyManager.h"
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::Checkpoint::Checkpoint
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::Checkpoint::Checkpoint(const QString& fileName)
+--                              fileName: The file to keep the checkpoint in.
+--
+-- NOTES:
+--                          Constructor for the Checkpoint. Nothing is read until Load is called.
+--------------------------------------------------------------------------------------------------*/
+kgp::Checkpoint::Checkpoint(const QString& fileName)
+    : mFileName(fileName)
+    , mEntries()
+    , mUsed(0)
+{
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::Checkpoint::TransferId
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               quint64 kgp::Checkpoint::TransferId(const QString& fileName)
+--                              fileName: The file that is going to be sent.
+--
+-- RETURN:                  The ID of a transfer of the file, 0 if the file could not be read.
+--
+-- NOTES:
+--                          Hashes the path, size and modification time of the file together with
+--                          its first Resume::ID_BYTES bytes. A file that has been changed since it
+--                          was cut off gets a new ID and is sent from the start.
+--------------------------------------------------------------------------------------------------*/
+quint64 kgp::Checkpoint::TransferId(const QString& fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) return 0;
+
+    const QFileInfo info(fileName);
+    const quint64 size = info.size();
+    const qint64 modified = info.lastModified().toMSecsSinceEpoch();
+
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(info.absoluteFilePath().toUtf8());
+    hash.addData((const char *)&size, sizeof(size));
+    hash.addData((const char *)&modified, sizeof(modified));
+    hash.addData(file.read(Resume::ID_BYTES));
+    file.close();
+
+    quint64 id;
+    const QByteArray digest = hash.result();
+    memcpy(&id, digest.constData(), sizeof(id));
+    // 0 means there is no transfer
+    return id == 0 ? 1 : id;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::Checkpoint::Load
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::Checkpoint::Load()
+--
+-- RETURN:                  False if the file exists but could not be read, true otherwise.
+--
+-- NOTES:
+--                          Replaces what is in memory with the checkpoint file. A missing file is an
+--                          empty checkpoint and lines that cannot be read are skipped.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::Checkpoint::Load()
+{
+    mEntries.clear();
+    mUsed = 0;
+    if (!QFile::exists(mFileName)) return true;
+
+    QFile file(mFileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        DependencyManager::Instance().Logger().Error("Could not read the checkpoint: " + mFileName.toStdString());
+        return false;
+    }
+    const QByteArray contents = file.readAll();
+    file.close();
+
+    for (const QString& line : QString::fromUtf8(contents.constData(), contents.size()).split('\n'))
+    {
+        const QStringList fields = line.split(' ');
+        // An ID, a size and pairs of offsets
+        if (fields.size() < 2 || fields.size() % 2 != 0) continue;
+
+        bool ok = true;
+        std::vector<quint64> values;
+        for (const QString& field : fields)
+        {
+            bool valid;
+            values.push_back(field.toULongLong(&valid));
+            ok = ok && valid;
+        }
+        if (!ok) continue;
+
+        Entry& entry = mEntries[values[0]];
+        entry.size = values[1];
+        entry.used = ++mUsed;
+        for (size_t i = 2; i < values.size(); i += 2)
+        {
+            if (values[i] < values[i + 1]) entry.ranges[values[i]] = values[i + 1];
+        }
+    }
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::Checkpoint::Save
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::Checkpoint::Save()
+--
+-- RETURN:                  True if the checkpoint was written, false otherwise.
+--
+-- NOTES:
+--                          Writes every transfer to the checkpoint file, least recently used first
+--                          so that Load keeps the order.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::Checkpoint::Save()
+{
+    std::vector<std::pair<quint64, quint64>> order;
+    for (const auto& entry : mEntries) order.push_back(std::make_pair(entry.second.used, entry.first));
+    std::sort(order.begin(), order.end());
+
+    QByteArray contents;
+    for (const auto& used : order)
+    {
+        const Entry& entry = mEntries[used.second];
+        contents.append(QString::number(used.second).toUtf8());
+        contents.append(' ');
+        contents.append(QString::number(entry.size).toUtf8());
+        for (const auto& range : entry.ranges)
+        {
+            contents.append(' ');
+            contents.append(QString::number(range.first).toUtf8());
+            contents.append(' ');
+            contents.append(QString::number(range.second).toUtf8());
+        }
+        contents.append('\n');
+    }
+
+    QSaveFile file(mFileName);
+    if (!file.open(QIODevice::WriteOnly) || file.write(contents) != contents.size() || !file.commit())
+    {
+        DependencyManager::Instance().Logger().Error("Could not write the checkpoint: " + mFileName.toStdString());
+        return false;
+    }
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::Checkpoint::Offset
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               quint64 kgp::Checkpoint::Offset(const quint64 id, const quint64 size)
+--                              id: The ID of the transfer.
+--                              size: The size of the file that is being sent.
+--
+-- RETURN:                  The number of bytes from the start of the file that have been committed,
+--                          0 if the transfer is unknown or was of a file with a different size.
+--------------------------------------------------------------------------------------------------*/
+quint64 kgp::Checkpoint::Offset(const quint64 id, const quint64 size)
+{
+    auto entry = mEntries.find(id);
+    if (entry == mEntries.end() || entry->second.size != size) return 0;
+
+    entry->second.used = ++mUsed;
+    const auto& ranges = entry->second.ranges;
+    if (ranges.empty() || ranges.begin()->first != 0) return 0;
+    return std::min(ranges.begin()->second, size);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::Checkpoint::Commit
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::Checkpoint::Commit(const quint64 id, const quint64 size, const quint64 start, const quint64 end)
+--                              id: The ID of the transfer.
+--                              size: The size of the file that is being sent.
+--                              start: The offset of the first committed byte.
+--                              end: The offset after the last committed byte.
+--
+-- NOTES:
+--                          Adds a range to the transfer, merging it with the ranges it touches. A
+--                          transfer of a file with a different size starts over. If there are more
+--                          than Resume::MAX_TRANSFERS transfers the least recently used one is
+--                          forgotten. Nothing is written until Save is called.
+--------------------------------------------------------------------------------------------------*/
+void kgp::Checkpoint::Commit(const quint64 id, const quint64 size, const quint64 start, const quint64 end)
+{
+    if (start >= end) return;
+
+    Entry& entry = mEntries[id];
+    if (entry.size != size) entry.ranges.clear();
+    entry.size = size;
+    entry.used = ++mUsed;
+
+    quint64 first = start;
+    quint64 last = end;
+    auto it = entry.ranges.upper_bound(first);
+    if (it != entry.ranges.begin() && std::prev(it)->second >= first)
+    {
+        --it;
+        first = it->first;
+        last = std::max(last, it->second);
+        it = entry.ranges.erase(it);
+    }
+    while (it != entry.ranges.end() && it->first <= last)
+    {
+        last = std::max(last, it->second);
+        it = entry.ranges.erase(it);
+    }
+    entry.ranges[first] = last;
+
+    while (mEntries.size() > Resume::MAX_TRANSFERS)
+    {
+        auto oldest = std::min_element(mEntries.begin(), mEntries.end(), [](const auto& a, const auto& b) { return a.second.used < b.second.used; });
+        mEntries.erase(oldest);
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::Checkpoint::Remove
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::Checkpoint::Remove(const quint64 id)
+--                              id: The ID of the transfer.
+--
+-- NOTES:
+--                          Forgets a transfer that has finished. Nothing is written until Save is
+--                          called.
+--------------------------------------------------------------------------------------------------*/
+void kgp::Checkpoint::Remove(const quint64 id)
+{
+    mEntries.erase(id);
+}
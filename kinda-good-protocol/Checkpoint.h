@@ -0,0 +1,85 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             Checkpoint.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          A small file on the receiver that remembers which bytes of unfinished
+--                          transfers have been handed to the application. A transfer is known by an
+--                          ID the sender makes up from the file, so a transfer that was cut off by an
+--                          idle timeout or a crash can pick up where it was when it is sent again.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <map>
+
+#include <QString>
+
+#include "res.h"
+
+namespace kgp
+{
+    class Checkpoint
+    {
+    private:
+        struct Entry
+        {
+            quint64 size;
+            // Committed ranges as start and end
+            std::map<quint64, quint64> ranges;
+            // Larger is more recently used
+            quint64 used;
+        };
+
+        QString mFileName;
+        std::map<quint64, Entry> mEntries;
+        quint64 mUsed;
+
+    public:
+        Checkpoint(const QString& fileName = CHECKPOINT_FILE);
+        ~Checkpoint() = default;
+
+        static quint64 TransferId(const QString& fileName);
+
+        bool Load();
+        bool Save();
+
+        quint64 Offset(const quint64 id, const quint64 size);
+        void Commit(const quint64 id, const quint64 size, const quint64 start, const quint64 end);
+        void Remove(const quint64 id);
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::Checkpoint::SetFileName
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               void kgp::Checkpoint::SetFileName(const QString& fileName)
+        --                              fileName: The file to keep the checkpoint in.
+        --
+        -- NOTES:
+        --                          Setter for the checkpoint file. What was loaded from the old file is
+        --                          forgotten. Defaults to CHECKPOINT_FILE.
+        --------------------------------------------------------------------------------------------------*/
+        inline void SetFileName(const QString& fileName)
+        {
+            mFileName = fileName;
+            mEntries.clear();
+        }
+    };
+}
@@ -0,0 +1,97 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             Clock.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          The source of time for everything that is timed in the application.
+--                          The steady clock follows real time. The simulated clock only moves
+--                          when it is told to so timeout driven scenarios can be fast forwarded.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <atomic>
+
+#include <QElapsedTimer>
+
+namespace kgp
+{
+    class Clock
+    {
+    public:
+        virtual ~Clock() = default;
+
+        // The current time in milliseconds. Only differences between two values are meaningful.
+        virtual quint64 Now() = 0;
+    };
+
+    class SteadyClock : public Clock
+    {
+    private:
+        QElapsedTimer mTimer;
+
+    public:
+        inline SteadyClock() { mTimer.start(); }
+
+        inline quint64 Now() override { return mTimer.elapsed(); }
+    };
+
+    class SimulatedClock : public Clock
+    {
+    private:
+        std::atomic<quint64> mNow;
+
+    public:
+        inline SimulatedClock(const quint64 start = 0) : mNow(start) {}
+
+        inline quint64 Now() override { return mNow; }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::SimulatedClock::Advance
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               void kgp::SimulatedClock::Advance(const quint64 ms)
+        --                              ms: The number of milliseconds to move forward.
+        --
+        -- NOTES:
+        --                          Moves the clock forward.
+        --------------------------------------------------------------------------------------------------*/
+        inline void Advance(const quint64 ms) { mNow += ms; }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::SimulatedClock::AdvanceTo
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               void kgp::SimulatedClock::AdvanceTo(const quint64 time)
+        --                              time: The time to move to.
+        --
+        -- NOTES:
+        --                          Moves the clock forward to time. The clock never moves backwards.
+        --------------------------------------------------------------------------------------------------*/
+        inline void AdvanceTo(const quint64 time) { if (time > mNow) mNow = time; }
+    };
+}
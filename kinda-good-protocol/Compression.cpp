@@ -0,0 +1,146 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             Compression.cpp
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Frames are compressed with qCompress at the fastest zlib level. Data that
+--                          does not compress, such as archives or media, would otherwise cost a
+--                          compression attempt per frame for nothing, so the compressor stops trying
+--                          for a growing number of frames every time a frame does not compress.
+---------------------------------------------------------------------------------------*/
+#include "Compression.h"
+
+#include <algorithm>
+
+#include <QtEndian>
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::Compressor::Compressor
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::Compressor::Compressor()
+--
+-- NOTES:
+--                          Constructor for the Compressor.
+--------------------------------------------------------------------------------------------------*/
+kgp::Compressor::Compressor()
+{
+    Reset();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::Compressor::Reset
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::Compressor::Reset()
+--
+-- NOTES:
+--                          Forgets about frames that did not compress, the next frame is tried.
+--------------------------------------------------------------------------------------------------*/
+void kgp::Compressor::Reset()
+{
+    mSkip = 0;
+    mBackoff = 1;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::Compressor::Compress
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::Compressor::Compress(const SlidingWindow::Frame& frame, QByteArray& out)
+--                              frame: The frame to compress.
+--                              out: Holds the compressed frame if true is returned.
+--
+-- RETURN:                  True if the frame should be sent compressed, false if it should be sent
+--                          as is.
+--
+-- NOTES:
+--                          A frame is sent compressed if that saves at least
+--                          Compression::MIN_SAVING bytes. Every frame that does not doubles the
+--                          number of frames that are sent as is without trying, up to
+--                          Compression::MAX_SKIP, and a frame that does starts over.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::Compressor::Compress(const SlidingWindow::Frame& frame, QByteArray& out)
+{
+    if (mSkip > 0)
+    {
+        mSkip--;
+        return false;
+    }
+
+    out = qCompress((const uchar *)frame.data, (int)frame.size, Compression::LEVEL);
+    if ((size_t)out.size() + Compression::MIN_SAVING <= frame.size)
+    {
+        mBackoff = 1;
+        return true;
+    }
+
+    mSkip = mBackoff;
+    mBackoff = std::min(mBackoff * 2, Compression::MAX_SKIP);
+    return false;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::Compressor::Decompress
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Allows frames up to Size::MAX_DATA.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::Compressor::Decompress(const char *data, const size_t size, const quint64 rawSize, QByteArray& out)
+--                              data: The compressed frame.
+--                              size: The size of the compressed frame.
+--                              rawSize: The size the frame had before it was compressed.
+--                              out: Holds the uncompressed frame if true is returned.
+--
+-- RETURN:                  True if the frame was uncompressed to rawSize bytes, false otherwise.
+--
+-- NOTES:
+--                          A frame never holds more than Size::MAX_DATA bytes. qCompress puts the
+--                          uncompressed size in front of the data and qUncompress allocates that
+--                          much, so it has to match rawSize before anything is uncompressed.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::Compressor::Decompress(const char *data, const size_t size, const quint64 rawSize, QByteArray& out)
+{
+    if (rawSize == 0 || rawSize > Size::MAX_DATA || size < sizeof(quint32)) return false;
+    if (qFromBigEndian<quint32>(data) != rawSize) return false;
+
+    out = qUncompress((const uchar *)data, (int)size);
+    return (quint64)out.size() == rawSize;
+}
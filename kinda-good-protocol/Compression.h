@@ -0,0 +1,47 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             Compression.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Compression of DATA frames. Every frame is compressed on its own so a
+--                          lost frame never holds up the frames after it, and the sequence numbers
+--                          keep counting uncompressed bytes.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <QByteArray>
+
+#include "res.h"
+#include "SlidingWindow.h"
+
+namespace kgp
+{
+    class Compressor
+    {
+    private:
+        // Frames left to send as is before compressing is tried again
+        quint64 mSkip;
+        // Frames to skip after the next frame that does not compress
+        quint64 mBackoff;
+
+    public:
+        Compressor();
+        ~Compressor() = default;
+
+        void Reset();
+
+        bool Compress(const SlidingWindow::Frame& frame, QByteArray& out);
+        static bool Decompress(const char *data, const size_t size, const quint64 rawSize, QByteArray& out);
+    };
+}
@@ -0,0 +1,39 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             Crc32c.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          CRC32C (Castagnoli) checksums for packets. Uses the SSE4.2 or ARMv8 CRC
+--                          instructions when the CPU has them and a slice-by-8 table otherwise.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cstddef>
+
+#include <QtGlobal>
+
+#include "res.h"
+
+namespace kgp
+{
+    class Crc32c
+    {
+    public:
+        static quint32 Compute(const void *data, const size_t size, const quint32 crc = 0);
+        static quint32 ComputeTable(const void *data, const size_t size, const quint32 crc = 0);
+        static quint32 ComputePacket(const Packet& packet);
+        static quint32 ComputePacket(const PacketHeader& header, const void *data);
+        static bool IsAccelerated();
+    };
+}
@@ -3,6 +3,7 @@
 #include <memory>
 
 #include "res.h"
+#include "Clock.h"
 #include "Logger.h"
 
 namespace kgp
@@ -12,7 +13,9 @@ namespace kgp
     private:
         static std::unique_ptr<DependencyManager> instance;
 
-        Logger mLogger;
+        kgp::Logger mLogger;
+        kgp::SteadyClock mSteadyClock;
+        kgp::Clock *mClock;
 
     public:
         /*--------------------------------------------------------------------------------------------------
@@ -50,9 +53,9 @@ namespace kgp
         -- INTERFACE:               kgp::DependencyManager::DependencyManager()
         --
         -- NOTES:
-        --                          Default constructor.
+        --                          Default constructor. Starts out with the real time clock.
         --------------------------------------------------------------------------------------------------*/
-        inline DependencyManager() = default;
+        inline DependencyManager() : mClock(&mSteadyClock) {}
 
         /*--------------------------------------------------------------------------------------------------
         -- FUNCTION:                kgp::DependancyManager::~DependancyManager
@@ -92,6 +95,49 @@ namespace kgp
         --                          it is ensured that the entire application uses the same logger so that
         --                          all messages are written to the same place.
         --------------------------------------------------------------------------------------------------*/
-        inline Logger& Logger() { return mLogger; }
+        inline kgp::Logger& Logger() { return mLogger; }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::DependancyManager::Clock
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               Clock& kgp::DependencyManager::Clock()
+        --
+        -- RETURNS:                 A reference to the current clock.
+        --
+        -- NOTES:
+        --                          All timers, the emulated link and anything else that measures time
+        --                          read this clock so that tests can replace real time with simulated
+        --                          time.
+        --------------------------------------------------------------------------------------------------*/
+        inline kgp::Clock& Clock() { return *mClock; }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::DependancyManager::SetClock
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               void kgp::DependencyManager::SetClock(kgp::Clock *clock)
+        --                              clock: The clock to use, or nullptr to go back to real time. The
+        --                                     clock is not owned and must outlive its use.
+        --
+        -- NOTES:
+        --                          Replaces the clock. Timers that are already running keep their start
+        --                          time so the clock should be replaced before any engine is created.
+        --------------------------------------------------------------------------------------------------*/
+        inline void SetClock(kgp::Clock *clock) { mClock = clock != nullptr ? clock : &mSteadyClock; }
     };
 }
@@ -0,0 +1,449 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             DirectoryBatch.cpp
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Only regular files are sent, symbolic links are not followed and empty
+--                          directories are left out.
+---------------------------------------------------------------------------------------*/
+#include "DirectoryBatch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <set>
+
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QThreadPool>
+
+#include "DependencyManager.h"
+
+namespace
+{
+    // Reads the files of a directory into their place in the stream, every reader takes the next
+    // file that nobody has taken yet
+    class ReadJob : public QRunnable
+    {
+    private:
+        const QDir& mRoot;
+        const std::vector<kgp::StreamFramer::FileEntry>& mEntries;
+        const std::vector<quint64>& mOffsets;
+        char *mStream;
+        std::atomic<size_t>& mNext;
+        std::atomic<qint64>& mFailed;
+
+    public:
+        ReadJob(const QDir& root, const std::vector<kgp::StreamFramer::FileEntry>& entries, const std::vector<quint64>& offsets,
+            char *stream, std::atomic<size_t>& next, std::atomic<qint64>& failed)
+            : mRoot(root)
+            , mEntries(entries)
+            , mOffsets(offsets)
+            , mStream(stream)
+            , mNext(next)
+            , mFailed(failed)
+        {
+        }
+
+        void run() override
+        {
+            for (size_t i = mNext++; i < mEntries.size() && mFailed < 0; i = mNext++)
+            {
+                // A file that shrank since it was listed would leave a hole in the stream
+                QFile file(mRoot.filePath(mEntries[i].name));
+                const qint64 size = (qint64)mEntries[i].size;
+                if (!file.open(QIODevice::ReadOnly) || (size > 0 && file.read(mStream + mOffsets[i], size) != size)) mFailed = (qint64)i;
+            }
+        }
+    };
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::DirectoryReader::Pack
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::DirectoryReader::Pack(const QString& directory, QByteArray& stream, std::vector<StreamFramer::FileEntry>& entries)
+--                              directory: The directory to send.
+--                              stream: Gets the manifest followed by the data of every file.
+--                              entries: Gets the files in the order of the manifest.
+--
+-- RETURN:                  True if every file was read, false otherwise.
+--
+-- NOTES:
+--                          Lists the files below the directory in the order of their paths, so the
+--                          same tree always gives the same stream. The stream is allocated once for
+--                          the manifest and all of the files, which Batch::READERS threads then read
+--                          straight into their place. A directory that does not fit into one
+--                          QByteArray is refused.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::DirectoryReader::Pack(const QString& directory, QByteArray& stream, std::vector<StreamFramer::FileEntry>& entries)
+{
+    const QDir root(directory);
+    if (!root.exists())
+    {
+        DependencyManager::Instance().Logger().Error("Could not find the directory: " + directory.toStdString());
+        return false;
+    }
+
+    entries.clear();
+    QDirIterator it(directory, QDir::Files | QDir::Hidden | QDir::NoSymLinks, QDirIterator::Subdirectories);
+    while (it.hasNext())
+    {
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        entries.push_back({ root.relativeFilePath(info.filePath()), (quint64)info.size() });
+    }
+    std::sort(entries.begin(), entries.end(), [](const StreamFramer::FileEntry& a, const StreamFramer::FileEntry& b) { return a.name < b.name; });
+
+    const QByteArray manifest = StreamFramer::Manifest(entries);
+    quint64 total = manifest.size();
+    std::vector<quint64> offsets;
+    offsets.reserve(entries.size());
+    for (const auto& entry : entries)
+    {
+        if ((quint64)entry.name.toUtf8().size() > Batch::MAX_PATH)
+        {
+            DependencyManager::Instance().Logger().Error("Path too long to send: " + entry.name.toStdString());
+            return false;
+        }
+        offsets.push_back(total);
+        total += entry.size;
+    }
+    if (manifest.size() - sizeof(BatchHeader) > Batch::MAX_MANIFEST || total > (quint64)INT_MAX)
+    {
+        DependencyManager::Instance().Logger().Error("Directory too large to send: " + directory.toStdString());
+        return false;
+    }
+
+    stream.resize((int)total);
+    char *data = stream.data();
+    memcpy(data, manifest.constData(), manifest.size());
+
+    std::atomic<size_t> next(0);
+    std::atomic<qint64> failed(-1);
+    QThreadPool pool;
+    pool.setMaxThreadCount((int)Batch::READERS);
+    const size_t readers = std::min<size_t>(Batch::READERS, entries.size());
+    for (size_t i = 0; i < readers; i++) pool.start(new ReadJob(root, entries, offsets, data, next, failed));
+    pool.waitForDone();
+
+    if (failed >= 0)
+    {
+        DependencyManager::Instance().Logger().Error("Could not read the file: " + entries[(size_t)failed].name.toStdString());
+        stream.clear();
+        return false;
+    }
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::DirectoryWriter::DirectoryWriter
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::DirectoryWriter::DirectoryWriter(const QString& root)
+--                              root: The directory the files are written below, made if it is missing.
+--
+-- NOTES:
+--                          Constructor for a writer that has not received any files.
+--------------------------------------------------------------------------------------------------*/
+kgp::DirectoryWriter::DirectoryWriter(const QString& root)
+    : mRoot(root)
+    , mPendingBytes(0)
+    , mInFile(false)
+    , mWritten(0)
+    , mFailed(false)
+{
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::DirectoryWriter::~DirectoryWriter
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::DirectoryWriter::~DirectoryWriter()
+--
+-- NOTES:
+--                          Destructor that creates the files that were finished and not created yet.
+--------------------------------------------------------------------------------------------------*/
+kgp::DirectoryWriter::~DirectoryWriter()
+{
+    Flush();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::DirectoryWriter::IsSafePath
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::DirectoryWriter::IsSafePath(const QString& path)
+--                              path: A path from a manifest.
+--
+-- RETURN:                  True if the path stays below the directory it is written to, false
+--                          otherwise.
+--
+-- NOTES:
+--                          The path comes from the peer. It is refused if it is absolute, names a
+--                          drive, uses \ which Windows takes as a separator, or has a part that is
+--                          empty, . or ..
+--------------------------------------------------------------------------------------------------*/
+bool kgp::DirectoryWriter::IsSafePath(const QString& path)
+{
+    if (path.isEmpty() || path.startsWith("/") || path.contains("\\") || path.contains(":")) return false;
+
+    for (const QString& part : path.split('/'))
+    {
+        if (part.isEmpty() || part == "." || part == "..") return false;
+    }
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::DirectoryWriter::StartFile
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::DirectoryWriter::StartFile(const QString& path, const quint64 size)
+--                              path: The path of the file relative to the directory.
+--                              size: The bytes of the file.
+--
+-- RETURN:                  True if the file will be written, false if its path was refused or it
+--                          could not be created.
+--
+-- NOTES:
+--                          A file smaller than Batch::WRITE_BYTES is kept in memory until it is
+--                          created with the ones around it, a larger one is created right away and
+--                          written as it arrives. The data of a refused file is dropped.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::DirectoryWriter::StartFile(const QString& path, const quint64 size)
+{
+    if (mInFile) FinishFile();
+
+    if (!IsSafePath(path))
+    {
+        DependencyManager::Instance().Logger().Error("Refusing to write the file: " + path.toStdString());
+        mFailed = true;
+        return false;
+    }
+
+    if (size < Batch::WRITE_BYTES)
+    {
+        mPending.push_back({ path, QByteArray() });
+        mPending.back().data.reserve((int)size);
+        mPath = path;
+        mInFile = true;
+        return true;
+    }
+
+    mLarge.setFileName(mRoot.filePath(path));
+    if (!makeParent(path) || !mLarge.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        DependencyManager::Instance().Logger().Error("Could not create the file: " + path.toStdString());
+        mFailed = true;
+        return false;
+    }
+    mPath = path;
+    mInFile = true;
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::DirectoryWriter::Write
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::DirectoryWriter::Write(const char *data, const size_t size)
+--                              data: The next bytes of the file that was started.
+--                              size: The number of bytes.
+--
+-- RETURN:                  True if the bytes were kept or written, false if no file is being
+--                          written or writing failed.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::DirectoryWriter::Write(const char *data, const size_t size)
+{
+    if (!mInFile) return false;
+
+    if (mLarge.isOpen())
+    {
+        if (mLarge.write(data, (qint64)size) != (qint64)size)
+        {
+            DependencyManager::Instance().Logger().Error("Could not write the file: " + mPath.toStdString());
+            mFailed = true;
+            return false;
+        }
+        return true;
+    }
+
+    mPending.back().data.append(data, (int)size);
+    mPendingBytes += size;
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::DirectoryWriter::FinishFile
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::DirectoryWriter::FinishFile()
+--
+-- RETURN:                  False if no file was being written or creating the kept files failed,
+--                          true otherwise.
+--
+-- NOTES:
+--                          Closes a large file. The kept files are created once they hold
+--                          Batch::WRITE_BYTES or there are Batch::WRITE_FILES of them.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::DirectoryWriter::FinishFile()
+{
+    if (!mInFile) return false;
+    mInFile = false;
+
+    if (mLarge.isOpen())
+    {
+        mLarge.close();
+        mWritten++;
+        return true;
+    }
+
+    if (mPendingBytes >= Batch::WRITE_BYTES || mPending.size() >= Batch::WRITE_FILES) return Flush();
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::DirectoryWriter::Flush
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::DirectoryWriter::Flush()
+--
+-- RETURN:                  True if every kept file was created, false otherwise.
+--
+-- NOTES:
+--                          Creates the kept files that have ended. Every directory they are in is
+--                          made once for all of them before the files are written. A small file
+--                          that has not ended stays kept.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::DirectoryWriter::Flush()
+{
+    const size_t ready = mPending.size() - (mInFile && !mLarge.isOpen() ? 1 : 0);
+    if (ready == 0) return true;
+
+    std::set<QString> parents;
+    for (size_t i = 0; i < ready; i++)
+    {
+        const int slash = mPending[i].path.lastIndexOf('/');
+        parents.insert(slash > 0 ? mPending[i].path.left(slash) : QString("."));
+    }
+
+    bool written = true;
+    for (const QString& parent : parents)
+    {
+        if (!mRoot.mkpath(parent))
+        {
+            DependencyManager::Instance().Logger().Error("Could not create the directory: " + parent.toStdString());
+            written = false;
+        }
+    }
+
+    for (size_t i = 0; i < ready; i++)
+    {
+        const Pending& pending = mPending[i];
+        QFile file(mRoot.filePath(pending.path));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(pending.data) != pending.data.size())
+        {
+            DependencyManager::Instance().Logger().Error("Could not write the file: " + pending.path.toStdString());
+            written = false;
+            continue;
+        }
+        mWritten++;
+    }
+
+    mPending.erase(mPending.begin(), mPending.begin() + ready);
+    mPendingBytes = mPending.empty() ? 0 : mPending.back().data.size();
+    if (!written) mFailed = true;
+    return written;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::DirectoryWriter::makeParent
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::DirectoryWriter::makeParent(const QString& path)
+--                              path: The path of a file relative to the directory.
+--
+-- RETURN:                  True if the directory the file goes into exists, false otherwise.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::DirectoryWriter::makeParent(const QString& path)
+{
+    const int slash = path.lastIndexOf('/');
+    return mRoot.mkpath(slash > 0 ? path.left(slash) : QString("."));
+}
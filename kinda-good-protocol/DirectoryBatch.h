@@ -0,0 +1,111 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             DirectoryBatch.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          A directory travels as one stream, the manifest of its files followed by
+--                          their data. The sender reads the files of the tree into that stream on a
+--                          few threads at once, and the receiver writes the files back below a
+--                          directory of its own. Creating many small files one at a time is slow, so
+--                          the receiver keeps them until it holds enough to create them together.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <vector>
+
+#include <QByteArray>
+#include <QDir>
+#include <QFile>
+#include <QString>
+
+#include "StreamFramer.h"
+#include "res.h"
+
+namespace kgp
+{
+    class DirectoryReader
+    {
+    public:
+        static bool Pack(const QString& directory, QByteArray& stream, std::vector<StreamFramer::FileEntry>& entries);
+    };
+
+    class DirectoryWriter
+    {
+    private:
+        // A small file that has been received but not created yet
+        struct Pending
+        {
+            QString path;
+            QByteArray data;
+        };
+
+        QDir mRoot;
+        std::vector<Pending> mPending;
+        quint64 mPendingBytes;
+        // The file that is being received, written as it arrives if it is large
+        QString mPath;
+        QFile mLarge;
+        bool mInFile;
+        quint64 mWritten;
+        bool mFailed;
+
+    public:
+        DirectoryWriter(const QString& root);
+        ~DirectoryWriter();
+
+        static bool IsSafePath(const QString& path);
+
+        bool StartFile(const QString& path, const quint64 size);
+        bool Write(const char *data, const size_t size);
+        bool FinishFile();
+        bool Flush();
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::DirectoryWriter::Written
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::DirectoryWriter::Written()
+        --
+        -- RETURN:                  The number of files that have been created on disk.
+        --------------------------------------------------------------------------------------------------*/
+        inline quint64 Written() const { return mWritten; }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::DirectoryWriter::Failed
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               bool kgp::DirectoryWriter::Failed()
+        --
+        -- RETURN:                  True if a file was refused or could not be written, false otherwise.
+        --------------------------------------------------------------------------------------------------*/
+        inline bool Failed() const { return mFailed; }
+
+    private:
+        bool makeParent(const QString& path);
+    };
+}
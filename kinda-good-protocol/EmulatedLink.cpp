@@ -0,0 +1,585 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             EmulatedLink.cpp
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          An in memory replacement for network-emu.py. Datagrams sent by an
+--                          endpoint are held by the link until their delivery time has passed and
+--                          are then handed to the endpoint bound to the destination on Poll.
+---------------------------------------------------------------------------------------*/
+#include "EmulatedLink.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "DependencyManager.h"
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::EmulatedTransport::EmulatedTransport
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::EmulatedTransport::EmulatedTransport(EmulatedLink& link, const QHostAddress& address, QObject *parent)
+--                              link: The link the endpoint is attached to.
+--                              address: The address of the emulated host.
+--                              parent: The parent QObject.
+--
+-- NOTES:
+--                          Constructor for an endpoint. Endpoints should be created through
+--                          EmulatedLink::CreateEndpoint.
+--------------------------------------------------------------------------------------------------*/
+kgp::EmulatedTransport::EmulatedTransport(EmulatedLink& link, const QHostAddress& address, QObject *parent)
+    : Transport(parent)
+    , mLink(link)
+    , mAddress(address)
+    , mPort(0)
+    , mBound(false)
+{
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::EmulatedTransport::Bind
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::EmulatedTransport::Bind(const QHostAddress& address, const short& port)
+--                              address: Ignored, the endpoint always uses the address of its host.
+--                              port: The port to bind to.
+--
+-- RETURN:                  Always true.
+--
+-- NOTES:
+--                          Binds the endpoint to port on the address of the emulated host.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::EmulatedTransport::Bind(const QHostAddress& address, const short& port)
+{
+    Q_UNUSED(address);
+    QMutexLocker locker(&mMutex);
+    mPort = port;
+    mBound = true;
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::EmulatedTransport::Close
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::EmulatedTransport::Close()
+--
+-- NOTES:
+--                          Unbinds the endpoint and drops any datagrams that have not been read.
+--------------------------------------------------------------------------------------------------*/
+void kgp::EmulatedTransport::Close()
+{
+    QMutexLocker locker(&mMutex);
+    mBound = false;
+    mQueue.clear();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::EmulatedTransport::Send
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               qint64 kgp::EmulatedTransport::Send(const char *data, const qint64 size, const QHostAddress& address, const short& port)
+--                              data: The start of the datagram.
+--                              size: The size of the datagram.
+--                              address: The address to send to.
+--                              port: The port to send to.
+--
+-- RETURN:                  The number of bytes sent.
+--
+-- NOTES:
+--                          Hands a copy of the datagram to the link.
+--------------------------------------------------------------------------------------------------*/
+qint64 kgp::EmulatedTransport::Send(const char *data, const qint64 size, const QHostAddress& address, const short& port)
+{
+    mLink.Transmit(this, QByteArray(data, (int)size), address, port);
+    return size;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::EmulatedTransport::SendProbe
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               qint64 kgp::EmulatedTransport::SendProbe(const char *data, const qint64 size, const QHostAddress& address, const short& port)
+--                              data: The start of the datagram.
+--                              size: The size of the datagram.
+--                              address: The address to send to.
+--                              port: The port to send to.
+--
+-- RETURN:                  The number of bytes sent.
+--
+-- NOTES:
+--                          Hands a copy of the datagram to the link, which drops it if it does not
+--                          fit through the link whole.
+--------------------------------------------------------------------------------------------------*/
+qint64 kgp::EmulatedTransport::SendProbe(const char *data, const qint64 size, const QHostAddress& address, const short& port)
+{
+    mLink.Transmit(this, QByteArray(data, (int)size), address, port, true);
+    return size;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::EmulatedTransport::SendGather
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               qint64 kgp::EmulatedTransport::SendGather(const char *header, const qint64 headerSize, const char *data, const qint64 dataSize, const QHostAddress& address, const short& port, const bool probe)
+--                              header: The start of the header.
+--                              headerSize: The size of the header.
+--                              data: The start of the data that follows the header.
+--                              dataSize: The size of the data.
+--                              address: The address to send to.
+--                              port: The port to send to.
+--                              probe: Whether the datagram must not be fragmented on its way.
+--
+-- RETURN:                  The number of bytes sent.
+--
+-- NOTES:
+--                          Joins the header and data straight into the copy the link keeps.
+--------------------------------------------------------------------------------------------------*/
+qint64 kgp::EmulatedTransport::SendGather(const char *header, const qint64 headerSize, const char *data, const qint64 dataSize, const QHostAddress& address, const short& port, const bool probe)
+{
+    QByteArray datagram;
+    datagram.reserve((int)(headerSize + dataSize));
+    datagram.append(header, (int)headerSize).append(data, (int)dataSize);
+    mLink.Transmit(this, datagram, address, port, probe);
+    return datagram.size();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::EmulatedTransport::HasPendingDatagrams
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::EmulatedTransport::HasPendingDatagrams()
+--
+-- RETURN:                  True if a delivered datagram is waiting to be read.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::EmulatedTransport::HasPendingDatagrams()
+{
+    QMutexLocker locker(&mMutex);
+    return !mQueue.empty();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::EmulatedTransport::Receive
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               QNetworkDatagram kgp::EmulatedTransport::Receive()
+--
+-- RETURN:                  The oldest delivered datagram, or an empty datagram if there is none.
+--------------------------------------------------------------------------------------------------*/
+QNetworkDatagram kgp::EmulatedTransport::Receive()
+{
+    QMutexLocker locker(&mMutex);
+    if (mQueue.empty()) return QNetworkDatagram();
+
+    QNetworkDatagram datagram = mQueue.front();
+    mQueue.pop_front();
+    return datagram;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::EmulatedTransport::deliver
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::EmulatedTransport::deliver(const QNetworkDatagram& datagram)
+--                              datagram: The datagram that arrived.
+--
+-- NOTES:
+--                          Called by the link when a datagram arrives. Queues the datagram and
+--                          signals that there is data to be read.
+--------------------------------------------------------------------------------------------------*/
+void kgp::EmulatedTransport::deliver(const QNetworkDatagram& datagram)
+{
+    {
+        QMutexLocker locker(&mMutex);
+        if (!mBound) return;
+        mQueue.push_back(datagram);
+    }
+    emit readyRead();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::EmulatedLink::EmulatedLink
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::EmulatedLink::EmulatedLink(const Config& config)
+--                              config: The behaviour of the link.
+--
+-- NOTES:
+--                          Constructor for the EmulatedLink. Seeds the generator from the config.
+--------------------------------------------------------------------------------------------------*/
+kgp::EmulatedLink::EmulatedLink(const Config& config)
+    : mConfig(config)
+    , mRandom(config.seed)
+{
+    memset(&mStats, 0, sizeof(mStats));
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::EmulatedLink::CreateEndpoint
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               EmulatedTransport *kgp::EmulatedLink::CreateEndpoint(const QHostAddress& address)
+--                              address: The address of the emulated host.
+--
+-- RETURN:                  The new endpoint. It is owned by the link.
+--
+-- NOTES:
+--                          Creates an endpoint for a host on the link. The endpoint must be bound
+--                          before it receives anything.
+--------------------------------------------------------------------------------------------------*/
+kgp::EmulatedTransport *kgp::EmulatedLink::CreateEndpoint(const QHostAddress& address)
+{
+    QMutexLocker locker(&mMutex);
+    mEndpoints.push_back(std::make_unique<EmulatedTransport>(*this, address));
+    return mEndpoints.back().get();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::EmulatedLink::SetMtu
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::EmulatedLink::SetMtu(const quint64 mtu)
+--                              mtu: The largest IP packet the link carries whole, 0 for unlimited.
+--
+-- NOTES:
+--                          Changes the MTU of the link, like a route change onto a path with a
+--                          smaller MTU. Datagrams that are already in flight are not affected.
+--------------------------------------------------------------------------------------------------*/
+void kgp::EmulatedLink::SetMtu(const quint64 mtu)
+{
+    QMutexLocker locker(&mMutex);
+    mConfig.mtu = mtu;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::EmulatedLink::Transmit
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Keeps the bandwidth cap in microseconds.
+--                          October 19, 2026 - Benny Wang: Flips bits.
+--                          October 19, 2026 - Benny Wang: Fragments datagrams larger than the MTU.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::EmulatedLink::Transmit(EmulatedTransport *source, const QByteArray& data, const QHostAddress& address, const short& port, const bool dontFragment)
+--                              source: The endpoint that sent the datagram.
+--                              data: The contents of the datagram.
+--                              address: The destination address.
+--                              port: The destination port.
+--                              dontFragment: Whether the datagram is dropped rather than fragmented.
+--
+-- NOTES:
+--                          Applies loss, duplication, reordering, corruption, delay and the
+--                          bandwidth cap to a datagram and schedules its delivery. The same number of random draws is
+--                          made for every datagram so changing one rate does not change the
+--                          decisions made for the others. A datagram that is larger than the MTU is
+--                          lost if any of its fragments is.
+--------------------------------------------------------------------------------------------------*/
+void kgp::EmulatedLink::Transmit(EmulatedTransport *source, const QByteArray& data, const QHostAddress& address, const short& port, const bool dontFragment)
+{
+    QMutexLocker locker(&mMutex);
+    mStats.sent++;
+
+    quint64 fragments = 1;
+    if (mConfig.mtu > Link::IP && (quint64)data.size() + Link::IP_UDP > mConfig.mtu)
+    {
+        // Fragments carry a multiple of 8 bytes of the UDP header and data
+        const quint64 perFragment = (mConfig.mtu - Link::IP) & ~(quint64)7;
+        fragments = ((quint64)data.size() + Link::IP_UDP - Link::IP + perFragment - 1) / perFragment;
+    }
+
+    const bool lost = chance(fragments == 1 ? mConfig.lossRate : 1 - std::pow(1 - mConfig.lossRate, (double)fragments));
+    const bool duplicated = chance(mConfig.duplicateRate);
+    const bool reordered = chance(mConfig.reorderRate);
+    const quint64 jitterRoll = mRandom();
+    const quint64 jitter = mConfig.jitter > 0 ? jitterRoll % (mConfig.jitter + 1) : 0;
+    const bool corrupted = chance(mConfig.corruptRate);
+    const quint64 corruptRoll = mRandom();
+
+    if (fragments > 1 && (dontFragment || mConfig.dropFragments))
+    {
+        mStats.dropped++;
+        return;
+    }
+    if (fragments > 1) mStats.fragmented++;
+
+    if (lost)
+    {
+        mStats.dropped++;
+        return;
+    }
+
+    EmulatedTransport *destination = findEndpoint(address, port);
+    if (destination == nullptr)
+    {
+        mStats.dropped++;
+        return;
+    }
+
+    // Serialize the datagram onto the link towards the destination
+    quint64 departure = now();
+    if (mConfig.bandwidth > 0)
+    {
+        quint64& busyUntil = mBusyUntil[destination];
+        busyUntil = std::max(departure * 1000, busyUntil) + (quint64)data.size() * 1000000 / mConfig.bandwidth;
+        // Round up to the millisecond the last byte leaves in
+        departure = (busyUntil + 999) / 1000;
+    }
+
+    quint64 arrival = departure + mConfig.delay + jitter;
+    if (reordered)
+    {
+        arrival += mConfig.reorderDelay;
+        mStats.reordered++;
+    }
+
+    QByteArray contents(data);
+    if (corrupted && (quint64)contents.size() > mConfig.corruptOffset)
+    {
+        const quint64 bit = mConfig.corruptOffset * 8 + corruptRoll % (((quint64)contents.size() - mConfig.corruptOffset) * 8);
+        contents[(int)(bit / 8)] = contents[(int)(bit / 8)] ^ (char)(1 << (bit % 8));
+        mStats.corrupted++;
+    }
+
+    InFlight packet;
+    packet.datagram = QNetworkDatagram(contents, address, port);
+    packet.datagram.setSender(source->Address(), source->Port());
+    packet.destination = address;
+    packet.port = port;
+    mInFlight.emplace(arrival, packet);
+
+    if (duplicated)
+    {
+        mInFlight.emplace(arrival, packet);
+        mStats.duplicated++;
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::EmulatedLink::Poll
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::EmulatedLink::Poll()
+--
+-- NOTES:
+--                          Delivers every datagram whose delivery time has passed. Datagrams sent
+--                          while handling a delivery are delivered in the same call if they are
+--                          already due. The link is not locked while delivering so that receivers
+--                          can send from their handlers.
+--------------------------------------------------------------------------------------------------*/
+void kgp::EmulatedLink::Poll()
+{
+    while (true)
+    {
+        std::vector<InFlight> due;
+        {
+            QMutexLocker locker(&mMutex);
+            const quint64 current = now();
+            auto end = mInFlight.upper_bound(current);
+            for (auto it = mInFlight.begin(); it != end; it++) due.push_back(it->second);
+            mInFlight.erase(mInFlight.begin(), end);
+        }
+
+        if (due.empty()) return;
+
+        for (const auto& packet : due)
+        {
+            EmulatedTransport *destination;
+            {
+                QMutexLocker locker(&mMutex);
+                destination = findEndpoint(packet.destination, packet.port);
+                if (destination == nullptr)
+                {
+                    mStats.dropped++;
+                    continue;
+                }
+                mStats.delivered++;
+                mStats.bytesDelivered += packet.datagram.data().size();
+            }
+            destination->deliver(packet.datagram);
+        }
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::EmulatedLink::NextDelivery
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               quint64 kgp::EmulatedLink::NextDelivery()
+--
+-- RETURN:                  The clock time at which the next datagram is delivered, or the largest
+--                          quint64 if nothing is in flight.
+--------------------------------------------------------------------------------------------------*/
+quint64 kgp::EmulatedLink::NextDelivery()
+{
+    QMutexLocker locker(&mMutex);
+    if (mInFlight.empty()) return std::numeric_limits<quint64>::max();
+    return mInFlight.begin()->first;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::EmulatedLink::findEndpoint
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               EmulatedTransport *kgp::EmulatedLink::findEndpoint(const QHostAddress& address, const short& port)
+--                              address: The address to look for.
+--                              port: The port to look for.
+--
+-- RETURN:                  The endpoint bound to address and port, or nullptr if there is none.
+--
+-- NOTES:
+--                          The link mutex must be held by the caller.
+--------------------------------------------------------------------------------------------------*/
+kgp::EmulatedTransport *kgp::EmulatedLink::findEndpoint(const QHostAddress& address, const short& port)
+{
+    for (auto& endpoint : mEndpoints)
+    {
+        QMutexLocker locker(&endpoint->mMutex);
+        if (endpoint->mBound && endpoint->mAddress.toIPv4Address() == address.toIPv4Address() && endpoint->mPort == port)
+        {
+            return endpoint.get();
+        }
+    }
+    return nullptr;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::EmulatedLink::now
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               quint64 kgp::EmulatedLink::now()
+--
+-- RETURN:                  The current time of the clock held by the dependency manager.
+--------------------------------------------------------------------------------------------------*/
+quint64 kgp::EmulatedLink::now()
+{
+    return DependencyManager::Instance().Clock().Now();
+}
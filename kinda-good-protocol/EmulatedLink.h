@@ -0,0 +1,235 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             EmulatedLink.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          An in memory replacement for network-emu.py. Endpoints created on
+--                          the link are transports that can be handed to an IoEngine, so both
+--                          ends of a transfer can run in the same process. Loss, duplication and
+--                          reordering are drawn from a seeded generator so that a run can be
+--                          reproduced exactly.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <QByteArray>
+#include <QHostAddress>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QNetworkDatagram>
+
+#include "Transport.h"
+
+namespace kgp
+{
+    class EmulatedLink;
+
+    namespace Link
+    {
+        // Bytes of IP and UDP headers in front of every datagram
+        constexpr quint64 IP_UDP = 28;
+        // Bytes of IP header in front of every fragment
+        constexpr quint64 IP = 20;
+    }
+
+    class EmulatedTransport : public Transport
+    {
+        Q_OBJECT
+
+        friend class EmulatedLink;
+
+    private:
+        EmulatedLink& mLink;
+        QHostAddress mAddress;
+        short mPort;
+        bool mBound;
+
+        QMutex mMutex;
+        std::deque<QNetworkDatagram> mQueue;
+
+    public:
+        EmulatedTransport(EmulatedLink& link, const QHostAddress& address, QObject *parent = nullptr);
+        virtual ~EmulatedTransport() = default;
+
+        bool Bind(const QHostAddress& address, const short& port) override;
+        void Close() override;
+        qint64 Send(const char *data, const qint64 size, const QHostAddress& address, const short& port) override;
+        qint64 SendProbe(const char *data, const qint64 size, const QHostAddress& address, const short& port) override;
+        qint64 SendGather(const char *header, const qint64 headerSize, const char *data, const qint64 dataSize, const QHostAddress& address, const short& port, const bool probe = false) override;
+        bool HasPendingDatagrams() override;
+        QNetworkDatagram Receive() override;
+
+        inline const QHostAddress& Address() const { return mAddress; }
+        inline short Port() const { return mPort; }
+
+    private:
+        void deliver(const QNetworkDatagram& datagram);
+    };
+
+    class EmulatedLink
+    {
+    public:
+        struct Config
+        {
+            // Seed for every random decision made by the link
+            quint32 seed;
+            // Probability that a datagram is dropped
+            double lossRate;
+            // Probability that a datagram is delivered twice
+            double duplicateRate;
+            // Probability that a datagram is held back so later datagrams overtake it
+            double reorderRate;
+            // Probability that a bit of a datagram is flipped
+            double corruptRate;
+            // Bytes at the start of a datagram that are never corrupted, so that only data is
+            quint64 corruptOffset;
+            // One way delay in milliseconds
+            quint64 delay;
+            // Extra uniformly distributed delay in milliseconds
+            quint64 jitter;
+            // Extra delay in milliseconds given to datagrams that are reordered
+            quint64 reorderDelay;
+            // Bandwidth cap in bytes per second, 0 for unlimited
+            quint64 bandwidth;
+            // Largest IP packet the link carries whole, 0 for unlimited. A datagram gets Link::IP_UDP
+            // bytes of headers, larger ones are fragmented and lost if any fragment is lost
+            quint64 mtu;
+            // Whether datagrams that would have to be fragmented are dropped, like on a path that
+            // filters fragments or sends the ICMP errors nowhere
+            bool dropFragments;
+        };
+
+        struct Stats
+        {
+            quint64 sent;
+            quint64 delivered;
+            quint64 dropped;
+            quint64 duplicated;
+            quint64 reordered;
+            quint64 corrupted;
+            quint64 fragmented;
+            quint64 bytesDelivered;
+        };
+
+    private:
+        struct InFlight
+        {
+            QNetworkDatagram datagram;
+            QHostAddress destination;
+            short port;
+        };
+
+        Config mConfig;
+        Stats mStats;
+
+        QMutex mMutex;
+        std::mt19937 mRandom;
+
+        std::vector<std::unique_ptr<EmulatedTransport>> mEndpoints;
+        // In flight datagrams keyed by delivery time, equal times keep their send order
+        std::multimap<quint64, InFlight> mInFlight;
+        // Time in microseconds at which the link towards each endpoint finishes serializing its last
+        // datagram, a full sized datagram takes well under a millisecond on a fast link
+        std::map<EmulatedTransport *, quint64> mBusyUntil;
+
+    public:
+        EmulatedLink(const Config& config);
+        ~EmulatedLink() = default;
+
+        EmulatedTransport *CreateEndpoint(const QHostAddress& address);
+
+        void Poll();
+        quint64 NextDelivery();
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::EmulatedLink::InFlightCount
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               size_t kgp::EmulatedLink::InFlightCount()
+        --
+        -- RETURN:                  The number of datagrams that have been sent but not delivered yet.
+        --------------------------------------------------------------------------------------------------*/
+        inline size_t InFlightCount()
+        {
+            QMutexLocker locker(&mMutex);
+            return mInFlight.size();
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::EmulatedLink::GetStats
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               Stats kgp::EmulatedLink::GetStats()
+        --
+        -- RETURN:                  A copy of the counters of the link.
+        --------------------------------------------------------------------------------------------------*/
+        inline Stats GetStats()
+        {
+            QMutexLocker locker(&mMutex);
+            return mStats;
+        }
+
+        inline const Config& GetConfig() const { return mConfig; }
+
+        void SetMtu(const quint64 mtu);
+        void Transmit(EmulatedTransport *source, const QByteArray& data, const QHostAddress& address, const short& port, const bool dontFragment = false);
+
+    private:
+        EmulatedTransport *findEndpoint(const QHostAddress& address, const short& port);
+        quint64 now();
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::EmulatedLink::chance
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               bool kgp::EmulatedLink::chance(const double probability)
+        --                              probability: The probability of returning true.
+        --
+        -- NOTES:
+        --                          Draws from the seeded generator. The conversion is done by hand since
+        --                          the standard distributions are not the same across standard libraries.
+        --------------------------------------------------------------------------------------------------*/
+        inline bool chance(const double probability)
+        {
+            const double roll = mRandom() / 4294967296.0;
+            return roll < probability;
+        }
+    };
+}
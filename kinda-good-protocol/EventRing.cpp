@@ -0,0 +1,111 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             EventRing.cpp
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          The last messages of the logger kept in memory.
+---------------------------------------------------------------------------------------*/
+#include "EventRing.h"
+
+#include <algorithm>
+
+#include <QDateTime>
+#include <QMutexLocker>
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::EventRing::EventRing
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::EventRing::EventRing(const size_t capacity)
+--                              capacity: The number of events kept, at least one.
+--
+-- NOTES:
+--                          Constructor for the EventRing. Every slot is made up front so that
+--                          pushing never allocates anything but the text.
+--------------------------------------------------------------------------------------------------*/
+kgp::EventRing::EventRing(const size_t capacity)
+    : mEvents(std::max<size_t>(capacity, 1))
+    , mNext(0)
+{
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::EventRing::Push
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::EventRing::Push(const bool error, const QString& text)
+--                              error: Whether the event is an error.
+--                              text: The message.
+--
+-- NOTES:
+--                          Adds an event with the next ID and the current time, over the oldest
+--                          event once the ring is full. Can be called from any thread.
+--------------------------------------------------------------------------------------------------*/
+void kgp::EventRing::Push(const bool error, const QString& text)
+{
+    const qint64 time = QDateTime::currentMSecsSinceEpoch();
+
+    QMutexLocker locker(&mMutex);
+    Event& event = mEvents[mNext % mEvents.size()];
+    event.id = mNext++;
+    event.time = time;
+    event.error = error;
+    event.text = text;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::EventRing::Read
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               quint64 kgp::EventRing::Read(const quint64 from, std::vector<Event>& out, const size_t most)
+--                              from: The ID of the first event wanted.
+--                              out: Where the events are appended, oldest first.
+--                              most: The most events to take.
+--
+-- RETURN:                  The ID to read from next time.
+--
+-- NOTES:
+--                          Copies the events from from on. Events that were overwritten before they
+--                          were read are skipped, which a reader sees as a gap between from and the
+--                          ID of the first event it got. Can be called from any thread.
+--------------------------------------------------------------------------------------------------*/
+quint64 kgp::EventRing::Read(const quint64 from, std::vector<Event>& out, const size_t most) const
+{
+    QMutexLocker locker(&mMutex);
+    const quint64 oldest = mNext > mEvents.size() ? mNext - mEvents.size() : 0;
+    quint64 id = std::max(from, oldest);
+    for (size_t taken = 0; id < mNext && taken < most; id++, taken++) out.push_back(mEvents[id % mEvents.size()]);
+    return id;
+}
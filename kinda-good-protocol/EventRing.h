@@ -0,0 +1,79 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             EventRing.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          The last messages of the logger kept in memory, for viewers that show
+--                          the log as it is written. The ring has a fixed size and overwrites its
+--                          oldest events, so logging costs the same however long the program runs
+--                          and a viewer that falls behind loses events instead of slowing the
+--                          engine down. Every event gets the next ID, a reader remembers the ID it
+--                          stopped at and asks for what came after.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <QMutex>
+#include <QString>
+#include <QtGlobal>
+
+#include "res.h"
+
+namespace kgp
+{
+    class EventRing
+    {
+    public:
+        struct Event
+        {
+            quint64 id;
+            // Milliseconds since the epoch
+            qint64 time;
+            bool error;
+            QString text;
+        };
+
+    private:
+        mutable QMutex mMutex;
+        std::vector<Event> mEvents;
+        // ID of the next event, the slot of an event is its ID modulo the capacity
+        quint64 mNext;
+
+    public:
+        EventRing(const size_t capacity = Events::CAPACITY);
+        ~EventRing() = default;
+
+        void Push(const bool error, const QString& text);
+        quint64 Read(const quint64 from, std::vector<Event>& out, const size_t most = Events::CAPACITY) const;
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::EventRing::Capacity
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               size_t kgp::EventRing::Capacity()
+        --
+        -- RETURN:                  The number of events kept.
+        --------------------------------------------------------------------------------------------------*/
+        inline size_t Capacity() const { return mEvents.size(); }
+    };
+}
@@ -0,0 +1,236 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             EventView.cpp
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          The events of the logger as a list model for the GUI, and the filter in
+--                          front of it.
+---------------------------------------------------------------------------------------*/
+#include "EventView.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <QBrush>
+#include <QDateTime>
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                EventModel::EventModel
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               EventModel::EventModel(const kgp::EventRing& ring, QObject *parent)
+--                              ring: Where the events come from. Must outlive the model.
+--                              parent: The parent QObject.
+--
+-- NOTES:
+--                          Constructor for the EventModel. Starts out empty, the events that are
+--                          already in the ring come with the first Refresh.
+--------------------------------------------------------------------------------------------------*/
+EventModel::EventModel(const kgp::EventRing& ring, QObject *parent)
+    : QAbstractListModel(parent)
+    , mRing(ring)
+    , mNext(0)
+{
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                EventModel::rowCount
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               int EventModel::rowCount(const QModelIndex& parent)
+--                              parent: The parent of the rows, only the root has any.
+--
+-- RETURN:                  The number of events in the model.
+--------------------------------------------------------------------------------------------------*/
+int EventModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : (int)mEvents.size();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                EventModel::data
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               QVariant EventModel::data(const QModelIndex& index, int role)
+--                              index: The row of the event.
+--                              role: What is wanted of it.
+--
+-- RETURN:                  The time and message of the event for display, red text for an error and
+--                          whether it is one for ErrorRole.
+--------------------------------------------------------------------------------------------------*/
+QVariant EventModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= (int)mEvents.size()) return QVariant();
+
+    const kgp::EventRing::Event& event = mEvents[index.row()];
+    switch (role)
+    {
+    case Qt::DisplayRole:
+        return QDateTime::fromMSecsSinceEpoch(event.time).toString("hh:mm:ss.zzz") + "  " + event.text;
+    case Qt::ForegroundRole:
+        return event.error ? QVariant(QBrush(Qt::red)) : QVariant();
+    case ErrorRole:
+        return event.error;
+    default:
+        return QVariant();
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                EventModel::Refresh
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void EventModel::Refresh()
+--
+-- NOTES:
+--                          Takes the events that were pushed since the last refresh. The oldest rows
+--                          are dropped first so that the model never holds more than the ring, the
+--                          rows in between are only added and removed at the ends.
+--------------------------------------------------------------------------------------------------*/
+void EventModel::Refresh()
+{
+    std::vector<kgp::EventRing::Event> events;
+    mNext = mRing.Read(mNext, events, mRing.Capacity());
+    if (events.empty()) return;
+
+    const size_t excess = std::min(mEvents.size(), mEvents.size() + events.size() > mRing.Capacity() ? mEvents.size() + events.size() - mRing.Capacity() : 0);
+    if (excess > 0)
+    {
+        beginRemoveRows(QModelIndex(), 0, (int)excess - 1);
+        mEvents.erase(mEvents.begin(), mEvents.begin() + excess);
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), (int)mEvents.size(), (int)(mEvents.size() + events.size()) - 1);
+    for (kgp::EventRing::Event& event : events) mEvents.push_back(std::move(event));
+    endInsertRows();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                EventFilter::EventFilter
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               EventFilter::EventFilter(QObject *parent)
+--                              parent: The parent QObject.
+--
+-- NOTES:
+--                          Constructor for the EventFilter. Lets every event through until a filter
+--                          is set.
+--------------------------------------------------------------------------------------------------*/
+EventFilter::EventFilter(QObject *parent)
+    : QSortFilterProxyModel(parent)
+    , mText()
+    , mErrorsOnly(false)
+{
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                EventFilter::SetText
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void EventFilter::SetText(const QString& text)
+--                              text: What the shown events have to contain, any case. Empty shows
+--                                    them all.
+--------------------------------------------------------------------------------------------------*/
+void EventFilter::SetText(const QString& text)
+{
+    mText = text;
+    invalidateFilter();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                EventFilter::SetErrorsOnly
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void EventFilter::SetErrorsOnly(const bool errorsOnly)
+--                              errorsOnly: Whether only errors are shown.
+--------------------------------------------------------------------------------------------------*/
+void EventFilter::SetErrorsOnly(const bool errorsOnly)
+{
+    mErrorsOnly = errorsOnly;
+    invalidateFilter();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                EventFilter::filterAcceptsRow
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool EventFilter::filterAcceptsRow(int row, const QModelIndex& parent)
+--                              row: The row of the event in the model.
+--                              parent: The parent of the row.
+--
+-- RETURN:                  True if the event matches the filter.
+--------------------------------------------------------------------------------------------------*/
+bool EventFilter::filterAcceptsRow(int row, const QModelIndex& parent) const
+{
+    const QModelIndex index = sourceModel()->index(row, 0, parent);
+    if (mErrorsOnly && !sourceModel()->data(index, EventModel::ErrorRole).toBool()) return false;
+    return mText.isEmpty() || sourceModel()->data(index, Qt::DisplayRole).toString().contains(mText, Qt::CaseInsensitive);
+}
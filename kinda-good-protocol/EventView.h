@@ -0,0 +1,75 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             EventView.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          The events of the logger as a list model for the GUI, and the filter in
+--                          front of it. The model takes what is new in the event ring when it is
+--                          refreshed, so the view costs the same however fast the engine logs, and
+--                          it keeps no more rows than the ring does. A QListView with uniform item
+--                          sizes only lays out the rows that are on screen.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <deque>
+
+#include <QAbstractListModel>
+#include <QSortFilterProxyModel>
+#include <QString>
+#include <QVariant>
+
+#include "EventRing.h"
+
+class EventModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    // Whether the event of a row is an error
+    static constexpr int ErrorRole = Qt::UserRole;
+
+private:
+    const kgp::EventRing& mRing;
+    std::deque<kgp::EventRing::Event> mEvents;
+    // ID of the next event to take from the ring
+    quint64 mNext;
+
+public:
+    EventModel(const kgp::EventRing& ring, QObject *parent = Q_NULLPTR);
+    ~EventModel() = default;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    void Refresh();
+};
+
+class EventFilter : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+private:
+    QString mText;
+    bool mErrorsOnly;
+
+public:
+    EventFilter(QObject *parent = Q_NULLPTR);
+    ~EventFilter() = default;
+
+    void SetText(const QString& text);
+    void SetErrorsOnly(const bool errorsOnly);
+
+protected:
+    bool filterAcceptsRow(int row, const QModelIndex& parent) const override;
+};
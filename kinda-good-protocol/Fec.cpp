@@ -0,0 +1,495 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             Fec.cpp
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          XOR parity can rebuild one frame per block. Splitting a group into more
+--                          blocks gives more parity frames per group, so the encoder trades
+--                          bandwidth for the number of losses a group survives. A Reed-Solomon
+--                          code could rebuild several frames per block with the same packets.
+---------------------------------------------------------------------------------------*/
+#include "Fec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::FecEncoder::FecEncoder
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::FecEncoder::FecEncoder(const quint64 groupSize)
+--                              groupSize: The number of frames in a group.
+--
+-- NOTES:
+--                          Constructor for the FecEncoder. Starts out assuming Fec::INITIAL_LOSS.
+--------------------------------------------------------------------------------------------------*/
+kgp::FecEncoder::FecEncoder(const quint64 groupSize)
+    : mGroupSize(std::max<quint64>(groupSize, 1))
+    , mLoss(Fec::INITIAL_LOSS)
+    , mBlockTarget(0)
+{
+    memset(&mBlock, 0, sizeof(mBlock));
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::FecEncoder::SetGroupSize
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::FecEncoder::SetGroupSize(const quint64 groupSize)
+--                              groupSize: The number of frames in a group.
+--
+-- NOTES:
+--                          Setter for the group size, it is capped at Fec::GROUP so the receiver
+--                          knows how long to keep delivered frames. Takes effect on the next block.
+--------------------------------------------------------------------------------------------------*/
+void kgp::FecEncoder::SetGroupSize(const quint64 groupSize)
+{
+    mGroupSize = std::min(std::max<quint64>(groupSize, 1), Fec::GROUP);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::FecEncoder::SetLoss
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::FecEncoder::SetLoss(const quint64 sent, const quint64 lost)
+--                              sent: The number of frames sent in this transfer.
+--                              lost: The number of those frames that were lost.
+--
+-- NOTES:
+--                          Updates the loss estimate. The initial loss rate is weighed in as if it
+--                          was observed over Fec::PRIOR_FRAMES frames so a few early losses do not
+--                          swing the parity ratio.
+--------------------------------------------------------------------------------------------------*/
+void kgp::FecEncoder::SetLoss(const quint64 sent, const quint64 lost)
+{
+    mLoss = (lost + Fec::INITIAL_LOSS * Fec::PRIOR_FRAMES) / (sent + Fec::PRIOR_FRAMES);
+    mLoss = std::min(mLoss, 1.0);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::FecEncoder::ParityCount
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               quint64 kgp::FecEncoder::ParityCount()
+--
+-- RETURN:                  The number of parity frames per group.
+--
+-- NOTES:
+--                          Aims for about one loss in every four blocks, which keeps the chance of
+--                          two losses in a block, the case XOR cannot rebuild, small. At least one
+--                          parity frame is sent and at most one for every two frames.
+--------------------------------------------------------------------------------------------------*/
+quint64 kgp::FecEncoder::ParityCount()
+{
+    const quint64 count = (quint64)std::ceil(mGroupSize * mLoss * 4);
+    return std::min(std::max<quint64>(count, 1), std::max<quint64>(mGroupSize / 2, 1));
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::FecEncoder::Encode
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::FecEncoder::Encode(const std::vector<SlidingWindow::Frame>& frames, std::vector<Packet>& parity)
+--                              frames: Contiguous frames that are being sent.
+--                              parity: The parity of every block that was completed is appended to
+--                                      this list.
+--
+-- NOTES:
+--                          Adds the frames to the open block. A block holds the group size divided
+--                          by the parity count frames and spans calls, since once ACKs are flowing
+--                          the sender only puts a frame or two on the wire at a time. A frame that
+--                          does not follow the open block closes it first. The parity of a block
+--                          is the XOR of its frames, shorter frames are padded with zeros.
+--------------------------------------------------------------------------------------------------*/
+void kgp::FecEncoder::Encode(const std::vector<SlidingWindow::Frame>& frames, std::vector<Packet>& parity)
+{
+    for (const SlidingWindow::Frame& frame : frames)
+    {
+        if (mBlock.Header.WindowSize > 0 && frame.seqNum != mBlock.Header.AckNumber) Flush(parity);
+
+        // Open a new block
+        if (mBlock.Header.WindowSize == 0)
+        {
+            const quint64 parityCount = ParityCount();
+            mBlockTarget = (mGroupSize + parityCount - 1) / parityCount;
+            mBlock.Header.PacketType = PacketType::FEC;
+            mBlock.Header.SequenceNumber = frame.seqNum;
+        }
+
+        for (size_t i = 0; i < frame.size; i++) mBlock.Data[i] ^= frame.data[i];
+        mBlock.Header.AckNumber = frame.seqNum + frame.size;
+        mBlock.Header.WindowSize++;
+        mBlock.Header.DataSize = std::max<quint64>(mBlock.Header.DataSize, frame.size);
+
+        if (mBlock.Header.WindowSize >= mBlockTarget) Flush(parity);
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::FecEncoder::Flush
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::FecEncoder::Flush(std::vector<Packet>& parity)
+--                              parity: The parity of the open block is appended to this list.
+--
+-- NOTES:
+--                          Closes the open block even if it is not full. Used when no frames will
+--                          follow the block for a while, such as after the last frame or a resend.
+--------------------------------------------------------------------------------------------------*/
+void kgp::FecEncoder::Flush(std::vector<Packet>& parity)
+{
+    if (mBlock.Header.WindowSize == 0) return;
+
+    parity.push_back(mBlock);
+    memset(&mBlock, 0, sizeof(mBlock));
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::FecDecoder::FecDecoder
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::FecDecoder::FecDecoder()
+--
+-- NOTES:
+--                          Constructor for the FecDecoder.
+--------------------------------------------------------------------------------------------------*/
+kgp::FecDecoder::FecDecoder()
+    : mFrames()
+    , mParity()
+    , mRecovered(0)
+{
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::FecDecoder::Reset
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::FecDecoder::Reset()
+--
+-- NOTES:
+--                          Drops all frames and parity.
+--------------------------------------------------------------------------------------------------*/
+void kgp::FecDecoder::Reset()
+{
+    mFrames.clear();
+    mParity.clear();
+    mRecovered = 0;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::FecDecoder::AddFrame
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::FecDecoder::AddFrame(const quint64 seqNum, const char *data, const size_t size)
+--                              seqNum: The sequence number of the frame.
+--                              data: The data of the frame.
+--                              size: The size of the frame.
+--
+-- NOTES:
+--                          Keeps a copy of a received frame. A frame that was received before is
+--                          replaced since a resend can be cut differently.
+--------------------------------------------------------------------------------------------------*/
+void kgp::FecDecoder::AddFrame(const quint64 seqNum, const char *data, const size_t size)
+{
+    if (size == 0) return;
+    mFrames[seqNum] = QByteArray(data, (int)size);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::FecDecoder::AddParity
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Allows parity up to Size::MAX_DATA.
+--                          October 19, 2026 - Benny Wang: Checks the header and data apart.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::FecDecoder::AddParity(const Packet& packet, const quint64 delivered)
+--                              packet: The FEC packet.
+--                              delivered: Everything before this sequence number has been delivered.
+--
+-- NOTES:
+--                          Keeps the parity of a block unless the whole block has been delivered
+--                          already or the packet does not describe a valid block.
+--------------------------------------------------------------------------------------------------*/
+void kgp::FecDecoder::AddParity(const Packet& packet, const quint64 delivered)
+{
+    AddParity(packet.Header, packet.Data, delivered);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::FecDecoder::AddParity
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::FecDecoder::AddParity(const PacketHeader& header, const char *data, const quint64 delivered)
+--                              header: The header of the FEC packet.
+--                              data: The DataSize bytes of parity that follow the header.
+--                              delivered: Everything before this sequence number has been delivered.
+--
+-- NOTES:
+--                          Same as for a whole packet, for a header and data that are not next to
+--                          each other in memory, like a packet that is read where it was received.
+--------------------------------------------------------------------------------------------------*/
+void kgp::FecDecoder::AddParity(const PacketHeader& header, const char *data, const quint64 delivered)
+{
+    const quint64 first = header.SequenceNumber;
+    const quint64 end = header.AckNumber;
+
+    if (end <= delivered || end <= first) return;
+    if (header.WindowSize == 0 || header.DataSize == 0 || header.DataSize > Size::MAX_DATA) return;
+
+    Parity parity;
+    parity.end = end;
+    parity.count = header.WindowSize;
+    parity.data = QByteArray(data, (int)header.DataSize);
+    mParity[first] = parity;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::FecDecoder::Recover
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               quint64 kgp::FecDecoder::Recover()
+--
+-- RETURN:                  The number of frames that were rebuilt.
+--
+-- NOTES:
+--                          Tries every unresolved parity. Parity is dropped once its block is
+--                          complete, whether the missing frame was received or rebuilt.
+--------------------------------------------------------------------------------------------------*/
+quint64 kgp::FecDecoder::Recover()
+{
+    const quint64 before = mRecovered;
+
+    for (auto it = mParity.begin(); it != mParity.end();)
+    {
+        if (recoverBlock(it->first, it->second)) it = mParity.erase(it);
+        else ++it;
+    }
+
+    return mRecovered - before;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::FecDecoder::Find
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               const QByteArray *kgp::FecDecoder::Find(const quint64 seqNum)
+--                              seqNum: The sequence number of the frame.
+--
+-- RETURN:                  The frame starting at seqNum, or nullptr if it has not been received
+--                          or rebuilt.
+--------------------------------------------------------------------------------------------------*/
+const QByteArray *kgp::FecDecoder::Find(const quint64 seqNum)
+{
+    auto it = mFrames.find(seqNum);
+    return it == mFrames.end() ? nullptr : &it->second;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::FecDecoder::Release
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Keeps a group of the largest frames.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::FecDecoder::Release(const quint64 delivered)
+--                              delivered: Everything before this sequence number has been delivered.
+--
+-- NOTES:
+--                          Drops the parity of delivered blocks and the delivered frames that can
+--                          no longer be needed. The parity of a block is sent after the block, so
+--                          the last group worth of delivered frames is kept for parity that is
+--                          still on its way.
+--------------------------------------------------------------------------------------------------*/
+void kgp::FecDecoder::Release(const quint64 delivered)
+{
+    for (auto it = mParity.begin(); it != mParity.end();)
+    {
+        if (it->second.end <= delivered) it = mParity.erase(it);
+        else ++it;
+    }
+
+    const quint64 horizon = Fec::GROUP * Size::MAX_DATA;
+    quint64 keep = delivered > horizon ? delivered - horizon : 0;
+    if (!mParity.empty()) keep = std::min(keep, mParity.begin()->first);
+
+    mFrames.erase(mFrames.begin(), mFrames.lower_bound(keep));
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::FecDecoder::recoverBlock
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::FecDecoder::recoverBlock(const quint64 first, const Parity& parity)
+--                              first: The first byte covered by the parity.
+--                              parity: The parity of the block.
+--
+-- RETURN:                  True if the parity is no longer needed, false otherwise.
+--
+-- NOTES:
+--                          Walks the frames of the block. If exactly one frame is missing, the gap
+--                          it leaves is its position and size and its data is the XOR of the
+--                          parity with every other frame. Frames that overlap, which happens when
+--                          a resend was cut differently, make the parity unusable.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::FecDecoder::recoverBlock(const quint64 first, const Parity& parity)
+{
+    quint64 present = 0;
+    quint64 gaps = 0;
+    quint64 gapStart = 0;
+    quint64 gapEnd = 0;
+    quint64 expected = first;
+
+    const auto begin = mFrames.lower_bound(first);
+    const auto end = mFrames.lower_bound(parity.end);
+    for (auto it = begin; it != end; ++it)
+    {
+        if (it->first < expected) return true;
+        if (it->first > expected)
+        {
+            gaps++;
+            gapStart = expected;
+            gapEnd = it->first;
+        }
+        expected = it->first + it->second.size();
+        present++;
+    }
+
+    if (expected > parity.end) return true;
+    if (expected < parity.end)
+    {
+        gaps++;
+        gapStart = expected;
+        gapEnd = parity.end;
+    }
+
+    // Every frame is here
+    if (gaps == 0) return true;
+
+    // XOR can only rebuild a single frame
+    if (gaps > 1 || present + 1 != parity.count) return false;
+    if (gapEnd - gapStart > (quint64)parity.data.size()) return true;
+
+    QByteArray frame(parity.data);
+    for (auto it = begin; it != end; ++it)
+    {
+        const QByteArray& data = it->second;
+        for (int i = 0; i < data.size(); i++) frame[i] = frame[i] ^ data[i];
+    }
+    frame.truncate((int)(gapEnd - gapStart));
+
+    mFrames[gapStart] = frame;
+    mRecovered++;
+    return true;
+}
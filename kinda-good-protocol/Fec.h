@@ -0,0 +1,123 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             Fec.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Forward error correction for DATA frames. The encoder cuts the frames
+--                          the sender puts on the wire into blocks of contiguous frames and sends
+--                          the XOR of each block as a parity frame. The decoder keeps the frames
+--                          around until their parity is resolved and rebuilds a block's frame if
+--                          it is the only one missing.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include <QByteArray>
+
+#include "res.h"
+#include "SlidingWindow.h"
+
+namespace kgp
+{
+    class FecEncoder
+    {
+    private:
+        quint64 mGroupSize;
+        double mLoss;
+
+        // Parity of the block that is being filled
+        Packet mBlock;
+        quint64 mBlockTarget;
+
+    public:
+        FecEncoder(const quint64 groupSize = Fec::GROUP);
+        ~FecEncoder() = default;
+
+        void SetGroupSize(const quint64 groupSize);
+        void SetLoss(const quint64 sent, const quint64 lost);
+        quint64 ParityCount();
+
+        void Encode(const std::vector<SlidingWindow::Frame>& frames, std::vector<Packet>& parity);
+        void Flush(std::vector<Packet>& parity);
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::FecEncoder::Loss
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               double kgp::FecEncoder::Loss()
+        --
+        -- RETURN:                  The estimated loss rate the parity is chosen for.
+        --------------------------------------------------------------------------------------------------*/
+        inline double Loss() { return mLoss; }
+    };
+
+    class FecDecoder
+    {
+    private:
+        struct Parity
+        {
+            quint64 end;
+            quint64 count;
+            QByteArray data;
+        };
+
+        // Received and rebuilt frames keyed by sequence number
+        std::map<quint64, QByteArray> mFrames;
+        // Unresolved parity keyed by the first byte it covers
+        std::map<quint64, Parity> mParity;
+        quint64 mRecovered;
+
+    public:
+        FecDecoder();
+        ~FecDecoder() = default;
+
+        void Reset();
+
+        void AddFrame(const quint64 seqNum, const char *data, const size_t size);
+        void AddParity(const Packet& packet, const quint64 delivered);
+        void AddParity(const PacketHeader& header, const char *data, const quint64 delivered);
+        quint64 Recover();
+        const QByteArray *Find(const quint64 seqNum);
+        void Release(const quint64 delivered);
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::FecDecoder::Recovered
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::FecDecoder::Recovered()
+        --
+        -- RETURN:                  The number of frames rebuilt since the last reset.
+        --------------------------------------------------------------------------------------------------*/
+        inline quint64 Recovered() { return mRecovered; }
+
+    private:
+        bool recoverBlock(const quint64 first, const Parity& parity);
+    };
+}
@@ -0,0 +1,181 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             InFlightTable.cpp
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          The ring keeps a power of two slots so a position is found with a mask.
+---------------------------------------------------------------------------------------*/
+#include "InFlightTable.h"
+
+namespace
+{
+    // Slots of a new table, a window of full size frames fits without growing
+    constexpr size_t INITIAL_SLOTS = 16;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::InFlightTable::InFlightTable
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::InFlightTable::InFlightTable()
+--
+-- NOTES:
+--                          Constructor for an empty table.
+--------------------------------------------------------------------------------------------------*/
+kgp::InFlightTable::InFlightTable()
+    : mRecords(INITIAL_SLOTS)
+    , mFirst(0)
+    , mCount(0)
+{
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::InFlightTable::Clear
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::InFlightTable::Clear()
+--
+-- NOTES:
+--                          Forgets every frame. The slots are kept for the next transfer.
+--------------------------------------------------------------------------------------------------*/
+void kgp::InFlightTable::Clear()
+{
+    mFirst = 0;
+    mCount = 0;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::InFlightTable::PushBack
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::InFlightTable::PushBack(const Record& record)
+--                              record: The frame that was handed out, it follows the newest one.
+--
+-- NOTES:
+--                          Adds a frame after the newest one, doubling the slots if they are full.
+--------------------------------------------------------------------------------------------------*/
+void kgp::InFlightTable::PushBack(const Record& record)
+{
+    if (mCount == mRecords.size()) grow();
+    mRecords[(mFirst + mCount) & (mRecords.size() - 1)] = record;
+    mCount++;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::InFlightTable::PopFront
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::InFlightTable::PopFront()
+--
+-- NOTES:
+--                          Drops the oldest frame, the table must not be empty.
+--------------------------------------------------------------------------------------------------*/
+void kgp::InFlightTable::PopFront()
+{
+    mFirst = (mFirst + 1) & (mRecords.size() - 1);
+    mCount--;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::InFlightTable::Find
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               qint64 kgp::InFlightTable::Find(const quint64 seqNum, const quint64 frameSize)
+--                              seqNum: The sequence number the frame starts at.
+--                              frameSize: The payload most frames were cut to.
+--
+-- RETURN:                  The position of the frame that starts at seqNum, -1 if there is none.
+--
+-- NOTES:
+--                          Frames are cut to the same size except at the edges of the window, so
+--                          the position is first guessed from the frame size. Only when the guess
+--                          misses are the records searched, which are in order of their sequence
+--                          numbers.
+--------------------------------------------------------------------------------------------------*/
+qint64 kgp::InFlightTable::Find(const quint64 seqNum, const quint64 frameSize) const
+{
+    if (mCount == 0 || seqNum < Front().seqNum) return -1;
+
+    const quint64 guess = frameSize > 0 ? (seqNum - Front().seqNum) / frameSize : 0;
+    if (guess < mCount && At(guess).seqNum == seqNum) return (qint64)guess;
+
+    size_t low = 0;
+    size_t high = mCount;
+    while (low < high)
+    {
+        const size_t middle = low + (high - low) / 2;
+        if (At(middle).seqNum < seqNum) low = middle + 1;
+        else high = middle;
+    }
+    return low < mCount && At(low).seqNum == seqNum ? (qint64)low : -1;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::InFlightTable::grow
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::InFlightTable::grow()
+--
+-- NOTES:
+--                          Doubles the slots and moves the records to the start of them in order.
+--------------------------------------------------------------------------------------------------*/
+void kgp::InFlightTable::grow()
+{
+    std::vector<Record> records(mRecords.size() * 2);
+    for (size_t i = 0; i < mCount; i++) records[i] = At(i);
+    mRecords.swap(records);
+    mFirst = 0;
+}
@@ -0,0 +1,138 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             InFlightTable.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          The frames a sender has handed out and not had ACK'd yet, in order of
+--                          their sequence numbers. Frames are only added at the back and ACK'd from
+--                          the front, so they are kept in a ring that grows when it is full. Every
+--                          frame remembers when it was sent and how often, which gives it its own
+--                          retransmission deadline and tells whether its ACK is a fair RTT sample.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <QtGlobal>
+
+namespace kgp
+{
+    class InFlightTable
+    {
+    public:
+        struct Record
+        {
+            quint64 seqNum;
+            size_t size;
+            char *data;
+            // Clock times the frame was first and last sent at
+            quint64 firstSent;
+            quint64 lastSent;
+            // Number of times the frame was sent again
+            quint64 retransmits;
+            // Whether the receiver ACK'd the start of the frame
+            bool acked;
+        };
+
+    private:
+        std::vector<Record> mRecords;
+        // Slot of the first record and the number of records, the slots are a power of two
+        size_t mFirst;
+        size_t mCount;
+
+    public:
+        InFlightTable();
+        ~InFlightTable() = default;
+
+        void Clear();
+        void PushBack(const Record& record);
+        void PopFront();
+        qint64 Find(const quint64 seqNum, const quint64 frameSize) const;
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::InFlightTable::Size
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               size_t kgp::InFlightTable::Size()
+        --
+        -- RETURN:                  The number of frames in flight.
+        --------------------------------------------------------------------------------------------------*/
+        inline size_t Size() const { return mCount; }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::InFlightTable::IsEmpty
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               bool kgp::InFlightTable::IsEmpty()
+        --
+        -- RETURN:                  True if no frame is in flight, false otherwise.
+        --------------------------------------------------------------------------------------------------*/
+        inline bool IsEmpty() const { return mCount == 0; }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::InFlightTable::At
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               Record& kgp::InFlightTable::At(const size_t index)
+        --                              index: The position of the frame, 0 is the oldest.
+        --
+        -- RETURN:                  The record of the frame.
+        --------------------------------------------------------------------------------------------------*/
+        inline Record& At(const size_t index) { return mRecords[(mFirst + index) & (mRecords.size() - 1)]; }
+        inline const Record& At(const size_t index) const { return mRecords[(mFirst + index) & (mRecords.size() - 1)]; }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::InFlightTable::Front
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               Record& kgp::InFlightTable::Front()
+        --
+        -- RETURN:                  The record of the oldest frame, the table must not be empty.
+        --------------------------------------------------------------------------------------------------*/
+        inline Record& Front() { return At(0); }
+        inline const Record& Front() const { return At(0); }
+
+    private:
+        void grow();
+    };
+}
@@ -18,42 +18,101 @@
 ---------------------------------------------------------------------------------------*/
 #include "IoEngine.h"
 
+#include <algorithm>
+#include <limits>
 #include <vector>
 
 #include <QNetworkDatagram>
 
+#include "DirectoryBatch.h"
+#include "UdpTransport.h"
+
 /*--------------------------------------------------------------------------------------------------
 -- FUNCTION:                kgp::IoEngine::IoEngine
 --
 -- DATE:                    November 27, 2018
 --
--- REVISIONS:               N/A
+-- REVISIONS:               October 19, 2026 - Benny Wang: Sends through a UdpTransport.
 --
 -- DESIGNER:                Benny Wang
 --
 -- PROGRAMMER:              Benny Wang
 --
--- INTERFACE:               kgp::IoEngine::IoEngine(const bool running, QObject *parent)
+-- INTERFACE:               kgp::IoEngine::IoEngine(QObject *parent)
 --                              parent: The parent QObject.
 --
 -- NOTES:
---                          Constructor for the IoEngine. Creates a sliding window and binds a port.
+--                          Constructor for the IoEngine. Creates a sliding window and binds a port
+--                          on a UDP socket.
 --------------------------------------------------------------------------------------------------*/
 kgp::IoEngine::IoEngine(QObject *parent)
+    : IoEngine(new UdpTransport(), parent)
+{
+    // The engine owns the default transport
+    mTransport->setParent(this);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::IoEngine
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Resumes transfers by default.
+--                          October 19, 2026 - Benny Wang: Discovers the path MTU by default.
+--                          October 19, 2026 - Benny Wang: Handles packets on the thread the
+--                          transport reports them on.
+--                          October 19, 2026 - Benny Wang: Reads files through the transport.
+--                          October 19, 2026 - Benny Wang: Starts without a batch sink.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::IoEngine::IoEngine(Transport *transport, QObject *parent)
+--                              transport: The transport to send and receive on. Not owned by the
+--                                         engine and must outlive it.
+--                              parent: The parent QObject.
+--
+-- NOTES:
+--                          Constructor for the IoEngine. Creates a sliding window and binds a port
+--                          on the given transport.
+--------------------------------------------------------------------------------------------------*/
+kgp::IoEngine::IoEngine(Transport *transport, QObject *parent)
     : QThread(parent)
-    , mSocket(this)
+    , mWakeup(false)
     , mState()
-    , mRcvTimer()
-    , mIdleTimer()
+    , mTransport(transport)
     , mClientAddress()
     , mClientPort(0)
+    , mRcvTimer()
+    , mIdleTimer()
+    , mSourceTimer()
+    , mRcvTimeout(Timeout::RCV)
+    , mIdleTimeout(Timeout::IDLE)
+    , mThreaded(true)
+    , mReceiveWindow(Size::WINDOW)
+    , mDeferRelease(false)
+    , mBatchSink()
+    , mBatch()
+    , mBatchBytes(0)
+    , mBatchCommit(0)
+    , mFeatures(Feature::CHECKSUM | Feature::RESUME | Feature::PMTU)
+    , mStreamWindows(Multiplex::STREAMS - 1)
+    , mStreamReceivers(Multiplex::STREAMS - 1)
 {
     memset(&mState, 0, sizeof(mState));
-    mState.rcvWindowSize = Size::WINDOW;
+    memset(&mStats, 0, sizeof(mStats));
+    mState.rcvWindowSize = mReceiveWindow;
     mState.idle = true;
 
-    mSocket.bind(QHostAddress::Any, PORT);
-    connect(&mSocket, &QUdpSocket::readyRead, this, &IoEngine::newDataHandler);
+    mTransport->Bind(QHostAddress::Any, PORT);
+    // Packets are handled on whichever thread the transport reports them on
+    connect(mTransport, &Transport::readyRead, this, &IoEngine::newDataHandler, Qt::DirectConnection);
+
+    // Files are read through the transport so that it can batch the reads with its other I/O
+    const SlidingWindow::FileReader reader = [this](QFile& file, QByteArray& data) { return mTransport->ReadFile(file, data); };
+    mWindow.SetFileReader(reader);
+    for (SlidingWindow& window : mStreamWindows) window.SetFileReader(reader);
 
     kgp::DependencyManager::Instance().Logger().Log("Io Engine initialized");
 }
@@ -63,7 +122,8 @@ kgp::IoEngine::IoEngine(QObject *parent)
 --
 -- DATE:                    November 27, 2018
 --
--- REVISIONS:               N/A
+-- REVISIONS:               October 19, 2026 - Benny Wang: Wakes the thread and waits for it to
+--                          finish.
 --
 -- DESIGNER:                Benny Wang
 --
@@ -72,12 +132,21 @@ kgp::IoEngine::IoEngine(QObject *parent)
 -- INTERFACE:               kgp::IoEngine::~IoEngine()
 --
 -- NOTES:
---                          Deconstructor for the IoEngine. Closes the bound socket.
+--                          Deconstructor for the IoEngine. Stops the thread if it is still running
+--                          and closes the transport.
 --------------------------------------------------------------------------------------------------*/
 kgp::IoEngine::~IoEngine()
 {
+    // Let the run loop finish before the thread object goes away
+    {
+        QMutexLocker locker(&mMutex);
+        mState.idle = true;
+    }
+    wake();
+    wait();
+
     DependencyManager::Instance().Logger().Log("Io Engine stopped");
-    mSocket.close();
+    mTransport->Close();
 }
 
 /*--------------------------------------------------------------------------------------------------
@@ -85,7 +154,8 @@ kgp::IoEngine::~IoEngine()
 --
 -- DATE:                    November 27, 2018
 --
--- REVISIONS:               N/A
+-- REVISIONS:               October 19, 2026 - Benny Wang: Only starts the thread if threaded, and
+--                          wakes it if it is already running.
 --
 -- DESIGNER:                Benny Wang
 --
@@ -95,11 +165,15 @@ kgp::IoEngine::~IoEngine()
 --
 -- NOTES:
 --                          Wrapper function of QThread::start. Starts the thread and executes the
---                          overloaded QThread::run function.
+--                          overloaded QThread::run function. Does nothing if the engine is not
+--                          threaded, in which case Poll has to be called by the owner.
 --------------------------------------------------------------------------------------------------*/
 void kgp::IoEngine::Start()
 {
     DependencyManager::Instance().Logger().Log("Io Engine starting");
+    if (!mThreaded) return;
+    // A running thread waits on the deadlines of what was there before
+    wake();
     start();
 }
 
@@ -108,7 +182,8 @@ void kgp::IoEngine::Start()
 --
 -- DATE:                    November 27, 2018
 --
--- REVISIONS:               N/A
+-- REVISIONS:               October 19, 2026 - Benny Wang: Wakes the thread so it sees the engine is
+--                          idle.
 --
 -- DESIGNER:                Benny Wang
 --
@@ -123,6 +198,7 @@ void kgp::IoEngine::Stop()
 {
     DependencyManager::Instance().Logger().Log("Io Engine stopping");
     exit();
+    wake();
 }
 
 /*--------------------------------------------------------------------------------------------------
@@ -130,7 +206,19 @@ void kgp::IoEngine::Stop()
 --
 -- DATE:                    November 27, 2018
 --
--- REVISIONS:               N/A
+-- REVISIONS:               October 19, 2026 - Benny Wang: Forgets the verification of the transfer.
+--                          October 19, 2026 - Benny Wang: Saves the checkpoint of a transfer that
+--                          was cut off.
+--                          October 19, 2026 - Benny Wang: Forgets the path MTU.
+--                          October 19, 2026 - Benny Wang: Keeps the receive window set by the
+--                          owner.
+--                          October 19, 2026 - Benny Wang: Forgets the file of the session in
+--                          progress.
+--                          October 19, 2026 - Benny Wang: Forgets the streams of a multiplexed
+--                          session.
+--                          October 19, 2026 - Benny Wang: Emits transferFinished when a transfer
+--                          under way ends.
+--                          October 19, 2026 - Benny Wang: Hands the last batch over first.
 --
 -- DESIGNER:                Benny Wang
 --
@@ -140,15 +228,27 @@ void kgp::IoEngine::Stop()
 --
 -- NOTES:
 --                          Resets the state of the IoEngine to the default state where the socket
---                          is still bond and there is not connection established yet.
+--                          is still bond and there is not connection established yet. A receiver
+--                          that is reset before the EOT commits what it has received so far, so the
+--                          transfer can be resumed.
 --------------------------------------------------------------------------------------------------*/
 void kgp::IoEngine::Reset()
 {
     DependencyManager::Instance().Logger().Log("Io Engine resetting");
     QMutexLocker locker(&mMutex);
+    // What was received is handed over before the checkpoint and transferFinished
+    flushBatch();
+    // Only a transfer that was under way has finished
+    const bool active = !mState.idle;
+    const bool complete = mState.complete;
+    if ((mState.features & Feature::RESUME) && mState.wait && mState.transferId != 0 && mState.seqNum > mState.checkpointed)
+    {
+        DependencyManager::Instance().Logger().Log("Saving checkpoint at " + QString::number(mState.seqNum).toStdString());
+        saveCheckpoint(mState.seqNum);
+    }
     // Reset state to idle state
     memset(&mState, 0, sizeof(mState));
-    mState.rcvWindowSize = Size::WINDOW;
+    mState.rcvWindowSize = mReceiveWindow;
     mState.idle = true;
     // Reset client values
     mClientAddress.clear();
@@ -158,8 +258,25 @@ void kgp::IoEngine::Reset()
     restartIdleTimer();
     // Reset window
     mWindow.Reset();
+    mFecDecoder.Reset();
+    mChunkHasher.Reset();
+    mTree.Build(std::vector<QByteArray>());
+    mVerifier.Reset();
+    mPathMtu.Reset(Size::DATA);
+    mFramer.Reset();
+    // Reset the streams past stream 0
+    for (SlidingWindow& window : mStreamWindows) window.Reset();
+    for (StreamReceiver& receiver : mStreamReceivers)
+    {
+        receiver.seqNum = receiver.ackNum = 0;
+        receiver.framer.Reset();
+    }
+    mScheduler.Reset();
     // Stop the thread
     Stop();
+    // Listeners may start the next transfer right away
+    locker.unlock();
+    if (active) emit transferFinished(complete);
 }
 
 /*--------------------------------------------------------------------------------------------------
@@ -167,52 +284,74 @@ void kgp::IoEngine::Reset()
 --
 -- DATE:                    November 27, 2018
 --
--- REVISIONS:               N/A
+-- REVISIONS:               October 19, 2026 - Benny Wang: Names the transfer so it can be resumed.
+--                          October 19, 2026 - Benny Wang: Starts a new round trip estimate.
+--                          October 19, 2026 - Benny Wang: Sends the first frame in the SYN and the
+--                          initial window after it when data in the SYN is offered.
+--                          October 19, 2026 - Benny Wang: Sends the next file of an open session
+--                          without a handshake.
+--                          October 19, 2026 - Benny Wang: Leaves the handshake to startTransfer.
+--                          October 19, 2026 - Benny Wang: Sends the file on a stream of its own
+--                          next to the others in a multiplexed session.
+--                          October 19, 2026 - Benny Wang: Refuses a file during the handshake
+--                          of another.
 --
 -- DESIGNER:                Benny Wang
 --
 -- PROGRAMMER:              Benny Wang
 --
--- INTERFACE:               bool kgp::IoEngine::StartFileSend(const std::string& filename, const std::string& address, const short& port)
+-- INTERFACE:               bool kgp::IoEngine::StartFileSend(const std::string& filename, const std::string& address, const short& port, const unsigned priority, const unsigned weight)
 --                              filename: The name of the file to send.
 --                              address: The address to send to.
 --                              port: The port to send the file on.
+--                              priority: The priority of the file in a multiplexed session.
+--                              weight: The share of the file next to files of the same priority.
 --
 -- RETURN:                  True if sending has started, false otherwise.
 --
 -- NOTES:
 --                          Initiates sending. Attempts to open the given file and buffers it in
 --                          the sliding window. Then sends a syn packet and transitions to the waitSyn
---                          state. If buffering the file fails or if the engine is already sending
---                          nothing will happen and false is returned.
+--                          state. If data in the SYN is offered the SYN carries the first frame and
+--                          the rest of the initial window is sent right after it, so a small file
+--                          does not wait a round trip for the handshake. If a session is open to the
+--                          same receiver the file follows the one before on it instead, a session to
+--                          another receiver is closed first. If the session is multiplexed the file
+--                          is sent next to the ones that are still being sent to that receiver, on a
+--                          stream of its own. If buffering the file fails or if the engine is
+--                          already sending nothing will happen and false is returned.
 --------------------------------------------------------------------------------------------------*/
-bool kgp::IoEngine::StartFileSend(const std::string& filename, const std::string& address, const short& port)
+bool kgp::IoEngine::StartFileSend(const std::string& filename, const std::string& address, const short& port, const unsigned priority, const unsigned weight)
 {
     QMutexLocker locker(&mMutex);
 
-    // If not already sending
-    if (!mState.dataSent)
+    const bool sameReceiver = QHostAddress(address.c_str()).toIPv4Address() == mClientAddress.toIPv4Address() && port == mClientPort;
+
+    // A session with another receiver is closed, the file gets a connection of its own
+    if (mState.open && !sameReceiver) closeSession();
+
+    // The next file of a session goes out without a handshake
+    if (mState.open) return sendNextFile(filename, priority, weight);
+
+    // A multiplexed session takes the file next to the ones it is sending
+    if (mState.dataSent && (mState.features & Feature::MULTIPLEX) && sameReceiver) return sendOnStream(filename, priority, weight);
+
+    // If not already sending, the handshake of a file counts as sending it
+    if (!mState.dataSent && !mState.waitSyn)
     {
         DependencyManager::Instance().Logger().Log("Sending file " + filename + " to " + address);
-        // Buffer file
+        mState.offered = mFeatures & ~Feature::BATCH;
+        // Buffer file, the first file of a session starts with its header
         QFile file(filename.c_str());
+        QByteArray header;
+        if (mState.offered & Feature::SESSION) header = streamHeader(1, filename, file);
         // Return false if the file could not be read
-        if (!mWindow.BufferFile(file)) return false;
-        // Set client
-        mClientAddress.setAddress(address.c_str());
-        mClientPort = port;
-        // Send SYN packet
-        Packet synPacket;
-        createSynPacket(&synPacket);
-        send(synPacket, mClientAddress, mClientPort);
-        // Start timeouts
-        restartRcvTimer();
-        restartIdleTimer();
-        // Set state
-        mState.idle = false;
-        mState.waitSyn = true;
-        // Start the thread
-        Start();
+        if (!mWindow.BufferFile(file, header)) return false;
+        if (mState.offered & Feature::SESSION) mState.streamId = 1;
+        mScheduler.Open(0, priority, weight);
+        mState.transferId = Checkpoint::TransferId(file.fileName());
+        mState.transferSize = mWindow.GetSize() - header.size();
+        startTransfer(address, port);
         return true;
     }
     else
@@ -222,30 +361,347 @@ bool kgp::IoEngine::StartFileSend(const std::string& filename, const std::string
     }
 }
 
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::StartDirectorySend
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Refuses a directory during the handshake
+--                          of a file.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::IoEngine::StartDirectorySend(const std::string& directory, const std::string& address, const short& port)
+--                              directory: The directory to send.
+--                              address: The address to send to.
+--                              port: The port to send the directory on.
+--
+-- RETURN:                  True if sending has started, false otherwise.
+--
+-- NOTES:
+--                          Sends every file below the directory as one transfer with a single
+--                          handshake. The files are read into one stream behind their manifest and
+--                          the SYN offers Feature::BATCH whether or not it was set, a receiver that
+--                          does not take part ends the transfer before anything is delivered. An
+--                          open session is closed first. If a file could not be read or if the
+--                          engine is already sending nothing will happen and false is returned.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::IoEngine::StartDirectorySend(const std::string& directory, const std::string& address, const short& port)
+{
+    QMutexLocker locker(&mMutex);
+
+    closeSession();
+
+    if (mState.dataSent || mState.waitSyn)
+    {
+        DependencyManager::Instance().Logger().Error("Already sending");
+        return false;
+    }
+
+    DependencyManager::Instance().Logger().Log("Sending directory " + directory + " to " + address);
+    QByteArray stream;
+    std::vector<StreamFramer::FileEntry> entries;
+    if (!DirectoryReader::Pack(QString::fromStdString(directory), stream, entries)) return false;
+    DependencyManager::Instance().Logger().Log(QString::number(entries.size()).toStdString() + " files packed");
+
+    mState.offered = (mFeatures & ~(Feature::SESSION | Feature::RESUME | Feature::VERIFY | Feature::MULTIPLEX)) | Feature::BATCH;
+    mWindow.BufferData(stream);
+    mState.streamId = entries.size();
+    mState.transferSize = stream.size();
+    startTransfer(address, port);
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::StartSourceSend
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::IoEngine::StartSourceSend(const std::shared_ptr<Source>& source, const std::string& address, const short& port)
+--                              source: Where the data comes from, read on the thread that handles
+--                                      packets.
+--                              address: The address to send to.
+--                              port: The port to send the data on.
+--
+-- RETURN:                  True if sending has started, false otherwise.
+--
+-- NOTES:
+--                          Sends data that is produced as it goes, such as the output of another
+--                          program. Sending starts right away and the window pulls from the source
+--                          as the receiver makes room, the EOT follows once the source has ended and
+--                          everything it gave was ACK'd. The size is not known up front, so the
+--                          features that need it or that send data again after it was ACK'd are not
+--                          offered: sessions, resuming, verifying, data in the SYN, directories and
+--                          streams. A source that cannot be read drops the transfer. An open session
+--                          is closed first. If the engine is already sending nothing will happen and
+--                          false is returned.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::IoEngine::StartSourceSend(const std::shared_ptr<Source>& source, const std::string& address, const short& port)
+{
+    QMutexLocker locker(&mMutex);
+
+    closeSession();
+
+    if (mState.dataSent || mState.waitSyn)
+    {
+        DependencyManager::Instance().Logger().Error("Already sending");
+        return false;
+    }
+
+    DependencyManager::Instance().Logger().Log("Sending from a source to " + address);
+    mState.offered = mFeatures & ~(Feature::SESSION | Feature::RESUME | Feature::VERIFY | Feature::EARLY | Feature::BATCH | Feature::MULTIPLEX);
+    mWindow.BufferSource(source);
+    mSourceTimer.Start();
+    startTransfer(address, port);
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::startTransfer
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoEngine::startTransfer(const std::string& address, const short& port)
+--                              address: The address to send to.
+--                              port: The port to send on.
+--
+-- NOTES:
+--                          Sends the SYN for what was buffered and transitions to the waitSyn state.
+--                          If data in the SYN is offered the SYN carries the first frame and the rest
+--                          of the initial window is sent right after it, so a small transfer does
+--                          not wait a round trip for the handshake.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoEngine::startTransfer(const std::string& address, const short& port)
+{
+    // Set client
+    mClientAddress.setAddress(address.c_str());
+    mClientPort = port;
+    // Send SYN packet, it may carry the first frame with the rest of the initial window after it
+    Packet synPacket;
+    createSynPacket(&synPacket);
+    std::vector<SlidingWindow::Frame> earlyFrames;
+    if (mState.offered & Feature::EARLY) addEarlyData(synPacket, earlyFrames);
+    send(synPacket, mClientAddress, mClientPort);
+    if (!earlyFrames.empty()) sendFrames(earlyFrames, mClientAddress, mClientPort);
+    // Start timeouts, the SYN-ACK gives the first round trip
+    mRtt.Reset(mRcvTimeout, mRcvTimeout);
+    restartRcvTimer();
+    restartIdleTimer();
+    // Set state
+    mState.idle = false;
+    mState.waitSyn = true;
+    // Start the thread
+    Start();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::CloseSession
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Marks the session complete.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoEngine::CloseSession()
+--
+-- NOTES:
+--                          Ends an open session with an EOT and goes back to idle. The session is
+--                          also closed once no file followed the last one within the receive
+--                          timeout, an owner that has nothing more to send closes it right away.
+--                          Does nothing while a file of the session is being sent.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoEngine::CloseSession()
+{
+    QMutexLocker locker(&mMutex);
+    closeSession();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::closeSession
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoEngine::closeSession()
+--
+-- NOTES:
+--                          Closes an open session as CloseSession does, for callers that already
+--                          hold the lock.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoEngine::closeSession()
+{
+    if (!mState.open) return;
+
+    DependencyManager::Instance().Logger().Log("Closing the session, sending EOT");
+    sendEot(mClientAddress, mClientPort);
+    mState.complete = true;
+    Reset();
+}
+
 /*--------------------------------------------------------------------------------------------------
 -- FUNCTION:                kgp::IoEngine::send
 --
 -- DATE:                    November 27, 2018
 --
--- REVISIONS:               N/A
+-- REVISIONS:               October 19, 2026 - Benny Wang: Counts sent packets.
+--                          October 19, 2026 - Benny Wang: Only sends the used part of the packet.
+--                          October 19, 2026 - Benny Wang: Fills in the checksum.
+--                          October 19, 2026 - Benny Wang: Sends probes without fragmenting them.
+--                          October 19, 2026 - Benny Wang: Sends the header and data apart.
 --
 -- DESIGNER:                Benny Wang
 --
 -- PROGRAMMER:              Benny Wang
 --
--- INTERFACE:               void kgp::IoEngine::send(const Packet& packet, const QHostAddress& address, const short& port)
+-- INTERFACE:               qint64 kgp::IoEngine::send(Packet& packet, const QHostAddress& address, const short& port, const bool probe)
 --                              packet: The packet to send.
 --                              address: The address to send the packet to.
 --                              port: The port to send the packet on.
+--                              probe: Whether the packet must not be fragmented on its way.
+--
+-- RETURN:                  The number of bytes sent or -1 on error.
+--
+-- NOTES:
+--                          Sends packet to address on port port over the transport and logs the
+--                          sent packet. Only the header and DataSize bytes of data are sent. If this
+--                          engine supports checksums the checksum of the packet is filled in first,
+--                          peers that do not support them ignore it.
+--------------------------------------------------------------------------------------------------*/
+qint64 kgp::IoEngine::send(Packet& packet, const QHostAddress& address, const short& port, const bool probe)
+{
+    return send(packet.Header, packet.Data, address, port, probe);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::send
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               qint64 kgp::IoEngine::send(PacketHeader& header, const char *data, const QHostAddress& address, const short& port, const bool probe)
+--                              header: The header of the packet to send.
+--                              data: The DataSize bytes of data that follow the header.
+--                              address: The address to send the packet to.
+--                              port: The port to send the packet on.
+--                              probe: Whether the packet must not be fragmented on its way.
+--
+-- RETURN:                  The number of bytes sent or -1 on error.
 --
 -- NOTES:
---                          Sends packet to address on port port using UDP and logs the sent packet.
+--                          Sends a packet whose data is not stored behind its header. The header and
+--                          data are checksummed and handed to the transport where they are, so a
+--                          frame goes out straight from the window without being copied into a
+--                          packet first.
 --------------------------------------------------------------------------------------------------*/
-void kgp::IoEngine::send(const Packet& packet, const QHostAddress& address, const short& port)
+qint64 kgp::IoEngine::send(PacketHeader& header, const char *data, const QHostAddress& address, const short& port, const bool probe)
 {
-    mSocket.writeDatagram((char *)&packet, sizeof(packet), address, port);
+    header.Checksum = 0;
+    if (mFeatures & Feature::CHECKSUM) header.Checksum = Crc32c::ComputePacket(header, data);
+    const qint64 dataSize = std::min<quint64>(header.DataSize, Size::MAX_DATA);
+    const qint64 sent = mTransport->SendGather((const char *)&header, Size::HEADER, data, dataSize, address, port, probe);
+    mStats.packetsSent++;
     DependencyManager::Instance().Logger().Log("Sending packet ...");
-    DependencyManager::Instance().Logger().LogPacket(packet, address);
+    DependencyManager::Instance().Logger().LogPacket(header, data, address);
+    return sent;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::sendProbe
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoEngine::sendProbe(const QHostAddress& client, const short& port)
+--                              client: The host to send to.
+--                              port: The port to send on.
+--
+-- NOTES:
+--                          Sends the next path MTU probe if one is due. A probe that cannot even
+--                          leave this host is too large, the next one is tried right away.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoEngine::sendProbe(const QHostAddress& client, const short& port)
+{
+    if (!(mState.features & Feature::PMTU)) return;
+
+    quint64 size;
+    while (mPathMtu.NextProbe(size))
+    {
+        Packet probe;
+        memset(&probe, 0, Size::HEADER + size);
+        probe.Header.PacketType = PacketType::PROBE;
+        probe.Header.WindowSize = mState.rcvWindowSize;
+        probe.Header.DataSize = size;
+
+        mStats.probesSent++;
+        if (send(probe, client, port, true) >= 0) break;
+
+        DependencyManager::Instance().Logger().Log("Probe of " + QString::number(size).toStdString() + " bytes is too large to send");
+        mPathMtu.ProbeTooBig(size);
+        updateFrameSize();
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::sendWindowProbe
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Leaves counting window probes to the
+--                          caller.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoEngine::sendWindowProbe(const QHostAddress& client, const short& port)
+--                              client: The receiver.
+--                              port: The port of the receiver.
+--
+-- NOTES:
+--                          Asks the receiver for its window. The update it sends once it has room
+--                          again can be lost, without a probe both sides would wait for each other.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoEngine::sendWindowProbe(const QHostAddress& client, const short& port)
+{
+    Packet probe;
+    memset(&probe.Header, 0, sizeof(probe.Header));
+    probe.Header.PacketType = PacketType::WINDOW;
+    probe.Header.SequenceNumber = mWindow.GetHead();
+    probe.Header.WindowSize = mState.rcvWindowSize;
+
+    send(probe, client, port);
 }
 
 /*--------------------------------------------------------------------------------------------------
@@ -253,36 +709,98 @@ void kgp::IoEngine::send(const Packet& packet, const QHostAddress& address, cons
 --
 -- DATE:                    November 27, 2018
 --
--- REVISIONS:               N/A
+-- REVISIONS:               October 19, 2026 - Benny Wang: Counts sent and resent frames.
+--                          October 19, 2026 - Benny Wang: Sends parity when FEC is negotiated.
+--                          October 19, 2026 - Benny Wang: Compresses frames when negotiated.
+--                          October 19, 2026 - Benny Wang: Hashes new frames for verification.
+--                          October 19, 2026 - Benny Wang: Sizes FEC groups by the frame size and
+--                          only clears the header of a frame.
+--                          October 19, 2026 - Benny Wang: Sends frames from where they are without
+--                          copying them into a packet.
+--                          October 19, 2026 - Benny Wang: Names the stream of the frames.
 --
 -- DESIGNER:                Benny Wang
 --
 -- PROGRAMMER:              Benny Wang
 --
--- INTERFACE:               void kgp::IoEngine::sendFrames(std::vector<SlidingWindow::Frame> list, const QHostAddress& client, const short& port)
+-- INTERFACE:               void kgp::IoEngine::sendFrames(const std::vector<SlidingWindow::Frame>& list, const QHostAddress& client, const short& port, const bool resend, const quint64 stream)
 --                              list: The list of frames to send.
 --                              client: The host to send to.
 --                              port: The port to send on.
+--                              resend: Whether the frames have been sent before.
+--                              stream: The stream the frames are on.
 --
 -- NOTES:
---                          Sends the list of frames to client on port port.
+--                          Sends the list of frames to client on port port. If compression was
+--                          negotiated every frame that compresses well enough is sent compressed.
+--                          If FEC was negotiated the frames are followed by parity frames, the more
+--                          frames have been lost on this connection the more parity is sent. The
+--                          parity always covers the uncompressed frames. If verification was
+--                          negotiated frames that are sent for the first time are hashed, they are
+--                          handed out in order so the file is hashed as it is sent. Only the header
+--                          of a frame is built here, the transport is handed its data where the
+--                          window or the compressor keeps it. If streams were offered the window
+--                          size of every frame names its stream, which is 0 for frames sent before
+--                          the receiver answered.
 --------------------------------------------------------------------------------------------------*/
-void kgp::IoEngine::sendFrames(std::vector<SlidingWindow::Frame> list, const QHostAddress& client, const short& port)
+void kgp::IoEngine::sendFrames(const std::vector<SlidingWindow::Frame>& list, const QHostAddress& client, const short& port, const bool resend, const quint64 stream)
 {
-    for (auto frame : list)
+    // Only the fields that differ between frames are filled in per frame
+    PacketHeader header;
+    memset(&header, 0, sizeof(header));
+    header.PacketType = PacketType::DATA;
+    header.WindowSize = (mState.offered & Feature::MULTIPLEX) ? stream : mState.rcvWindowSize;
+
+    QByteArray compressed;
+    for (const auto& frame : list)
     {
-        Packet framePacket;
-        memset(&framePacket, 0, sizeof(framePacket));
+        if (!resend && (mState.features & Feature::VERIFY)) mChunkHasher.Add(frame.data, frame.size);
+
+        header.SequenceNumber = frame.seqNum;
+        header.AckNumber = 0;
+        header.DataSize = frame.size;
+        const char *data = frame.data;
+
+        // The AckNumber of a compressed frame is its uncompressed size
+        if ((mState.features & Feature::COMPRESS) && mCompressor.Compress(frame, compressed))
+        {
+            header.AckNumber = frame.size;
+            header.DataSize = compressed.size();
+            data = compressed.constData();
+            mStats.bytesSaved += frame.size - compressed.size();
+        }
+
+        // The data goes out from the window or the compressor, it is never copied into a packet
+        send(header, data, client, port);
+
+        if (resend) mStats.framesResent++;
+        else mStats.framesSent++;
+        mStats.bytesSent += frame.size;
+    }
 
-        framePacket.Header.PacketType = PacketType::DATA;
-        framePacket.Header.SequenceNumber = frame.seqNum;
-        framePacket.Header.AckNumber = 0;
-        framePacket.Header.WindowSize = mState.rcvWindowSize;
-        framePacket.Header.DataSize = frame.size;
+    if (resend) mState.resends++;
+    else mState.framesSent += list.size();
 
-        memcpy(framePacket.Data, frame.data, frame.size);
+    // Follow the frames with their parity
+    if (mState.features & Feature::FEC)
+    {
+        // Every resend and every rebuilt frame means at least one frame was lost. A resend covers
+        // the whole window so counting the resent frames would overstate the loss
+        mFecEncoder.SetLoss(mState.framesSent, mState.resends + mState.fecRecovered);
+        // A block has to fit in the window after a lost frame, or the frames that complete it are
+        // never sent since the receiver stops ACKing at the lost frame
+        const quint64 windowFrames = mWindow.GetWindowSize() / mWindow.GetFrameSize();
+        mFecEncoder.SetGroupSize(windowFrames > 2 ? windowFrames - 2 : 1);
 
-        send(framePacket, client, port);
+        std::vector<Packet> parity;
+        mFecEncoder.Encode(list, parity);
+        // Nothing follows a resend or the last frame until the receiver answers
+        if (resend || mWindow.IsAllSent()) mFecEncoder.Flush(parity);
+        for (Packet& packet : parity)
+        {
+            send(packet, client, port);
+            mStats.paritySent++;
+        }
     }
 }
 
@@ -291,44 +809,97 @@ void kgp::IoEngine::sendFrames(std::vector<SlidingWindow::Frame> list, const QHo
 --
 -- DATE:                    November 27, 2018
 --
--- REVISIONS:               N/A
+-- REVISIONS:               October 19, 2026 - Benny Wang: Waits for verification after the EOT.
+--                          October 19, 2026 - Benny Wang: Probes the path MTU next to the data.
+--                          October 19, 2026 - Benny Wang: Frames sent on a duplicate ACK leave the
+--                          receive timer running.
+--                          October 19, 2026 - Benny Wang: Holds the session open after the last
+--                          frame of a file.
+--                          October 19, 2026 - Benny Wang: Counts the files of a directory once it
+--                          is sent.
+--                          October 19, 2026 - Benny Wang: Leaves multiplexed sessions to
+--                          sendStreams.
+--                          October 19, 2026 - Benny Wang: Marks the transfer complete once the EOT
+--                          is sent.
+--                          October 19, 2026 - Benny Wang: Drops the transfer when its source cannot
+--                          be read.
 --
 -- DESIGNER:                Benny Wang
 --
 -- PROGRAMMER:              Benny Wang
 --
--- INTERFACE:               void kgp::IoEngine::sendWindow(const QHostAddress& client, const short& port)
+-- INTERFACE:               void kgp::IoEngine::sendWindow(const QHostAddress& client, const short& port, const bool progress)
 --                              client: The client to send to.
 --                              port: The port to send on.
+--                              progress: Whether the receiver got something new since the last call.
 --
 -- NOTES:
 --                          Sends the window to the client on port port. Will grab a list of frames
 --                          from the sliding window and then sends it to the client. If the window
---                          has no more frames to send then an EOT packet is sent instead.
+--                          has no more frames to send then an EOT packet is sent instead. If
+--                          verification was negotiated the EOT carries the root of the file and the
+--                          file is kept until the receiver is done with it. In a session no EOT is
+--                          sent, the connection is held for the next file. Without progress new
+--                          frames leave the receive timer running, so frames sent before them are
+--                          still resent on time when all the receiver did was open its window. The
+--                          streams of a multiplexed session are left to sendStreams.
 --------------------------------------------------------------------------------------------------*/
-void kgp::IoEngine::sendWindow(const QHostAddress& client, const short& port)
+void kgp::IoEngine::sendWindow(const QHostAddress& client, const short& port, const bool progress)
 {
-    if (mWindow.IsEot())
+    if (mState.features & Feature::MULTIPLEX)
+    {
+        sendStreams(client, port, progress);
+    }
+    else if (mWindow.IsEot() && (mState.features & Feature::SESSION))
+    {
+        mStats.filesSent++;
+        holdSession();
+    }
+    else if (mWindow.IsEot())
     {
         DependencyManager::Instance().Logger().Log("Transmission finished, sending EOT");
-        sendEot(client, port);
-        Reset();
+        if (mState.features & Feature::VERIFY)
+        {
+            mTree.Build(mChunkHasher.Finish());
+            mState.dataSent = false;
+            mState.waitVerify = true;
+            sendEot(client, port);
+            restartRcvTimer();
+        }
+        else
+        {
+            // Every file of a directory was in the one transfer
+            if (mState.features & Feature::BATCH) mStats.filesSent += mState.streamId;
+            sendEot(client, port);
+            mState.complete = true;
+            Reset();
+        }
     }
     else
     {
         DependencyManager::Instance().Logger().Log("Transmission unfinished, sending data");
         std::vector<SlidingWindow::Frame> frames;
         mWindow.GetNextFrames(frames);
-        sendFrames(frames, client, port);
-        restartRcvTimer();
+        if (mWindow.HasFailed())
+        {
+            Reset();
+            return;
+        }
+        // Only new data restarts the receive timer, otherwise duplicate ACKs could hold off a resend forever
+        if (!frames.empty())
+        {
+            sendFrames(frames, client, port);
+            if (progress) restartRcvTimer();
+        }
         mState.dataSent = true;
+        sendProbe(client, port);
     }
 }
 
 /*--------------------------------------------------------------------------------------------------
--- FUNCTION:                kgp::IoEngine::newDataHandler
+-- FUNCTION:                kgp::IoEngine::sendFromSource
 --
--- DATE:                    November 27, 2018
+-- DATE:                    October 19, 2026
 --
 -- REVISIONS:               N/A
 --
@@ -336,38 +907,1049 @@ void kgp::IoEngine::sendWindow(const QHostAddress& client, const short& port)
 --
 -- PROGRAMMER:              Benny Wang
 --
--- INTERFACE:               void kgp::IoEngine::newDataHandler()
+-- INTERFACE:               void kgp::IoEngine::sendFromSource()
 --
 -- NOTES:
---                          Callback function for when new data appears on the socket to be read.
---                          Will read packets from the socket until all packets are handled. After
---                          validating the packet size, the packet is handled according to protocol.
+--                          Asks the source of the window for more and sends whatever fits in the
+--                          window. ACKs only come for what was sent, so a source that had nothing
+--                          when the last one came is asked again every Timeout::SOURCE by Poll.
 --------------------------------------------------------------------------------------------------*/
-void kgp::IoEngine::newDataHandler()
+void kgp::IoEngine::sendFromSource()
 {
-    while (mSocket.hasPendingDatagrams())
-    {
-        // Read in packet
-        Packet buffer;
-        //quint64 sizeRead = mSocket.readDatagram((char *)&buffer, Size::DATA, &sender, &port);
-        QNetworkDatagram datagram = mSocket.receiveDatagram();
+    mSourceTimer.Start();
 
+    std::vector<SlidingWindow::Frame> frames;
+    mWindow.GetNextFrames(frames);
+    if (mWindow.HasFailed())
+    {
+        Reset();
+        return;
+    }
+    if (!frames.empty()) sendFrames(frames, mClientAddress, mClientPort);
+}
 
-        // If less than a header was read print error and continue
-        if (datagram.data().size() < sizeof(struct PacketHeader))
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::sendStreams
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoEngine::sendStreams(const QHostAddress& client, const short& port, const bool progress)
+--                              client: The client to send to.
+--                              port: The port to send on.
+--                              progress: Whether the receiver got something new since the last call.
+--
+-- NOTES:
+--                          Sends the streams of a multiplexed session. A stream whose last frame
+--                          was ACK'd is done with its file and the session is held once every
+--                          stream is. The room the receiver advertised is shared by all streams and
+--                          handed out a frame at a time, the scheduler picks the stream that sends
+--                          each one. A stream that lost a frame resends it on its own timeout while
+--                          the others go on.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoEngine::sendStreams(const QHostAddress& client, const short& port, const bool progress)
+{
+    bool busy = false;
+    for (quint64 stream = 0; stream < Multiplex::STREAMS; stream++)
+    {
+        if (mScheduler.IsOpen(stream) && streamWindow(stream).IsEot())
         {
-            DependencyManager::Instance().Logger().Error("Not enough data was read from " + datagram.senderAddress().toString().toStdString());
+            DependencyManager::Instance().Logger().Log("File on stream " + QString::number(stream).toStdString() + " sent");
+            mScheduler.Close(stream);
+            mStats.filesSent++;
+        }
+        busy = busy || mScheduler.IsOpen(stream);
+    }
+    if (!busy)
+    {
+        holdSession();
+        return;
+    }
+
+    DependencyManager::Instance().Logger().Log("Transmission unfinished, sending data");
+    quint64 outstanding = streamOutstanding();
+    std::vector<bool> ready(Multiplex::STREAMS);
+    std::vector<SlidingWindow::Frame> frames;
+    bool sent = false;
+    while (outstanding < mState.streamRoom)
+    {
+        for (quint64 stream = 0; stream < Multiplex::STREAMS; stream++) ready[stream] = !streamWindow(stream).IsAllSent();
+        size_t stream;
+        if (!mScheduler.Next(ready, stream)) break;
+
+        // The window of the stream ends where its next frame does
+        SlidingWindow& window = streamWindow(stream);
+        window.SetWindowSize(window.GetPointer() - window.GetHead() + std::min(window.GetFrameSize(), mState.streamRoom - outstanding));
+        frames.clear();
+        window.GetNextFrames(frames);
+        if (frames.empty()) break;
+
+        sendFrames(frames, client, port, false, stream);
+        for (const auto& frame : frames) outstanding += frame.size;
+        sent = true;
+    }
+    // Only new data restarts the receive timer, otherwise duplicate ACKs could hold off a resend forever
+    if (sent && progress) restartRcvTimer();
+    mState.dataSent = true;
+    sendProbe(client, port);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::sendNextFile
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Gives the file its priority.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::IoEngine::sendNextFile(const std::string& filename, const unsigned priority, const unsigned weight)
+--                              filename: The name of the file to send.
+--                              priority: The priority of the file in a multiplexed session.
+--                              weight: The share of the file next to files of the same priority.
+--
+-- RETURN:                  True if sending has started, false if the file could not be read.
+--
+-- NOTES:
+--                          Sends a file on the open session. The file starts at the sequence number
+--                          the one before ended at, with its header in front of it. What was learned
+--                          about the connection is kept: the round trip, the payload the path
+--                          carries and the room the receiver advertised, which is counted from the
+--                          last frame of the file before. If the file could not be read the session
+--                          stays open.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::IoEngine::sendNextFile(const std::string& filename, const unsigned priority, const unsigned weight)
+{
+    DependencyManager::Instance().Logger().Log("Sending file " + filename + " on the open session");
+    const quint64 windowEnd = mWindow.GetHead() + mWindow.GetWindowSize();
+
+    QFile file(filename.c_str());
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        DependencyManager::Instance().Logger().Error("Could not buffer the file: " + filename);
+        return false;
+    }
+    // Buffering resets the window it reads into, so the file is read into a copy that only
+    // replaces the window, which still holds the file before, once the file was read
+    SlidingWindow next(mWindow);
+    if (!next.BufferFile(file, streamHeader(mState.streamId + 1, filename, file), mState.streamBase)) return false;
+    mWindow = next;
+    mState.streamId++;
+    mWindow.SetWindowSize(windowEnd > mState.streamBase ? windowEnd - mState.streamBase : 0);
+    updateFrameSize();
+    mScheduler.Open(0, priority, weight);
+
+    mState.open = false;
+    restartIdleTimer();
+    sendWindow(mClientAddress, mClientPort);
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::holdSession
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Leaves counting the file to the caller.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoEngine::holdSession()
+--
+-- NOTES:
+--                          Called once the last frame of a file of a session was ACK'd. The next
+--                          file starts where this one ended and the receive timer gives it until the
+--                          timeout to be started.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoEngine::holdSession()
+{
+    DependencyManager::Instance().Logger().Log("File sent, holding the session open");
+    mState.streamBase = mWindow.GetEnd();
+    mState.dataSent = false;
+    mState.open = true;
+    restartRcvTimer();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::sendOnStream
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Only takes the stream and counts the file
+--                          once the file was read.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::IoEngine::sendOnStream(const std::string& filename, const unsigned priority, const unsigned weight)
+--                              filename: The name of the file to send.
+--                              priority: The priority of the file, smaller goes first.
+--                              weight: The share of the file next to files of the same priority.
+--
+-- RETURN:                  True if sending has started, false if every stream is busy or the file
+--                          could not be read.
+--
+-- NOTES:
+--                          Sends a file of a multiplexed session while other files are still being
+--                          sent. It goes on the first stream that is done with its file, starting
+--                          where the file before on that stream ended, with its header in front of
+--                          it.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::IoEngine::sendOnStream(const std::string& filename, const unsigned priority, const unsigned weight)
+{
+    quint64 stream = 0;
+    while (stream < Multiplex::STREAMS && mScheduler.IsOpen(stream)) stream++;
+    if (stream == Multiplex::STREAMS)
+    {
+        DependencyManager::Instance().Logger().Error("Every stream of the session is busy");
+        return false;
+    }
+
+    QFile file(filename.c_str());
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        DependencyManager::Instance().Logger().Error("Could not buffer the file: " + filename);
+        return false;
+    }
+    DependencyManager::Instance().Logger().Log("Sending file " + filename + " on stream " + QString::number(stream).toStdString());
+    // The file is read into a copy so that a file that cannot be read leaves the stream where the
+    // file before on it ended
+    SlidingWindow& window = streamWindow(stream);
+    SlidingWindow next(window);
+    if (!next.BufferFile(file, streamHeader(mState.streamId + 1, filename, file), window.GetEnd())) return false;
+    window = next;
+    mState.streamId++;
+    updateFrameSize();
+    mScheduler.Open(stream, priority, weight);
+
+    sendWindow(mClientAddress, mClientPort);
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::ackStream
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoEngine::ackStream(const PacketHeader& ack, const QHostAddress& client, const short& port)
+--                              ack: The header of an ACK of a multiplexed session.
+--                              client: The client that sent the ACK.
+--                              port: The port the ACK came from.
+--
+-- NOTES:
+--                          Moves the window of the stream the ACK names. Every valid ACK carries the
+--                          room the receiver has for all streams, a stale one at worst has a frame
+--                          turned down that is resent on its timeout.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoEngine::ackStream(const PacketHeader& ack, const QHostAddress& client, const short& port)
+{
+    if (ack.SequenceNumber >= Multiplex::STREAMS)
+    {
+        DependencyManager::Instance().Logger().Error("ACK for unknown stream " + QString::number(ack.SequenceNumber).toStdString() + " received");
+        return;
+    }
+
+    SlidingWindow& window = streamWindow(ack.SequenceNumber);
+    const quint64 head = window.GetHead();
+    if (!window.AckFrame(ack.AckNumber))
+    {
+        DependencyManager::Instance().Logger().Error("Unexpected ACK received(" + QString::number(ack.AckNumber).toStdString() + ")");
+        return;
+    }
+
+    quint64 rtt;
+    if (window.TakeRttSample(rtt)) addRttSample(rtt);
+    mState.streamRoom = ack.WindowSize;
+    sendWindow(client, port, window.GetHead() != head);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::receiveStream
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoEngine::receiveStream(const PacketHeader& header, const char *data, const size_t size, const QHostAddress& client, const short& port)
+--                              header: The header of a DATA frame of a multiplexed session.
+--                              data: The frame as it was read from the file.
+--                              size: The number of bytes of the frame.
+--                              client: The host that is sending.
+--                              port: The port the host is sending on.
+--
+-- NOTES:
+--                          Takes the frame if it is the next one of its stream, a frame that is
+--                          missing only holds up the stream it was on. The frame is delivered
+--                          before it is ACK'd so that the ACK carries the room that is left after
+--                          it, an earlier frame is ACK'd again since its ACK may have been lost.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoEngine::receiveStream(const PacketHeader& header, const char *data, const size_t size, const QHostAddress& client, const short& port)
+{
+    const quint64 stream = header.WindowSize;
+    if (stream >= Multiplex::STREAMS)
+    {
+        DependencyManager::Instance().Logger().Error("Frame for unknown stream " + QString::number(stream).toStdString() + " received");
+        return;
+    }
+
+    quint64& seqNum = stream == 0 ? mState.seqNum : mStreamReceivers[stream - 1].seqNum;
+    quint64& ackNum = stream == 0 ? mState.ackNum : mStreamReceivers[stream - 1].ackNum;
+    if (header.SequenceNumber > seqNum)
+    {
+        DependencyManager::Instance().Logger().Error("Invalid packet received on stream " + QString::number(stream).toStdString() + ", expecting sequence number " + QString::number(seqNum).toStdString());
+    }
+    else if (header.SequenceNumber < seqNum)
+    {
+        ackPacket(header.SequenceNumber, client, port, stream);
+    }
+    // A sender that runs past the window gets nothing, it finds out with its next probe
+    else if (size > receiveRoom())
+    {
+        DependencyManager::Instance().Logger().Error("No room for frame " + QString::number(header.SequenceNumber).toStdString() + " of stream " + QString::number(stream).toStdString());
+    }
+    else
+    {
+        deliverStream(stream, data, size);
+        ackNum = seqNum;
+        seqNum += size;
+        ackPacket(ackNum, client, port, stream);
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::deliverFrames
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Shares the rebuilt frames with the batch
+--                          sink.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoEngine::deliverFrames(const QHostAddress& client, const short& port)
+--                              client: The host that is sending.
+--                              port: The port the host is sending on.
+--
+-- NOTES:
+--                          Rebuilds what it can from parity and then delivers every frame that is
+--                          next in order. The last delivered frame is ACK'd, nothing is ACK'd if
+--                          the next frame is still missing.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoEngine::deliverFrames(const QHostAddress& client, const short& port)
+{
+    mStats.framesRecovered += mFecDecoder.Recover();
+
+    bool delivered = false;
+    while (const QByteArray *frame = mFecDecoder.Find(mState.seqNum))
+    {
+        // Signal new data was read
+        deliver(mState.seqNum, frame->constData(), frame->size(), *frame);
+        // Remember the last frame that was delivered and increment sequence number counter
+        mState.ackNum = mState.seqNum;
+        mState.seqNum += frame->size();
+        delivered = true;
+    }
+    mFecDecoder.Release(mState.seqNum);
+
+    if (delivered) ackPacket(mState.ackNum, client, port);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::deliverStream
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Splits every stream of a multiplexed
+--                          session on its own and names the file of the bytes.
+--                          October 19, 2026 - Benny Wang: Gathers the bytes of the files in batches
+--                          when there is a batch sink.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoEngine::deliverStream(const quint64 stream, const char *data, const size_t size)
+--                              stream: The stream of the session the bytes are on.
+--                              data: The next bytes of the stream.
+--                              size: The number of bytes.
+--
+-- NOTES:
+--                          Splits the bytes of a session into its files. Only the bytes of the files
+--                          are handed to dataRead and held against the receive window, each file is
+--                          announced with fileStarted before its first byte and fileFinished after
+--                          its last. Once a header is damaged nothing more of the session is handed
+--                          out, there is no telling where the next file starts. The bytes of a file
+--                          also go to fileDataRead along with its ID, the files on the streams of a
+--                          multiplexed session arrive at the same time. A batch sink gets copies of
+--                          the bytes, the framer may have put a file's bytes together from frames.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoEngine::deliverStream(const quint64 stream, const char *data, const size_t size)
+{
+    StreamFramer& framer = stream == 0 ? mFramer : mStreamReceivers[stream - 1].framer;
+    std::vector<StreamFramer::Event> events;
+    if (!framer.Add(data, size, events))
+    {
+        DependencyManager::Instance().Logger().Error("Damaged file header received from " + mClientAddress.toString().toStdString());
+    }
+
+    for (const auto& event : events)
+    {
+        switch (event.type)
+        {
+        case StreamFramer::EventType::START:
+            DependencyManager::Instance().Logger().Log("Receiving file " + event.name.toStdString() + " of " + QString::number(event.size).toStdString() + " bytes");
+            // The bytes of the file before go out before the file is announced
+            flushBatch();
+            emit fileStarted(event.id, event.name, event.size);
+            break;
+        case StreamFramer::EventType::DATA:
+            if (mDeferRelease) mState.rcvHeld += event.size;
+            if (mBatchSink) batch(event.data, event.size, QByteArray());
+            else emit dataRead(event.data, event.size);
+            emit fileDataRead(event.id, event.data, event.size);
+            mStats.bytesRead += event.size;
+            break;
+        case StreamFramer::EventType::END:
+            mStats.filesReceived++;
+            flushBatch();
+            emit fileFinished(event.id);
+            break;
+        }
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::batch
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoEngine::batch(const char *data, const size_t size, const QByteArray& owner)
+--                              data: The next bytes of the transfer.
+--                              size: The number of bytes.
+--                              owner: The buffer data is in, empty if it cannot be shared.
+--
+-- NOTES:
+--                          Adds the bytes to the batch for the sink. Bytes that are not in a buffer
+--                          that can be shared are copied into one of their own. The batch is handed
+--                          over once it holds a receive window's worth.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoEngine::batch(const char *data, const size_t size, const QByteArray& owner)
+{
+    if (size == 0) return;
+
+    if (owner.isEmpty()) mBatch.push_back({ QByteArray(data, (int)size), 0, size });
+    else mBatch.push_back({ owner, (size_t)(data - owner.constData()), size });
+    mBatchBytes += size;
+
+    if (mBatchBytes >= mState.rcvWindowSize) flushBatch();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::flushBatch
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoEngine::flushBatch()
+--
+-- NOTES:
+--                          Hands the batch to the sink and then saves the checkpoint that came due
+--                          while it was gathered. Nothing happens if the batch is empty.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoEngine::flushBatch()
+{
+    if (mBatch.empty()) return;
+
+    mStats.batches++;
+    mBatchSink(mBatch);
+    mBatch.clear();
+    mBatchBytes = 0;
+
+    if (mBatchCommit > 0 && (mState.features & Feature::RESUME) && mState.transferId != 0) saveCheckpoint(mBatchCommit);
+    mBatchCommit = 0;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::resumeReceive
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Reads the packet in place.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoEngine::resumeReceive(const PacketView& syn)
+--                              syn: The SYN of the sender.
+--
+-- NOTES:
+--                          Looks the transfer in the SYN up in the checkpoint and expects the first
+--                          byte that has not been committed next. A transfer that was committed
+--                          completely resumes at its last byte, so that the sender still has a frame
+--                          to end the transfer with. A SYN that offers resuming without saying what
+--                          to resume turns it off for the connection.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoEngine::resumeReceive(const PacketView& syn)
+{
+    if (!(mState.features & Feature::RESUME)) return;
+
+    ResumeOptions options;
+    if (!readResumeOptions(syn, options) || options.TransferId == 0)
+    {
+        mState.features &= ~Feature::RESUME;
+        return;
+    }
+    mState.transferId = options.TransferId;
+    mState.transferSize = options.Size;
+
+    mCheckpoint.Load();
+    quint64 offset = mCheckpoint.Offset(options.TransferId, options.Size);
+    if (offset >= options.Size) offset = options.Size > 0 ? options.Size - 1 : 0;
+    if (offset > 0) DependencyManager::Instance().Logger().Log("Resuming transfer at " + QString::number(offset).toStdString());
+
+    mState.offset = mState.seqNum = mState.checkpointed = offset;
+    // An ACK that is resent before anything arrives must not read as the ACK for the first frame
+    mState.ackNum = offset > 0 ? offset - 1 : 0;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::resumeSend
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Reads the packet in place.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoEngine::resumeSend(const PacketView& ack)
+--                              ack: The ACK for the SYN.
+--
+-- NOTES:
+--                          Starts the window at the offset the receiver answered with. The offset is
+--                          only used if the receiver echoes this transfer and it is inside the file,
+--                          otherwise the file is sent from the start.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoEngine::resumeSend(const PacketView& ack)
+{
+    if (!(mState.features & Feature::RESUME)) return;
+
+    ResumeOptions options;
+    if (!readResumeOptions(ack, options) || options.Offset == 0) return;
+    if (options.TransferId != mState.transferId || options.Size != mState.transferSize || options.Offset >= mState.transferSize)
+    {
+        DependencyManager::Instance().Logger().Error("Invalid resume offset " + QString::number(options.Offset).toStdString() + " received");
+        return;
+    }
+
+    DependencyManager::Instance().Logger().Log("Resuming transfer at " + QString::number(options.Offset).toStdString());
+    mWindow.StartAt(options.Offset);
+    mState.offset = options.Offset;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::addEarlyData
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoEngine::addEarlyData(Packet& syn, std::vector<SlidingWindow::Frame>& frames)
+--                              syn: The SYN to add the first frame to.
+--                              frames: Gets the frames of the initial window that follow the SYN.
+--
+-- NOTES:
+--                          Appends the early options and the first frame of the file to the SYN. The
+--                          SYN is kept to Size::MIN_DATA bytes of data so that every path carries it,
+--                          the first frame is cut to what is left of that. The rest of Size::WINDOW
+--                          is handed out as usual and goes out before the SYN-ACK, the features that
+--                          change frames are not negotiated yet so these frames are sent as they are.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoEngine::addEarlyData(Packet& syn, std::vector<SlidingWindow::Frame>& frames)
+{
+    EarlyOptions options;
+    options.Nonce = ReplayFilter::NewNonce();
+    options.Size = mState.transferSize;
+    options.Accepted = 0;
+    memcpy(syn.Data + syn.Header.DataSize, &options, sizeof(options));
+    syn.Header.DataSize += sizeof(options);
+    mState.earlyNonce = options.Nonce;
+
+    std::vector<SlidingWindow::Frame> first;
+    mWindow.SetWindowSize(Size::MIN_DATA - syn.Header.DataSize);
+    mWindow.GetNextFrames(first);
+    mWindow.SetWindowSize(Size::WINDOW);
+    if (first.empty()) return;
+
+    memcpy(syn.Data + syn.Header.DataSize, first.front().data, first.front().size);
+    syn.Header.DataSize += first.front().size;
+    mState.earlyData = first.front().size;
+    mState.framesSent++;
+    mStats.framesSent++;
+    mStats.bytesSent += first.front().size;
+
+    mWindow.GetNextFrames(frames);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::acceptEarlyData
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Refuses the frame of a session the
+--                          receiver turned down.
+--                          October 19, 2026 - Benny Wang: Refuses the frame of a directory the
+--                          receiver turned down.
+--                          October 19, 2026 - Benny Wang: Reads the packet in place.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoEngine::acceptEarlyData(const PacketView& syn)
+--                              syn: The SYN of the sender.
+--
+-- NOTES:
+--                          Delivers the first frame the SYN carries. The frame is refused if its
+--                          nonce was seen before, since the SYN was then duplicated or replayed, if
+--                          the transfer resumes past it or if it does not fit into the window. The
+--                          sender learns from the SYN-ACK and sends the frame again. A SYN that
+--                          offers data without carrying the options turns it off for the connection.
+--                          The frame of a SYN that offers a session or directory the receiver does
+--                          not take part in starts with a header or manifest it would hand out as
+--                          file data, so it is refused.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoEngine::acceptEarlyData(const PacketView& syn)
+{
+    if (!(mState.features & Feature::EARLY)) return;
+
+    EarlyOptions options;
+    quint64 at;
+    if (!readEarlyOptions(syn, options, at))
+    {
+        mState.features &= ~Feature::EARLY;
+        return;
+    }
+    mState.earlyNonce = options.Nonce;
+    if (mState.transferSize == 0) mState.transferSize = options.Size;
+
+    const quint64 size = syn.Header.DataSize - at;
+    if (size == 0) return;
+    // The nonce is remembered whether or not the frame is taken
+    // The data of a session or directory starts with a header or manifest, which only a peer that takes
+    // part reads
+    SynOptions offered;
+    memcpy(&offered, syn.Data, sizeof(offered));
+    const bool unframed = (offered.Features & ~mState.features & (Feature::SESSION | Feature::BATCH)) != 0;
+    if (!mReplayFilter.Admit(options.Nonce) || mState.seqNum != 0 || size > receiveRoom() || unframed)
+    {
+        DependencyManager::Instance().Logger().Log("Refusing the data in the SYN");
+        mStats.earlyRefused++;
+        return;
+    }
+
+    deliver(0, syn.Data + at, size);
+    mState.ackNum = 0;
+    mState.seqNum = mState.earlyData = size;
+    mStats.earlyBytes += size;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::finishEarlyData
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Reads the packet in place.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoEngine::finishEarlyData(const PacketView& ack)
+--                              ack: The ACK for the SYN.
+--
+-- NOTES:
+--                          Settles the frames that were sent before the SYN-ACK. If the receiver
+--                          echoes the nonce and took the whole first frame the SYN-ACK counts as its
+--                          ACK. A resumed transfer has already moved past these frames. Otherwise
+--                          the receiver still expects the first byte and every frame in flight is
+--                          sent again. If verification was negotiated the frames that were handed out
+--                          are hashed now, they were sent before the hasher was in use.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoEngine::finishEarlyData(const PacketView& ack)
+{
+    if (mState.earlyData == 0) return;
+
+    EarlyOptions options;
+    quint64 at;
+    const bool accepted = (mState.features & Feature::EARLY) && readEarlyOptions(ack, options, at)
+        && options.Nonce == mState.earlyNonce && options.Accepted == mState.earlyData;
+
+    if (mState.offset > 0)
+    {
+        DependencyManager::Instance().Logger().Log("Transfer resumed past the data in the SYN");
+    }
+    else if (accepted)
+    {
+        DependencyManager::Instance().Logger().Log("Data in the SYN was delivered");
+        mWindow.AckFrame(0);
+        // The SYN-ACK already gave the round trip of the SYN
+        quint64 rtt;
+        mWindow.TakeRttSample(rtt);
+    }
+    else
+    {
+        DependencyManager::Instance().Logger().Log("Data in the SYN was refused, sending it again");
+        std::vector<SlidingWindow::Frame> pendingFrames;
+        mWindow.GetPendingFrames(pendingFrames);
+        sendFrames(pendingFrames, mClientAddress, mClientPort, true);
+    }
+
+    if (mState.features & Feature::VERIFY)
+    {
+        std::vector<SlidingWindow::Frame> frames;
+        mWindow.GetRangeFrames(mState.offset, mWindow.GetPointer(), frames);
+        for (const auto& frame : frames) mChunkHasher.Add(frame.data, frame.size);
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::sendHashes
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Only clears the header, writeHashes
+--                          fills the data.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoEngine::sendHashes(const PacketHeader& request, const QHostAddress& client, const short& port)
+--                              request: The header of the HASH the receiver sent.
+--                              client: The host that is verifying.
+--                              port: The port the host is verifying on.
+--
+-- NOTES:
+--                          Answers a request for nodes of the tree. No more nodes are sent than fit
+--                          into a packet or exist on the level, a request for nodes that do not exist
+--                          is ignored.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoEngine::sendHashes(const PacketHeader& request, const QHostAddress& client, const short& port)
+{
+    const quint64 level = request.SequenceNumber;
+    const quint64 first = request.AckNumber;
+    if (first >= mTree.Width(level)) return;
+
+    const quint64 count = std::min({ request.WindowSize, mTree.Width(level) - first, (quint64)((Size::DATA - sizeof(quint32)) / Verify::HASH) });
+    std::vector<QByteArray> hashes;
+    for (quint64 i = 0; i < count; i++) hashes.push_back(mTree.Node(level, first + i));
+
+    Packet res;
+    memset(&res.Header, 0, sizeof(res.Header));
+    res.Header.PacketType = PacketType::HASH;
+    res.Header.SequenceNumber = level;
+    res.Header.AckNumber = first;
+    res.Header.WindowSize = count;
+    writeHashes(res, hashes);
+    send(res, client, port);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::sendChunk
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Counts chunks from where the transfer
+--                          resumed.
+--                          October 19, 2026 - Benny Wang: Only clears the header of a frame.
+--                          October 19, 2026 - Benny Wang: Sends frames from where they are.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoEngine::sendChunk(const quint64 index, const QHostAddress& client, const short& port)
+--                              index: The index of the chunk.
+--                              client: The host that is verifying.
+--                              port: The port the host is verifying on.
+--
+-- NOTES:
+--                          Sends a chunk again as DATA frames cut from the start of the chunk. The
+--                          frames are never compressed and get no parity, the receiver checks the
+--                          whole chunk against its hash anyway. Only what was sent on this connection
+--                          is hashed, so the first chunk starts where the transfer resumed.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoEngine::sendChunk(const quint64 index, const QHostAddress& client, const short& port)
+{
+    std::vector<SlidingWindow::Frame> frames;
+    mWindow.GetRangeFrames(mState.offset + index * Verify::CHUNK, mState.offset + (index + 1) * Verify::CHUNK, frames);
+    DependencyManager::Instance().Logger().Log("Sending chunk " + QString::number(index).toStdString() + " again");
+
+    PacketHeader header;
+    memset(&header, 0, sizeof(header));
+    header.PacketType = PacketType::DATA;
+    header.WindowSize = mState.rcvWindowSize;
+
+    for (const auto& frame : frames)
+    {
+        header.SequenceNumber = frame.seqNum;
+        header.DataSize = frame.size;
+
+        send(header, frame.data, client, port);
+        mStats.framesResent++;
+        mStats.bytesSent += frame.size;
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::startVerify
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Reads the packet in place.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoEngine::startVerify(const PacketView& eot, const QHostAddress& client, const short& port)
+--                              eot: The EOT of the sender.
+--                              client: The host that is sending.
+--                              port: The port the host is sending on.
+--
+-- NOTES:
+--                          Waits for the last chunks to be hashed and compares the root with the
+--                          one in the EOT. An EOT with a damaged root is ignored, the sender sends it
+--                          again. A transfer that cannot be verified because the number of chunks
+--                          differs is ended like one without verification.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoEngine::startVerify(const PacketView& eot, const QHostAddress& client, const short& port)
+{
+    std::vector<QByteArray> root;
+    if (!readHashes(eot, root) || root.size() != 1)
+    {
+        DependencyManager::Instance().Logger().Error("EOT with a damaged root received from " + client.toString().toStdString());
+        return;
+    }
+
+    const std::vector<QByteArray> leaves = mChunkHasher.Finish();
+    mState.wait = false;
+    mState.verifying = true;
+    restartRcvTimer();
+
+    if (leaves.size() != eot.Header.SequenceNumber)
+    {
+        DependencyManager::Instance().Logger().Error("Expected " + QString::number(eot.Header.SequenceNumber).toStdString() + " chunks but received " + QString::number(leaves.size()).toStdString());
+        continueVerify(MerkleVerifier::Requests(), client, port);
+        return;
+    }
+
+    MerkleVerifier::Requests requests;
+    mVerifier.Start(leaves, mChunkHasher.Size(), root.front(), requests);
+    continueVerify(requests, client, port);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::continueVerify
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Forgets the checkpoint of the transfer.
+--                          October 19, 2026 - Benny Wang: Only clears the headers of the
+--                          requests, which carry no data.
+--                          October 19, 2026 - Benny Wang: Marks the transfer complete once
+--                          verified.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoEngine::continueVerify(const MerkleVerifier::Requests& requests, const QHostAddress& client, const short& port)
+--                              requests: The nodes and chunks to ask for.
+--                              client: The host that is sending.
+--                              port: The port the host is sending on.
+--
+-- NOTES:
+--                          Asks the sender for the children of every node and for every chunk in
+--                          requests. Once nothing is missing the sender is told with an EOT that the
+--                          transfer is over and it is dropped from the checkpoint.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoEngine::continueVerify(const MerkleVerifier::Requests& requests, const QHostAddress& client, const short& port)
+{
+    for (const auto& node : requests.nodes)
+    {
+        Packet res;
+        memset(&res.Header, 0, sizeof(res.Header));
+        res.Header.PacketType = PacketType::HASH;
+        res.Header.SequenceNumber = node.first - 1;
+        res.Header.AckNumber = node.second * 2;
+        res.Header.WindowSize = 2;
+        res.Header.DataSize = 0;
+        send(res, client, port);
+    }
+    for (const quint64 chunk : requests.chunks)
+    {
+        Packet res;
+        memset(&res.Header, 0, sizeof(res.Header));
+        res.Header.PacketType = PacketType::REFETCH;
+        res.Header.SequenceNumber = chunk;
+        res.Header.DataSize = 0;
+        send(res, client, port);
+    }
+
+    if (!mVerifier.IsDone()) return;
+
+    mStats.chunksMismatched += mVerifier.Mismatched();
+    if (mVerifier.Failed() > 0)
+    {
+        DependencyManager::Instance().Logger().Error(QString::number(mVerifier.Failed()).toStdString() + " chunks could not be repaired");
+    }
+    DependencyManager::Instance().Logger().Log("Verification finished, sending EOT");
+    sendEot(client, port);
+    finishCheckpoint();
+    mState.complete = true;
+    Reset();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::newDataHandler
+--
+-- DATE:                    November 27, 2018
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Holds the lock of the engine and wakes
+--                          the thread once the packets are handled.
+--                          October 19, 2026 - Benny Wang: Counts received packets and bytes.
+--                          October 19, 2026 - Benny Wang: Accepts the ACK for the first frame.
+--                          October 19, 2026 - Benny Wang: Negotiates features and handles FEC.
+--                          October 19, 2026 - Benny Wang: Uncompresses frames and checks the size
+--                          of received packets.
+--                          October 19, 2026 - Benny Wang: Drops packets with a bad checksum.
+--                          October 19, 2026 - Benny Wang: Verifies transfers and fetches damaged
+--                          chunks again.
+--                          October 19, 2026 - Benny Wang: Resumes transfers from the checkpoint.
+--                          October 19, 2026 - Benny Wang: Negotiates the payload and answers path
+--                          MTU probes.
+--                          October 19, 2026 - Benny Wang: Follows the receive window the peer
+--                          offers with the ACK of the head, ACKs frames once they were taken in
+--                          and answers window probes.
+--                          October 19, 2026 - Benny Wang: Measures the round trip from the SYN-ACK
+--                          and the ACKs of frames.
+--                          October 19, 2026 - Benny Wang: Takes the first frame from the SYN and
+--                          settles the frames sent before the SYN-ACK.
+--                          October 19, 2026 - Benny Wang: Sends the file without its header when
+--                          the session is turned down.
+--                          October 19, 2026 - Benny Wang: Ends a directory the receiver does not
+--                          take and splits the stream of one it does by its manifest.
+--                          October 19, 2026 - Benny Wang: Hands the ACKs and frames of a
+--                          multiplexed session to their streams.
+--                          October 19, 2026 - Benny Wang: Marks the transfer complete on the EOT
+--                          that ends it.
+--                          October 19, 2026 - Benny Wang: Hands the frames to the batch sink in the
+--                          datagram they came in, one batch per drained socket.
+--                          October 19, 2026 - Benny Wang: Reads packets in place through a
+--                          PacketView instead of copying them, and counts the malformed ones.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoEngine::newDataHandler()
+--
+-- NOTES:
+--                          Callback function for when new data appears on the socket to be read.
+--                          Will read packets from the socket until all packets are handled. After
+--                          the packet is parsed and its checksum checked, it is handled according
+--                          to protocol. Runs on the thread of the transport, so the state is only
+--                          touched with the lock held.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoEngine::newDataHandler()
+{
+    QMutexLocker locker(&mMutex);
+
+    while (mTransport->HasPendingDatagrams())
+    {
+        // The datagram keeps the bytes the view reads from until the packet is handled
+        QNetworkDatagram datagram = mTransport->Receive();
+        const QByteArray bytes = datagram.data();
+
+        // Drop anything that is not a whole packet of a known type before reading the rest of it
+        PacketView buffer;
+        switch (PacketView::Parse(bytes.constData(), bytes.size(), buffer))
+        {
+        case PacketView::Status::VALID:
+            break;
+        case PacketView::Status::SHORT:
+            DependencyManager::Instance().Logger().Error("Not enough data was read from " + datagram.senderAddress().toString().toStdString());
+            mStats.malformed++;
+            continue;
+        case PacketView::Status::TYPE:
+            DependencyManager::Instance().Logger().Error("Packet of an unknown type received from " + datagram.senderAddress().toString().toStdString());
+            mStats.malformed++;
+            continue;
+        case PacketView::Status::TRUNCATED:
+            DependencyManager::Instance().Logger().Error("Truncated packet received from " + datagram.senderAddress().toString().toStdString());
+            mStats.malformed++;
+            continue;
+        case PacketView::Status::OVERSIZED:
+            DependencyManager::Instance().Logger().Error("Packet larger than any frame received from " + datagram.senderAddress().toString().toStdString());
+            mStats.malformed++;
             continue;
         }
-
-        memcpy(&buffer, datagram.data().data(), datagram.data().size());
+        // Drop corrupted packets before they reach the state machine
+        if (!checksumValid(buffer))
+        {
+            DependencyManager::Instance().Logger().Error("Packet with a bad checksum received from " + datagram.senderAddress().toString().toStdString());
+            mStats.checksumErrors++;
+            continue;
+        }
+        mStats.packetsReceived++;
 
         // Restart idle timeout
         restartIdleTimer();
 
         // Log receive packet here
         DependencyManager::Instance().Logger().Log("Receiving packet ...");
-        DependencyManager::Instance().Logger().LogPacket(buffer, datagram.senderAddress());
+        DependencyManager::Instance().Logger().LogPacket(buffer.Header, buffer.Data, datagram.senderAddress());
 
         // Handle packet accordingly
         switch (buffer.Header.PacketType)
@@ -380,51 +1962,119 @@ void kgp::IoEngine::newDataHandler()
                 mClientPort = datagram.senderPort();
                 mState.idle = false;
                 mState.wait = true;
+                mState.features = readSynOptions(buffer, mFeatures);
+                mFecDecoder.Reset();
+                mChunkHasher.Reset();
+                resumeReceive(buffer);
+                if (mState.features & Feature::PMTU)
+                {
+                    PathOptions path;
+                    if (readPathOptions(buffer, path)) mState.maxPayload = std::min<quint64>(path.MaxPayload, Size::MAX_DATA);
+                    else mState.features &= ~Feature::PMTU;
+                }
+                if (mState.features & Feature::BATCH) mFramer.Reset(StreamFramer::Layout::MANIFEST);
+                emit transferStarted(mState.offset);
+                acceptEarlyData(buffer);
                 // Start thread
                 Start();
                 // ACK the SYN
-                ackPacket(buffer.Header.SequenceNumber, datagram.senderAddress(), datagram.senderPort());
+                ackSyn(datagram.senderAddress(), datagram.senderPort());
             }
             else
             {
-                DependencyManager::Instance().Logger().Error("SYN received while in invalid state from " + datagram.senderAddress().toString().toStdString());
+                // A SYN the network duplicated is not an error, its data was already delivered
+                EarlyOptions early;
+                quint64 at;
+                if (mState.earlyNonce != 0 && readEarlyOptions(buffer, early, at) && early.Nonce == mState.earlyNonce)
+                {
+                    DependencyManager::Instance().Logger().Log("Duplicate SYN dropped");
+                }
+                else
+                {
+                    DependencyManager::Instance().Logger().Error("SYN received while in invalid state from " + datagram.senderAddress().toString().toStdString());
+                }
             }
             break;
         case PacketType::ACK:
             if (datagram.senderAddress().toIPv4Address() == mClientAddress.toIPv4Address() && datagram.senderPort() == mClientPort)
             {
-                // Adjust window size
-                mWindow.SetWindowSize(buffer.Header.WindowSize);
-
                 // If the ACK is for a SYN
-                if (buffer.Header.AckNumber == 0)
+                if (buffer.Header.AckNumber == 0 && mState.waitSyn)
                 {
-                    if (mState.waitSyn)
+                    // The SYN is never sent again, its timer started when it was sent
+                    addRttSample(mRcvTimer.Elapsed());
+                    mState.waitSyn = false;
+                    mState.features = readSynOptions(buffer, mState.offered);
+                    // The receiver does not take directories, nothing it was sent was delivered
+                    if ((mState.offered & Feature::BATCH) && !(mState.features & Feature::BATCH))
+                    {
+                        DependencyManager::Instance().Logger().Error("The receiver does not take directories, sending EOT");
+                        sendEot(datagram.senderAddress(), datagram.senderPort());
+                        Reset();
+                        break;
+                    }
+                    // The first window the receiver offers, the streams of a multiplexed session
+                    // share theirs
+                    if (!(mState.features & Feature::MULTIPLEX)) mWindow.SetWindowSize(buffer.Header.WindowSize);
+                    mFecEncoder = FecEncoder();
+                    mCompressor.Reset();
+                    mChunkHasher.Reset();
+                    // The receiver turned the session down, the file goes out without its header
+                    if ((mState.offered & Feature::SESSION) && !(mState.features & Feature::SESSION))
+                    {
+                        mWindow.DropFront(mWindow.GetSize() - mState.transferSize);
+                        mState.earlyData = 0;
+                    }
+                    resumeSend(buffer);
+                    PathOptions path;
+                    if ((mState.features & Feature::PMTU) && readPathOptions(buffer, path) && path.MaxPayload > 0)
                     {
-                        mState.waitSyn = false;
-                        sendWindow(datagram.senderAddress(), datagram.senderPort());
+                        mPathMtu.Reset(std::min<quint64>(path.MaxPayload, Size::MAX_DATA));
+                        updateFrameSize();
                     }
                     else
                     {
-                        DependencyManager::Instance().Logger().Error("ACK received for SYN while in invalid state from " + datagram.senderAddress().toString().toStdString());
+                        mState.features &= ~Feature::PMTU;
                     }
+                    if (mState.features & Feature::MULTIPLEX) mState.streamRoom = buffer.Header.WindowSize;
+                    finishEarlyData(buffer);
+                    sendWindow(datagram.senderAddress(), datagram.senderPort());
                 }
-                // If the ACK is for data
-                else
+                // The ACK is for a frame of one of the streams
+                else if (mState.dataSent && (mState.features & Feature::MULTIPLEX))
                 {
-                    if (mState.dataSent)
-                    {
-                        // If ACK number was valid
-                        if (mWindow.AckFrame(buffer.Header.AckNumber))
-                        {
-                            sendWindow(datagram.senderAddress(), datagram.senderPort());
-                        }
-                        else
-                        {
-                            DependencyManager::Instance().Logger().Error("Unexpected ACK received(" + QString::number(buffer.Header.AckNumber).toStdString() + ")");
-                        }
+                    ackStream(buffer.Header, datagram.senderAddress(), datagram.senderPort());
+                }
+                // If the ACK is for data, the first frame also has sequence number 0
+                else if (mState.dataSent)
+                {
+                    // The receiver reports how many frames it has rebuilt so far
+                    if (mState.features & Feature::FEC) mState.fecRecovered = std::max(mState.fecRecovered, buffer.Header.SequenceNumber);
 
+                    // If ACK number was valid
+                    const quint64 head = mWindow.GetHead();
+                    if (mWindow.AckFrame(buffer.Header.AckNumber))
+                    {
+                        quint64 rtt;
+                        if (mWindow.TakeRttSample(rtt)) addRttSample(rtt);
+                        // The window is measured from the ACK number, an older ACK says nothing
+                        // about the room the receiver has now
+                        if (buffer.Header.AckNumber == mWindow.GetHead()) mWindow.SetWindowSize(buffer.Header.WindowSize);
+                        sendWindow(datagram.senderAddress(), datagram.senderPort(), mWindow.GetHead() != head);
                     }
+                    else
+                    {
+                        DependencyManager::Instance().Logger().Error("Unexpected ACK received(" + QString::number(buffer.Header.AckNumber).toStdString() + ")");
+                    }
+                }
+                // The last file of the session was ACK'd more than once
+                else if (mState.open)
+                {
+                    DependencyManager::Instance().Logger().Log("ACK received while the session is open");
+                }
+                else
+                {
+                    DependencyManager::Instance().Logger().Error("ACK received while in invalid state from " + datagram.senderAddress().toString().toStdString());
                 }
             }
             else
@@ -433,24 +2083,90 @@ void kgp::IoEngine::newDataHandler()
             }
             break;
         case PacketType::DATA:
-            if (mState.wait)
+        {
+            // A chunk that is fetched again after the EOT, it is sent as is
+            if (mState.verifying)
             {
-                // Check if it is the incoming packet is a previous packet or next packet
-                if (buffer.Header.SequenceNumber <= mState.seqNum)
+                // The chunks are counted from where the transfer resumed
+                if (buffer.Header.SequenceNumber < mState.offset) break;
+                quint64 offset;
+                QByteArray chunk;
+                MerkleVerifier::Requests requests;
+                if (mVerifier.AddFrame(buffer.Header.SequenceNumber - mState.offset, buffer.Data, buffer.Header.DataSize, offset, chunk, requests))
                 {
-                    DependencyManager::Instance().Logger().Log("Valid packet received");
+                    offset += mState.offset;
+                    DependencyManager::Instance().Logger().Log("Chunk at " + QString::number(offset).toStdString() + " repaired");
+                    emit dataRepaired(offset, chunk.constData(), chunk.size());
+                    mStats.chunksRepaired++;
+                }
+                continueVerify(requests, datagram.senderAddress(), datagram.senderPort());
+                break;
+            }
+
+            // The frame as it was read from the file, in the datagram so a batch sink can share it
+            QByteArray owner = bytes;
+            const char *data = owner.constData() + Size::HEADER;
+            quint64 dataSize = buffer.Header.DataSize;
+            if (mState.wait && (mState.features & Feature::COMPRESS) && buffer.Header.AckNumber != 0)
+            {
+                QByteArray uncompressed;
+                if (!Compressor::Decompress(buffer.Data, buffer.Header.DataSize, buffer.Header.AckNumber, uncompressed))
+                {
+                    DependencyManager::Instance().Logger().Error("Could not uncompress frame " + QString::number(buffer.Header.SequenceNumber).toStdString());
+                    break;
+                }
+                owner = uncompressed;
+                data = owner.constData();
+                dataSize = owner.size();
+            }
 
-                    // Always ACK a valid packet
+            if (mState.wait && (mState.features & Feature::FEC))
+            {
+                if (buffer.Header.SequenceNumber < mState.seqNum)
+                {
+                    // Already delivered, the ACK may have been lost
                     ackPacket(buffer.Header.SequenceNumber, datagram.senderAddress(), datagram.senderPort());
+                }
+                // Frames ahead of a lost frame are kept so the lost frame can be rebuilt
+                else if (buffer.Header.SequenceNumber < mState.seqNum + receiveRoom())
+                {
+                    mFecDecoder.AddFrame(buffer.Header.SequenceNumber, data, dataSize);
+                    deliverFrames(datagram.senderAddress(), datagram.senderPort());
+                }
+                else
+                {
+                    DependencyManager::Instance().Logger().Error("Invalid packet received, expecting sequence number " + QString::number(mState.seqNum).toStdString());
+                }
+            }
+            else if (mState.wait && (mState.features & Feature::MULTIPLEX))
+            {
+                receiveStream(buffer.Header, data, dataSize, datagram.senderAddress(), datagram.senderPort());
+            }
+            else if (mState.wait)
+            {
+                // A sender that runs past the window gets nothing, it finds out with its next probe
+                if (buffer.Header.SequenceNumber == mState.seqNum && dataSize > receiveRoom())
+                {
+                    DependencyManager::Instance().Logger().Error("No room for frame " + QString::number(buffer.Header.SequenceNumber).toStdString());
+                }
+                // Check if it is the incoming packet is a previous packet or next packet
+                else if (buffer.Header.SequenceNumber <= mState.seqNum)
+                {
+                    DependencyManager::Instance().Logger().Log("Valid packet received");
 
                     // If it was new data
                     if (buffer.Header.SequenceNumber == mState.seqNum)
                     {
                         // Signal new data was read
-                        emit dataRead(buffer.Data, buffer.Header.DataSize);
-                        // Increment sequence number counter
-                        mState.seqNum += buffer.Header.DataSize;
+                        deliver(mState.seqNum, data, dataSize, owner);
+                        // Remember the last frame that was ACK'd and increment sequence number counter
+                        mState.ackNum = buffer.Header.SequenceNumber;
+                        mState.seqNum += dataSize;
                     }
+
+                    // Always ACK a valid packet, after new data was taken in so the ACK carries the
+                    // room left
+                    ackPacket(buffer.Header.SequenceNumber, datagram.senderAddress(), datagram.senderPort());
                 }
                 else
                 {
@@ -462,13 +2178,121 @@ void kgp::IoEngine::newDataHandler()
                 DependencyManager::Instance().Logger().Error("Data received while in invalid state from " + datagram.senderAddress().toString().toStdString());
             }
             break;
+        }
+        case PacketType::FEC:
+            if (mState.wait && (mState.features & Feature::FEC))
+            {
+                mFecDecoder.AddParity(buffer.Header, buffer.Data, mState.seqNum);
+                deliverFrames(datagram.senderAddress(), datagram.senderPort());
+            }
+            else
+            {
+                DependencyManager::Instance().Logger().Error("FEC received while in invalid state from " + datagram.senderAddress().toString().toStdString());
+            }
+            break;
+        case PacketType::HASH:
+            if (mState.waitVerify && buffer.Header.DataSize == 0)
+            {
+                sendHashes(buffer.Header, datagram.senderAddress(), datagram.senderPort());
+                // The receiver is still verifying, there is no need to resend the EOT
+                restartRcvTimer();
+            }
+            else if (mState.verifying && buffer.Header.DataSize > 0)
+            {
+                std::vector<QByteArray> hashes;
+                if (!readHashes(buffer, hashes))
+                {
+                    DependencyManager::Instance().Logger().Error("Damaged hashes received from " + datagram.senderAddress().toString().toStdString());
+                    break;
+                }
+                MerkleVerifier::Requests requests;
+                mVerifier.AddNodes(buffer.Header.SequenceNumber, buffer.Header.AckNumber, hashes, requests);
+                continueVerify(requests, datagram.senderAddress(), datagram.senderPort());
+            }
+            else
+            {
+                DependencyManager::Instance().Logger().Error("HASH received while in invalid state from " + datagram.senderAddress().toString().toStdString());
+            }
+            break;
+        case PacketType::REFETCH:
+            if (mState.waitVerify)
+            {
+                sendChunk(buffer.Header.SequenceNumber, datagram.senderAddress(), datagram.senderPort());
+                restartRcvTimer();
+            }
+            else
+            {
+                DependencyManager::Instance().Logger().Error("REFETCH received while in invalid state from " + datagram.senderAddress().toString().toStdString());
+            }
+            break;
+        case PacketType::PROBE:
+            if (datagram.senderAddress().toIPv4Address() != mClientAddress.toIPv4Address() || datagram.senderPort() != mClientPort)
+            {
+                DependencyManager::Instance().Logger().LogInvalidSender(mClientAddress, mClientPort, datagram.senderAddress(), datagram.senderPort());
+            }
+            else if (mState.wait && (mState.features & Feature::PMTU) && buffer.Header.DataSize > 0)
+            {
+                // The probe got through whole, tell the sender how large it was
+                Packet res;
+                memset(&res.Header, 0, sizeof(res.Header));
+                res.Header.PacketType = PacketType::PROBE;
+                res.Header.AckNumber = buffer.Header.DataSize;
+                res.Header.WindowSize = mState.rcvWindowSize;
+                send(res, datagram.senderAddress(), datagram.senderPort());
+            }
+            else if (mState.dataSent && (mState.features & Feature::PMTU) && buffer.Header.DataSize == 0)
+            {
+                DependencyManager::Instance().Logger().Log("Probe of " + QString::number(buffer.Header.AckNumber).toStdString() + " bytes got through");
+                mPathMtu.ProbeAcked(buffer.Header.AckNumber);
+                updateFrameSize();
+                sendProbe(datagram.senderAddress(), datagram.senderPort());
+            }
+            else
+            {
+                DependencyManager::Instance().Logger().Error("PROBE received while in invalid state from " + datagram.senderAddress().toString().toStdString());
+            }
+            break;
+        case PacketType::WINDOW:
+            if (datagram.senderAddress().toIPv4Address() != mClientAddress.toIPv4Address() || datagram.senderPort() != mClientPort)
+            {
+                DependencyManager::Instance().Logger().LogInvalidSender(mClientAddress, mClientPort, datagram.senderAddress(), datagram.senderPort());
+            }
+            else if (mState.wait)
+            {
+                // The ACK carries the room the receiver has now
+                ackPacket(mState.ackNum, datagram.senderAddress(), datagram.senderPort());
+            }
+            else
+            {
+                DependencyManager::Instance().Logger().Error("WINDOW received while in invalid state from " + datagram.senderAddress().toString().toStdString());
+            }
+            break;
         case PacketType::EOT:
-            if (mState.wait)
+            if (mState.wait && (mState.features & Feature::VERIFY))
+            {
+                DependencyManager::Instance().Logger().Log("EOT received, verifying transfer");
+                startVerify(buffer, datagram.senderAddress(), datagram.senderPort());
+            }
+            else if (mState.wait)
             {
                 // Valid EOT was received so reset
                 DependencyManager::Instance().Logger().Log("EOT received, resetting state");
+                finishCheckpoint();
+                mState.complete = true;
                 Reset();
             }
+            else if (mState.waitVerify)
+            {
+                // The receiver has everything it could get
+                DependencyManager::Instance().Logger().Log("Transfer verified, resetting state");
+                mState.complete = true;
+                Reset();
+            }
+            else if (mState.verifying)
+            {
+                // The sender has not heard from this side in a while, the next timeout asks again
+                DependencyManager::Instance().Logger().Log("EOT received again while verifying");
+            }
             else
             {
                 DependencyManager::Instance().Logger().Error("EOT received while in invalid state from " + datagram.senderAddress().toString().toStdString());
@@ -476,78 +2300,278 @@ void kgp::IoEngine::newDataHandler()
             break;
         }
     }
+
+    // Everything the socket had goes to the batch sink at once
+    flushBatch();
+
+    // ACKs and frames move the timeouts run is waiting on
+    if (mThreaded) wake();
 }
 
 /*--------------------------------------------------------------------------------------------------
--- FUNCTION:                kgp::IoEngine::run
+-- FUNCTION:                kgp::IoEngine::Poll
 --
 -- DATE:                    November 27, 2018
 --
--- REVISIONS:               N/A
+-- REVISIONS:               October 19, 2026 - Benny Wang: Moved out of run so that it can be
+--                          driven without the thread. Holds the lock of the engine.
+--                          October 19, 2026 - Benny Wang: Counts resent frames.
+--                          October 19, 2026 - Benny Wang: Resends what verification waits for.
+--                          October 19, 2026 - Benny Wang: Times out path MTU probes and drops the
+--                          payload when the path stops carrying it.
+--                          October 19, 2026 - Benny Wang: Probes the receive window while it is
+--                          closed.
+--                          October 19, 2026 - Benny Wang: Resends frames on their own
+--                          retransmission timeouts instead of the receive timeout.
+--                          October 19, 2026 - Benny Wang: Closes a session no file followed on.
+--                          October 19, 2026 - Benny Wang: Resends the frames of every stream on
+--                          their own.
+--                          October 19, 2026 - Benny Wang: Asks a source that had nothing to give
+--                          again and keeps the receiver from dropping the connection meanwhile.
 --
 -- DESIGNER:                Benny Wang
 --
 -- PROGRAMMER:              Benny Wang
 --
--- INTERFACE:               void kgp::IoEngine::run()
+-- INTERFACE:               void kgp::IoEngine::Poll()
 --
 -- NOTES:
---                          Overloaded run function of QThread::run. This is the main function of the
---                          thread. The thread is started and this function is run whenever there is
---                          an active connection and is stopped when the connection is closed. This
---                          function is responsible for checking the timeouts and handling them
---                          accordingly.
+--                          Checks the timeouts once and handles them accordingly. Called by run
+--                          whenever a timeout is due when the engine is threaded, and by the owner
+--                          otherwise. Packets may be handled on another thread meanwhile, so the
+--                          state is only touched with the lock held.
 --------------------------------------------------------------------------------------------------*/
-void kgp::IoEngine::run()
+void kgp::IoEngine::Poll()
 {
-    // Only run when there is a connection and not idle
-    while (!mState.idle)
-    {
-        checkTimers();
+    QMutexLocker locker(&mMutex);
+    if (mState.idle) return;
 
-        // If idle timeout has been reached
-        if (mState.timeoutIdle)
-        {
-            DependencyManager::Instance().Logger().Log("Idle timeout reached");
-            Reset();
-        }
+    checkTimers();
 
-        // If receive timeout has been reached
-        if (mState.timeoutRcv)
+    // If a path MTU probe was not answered in time
+    const quint64 blackHoles = mPathMtu.BlackHoles();
+    if (mState.dataSent && (mState.features & Feature::PMTU) && mPathMtu.CheckProbe())
+    {
+        updateFrameSize();
+        // The path stopped carrying the payload in use, resend what is pending at the new size
+        // before the receiver gives up on the connection
+        if (mPathMtu.BlackHoles() != blackHoles)
         {
-            DependencyManager::Instance().Logger().Log("Receive timeout reached");
-
-            // If syn timed out
-            if (mState.waitSyn)
-            {
-                // Just reset
-                Reset();
-            }
-            // If data packet timed out
-            else if (mState.dataSent)
+            DependencyManager::Instance().Logger().Log("Path stopped carrying frames, cutting them to " + QString::number(mPathMtu.Payload()).toStdString() + " bytes");
+            mStats.blackHoles++;
+            for (quint64 stream = 0; stream < streamCount(); stream++)
             {
-                // Resend pending frames
-                DependencyManager::Instance().Logger().Log("Resending pending packets");
                 std::vector<SlidingWindow::Frame> pendingFrames;
-                mWindow.GetPendingFrames(pendingFrames);
-                sendFrames(pendingFrames, mClientAddress, mClientPort);
-                restartRcvTimer();
-                restartIdleTimer();
+                streamWindow(stream).GetPendingFrames(pendingFrames);
+                if (!pendingFrames.empty()) sendFrames(pendingFrames, mClientAddress, mClientPort, true, stream);
             }
-            // If ACKs timed out
-            else if (mState.wait)
+            restartRcvTimer();
+        }
+        sendProbe(mClientAddress, mClientPort);
+    }
+
+    // Frames that were not ACK'd in time are sent again along with the frames after them on their
+    // stream, the other streams go on as they were
+    for (quint64 stream = 0; mState.dataSent && stream < streamCount(); stream++)
+    {
+        std::vector<SlidingWindow::Frame> expiredFrames;
+        if (!streamWindow(stream).GetExpiredFrames(mRtt, expiredFrames)) continue;
+
+        DependencyManager::Instance().Logger().Log("Retransmission timeout at " + QString::number(expiredFrames.front().seqNum).toStdString() + ", resending " + QString::number(expiredFrames.size()).toStdString() + " frames");
+        mStats.retransmitTimeouts++;
+        sendFrames(expiredFrames, mClientAddress, mClientPort, true, stream);
+        // Frames may have timed out because the path stopped carrying them, a probe of their size
+        // tells
+        if (mState.features & Feature::PMTU)
+        {
+            mPathMtu.DataTimedOut();
+            sendProbe(mClientAddress, mClientPort);
+        }
+    }
+
+    // A source that had nothing to give is asked again
+    if (mState.dataSent && mWindow.IsWaiting() && mSourceTimer.Elapsed() > Timeout::SOURCE) sendFromSource();
+
+    // If idle timeout has been reached
+    if (mState.timeoutIdle)
+    {
+        DependencyManager::Instance().Logger().Log("Idle timeout reached");
+        Reset();
+    }
+
+    // If receive timeout has been reached
+    if (mState.timeoutRcv)
+    {
+        DependencyManager::Instance().Logger().Log("Receive timeout reached");
+
+        // If syn timed out
+        if (mState.waitSyn)
+        {
+            // Just reset
+            Reset();
+        }
+        // If the receiver has not made progress, frames are resent on their own timeouts
+        else if (mState.dataSent)
+        {
+            // Everything that fits has been delivered, ask for the window
+            if (windowClosed())
             {
-                DependencyManager::Instance().Logger().Log("Resending ACK");
-                // Resend all ACKs
-                ackPacket(mState.seqNum, mClientAddress, mClientPort);
-                restartRcvTimer();
-                restartIdleTimer();
+                DependencyManager::Instance().Logger().Log("Receive window closed, probing it");
+                mStats.windowProbes++;
+                sendWindowProbe(mClientAddress, mClientPort);
             }
-            else
+            // The receiver would drop a connection that nothing came over for too long
+            else if (mWindow.IsWaiting())
             {
-                // This should never happen
-                DependencyManager::Instance().Logger().Error("Receive timeout reached while in invalid state.");
+                DependencyManager::Instance().Logger().Log("Waiting on the source, probing the receiver");
+                sendWindowProbe(mClientAddress, mClientPort);
             }
+            // The idle timer is left running so a peer that has gone away is eventually dropped
+            restartRcvTimer();
+        }
+        // If no file followed the last one of the session
+        else if (mState.open)
+        {
+            closeSession();
+        }
+        // If ACKs timed out
+        else if (mState.wait)
+        {
+            DependencyManager::Instance().Logger().Log("Resending ACK");
+            // Resend the ACK for the last frame that was received in order
+            ackPacket(mState.ackNum, mClientAddress, mClientPort);
+            restartRcvTimer();
+        }
+        // If the receiver has not finished verifying
+        else if (mState.waitVerify)
+        {
+            DependencyManager::Instance().Logger().Log("Resending EOT");
+            sendEot(mClientAddress, mClientPort);
+            restartRcvTimer();
+        }
+        // If hashes or chunks that were asked for timed out
+        else if (mState.verifying)
+        {
+            DependencyManager::Instance().Logger().Log("Asking again for hashes and chunks");
+            MerkleVerifier::Requests requests;
+            mVerifier.Outstanding(requests);
+            continueVerify(requests, mClientAddress, mClientPort);
+            restartRcvTimer();
+        }
+        else
+        {
+            // This should never happen
+            DependencyManager::Instance().Logger().Error("Receive timeout reached while in invalid state.");
         }
     }
-}
\ No newline at end of file
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::NextDeadline
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Includes the timeout of a probe.
+--                          October 19, 2026 - Benny Wang: Includes the retransmission timeouts of
+--                          the frames in flight.
+--                          October 19, 2026 - Benny Wang: Includes the frames of every stream.
+--                          October 19, 2026 - Benny Wang: Includes when a waiting source is asked
+--                          again.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               quint64 kgp::IoEngine::NextDeadline()
+--
+-- RETURN:                  The clock time at which the next timeout fires, or the largest quint64
+--                          if the engine is idle.
+--
+-- NOTES:
+--                          Used by a simulation to jump the clock straight to the next timeout.
+--------------------------------------------------------------------------------------------------*/
+quint64 kgp::IoEngine::NextDeadline()
+{
+    QMutexLocker locker(&mMutex);
+    if (mState.idle) return std::numeric_limits<quint64>::max();
+
+    // Timeouts fire once the elapsed time is strictly greater than the timeout
+    const quint64 rcv = mRcvTimer.Started() + mRcvTimeout + 1;
+    const quint64 idle = mIdleTimer.Started() + mIdleTimeout + 1;
+    const quint64 probe = (mState.features & Feature::PMTU) ? mPathMtu.ProbeDeadline() : std::numeric_limits<quint64>::max();
+    quint64 frame = std::numeric_limits<quint64>::max();
+    for (quint64 stream = 0; mState.dataSent && stream < streamCount(); stream++) frame = std::min(frame, streamWindow(stream).NextExpiry(mRtt));
+    const quint64 source = (mState.dataSent && mWindow.IsWaiting()) ? mSourceTimer.Started() + Timeout::SOURCE + 1 : std::numeric_limits<quint64>::max();
+    return std::min({ rcv, idle, probe, frame, source });
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::Release
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoEngine::Release(const quint64 size)
+--                              size: The number of bytes the listener is done with.
+--
+-- NOTES:
+--                          Gives room taken by data handed to dataRead back to the receive window
+--                          when the release is deferred. The sender is only told once the window
+--                          has grown by half its size, so that it sends a few large frames instead
+--                          of many small ones. Can be called from any thread, the listener may hand
+--                          the data to a thread of its own and release it there.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoEngine::Release(const quint64 size)
+{
+    QMutexLocker locker(&mMutex);
+    mState.rcvHeld -= std::min(size, mState.rcvHeld);
+    if (!mState.wait || receiveRoom() < mState.rcvAdvertised + mState.rcvWindowSize / 2) return;
+
+    DependencyManager::Instance().Logger().Log("Receive window reopened to " + QString::number(receiveRoom()).toStdString() + " bytes");
+    mStats.windowUpdates++;
+    ackPacket(mState.ackNum, mClientAddress, mClientPort);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoEngine::run
+--
+-- DATE:                    November 27, 2018
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Timeout handling moved to Poll, sleeps
+--                          until the next timeout in between.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoEngine::run()
+--
+-- NOTES:
+--                          Overloaded run function of QThread::run. This is the main function of the
+--                          thread. The thread is started and this function is run whenever there is
+--                          an active connection and is stopped when the connection is closed. This
+--                          function is responsible for checking the timeouts and handling them
+--                          accordingly. Between timeouts the thread sleeps until the next one is
+--                          due, or until packets or the owner wake it.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoEngine::run()
+{
+    while (true)
+    {
+        Poll();
+
+        // Only run when there is a connection and not idle
+        const quint64 deadline = NextDeadline();
+        if (deadline == std::numeric_limits<quint64>::max()) break;
+
+        const quint64 now = DependencyManager::Instance().Clock().Now();
+        QMutexLocker locker(&mWakeMutex);
+        if (!mWakeup && deadline > now) mWake.wait(&mWakeMutex, (unsigned long)std::min<quint64>(deadline - now, std::numeric_limits<unsigned long>::max() - 1));
+        mWakeup = false;
+    }
+}
@@ -1,17 +1,35 @@
 #pragma once
 
+#include <algorithm>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <QHostAddress>
 #include <QMutex>
 #include <QMutexLocker>
-#include <QUdpSocket>
+#include <QRecursiveMutex>
 #include <QThread>
-#include <QTime>
+#include <QWaitCondition>
 
+#include "Checkpoint.h"
+#include "Compression.h"
+#include "Crc32c.h"
 #include "DependencyManager.h"
+#include "Fec.h"
+#include "Merkle.h"
+#include "PacketView.h"
+#include "PathMtu.h"
+#include "ReplayFilter.h"
 #include "res.h"
+#include "RttEstimator.h"
 #include "SlidingWindow.h"
+#include "Sink.h"
+#include "Source.h"
+#include "StreamFramer.h"
+#include "StreamScheduler.h"
+#include "Timer.h"
+#include "Transport.h"
 
 namespace kgp
 {
@@ -19,24 +37,132 @@ namespace kgp
     {
         Q_OBJECT
 
+    public:
+        struct Stats
+        {
+            quint64 packetsSent;
+            quint64 packetsReceived;
+            // Data frames sent for the first time
+            quint64 framesSent;
+            // Data frames sent again after a retransmission timeout
+            quint64 framesResent;
+            // Payload bytes in framesSent and framesResent
+            quint64 bytesSent;
+            // Payload bytes handed to dataRead or the batch sink
+            quint64 bytesRead;
+            // Batches handed to the batch sink
+            quint64 batches;
+            // Parity frames sent
+            quint64 paritySent;
+            // Frames rebuilt from parity instead of being resent
+            quint64 framesRecovered;
+            // Payload bytes compression kept off the wire
+            quint64 bytesSaved;
+            // Packets dropped because their checksum did not match
+            quint64 checksumErrors;
+            // Packets dropped because they were too short, of an unknown type or claimed more data
+            // than they carried
+            quint64 malformed;
+            // Received chunks whose hash did not match the sender's
+            quint64 chunksMismatched;
+            // Chunks that matched after they were fetched again
+            quint64 chunksRepaired;
+            // Path MTU probes sent
+            quint64 probesSent;
+            // Times the payload was dropped because the path stopped carrying it
+            quint64 blackHoles;
+            // Largest payload frames were cut to
+            quint64 maxPayload;
+            // Probes sent while the receive window of the peer was closed
+            quint64 windowProbes;
+            // ACKs sent because the listener released enough data to reopen the window
+            quint64 windowUpdates;
+            // Times a frame was not ACK'd within its retransmission timeout
+            quint64 retransmitTimeouts;
+            // Smoothed round trip time and retransmission timeout in milliseconds
+            quint64 srtt;
+            quint64 rto;
+            // Bytes delivered from SYNs and SYNs whose data was refused
+            quint64 earlyBytes;
+            quint64 earlyRefused;
+            // Files sent and received over sessions
+            quint64 filesSent;
+            quint64 filesReceived;
+            // The window of the peer, the bytes in flight in it and the room of the receive window,
+            // as they were when GetStats was called
+            quint64 sendWindow;
+            quint64 inFlight;
+            quint64 receiveRoom;
+        };
+
     private:
-        QMutex mMutex;
+        // Where a stream of a multiplexed session is on the receiver
+        struct StreamReceiver
+        {
+            quint64 seqNum;
+            quint64 ackNum;
+            StreamFramer framer;
+        };
+
+        // Held while packets, timeouts or the owner touch the state. Recursive as the handlers call
+        // the public functions and listeners may call back into the engine
+        QRecursiveMutex mMutex;
+        // Wakes the thread before the next timeout when packets or the owner change the deadlines
+        QMutex mWakeMutex;
+        QWaitCondition mWake;
+        bool mWakeup;
 
         struct State mState;
         
-        QUdpSocket mSocket;
+        Transport *mTransport;
         QHostAddress mClientAddress;
         short mClientPort;
 
-        QTime mRcvTimer;
-        QTime mIdleTimer;
+        Timer mRcvTimer;
+        Timer mIdleTimer;
+        // Since the source of the window was last asked for more
+        Timer mSourceTimer;
+        quint64 mRcvTimeout;
+        quint64 mIdleTimeout;
+        bool mThreaded;
+        // Receive window set by the owner, kept across Reset
+        quint64 mReceiveWindow;
+        bool mDeferRelease;
+        // Takes received data in batches instead of dataRead when set, and the batch being gathered
+        BatchSink mBatchSink;
+        std::vector<Span> mBatch;
+        quint64 mBatchBytes;
+        // Where the checkpoint is due once the batch has been handed over
+        quint64 mBatchCommit;
         SlidingWindow mWindow;
+        RttEstimator mRtt;
+        Stats mStats;
+
+        quint64 mFeatures;
+        FecEncoder mFecEncoder;
+        FecDecoder mFecDecoder;
+        Compressor mCompressor;
+        ChunkHasher mChunkHasher;
+        MerkleTree mTree;
+        MerkleVerifier mVerifier;
+        Checkpoint mCheckpoint;
+        PathMtu mPathMtu;
+        // Kept across Reset, a SYN is replayed after the transfer it started has ended
+        ReplayFilter mReplayFilter;
+        // Splits the bytes of a session into its files
+        StreamFramer mFramer;
+        // Streams of a multiplexed session past stream 0, which uses mWindow to send and mState and
+        // mFramer to receive, and the order their frames go out in
+        std::vector<SlidingWindow> mStreamWindows;
+        std::vector<StreamReceiver> mStreamReceivers;
+        StreamScheduler mScheduler;
 
     protected:
         void run();
 
     public:
         IoEngine(QObject *parent = nullptr);
+        IoEngine(Transport *transport, QObject *parent = nullptr);
         virtual ~IoEngine();
 
         void Start();
@@ -44,7 +170,15 @@ namespace kgp
 
         void Reset();
 
-        bool StartFileSend(const std::string& filename, const std::string& address, const short& port);
+        bool StartFileSend(const std::string& filename, const std::string& address, const short& port, const unsigned priority = Multiplex::NORMAL, const unsigned weight = Multiplex::WEIGHT);
+        bool StartDirectorySend(const std::string& directory, const std::string& address, const short& port);
+        bool StartSourceSend(const std::shared_ptr<Source>& source, const std::string& address, const short& port);
+        void CloseSession();
+
+        void Poll();
+        quint64 NextDeadline();
+
+        void Release(const quint64 size);
 
 
         /*--------------------------------------------------------------------------------------------------
@@ -52,19 +186,260 @@ namespace kgp
         --
         -- DATE:                    November 27, 2018
         --
-        -- REVISIONS:               N/A
+        -- REVISIONS:               October 19, 2026 - Benny Wang: Kept across Reset.
         --
         -- DESIGNER:                Benny Wang
         --
         -- PROGRAMMER:              Benny Wang
         --
-        -- INTERFACE:               void kgp::IoEngine::SetReceiveWindowSize(cosnt quint64 size)
+        -- INTERFACE:               void kgp::IoEngine::SetReceiveWindowSize(const quint64 size)
         --                              size: The new size of the receiving window.
         --
         -- NOTES:
-        --                          Setter for the receiving window size.
+        --                          Setter for the receiving window size, the most data the receiver
+        --                          holds between what it has not received yet and what the listener
+        --                          has not released. Defaults to Size::WINDOW.
+        --------------------------------------------------------------------------------------------------*/
+        inline void SetReceiveWindowSize(const quint64 size)
+        {
+            mReceiveWindow = size;
+            mState.rcvWindowSize = size;
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::SetDeferredRelease
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               void kgp::IoEngine::SetDeferredRelease(const bool deferred)
+        --                              deferred: Whether the listener releases data with Release.
+        --
+        -- NOTES:
+        --                          By default data is done with once dataRead returns. A listener that
+        --                          queues data for a slower consumer defers the release instead, the data
+        --                          then takes room in the receive window until Release is called.
+        --------------------------------------------------------------------------------------------------*/
+        inline void SetDeferredRelease(const bool deferred) { mDeferRelease = deferred; }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::SetBatchSink
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               void kgp::IoEngine::SetBatchSink(const BatchSink& sink)
+        --                              sink: Takes the received data, an empty one goes back to dataRead.
+        --
+        -- NOTES:
+        --                          Hands received data to sink instead of dataRead. Everything that
+        --                          arrives while the socket is drained goes out as one batch, or sooner
+        --                          once a receive window's worth has been gathered, and a transfer's last
+        --                          batch goes out before transferFinished. Frames are not copied for the
+        --                          sink, the spans share the datagram or the buffer a frame was
+        --                          uncompressed or rebuilt in. With a deferred release the spans hold
+        --                          room in the receive window until Release is called. Has to be set
+        --                          while the engine is idle.
+        --------------------------------------------------------------------------------------------------*/
+        inline void SetBatchSink(const BatchSink& sink) { mBatchSink = sink; }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::SetTimeouts
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               void kgp::IoEngine::SetTimeouts(const quint64 rcv, const quint64 idle)
+        --                              rcv: The receive timeout in milliseconds.
+        --                              idle: The idle timeout in milliseconds.
+        --
+        -- NOTES:
+        --                          Setter for the timeouts. Defaults to Timeout::RCV and Timeout::IDLE.
+        --------------------------------------------------------------------------------------------------*/
+        inline void SetTimeouts(const quint64 rcv, const quint64 idle)
+        {
+            mRcvTimeout = rcv;
+            mIdleTimeout = idle;
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::SetThreaded
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               void kgp::IoEngine::SetThreaded(const bool threaded)
+        --                              threaded: Whether the engine checks its timers on its own thread.
+        --
+        -- NOTES:
+        --                          When the engine is not threaded Start does not start the thread and
+        --                          the owner is responsible for calling Poll. This is used to drive
+        --                          engines from a simulation on a single thread.
         --------------------------------------------------------------------------------------------------*/
-        inline void SetReceiveWindowSize(const quint64 size) { mState.rcvWindowSize = size; }
+        inline void SetThreaded(const bool threaded) { mThreaded = threaded; }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::SetFeatures
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               void kgp::IoEngine::SetFeatures(const quint64 features)
+        --                              features: A combination of the Feature flags.
+        --
+        -- NOTES:
+        --                          Setter for the features this engine asks for in a SYN and accepts
+        --                          from one. A feature is only used if both sides support it. Takes
+        --                          effect on the next connection. Only Feature::CHECKSUM,
+        --                          Feature::RESUME and Feature::PMTU are enabled by default. A receiver
+        --                          only takes directories with Feature::BATCH, which a sender offers for
+        --                          every directory and never for a single file.
+        --------------------------------------------------------------------------------------------------*/
+        inline void SetFeatures(const quint64 features) { mFeatures = features; }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::SetCheckpointFile
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               void kgp::IoEngine::SetCheckpointFile(const std::string& filename)
+        --                              filename: The file the receiver keeps its checkpoint in.
+        --
+        -- NOTES:
+        --                          Setter for the checkpoint file of resumable transfers. Defaults to
+        --                          CHECKPOINT_FILE.
+        --------------------------------------------------------------------------------------------------*/
+        inline void SetCheckpointFile(const std::string& filename)
+        {
+            QMutexLocker locker(&mMutex);
+            mCheckpoint.SetFileName(filename.c_str());
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::IsIdle
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               October 19, 2026 - Benny Wang: Locked, the GUI polls it from its own
+        --                          thread.
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               bool kgp::IoEngine::IsIdle()
+        --
+        -- RETURN:                  True if there is no connection, false otherwise.
+        --------------------------------------------------------------------------------------------------*/
+        inline bool IsIdle()
+        {
+            QMutexLocker locker(&mMutex);
+            return mState.idle;
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::IsSessionOpen
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               October 19, 2026 - Benny Wang: Takes the lock like GetStats.
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               bool kgp::IoEngine::IsSessionOpen()
+        --
+        -- RETURN:                  True if the last file was sent and the connection is held open for
+        --                          the next one, false otherwise.
+        --------------------------------------------------------------------------------------------------*/
+        inline bool IsSessionOpen()
+        {
+            QMutexLocker locker(&mMutex);
+            return mState.open;
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::GetStats
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               October 19, 2026 - Benny Wang: Adds the windows as they are now.
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               Stats kgp::IoEngine::GetStats()
+        --
+        -- RETURN:                  A copy of the counters of the engine. They are kept across Reset.
+        --
+        -- NOTES:
+        --                          The windows are taken as they are now and are 0 while the engine is
+        --                          not sending or receiving. Everything is read under the lock, so the
+        --                          GUI can poll the stats from its own thread while the I/O thread runs.
+        --------------------------------------------------------------------------------------------------*/
+        inline Stats GetStats()
+        {
+            QMutexLocker locker(&mMutex);
+            Stats stats = mStats;
+            stats.sendWindow = mState.dataSent ? mWindow.GetWindowSize() : 0;
+            stats.inFlight = mState.dataSent ? streamOutstanding() : 0;
+            stats.receiveRoom = mState.wait ? receiveRoom() : 0;
+            return stats;
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::GetWindowSize
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::IoEngine::GetWindowSize()
+        --
+        -- RETURN:                  The window the receiver last offered this engine as a sender.
+        --------------------------------------------------------------------------------------------------*/
+        inline quint64 GetWindowSize()
+        {
+            QMutexLocker locker(&mMutex);
+            return mWindow.GetWindowSize();
+        }
 
     private:
         /*--------------------------------------------------------------------------------------------------
@@ -85,7 +460,7 @@ namespace kgp
         --------------------------------------------------------------------------------------------------*/
         inline void restartRcvTimer()
         {
-            mRcvTimer.start();
+            mRcvTimer.Start();
             mState.timeoutRcv = false;
         }
 
@@ -107,10 +482,35 @@ namespace kgp
         --------------------------------------------------------------------------------------------------*/
         inline void restartIdleTimer()
         {
-            mIdleTimer.start();
+            mIdleTimer.Start();
             mState.timeoutIdle = false;
         }
 
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::addRttSample
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               void kgp::IoEngine::addRttSample(const quint64 rtt)
+        --                              rtt: The milliseconds a packet took to be answered.
+        --
+        -- NOTES:
+        --                          Folds a round trip into the estimate the retransmission timeouts of
+        --                          the frames are taken from.
+        --------------------------------------------------------------------------------------------------*/
+        inline void addRttSample(const quint64 rtt)
+        {
+            mRtt.AddSample(rtt);
+            mStats.srtt = mRtt.Srtt();
+            mStats.rto = mRtt.Rto();
+        }
+
         /*--------------------------------------------------------------------------------------------------
         -- FUNCTION:                kgp::IoEngine::checkTimers
         --
@@ -130,8 +530,32 @@ namespace kgp
         inline void checkTimers()
         {
             QMutexLocker locker(&mMutex);
-            if (mRcvTimer.elapsed() > Timeout::RCV) mState.timeoutRcv = true;
-            if (mIdleTimer.elapsed() > Timeout::IDLE) mState.timeoutIdle = true;
+            if (mRcvTimer.Elapsed() > mRcvTimeout) mState.timeoutRcv = true;
+            if (mIdleTimer.Elapsed() > mIdleTimeout) mState.timeoutIdle = true;
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::wake
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               void kgp::IoEngine::wake()
+        --
+        -- NOTES:
+        --                          Wakes run so that it polls again and waits on the deadlines as they
+        --                          are now.
+        --------------------------------------------------------------------------------------------------*/
+        inline void wake()
+        {
+            QMutexLocker locker(&mWakeMutex);
+            mWakeup = true;
+            mWake.wakeAll();
         }
 
         /*--------------------------------------------------------------------------------------------------
@@ -139,7 +563,12 @@ namespace kgp
         --
         -- DATE:                    November 27, 2018
         --
-        -- REVISIONS:               N/A
+        -- REVISIONS:               October 19, 2026 - Benny Wang: Offers features in the SYN.
+        --                          October 19, 2026 - Benny Wang: Names the transfer to resume.
+        --                          October 19, 2026 - Benny Wang: Offers the largest payload, only
+        --                          clears the header as the options are written over the data.
+        --                          October 19, 2026 - Benny Wang: Offers the features chosen for the
+        --                          transfer.
         --
         -- DESIGNER:                Benny Wang
         --
@@ -149,16 +578,103 @@ namespace kgp
         --                              buffer: A pointer to the packet buffer to fill.
         --
         -- NOTES:
-        --                          Creates a SYN packet and puts it into buffer.
+        --                          Creates a SYN packet and puts it into buffer. The features offered
+        --                          for this transfer are sent as the data of the SYN. If resuming is
+        --                          offered they are followed by the ID and size of the transfer, and if
+        --                          path MTU discovery is offered by the largest payload this engine
+        --                          can send.
         --------------------------------------------------------------------------------------------------*/
         inline void createSynPacket(Packet *buffer)
         {
-            memset(buffer, 0, sizeof(buffer));
+            memset(&buffer->Header, 0, sizeof(buffer->Header));
             buffer->Header.AckNumber = 0;
             buffer->Header.SequenceNumber = 0;
             buffer->Header.WindowSize = mState.rcvWindowSize;
             buffer->Header.PacketType = PacketType::SYN;
-            buffer->Header.DataSize = 0;
+            buffer->Header.DataSize = sizeof(SynOptions);
+
+            SynOptions options;
+            options.Features = mState.offered;
+            memcpy(buffer->Data, &options, sizeof(options));
+
+            if (mState.offered & Feature::RESUME)
+            {
+                ResumeOptions resume;
+                resume.TransferId = mState.transferId;
+                resume.Size = mState.transferSize;
+                resume.Offset = 0;
+                memcpy(buffer->Data + sizeof(options), &resume, sizeof(resume));
+                buffer->Header.DataSize += sizeof(resume);
+            }
+
+            if (mState.offered & Feature::PMTU)
+            {
+                PathOptions path;
+                path.MaxPayload = Size::MAX_DATA;
+                memcpy(buffer->Data + buffer->Header.DataSize, &path, sizeof(path));
+                buffer->Header.DataSize += sizeof(path);
+            }
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::receiveRoom
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::IoEngine::receiveRoom()
+        --
+        -- RETURN:                  The bytes past the last byte delivered the receiver has room for.
+        --
+        -- NOTES:
+        --                          Data the listener still holds takes room away. Frames kept for
+        --                          reassembly are not counted, they lie inside the room that was
+        --                          advertised for them and delivering them moves the room along.
+        --------------------------------------------------------------------------------------------------*/
+        inline quint64 receiveRoom()
+        {
+            return mState.rcvHeld < mState.rcvWindowSize ? mState.rcvWindowSize - mState.rcvHeld : 0;
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::advertiseWindow
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               October 19, 2026 - Benny Wang: Holds back room that opened by less
+        --                          than half the window.
+        --                          October 19, 2026 - Benny Wang: Only the room in a multiplexed
+        --                          session.
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::IoEngine::advertiseWindow(const quint64 ackNum)
+        --                              ackNum: The ACK number the window goes out with.
+        --
+        -- RETURN:                  The window to send with an ACK of ackNum.
+        --
+        -- NOTES:
+        --                          The sender measures its window from the frame it got ACK'd, which the
+        --                          receiver has already delivered, so the window covers that frame and
+        --                          the room past it. Room that opened by less than half the window is
+        --                          only advertised once it has grown past that, like in Release, so a
+        --                          periodic ACK does not invite the sender to trickle small frames. The
+        --                          streams of a multiplexed session share the room, so their ACKs carry
+        --                          only the room and the sender counts what it has outstanding itself.
+        --------------------------------------------------------------------------------------------------*/
+        inline quint64 advertiseWindow(const quint64 ackNum)
+        {
+            const quint64 room = receiveRoom();
+            if (room < mState.rcvAdvertised || room >= mState.rcvAdvertised + mState.rcvWindowSize / 2) mState.rcvAdvertised = room;
+            if (mState.features & Feature::MULTIPLEX) return mState.rcvAdvertised;
+            return (mState.seqNum > ackNum ? mState.seqNum - ackNum : 0) + mState.rcvAdvertised;
         }
 
         /*--------------------------------------------------------------------------------------------------
@@ -166,39 +682,400 @@ namespace kgp
         --
         -- DATE:                    November 27, 2018
         --
-        -- REVISIONS:               N/A
+        -- REVISIONS:               October 19, 2026 - Benny Wang: Reports rebuilt frames.
+        --                          October 19, 2026 - Benny Wang: Only clears the header, an ACK
+        --                          carries no data.
+        --                          October 19, 2026 - Benny Wang: Advertises the room that is left.
+        --                          October 19, 2026 - Benny Wang: Names the stream of a multiplexed
+        --                          session.
         --
         -- DESIGNER:                Benny Wang
         --
         -- PROGRAMMER:              Benny Wang
         --
-        -- INTERFACE:               void kgp::IoEngine::ackPacket(const quint64& seqNum, const QHostAddress& sender, const shortkgp::IoEngine::& port)
+        -- INTERFACE:               void kgp::IoEngine::ackPacket(const quint64& seqNum, const QHostAddress& sender, const short& port, const quint64 stream)
         --                              seqNum: The sequence number to ACK.
         --                              sender: The sender of the packet that is being ACK'd.
         --                              port: The port of the packet that is being ACK'd.
+        --                              stream: The stream the packet was on.
         --
         -- NOTES:
         --                          Creates an ACK packet for seqNum and sends it to sender on port port.
+        --                          The sequence number of the ACK carries the number of frames rebuilt
+        --                          from parity, which is 0 unless FEC was negotiated, or the stream if
+        --                          the session is multiplexed.
         --------------------------------------------------------------------------------------------------*/
-        inline void ackPacket(const quint64& seqNum, const QHostAddress& sender, const short& port)
+        inline void ackPacket(const quint64& seqNum, const QHostAddress& sender, const short& port, const quint64 stream = 0)
         {
             Packet res;
-            memset(&res, 0, sizeof(res));
+            memset(&res.Header, 0, sizeof(res.Header));
             res.Header.AckNumber = seqNum;
-            res.Header.SequenceNumber = 0;
-            res.Header.WindowSize = mState.rcvWindowSize;
+            res.Header.SequenceNumber = (mState.features & Feature::MULTIPLEX) ? stream : mFecDecoder.Recovered();
+            res.Header.WindowSize = advertiseWindow(seqNum);
             res.Header.PacketType = PacketType::ACK;
             res.Header.DataSize = 0;
 
             send(res, sender, port);
         }
 
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::ackSyn
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               October 19, 2026 - Benny Wang: Tells the sender where to resume.
+        --                          October 19, 2026 - Benny Wang: Answers with the largest payload and
+        --                          only clears the header.
+        --                          October 19, 2026 - Benny Wang: Advertises the room that is left.
+        --                          October 19, 2026 - Benny Wang: Tells the sender whether the data in
+        --                          the SYN was delivered.
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               void kgp::IoEngine::ackSyn(const QHostAddress& sender, const short& port)
+        --                              sender: The sender of the SYN.
+        --                              port: The port of the SYN.
+        --
+        -- NOTES:
+        --                          Sends the ACK for a SYN with the negotiated features as its data. If
+        --                          resuming was negotiated they are followed by the offset the transfer
+        --                          resumes at, if path MTU discovery was negotiated by the largest
+        --                          payload both sides can handle, and if data in the SYN was negotiated
+        --                          by the bytes of it that were delivered. The SYN-ACK then also ACKs the
+        --                          first frame, so the window is measured from it.
+        --------------------------------------------------------------------------------------------------*/
+        inline void ackSyn(const QHostAddress& sender, const short& port)
+        {
+            Packet res;
+            memset(&res.Header, 0, sizeof(res.Header));
+            res.Header.AckNumber = 0;
+            res.Header.SequenceNumber = 0;
+            res.Header.WindowSize = advertiseWindow(mState.earlyData > 0 ? mState.ackNum : mState.seqNum);
+            res.Header.PacketType = PacketType::ACK;
+            res.Header.DataSize = sizeof(SynOptions);
+
+            SynOptions options;
+            options.Features = mState.features;
+            memcpy(res.Data, &options, sizeof(options));
+
+            if (mState.features & Feature::RESUME)
+            {
+                ResumeOptions resume;
+                resume.TransferId = mState.transferId;
+                resume.Size = mState.transferSize;
+                resume.Offset = mState.offset;
+                memcpy(res.Data + sizeof(options), &resume, sizeof(resume));
+                res.Header.DataSize += sizeof(resume);
+            }
+
+            if (mState.features & Feature::PMTU)
+            {
+                PathOptions path;
+                path.MaxPayload = mState.maxPayload;
+                memcpy(res.Data + res.Header.DataSize, &path, sizeof(path));
+                res.Header.DataSize += sizeof(path);
+            }
+
+            if (mState.features & Feature::EARLY)
+            {
+                EarlyOptions early;
+                early.Nonce = mState.earlyNonce;
+                early.Size = mState.transferSize;
+                early.Accepted = mState.earlyData;
+                memcpy(res.Data + res.Header.DataSize, &early, sizeof(early));
+                res.Header.DataSize += sizeof(early);
+            }
+
+            send(res, sender, port);
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::readSynOptions
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               October 19, 2026 - Benny Wang: A session leaves out resuming and
+        --                          verifying.
+        --                          October 19, 2026 - Benny Wang: Takes the features of this side, a
+        --                          directory leaves out sessions, resuming and verifying.
+        --                          October 19, 2026 - Benny Wang: Streams need a session and no FEC.
+        --                          October 19, 2026 - Benny Wang: Reads the packet in place.
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::IoEngine::readSynOptions(const PacketView& packet, const quint64 supported)
+        --                              packet: A SYN or the ACK for one.
+        --                              supported: The features of this side, the ones the receiver
+        --                              supports or the ones the sender offered.
+        --
+        -- RETURN:                  The features both this engine and the peer support.
+        --
+        -- NOTES:
+        --                          Both sides drop the same features so they agree on what is left. The
+        --                          checkpoint and the Merkle tree are kept per transfer, not per file.
+        --------------------------------------------------------------------------------------------------*/
+        inline quint64 readSynOptions(const PacketView& packet, const quint64 supported)
+        {
+            if (packet.Header.DataSize < sizeof(SynOptions)) return 0;
+
+            SynOptions options;
+            memcpy(&options, packet.Data, sizeof(options));
+            quint64 features = options.Features & supported;
+            if (features & Feature::BATCH) features &= ~(Feature::SESSION | Feature::RESUME | Feature::VERIFY);
+            if (features & Feature::SESSION) features &= ~(Feature::RESUME | Feature::VERIFY);
+            if (!(features & Feature::SESSION) || (features & Feature::FEC)) features &= ~Feature::MULTIPLEX;
+            return features;
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::readResumeOptions
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               October 19, 2026 - Benny Wang: Reads the packet in place.
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               bool kgp::IoEngine::readResumeOptions(const PacketView& packet, ResumeOptions& options)
+        --                              packet: A SYN or the ACK for one.
+        --                              options: Gets the options.
+        --
+        -- RETURN:                  True if the packet carries resume options, false otherwise.
+        --------------------------------------------------------------------------------------------------*/
+        inline bool readResumeOptions(const PacketView& packet, ResumeOptions& options)
+        {
+            if (packet.Header.DataSize < sizeof(SynOptions) + sizeof(ResumeOptions)) return false;
+
+            memcpy(&options, packet.Data + sizeof(SynOptions), sizeof(options));
+            return true;
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::readPathOptions
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               October 19, 2026 - Benny Wang: Reads the packet in place.
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               bool kgp::IoEngine::readPathOptions(const PacketView& packet, PathOptions& options)
+        --                              packet: A SYN or the ACK for one.
+        --                              options: Gets the options.
+        --
+        -- RETURN:                  True if the packet carries path options, false otherwise.
+        --
+        -- NOTES:
+        --                          The options follow the resume options if the peer put those in the
+        --                          packet, which depends on what the peer offered rather than on what
+        --                          was negotiated.
+        --------------------------------------------------------------------------------------------------*/
+        inline bool readPathOptions(const PacketView& packet, PathOptions& options)
+        {
+            if (packet.Header.DataSize < sizeof(SynOptions)) return false;
+
+            SynOptions syn;
+            memcpy(&syn, packet.Data, sizeof(syn));
+            const quint64 at = sizeof(SynOptions) + ((syn.Features & Feature::RESUME) ? sizeof(ResumeOptions) : 0);
+            if (packet.Header.DataSize < at + sizeof(PathOptions)) return false;
+
+            memcpy(&options, packet.Data + at, sizeof(options));
+            return true;
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::readEarlyOptions
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               October 19, 2026 - Benny Wang: Reads the packet in place.
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               bool kgp::IoEngine::readEarlyOptions(const PacketView& packet, EarlyOptions& options, quint64& at)
+        --                              packet: A SYN or the ACK for one.
+        --                              options: Gets the options.
+        --                              at: Gets the offset of the data that follows the options.
+        --
+        -- RETURN:                  True if the packet carries early options, false otherwise.
+        --
+        -- NOTES:
+        --                          The options follow whichever of the other options the peer put in the
+        --                          packet. In a SYN the first frame of the file follows them.
+        --------------------------------------------------------------------------------------------------*/
+        inline bool readEarlyOptions(const PacketView& packet, EarlyOptions& options, quint64& at)
+        {
+            if (packet.Header.DataSize < sizeof(SynOptions)) return false;
+
+            SynOptions syn;
+            memcpy(&syn, packet.Data, sizeof(syn));
+            at = sizeof(SynOptions);
+            if (syn.Features & Feature::RESUME) at += sizeof(ResumeOptions);
+            if (syn.Features & Feature::PMTU) at += sizeof(PathOptions);
+            if (packet.Header.DataSize < at + sizeof(EarlyOptions)) return false;
+
+            memcpy(&options, packet.Data + at, sizeof(options));
+            at += sizeof(options);
+            return true;
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::streamHeader
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               QByteArray kgp::IoEngine::streamHeader(const quint64 id, const std::string& filename, QFile& file)
+        --                              id: The stream ID of the file.
+        --                              filename: The name of the file as it was given.
+        --                              file: The file.
+        --
+        -- RETURN:                  The header of the file with the given stream ID.
+        --
+        -- NOTES:
+        --                          Only the name of the file goes to the receiver, not its directory.
+        --------------------------------------------------------------------------------------------------*/
+        inline QByteArray streamHeader(const quint64 id, const std::string& filename, QFile& file)
+        {
+            const std::string name = filename.substr(filename.find_last_of("/\\") + 1);
+            return StreamFramer::Header(id, QString::fromStdString(name), file.size());
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::updateFrameSize
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               October 19, 2026 - Benny Wang: Cuts the frames of every stream.
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               void kgp::IoEngine::updateFrameSize()
+        --
+        -- NOTES:
+        --                          Cuts new frames of every stream to the payload the path MTU discovery
+        --                          settled on.
+        --------------------------------------------------------------------------------------------------*/
+        inline void updateFrameSize()
+        {
+            for (quint64 stream = 0; stream < Multiplex::STREAMS; stream++) streamWindow(stream).SetFrameSize(mPathMtu.Payload());
+            mStats.maxPayload = std::max(mStats.maxPayload, mPathMtu.Payload());
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::streamWindow
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               SlidingWindow& kgp::IoEngine::streamWindow(const quint64 stream)
+        --                              stream: A stream below Multiplex::STREAMS.
+        --
+        -- RETURN:                  The window the stream sends from, mWindow for stream 0.
+        --------------------------------------------------------------------------------------------------*/
+        inline SlidingWindow& streamWindow(const quint64 stream)
+        {
+            return stream == 0 ? mWindow : mStreamWindows[stream - 1];
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::streamCount
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::IoEngine::streamCount()
+        --
+        -- RETURN:                  The number of streams of the connection, 1 unless it is multiplexed.
+        --------------------------------------------------------------------------------------------------*/
+        inline quint64 streamCount()
+        {
+            return (mState.features & Feature::MULTIPLEX) ? Multiplex::STREAMS : 1;
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::streamOutstanding
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::IoEngine::streamOutstanding()
+        --
+        -- RETURN:                  The bytes of all streams that were sent and not delivered as far as
+        --                          is known, they take up the room the receiver advertised.
+        --------------------------------------------------------------------------------------------------*/
+        inline quint64 streamOutstanding()
+        {
+            quint64 outstanding = 0;
+            for (quint64 stream = 0; stream < streamCount(); stream++) outstanding += streamWindow(stream).GetOutstanding();
+            return outstanding;
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::windowClosed
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               bool kgp::IoEngine::windowClosed()
+        --
+        -- RETURN:                  True if the receiver has no room for anything more, false otherwise.
+        --
+        -- NOTES:
+        --                          The streams of a multiplexed session are closed together, once what
+        --                          they have outstanding fills the room the receiver advertised.
+        --------------------------------------------------------------------------------------------------*/
+        inline bool windowClosed()
+        {
+            if (!(mState.features & Feature::MULTIPLEX)) return mWindow.IsClosed();
+            return streamOutstanding() >= mState.streamRoom;
+        }
+
         /*--------------------------------------------------------------------------------------------------
         -- FUNCTION:                kgp::IoEngine::sendEot
         --
         -- DATE:                    November 27, 2018
         --
-        -- REVISIONS:               N/A
+        -- REVISIONS:               October 19, 2026 - Benny Wang: Carries the root of the transfer.
+        --                          October 19, 2026 - Benny Wang: Only clears the header, the root is
+        --                          the only data.
         --
         -- DESIGNER:                Benny Wang
         --
@@ -209,29 +1086,262 @@ namespace kgp
         --                              port: The port to send the EOT on.
         --
         -- NOTES:
-        --                          Sends an EOT packet to receiver on port port.
+        --                          Sends an EOT packet to receiver on port port. A sender that waits for
+        --                          the transfer to be verified puts the root of its tree and the number
+        --                          of chunks into the EOT.
         --------------------------------------------------------------------------------------------------*/
         inline void sendEot(const QHostAddress& receiver, const short& port)
         {
             Packet res;
-            memset(&res, 0, sizeof(res));
+            memset(&res.Header, 0, sizeof(res.Header));
             res.Header.PacketType = PacketType::EOT;
             res.Header.SequenceNumber = 0;
             res.Header.AckNumber = 0;
             res.Header.WindowSize = 0;
             res.Header.DataSize = 0;
+            if (mState.waitVerify)
+            {
+                res.Header.SequenceNumber = mTree.Width(0);
+                writeHashes(res, std::vector<QByteArray>(1, mTree.Root()));
+            }
             send(res, receiver, port);
         }
 
-        void send(const Packet& packet, const QHostAddress& address, const short& port);
-        void sendFrames(std::vector<SlidingWindow::Frame> list, const QHostAddress& client, const short& port);
-        void sendWindow(const QHostAddress& client, const short& port);
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::writeHashes
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               void kgp::IoEngine::writeHashes(Packet& packet, const std::vector<QByteArray>& hashes)
+        --                              packet: The packet to put the hashes into.
+        --                              hashes: The hashes, no more than fit into a packet.
+        --
+        -- NOTES:
+        --                          Puts hashes into the data of a packet followed by their CRC32C, which
+        --                          is there whether checksums were negotiated or not.
+        --------------------------------------------------------------------------------------------------*/
+        inline void writeHashes(Packet& packet, const std::vector<QByteArray>& hashes)
+        {
+            size_t size = 0;
+            for (const QByteArray& hash : hashes)
+            {
+                memcpy(packet.Data + size, hash.constData(), Verify::HASH);
+                size += Verify::HASH;
+            }
+            const quint32 crc = Crc32c::Compute(packet.Data, size);
+            memcpy(packet.Data + size, &crc, sizeof(crc));
+            packet.Header.DataSize = size + sizeof(crc);
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::readHashes
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               October 19, 2026 - Benny Wang: Reads the packet in place.
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               bool kgp::IoEngine::readHashes(const PacketView& packet, std::vector<QByteArray>& hashes)
+        --                              packet: A packet filled by writeHashes.
+        --                              hashes: Gets the hashes.
+        --
+        -- RETURN:                  True if the packet holds hashes with the right CRC32C, false otherwise.
+        --------------------------------------------------------------------------------------------------*/
+        inline bool readHashes(const PacketView& packet, std::vector<QByteArray>& hashes)
+        {
+            const quint64 size = packet.Header.DataSize;
+            if (size <= sizeof(quint32) || (size - sizeof(quint32)) % Verify::HASH != 0) return false;
+
+            quint32 crc;
+            memcpy(&crc, packet.Data + size - sizeof(crc), sizeof(crc));
+            if (Crc32c::Compute(packet.Data, size - sizeof(crc)) != crc) return false;
+
+            for (quint64 at = 0; at + sizeof(crc) < size; at += Verify::HASH) hashes.push_back(QByteArray(packet.Data + at, (int)Verify::HASH));
+            return true;
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::deliver
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               October 19, 2026 - Benny Wang: Saves a checkpoint every
+        --                          Resume::INTERVAL bytes.
+        --                          October 19, 2026 - Benny Wang: Holds the data against the receive
+        --                          window until it is released.
+        --                          October 19, 2026 - Benny Wang: Splits the bytes of a session into
+        --                          its files.
+        --                          October 19, 2026 - Benny Wang: Splits the bytes of a directory.
+        --                          October 19, 2026 - Benny Wang: Gathers the data in a batch when there
+        --                          is a batch sink.
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               void kgp::IoEngine::deliver(const quint64 offset, const char *data, const size_t size, const QByteArray& owner)
+        --                              offset: The offset of the data in the file.
+        --                              data: The next bytes of the file.
+        --                              size: The number of bytes.
+        --                              owner: The buffer data is in, if it can be shared.
+        --
+        -- NOTES:
+        --                          Hands received data to whoever listens to dataRead. If the transfer is
+        --                          verified the data is also hashed on the way. If it can be resumed the
+        --                          checkpoint is saved once enough has been handed over, which is after
+        --                          the listener has returned with the data, for a batch sink once the
+        --                          batch has been handed over. The bytes of a session or directory go
+        --                          through the framer first.
+        --------------------------------------------------------------------------------------------------*/
+        inline void deliver(const quint64 offset, const char *data, const size_t size, const QByteArray& owner = QByteArray())
+        {
+            if (mState.features & (Feature::SESSION | Feature::BATCH))
+            {
+                deliverStream(0, data, size);
+                return;
+            }
+            if (mDeferRelease) mState.rcvHeld += size;
+            if (mBatchSink) batch(data, size, owner);
+            else emit dataRead(data, size);
+            mStats.bytesRead += size;
+            if (mState.features & Feature::VERIFY) mChunkHasher.Add(data, size);
+            if ((mState.features & Feature::RESUME) && offset + size >= mState.checkpointed + Resume::INTERVAL)
+            {
+                // A batch has not been handed over yet
+                if (mBatchSink) mBatchCommit = offset + size;
+                else saveCheckpoint(offset + size);
+            }
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::saveCheckpoint
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               void kgp::IoEngine::saveCheckpoint(const quint64 end)
+        --                              end: The offset after the last byte that has been handed over.
+        --
+        -- NOTES:
+        --                          Commits everything from where the transfer started or resumed up to
+        --                          end and writes the checkpoint.
+        --------------------------------------------------------------------------------------------------*/
+        inline void saveCheckpoint(const quint64 end)
+        {
+            mCheckpoint.Commit(mState.transferId, mState.transferSize, mState.offset, end);
+            mCheckpoint.Save();
+            mState.checkpointed = end;
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::finishCheckpoint
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               October 19, 2026 - Benny Wang: Hands the last batch over first.
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               void kgp::IoEngine::finishCheckpoint()
+        --
+        -- NOTES:
+        --                          Forgets a transfer that has been received completely so that the next
+        --                          transfer of the file starts from the beginning.
+        --------------------------------------------------------------------------------------------------*/
+        inline void finishCheckpoint()
+        {
+            flushBatch();
+            if (!(mState.features & Feature::RESUME)) return;
+            mCheckpoint.Remove(mState.transferId);
+            mCheckpoint.Save();
+            // Nothing is left for Reset to commit
+            mState.transferId = 0;
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoEngine::checksumValid
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               October 19, 2026 - Benny Wang: Reads the packet in place.
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               bool kgp::IoEngine::checksumValid(const PacketView& packet)
+        --                              packet: A received packet.
+        --
+        -- RETURN:                  False if the packet has to be dropped, true otherwise.
+        --
+        -- NOTES:
+        --                          Checks the checksum of a packet if this engine supports checksums.
+        --                          Until both sides have agreed on checksums, which happens in the SYN
+        --                          and its ACK, a packet without a checksum is let through.
+        --------------------------------------------------------------------------------------------------*/
+        inline bool checksumValid(const PacketView& packet)
+        {
+            if (!(mFeatures & Feature::CHECKSUM)) return true;
+            if (!(mState.features & Feature::CHECKSUM) && packet.Header.Checksum == 0) return true;
+            return Crc32c::ComputePacket(packet.Header, packet.Data) == packet.Header.Checksum;
+        }
+
+        qint64 send(Packet& packet, const QHostAddress& address, const short& port, const bool probe = false);
+        qint64 send(PacketHeader& header, const char *data, const QHostAddress& address, const short& port, const bool probe = false);
+        void sendProbe(const QHostAddress& client, const short& port);
+        void sendWindowProbe(const QHostAddress& client, const short& port);
+        void sendFrames(const std::vector<SlidingWindow::Frame>& list, const QHostAddress& client, const short& port, const bool resend = false, const quint64 stream = 0);
+        void startTransfer(const std::string& address, const short& port);
+        void sendWindow(const QHostAddress& client, const short& port, const bool progress = true);
+        void sendFromSource();
+        void sendStreams(const QHostAddress& client, const short& port, const bool progress);
+        bool sendNextFile(const std::string& filename, const unsigned priority, const unsigned weight);
+        bool sendOnStream(const std::string& filename, const unsigned priority, const unsigned weight);
+        void holdSession();
+        void closeSession();
+        void ackStream(const PacketHeader& ack, const QHostAddress& client, const short& port);
+        void receiveStream(const PacketHeader& header, const char *data, const size_t size, const QHostAddress& client, const short& port);
+        void deliverStream(const quint64 stream, const char *data, const size_t size);
+        void batch(const char *data, const size_t size, const QByteArray& owner);
+        void flushBatch();
+        void deliverFrames(const QHostAddress& client, const short& port);
+        void resumeReceive(const PacketView& syn);
+        void resumeSend(const PacketView& ack);
+        void addEarlyData(Packet& syn, std::vector<SlidingWindow::Frame>& frames);
+        void acceptEarlyData(const PacketView& syn);
+        void finishEarlyData(const PacketView& ack);
+        void sendHashes(const PacketHeader& request, const QHostAddress& client, const short& port);
+        void sendChunk(const quint64 index, const QHostAddress& client, const short& port);
+        void startVerify(const PacketView& eot, const QHostAddress& client, const short& port);
+        void continueVerify(const MerkleVerifier::Requests& requests, const QHostAddress& client, const short& port);
 
     private slots:
         void newDataHandler();
 
     signals:
         void dataRead(const char *data, const size_t& size);
+        void fileDataRead(const quint64& id, const char *data, const size_t& size);
+        void dataRepaired(const quint64& offset, const char *data, const size_t& size);
+        void transferStarted(const quint64& offset);
+        void fileStarted(const quint64& id, const QString& name, const quint64& size);
+        void fileFinished(const quint64& id);
+        void transferFinished(const bool& complete);
 
     };
 }
@@ -0,0 +1,280 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             IoThread.cpp
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Runs an IoEngine on a thread of its own.
+---------------------------------------------------------------------------------------*/
+#include "IoThread.h"
+
+#if defined(__linux__)
+
+#include <algorithm>
+#include <limits>
+
+#include "DependencyManager.h"
+#include "UringTransport.h"
+
+namespace
+{
+    // The transport of the backend, the socket is used directly when the kernel cannot run a ring
+    kgp::ReactorTransport *makeTransport(kgp::Reactor& reactor, const kgp::IoThread::Backend backend)
+    {
+        if (backend == kgp::IoThread::URING)
+        {
+            if (kgp::IoUring::IsSupported()) return new kgp::UringTransport(reactor);
+            kgp::DependencyManager::Instance().Logger().Log("io_uring is not supported here, the I/O thread uses epoll");
+        }
+        return new kgp::ReactorTransport(reactor);
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoThread::IoThread
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::IoThread::IoThread(const short port, const Backend backend)
+--                              port: The local port to receive on.
+--                              backend: How the socket and the files are used. A ring falls back
+--                                       to epoll where the kernel cannot run one.
+--
+-- NOTES:
+--                          Constructor for the IoThread. Creates the first engine of the thread,
+--                          the timer polls every engine for the timeouts that have been reached.
+--------------------------------------------------------------------------------------------------*/
+kgp::IoThread::IoThread(const short port, const Backend backend)
+    : mReactor()
+    , mBackend(backend)
+    , mTransports()
+    , mEngines()
+    , mThread()
+    , mArmed(std::numeric_limits<quint64>::max())
+{
+    if (!mReactor.IsValid()) DependencyManager::Instance().Logger().Error("Could not create the event loop of the I/O thread");
+
+    AddEngine(port);
+    mReactor.SetTimerHandler([this]()
+    {
+        // The timer fires once
+        mArmed = std::numeric_limits<quint64>::max();
+        for (const std::unique_ptr<IoEngine>& engine : mEngines) engine->Poll();
+    });
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoThread::~IoThread
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::IoThread::~IoThread()
+--
+-- NOTES:
+--                          Deconstructor for the IoThread. Stops the thread before the engines and
+--                          the sockets they use go away, the engines before their transports.
+--------------------------------------------------------------------------------------------------*/
+kgp::IoThread::~IoThread()
+{
+    Stop();
+    mEngines.clear();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoThread::AddEngine
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               IoEngine& kgp::IoThread::AddEngine(const short port)
+--                              port: The local port the engine receives on.
+--
+-- RETURN:                  The engine, which the thread runs along with the others.
+--
+-- NOTES:
+--                          The engine is told not to start a thread of its own, its timeouts are
+--                          handled by the reactor. It binds the protocol port, any other port is
+--                          bound in its place. Only call it before Start.
+--------------------------------------------------------------------------------------------------*/
+kgp::IoEngine& kgp::IoThread::AddEngine(const short port)
+{
+    mTransports.emplace_back(makeTransport(mReactor, mBackend));
+    mEngines.emplace_back(new IoEngine(mTransports.back().get()));
+
+    IoEngine& engine = *mEngines.back();
+    engine.SetThreaded(false);
+    if (port != PORT) mTransports.back()->Bind(QHostAddress::Any, port);
+    return engine;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoThread::Start
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoThread::Start()
+--
+-- NOTES:
+--                          Starts the thread. After every turn of the reactor whatever the transports
+--                          held back is handed to the kernel, and the timer is set to the next
+--                          timeout of the engines, since handling a packet or a task can move it. A
+--                          stopped thread cannot be started again.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoThread::Start()
+{
+    if (mThread.joinable()) return;
+
+    mThread = std::thread([this]()
+    {
+        setTimer();
+        while (mReactor.RunOnce())
+        {
+            for (const std::unique_ptr<ReactorTransport>& transport : mTransports) transport->Flush();
+            setTimer();
+        }
+    });
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoThread::Stop
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoThread::Stop()
+--
+-- NOTES:
+--                          Stops the reactor and waits for the thread to finish. Tasks that were
+--                          posted and have not run yet are dropped, file writes that were queued
+--                          are waited for.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoThread::Stop()
+{
+    mReactor.Stop();
+    if (!mThread.joinable() || mThread.get_id() == std::this_thread::get_id()) return;
+
+    mThread.join();
+    for (const std::unique_ptr<ReactorTransport>& transport : mTransports) transport->Flush(true);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoThread::Post
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoThread::Post(const Reactor::Handler& task)
+--                              task: The work to run on the thread, such as starting a send.
+--
+-- NOTES:
+--                          The engines are not safe to use from two threads at once, so other
+--                          threads hand them work through here.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoThread::Post(const Reactor::Handler& task)
+{
+    mReactor.Post(task);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoThread::Syscalls
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               quint64 kgp::IoThread::Syscalls()
+--
+-- RETURN:                  The system calls the reactor and the transports made so far. Only read
+--                          it once the thread has stopped.
+--------------------------------------------------------------------------------------------------*/
+quint64 kgp::IoThread::Syscalls() const
+{
+    quint64 syscalls = mReactor.Syscalls();
+    for (const std::unique_ptr<ReactorTransport>& transport : mTransports) syscalls += transport->Syscalls();
+    return syscalls;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoThread::setTimer
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoThread::setTimer()
+--
+-- NOTES:
+--                          Sets the timer of the reactor to the next timeout of any engine. A
+--                          deadline that has passed fires a millisecond from now rather than right
+--                          away, so one Poll has nothing to do for cannot spin the thread. Most
+--                          turns leave the deadline where it was and do not touch the timer.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoThread::setTimer()
+{
+    quint64 deadline = std::numeric_limits<quint64>::max();
+    for (const std::unique_ptr<IoEngine>& engine : mEngines) deadline = std::min(deadline, engine->NextDeadline());
+    if (deadline == mArmed) return;
+
+    mArmed = deadline;
+    if (deadline == std::numeric_limits<quint64>::max())
+    {
+        mReactor.SetTimer(deadline);
+        return;
+    }
+
+    const quint64 now = DependencyManager::Instance().Clock().Now();
+    mReactor.SetTimer(deadline > now ? deadline - now : 1);
+}
+
+#endif
@@ -0,0 +1,135 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             IoThread.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Runs an IoEngine on a thread of its own. The thread runs a Reactor that
+--                          owns the socket and a timer set to the next timeout of the engine, so
+--                          packets are handled as they arrive instead of waiting on the event loop
+--                          of the thread that created the engine, and no thread spins on the
+--                          timeouts. The signals of the engine are emitted on that thread. The
+--                          socket and the files are either used directly or through an io_uring,
+--                          picked when the thread is created. More engines can share the thread,
+--                          each on a port of its own, so that many transfers run at once without a
+--                          thread each. Only available on Linux, elsewhere the engine keeps using
+--                          UdpTransport.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#if defined(__linux__)
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "IoEngine.h"
+#include "Reactor.h"
+#include "ReactorTransport.h"
+
+namespace kgp
+{
+    class IoThread
+    {
+    public:
+        // How the socket and the files are used
+        enum Backend
+        {
+            // Waited on with epoll and used one system call at a time
+            EPOLL,
+            // Through an io_uring that is submitted once per turn of the reactor
+            URING
+        };
+
+    private:
+        Reactor mReactor;
+        Backend mBackend;
+        // The transport of every engine, created before the engine that binds it
+        std::vector<std::unique_ptr<ReactorTransport>> mTransports;
+        std::vector<std::unique_ptr<IoEngine>> mEngines;
+        std::thread mThread;
+        // The deadline the timer is set to, so that it is only set again when the deadline moves
+        quint64 mArmed;
+
+        void setTimer();
+
+    public:
+        IoThread(const short port = PORT, const Backend backend = EPOLL);
+        ~IoThread();
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoThread::Engine
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               IoEngine& kgp::IoThread::Engine(const size_t index)
+        --                              index: The engine in the order they were added, the one the
+        --                                     thread was created with first.
+        --
+        -- RETURN:                  An engine the thread runs. Its signals can be connected to at any
+        --                          time, anything else has to be done through Post once the thread
+        --                          has started.
+        --------------------------------------------------------------------------------------------------*/
+        inline IoEngine& Engine(const size_t index = 0) { return *mEngines[index]; }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoThread::Engines
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               size_t kgp::IoThread::Engines()
+        --
+        -- RETURN:                  The number of engines the thread runs.
+        --------------------------------------------------------------------------------------------------*/
+        inline size_t Engines() const { return mEngines.size(); }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoThread::GetTransport
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               Transport& kgp::IoThread::GetTransport(const size_t index)
+        --                              index: The engine the transport belongs to.
+        --
+        -- RETURN:                  The transport of an engine, for writing received files through the
+        --                          same backend. Only use it on the thread.
+        --------------------------------------------------------------------------------------------------*/
+        inline Transport& GetTransport(const size_t index = 0) { return *mTransports[index]; }
+
+        IoEngine& AddEngine(const short port);
+        void Start();
+        void Stop();
+        void Post(const Reactor::Handler& task);
+        quint64 Syscalls() const;
+    };
+}
+
+#endif
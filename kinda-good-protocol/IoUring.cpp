@@ -0,0 +1,390 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             IoUring.cpp
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          A thin wrapper around an io_uring submission and completion queue.
+---------------------------------------------------------------------------------------*/
+#include "IoUring.h"
+
+#if defined(__linux__)
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace
+{
+    // The io_uring system calls, which glibc has no wrappers for
+    int setup(const unsigned entries, io_uring_params& params)
+    {
+        return (int)syscall(__NR_io_uring_setup, entries, &params);
+    }
+
+    int enter(const int fd, const unsigned submit, const unsigned wait, const unsigned flags)
+    {
+        return (int)syscall(__NR_io_uring_enter, fd, submit, wait, flags, nullptr, 0);
+    }
+
+    int registerWith(const int fd, const unsigned opcode, const void *arg, const unsigned count)
+    {
+        return (int)syscall(__NR_io_uring_register, fd, opcode, arg, count);
+    }
+
+    // Maps a region of the ring into memory, nullptr if it could not be
+    void *map(const int fd, const size_t size, const off_t offset)
+    {
+        void *region = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+        return region == MAP_FAILED ? nullptr : region;
+    }
+
+    // Operations the transports built on the ring rely on
+    const unsigned REQUIRED[] = { IORING_OP_SENDMSG, IORING_OP_RECVMSG, IORING_OP_READ, IORING_OP_WRITE, IORING_OP_WRITE_FIXED, IORING_OP_ASYNC_CANCEL };
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoUring::IoUring
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::IoUring::IoUring(const unsigned entries)
+--                              entries: The number of requests that can be queued at once. The
+--                                       kernel rounds it up to a power of two and makes room for
+--                                       twice as many completions.
+--
+-- NOTES:
+--                          Constructor for the IoUring. Sets up the ring and maps its queues,
+--                          IsValid tells if that failed.
+--------------------------------------------------------------------------------------------------*/
+kgp::IoUring::IoUring(const unsigned entries)
+    : mFd(-1)
+    , mSqRing(nullptr)
+    , mSqRingSize(0)
+    , mCqRing(nullptr)
+    , mCqRingSize(0)
+    , mEntries(nullptr)
+    , mEntriesSize(0)
+    , mSqQueued(0)
+    , mSyscalls(0)
+{
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    const int fd = setup(entries, params);
+    if (fd < 0) return;
+
+    mSqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    mCqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    // Newer kernels map both queues in one go
+    if (params.features & IORING_FEAT_SINGLE_MMAP) mSqRingSize = mCqRingSize = std::max(mSqRingSize, mCqRingSize);
+
+    mSqRing = map(fd, mSqRingSize, IORING_OFF_SQ_RING);
+    mCqRing = (params.features & IORING_FEAT_SINGLE_MMAP) ? mSqRing : map(fd, mCqRingSize, IORING_OFF_CQ_RING);
+    mEntriesSize = params.sq_entries * sizeof(io_uring_sqe);
+    mEntries = (io_uring_sqe *)map(fd, mEntriesSize, IORING_OFF_SQES);
+    mFd = fd;
+    if (!mSqRing || !mCqRing || !mEntries)
+    {
+        release();
+        return;
+    }
+
+    char *sq = (char *)mSqRing;
+    mSqHead = (unsigned *)(sq + params.sq_off.head);
+    mSqTail = (unsigned *)(sq + params.sq_off.tail);
+    mSqMask = *(unsigned *)(sq + params.sq_off.ring_mask);
+    mSqSize = params.sq_entries;
+    mSqArray = (unsigned *)(sq + params.sq_off.array);
+    mSqQueued = *mSqTail;
+
+    char *cq = (char *)mCqRing;
+    mCqHead = (unsigned *)(cq + params.cq_off.head);
+    mCqTail = (unsigned *)(cq + params.cq_off.tail);
+    mCqMask = *(unsigned *)(cq + params.cq_off.ring_mask);
+    mCompletions = (io_uring_cqe *)(cq + params.cq_off.cqes);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoUring::~IoUring
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::IoUring::~IoUring()
+--
+-- NOTES:
+--                          Deconstructor for the IoUring. Unmaps the queues and closes the ring.
+--                          Requests still in flight are cancelled by the kernel, the memory they
+--                          use has to stay valid until their owner has waited for them.
+--------------------------------------------------------------------------------------------------*/
+kgp::IoUring::~IoUring()
+{
+    release();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoUring::IsSupported
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::IoUring::IsSupported()
+--
+-- RETURN:                  True if the kernel can set up a ring and supports every operation the
+--                          transports built on it use.
+--
+-- NOTES:
+--                          io_uring may be missing from old kernels or turned off by a sandbox, so
+--                          this is checked at run time before a ring is picked over epoll.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::IoUring::IsSupported()
+{
+    IoUring ring(2);
+    if (!ring.IsValid()) return false;
+
+    const unsigned ops = 256;
+    std::vector<char> memory(sizeof(io_uring_probe) + ops * sizeof(io_uring_probe_op), 0);
+    io_uring_probe *probe = (io_uring_probe *)memory.data();
+    if (registerWith(ring.mFd, IORING_REGISTER_PROBE, probe, ops) < 0) return false;
+
+    for (const unsigned op : REQUIRED)
+    {
+        if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) return false;
+    }
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoUring::GetEntry
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               io_uring_sqe *kgp::IoUring::GetEntry()
+--
+-- RETURN:                  A cleared request to fill in, or nullptr if the queue is full and has to
+--                          be submitted first.
+--------------------------------------------------------------------------------------------------*/
+io_uring_sqe *kgp::IoUring::GetEntry()
+{
+    if (!IsValid()) return nullptr;
+
+    const unsigned head = __atomic_load_n(mSqHead, __ATOMIC_ACQUIRE);
+    if (mSqQueued - head >= mSqSize) return nullptr;
+
+    const unsigned index = mSqQueued & mSqMask;
+    mSqArray[index] = index;
+    mSqQueued++;
+
+    io_uring_sqe *entry = &mEntries[index];
+    memset(entry, 0, sizeof(*entry));
+    return entry;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoUring::Queued
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               unsigned kgp::IoUring::Queued()
+--
+-- RETURN:                  The requests that have been filled in and not taken by the kernel yet.
+--------------------------------------------------------------------------------------------------*/
+unsigned kgp::IoUring::Queued()
+{
+    if (!IsValid()) return 0;
+    return mSqQueued - __atomic_load_n(mSqHead, __ATOMIC_ACQUIRE);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoUring::Submit
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               int kgp::IoUring::Submit(const unsigned wait)
+--                              wait: The number of completions to wait for.
+--
+-- RETURN:                  The number of requests the kernel took, or a negative errno.
+--
+-- NOTES:
+--                          Hands every queued request to the kernel in one system call. Nothing is
+--                          entered if there is nothing to submit or wait for.
+--------------------------------------------------------------------------------------------------*/
+int kgp::IoUring::Submit(const unsigned wait)
+{
+    if (!IsValid()) return -EBADF;
+
+    __atomic_store_n(mSqTail, mSqQueued, __ATOMIC_RELEASE);
+    const unsigned queued = Queued();
+    if (queued == 0 && wait == 0) return 0;
+
+    int result;
+    do
+    {
+        mSyscalls++;
+        result = enter(mFd, queued, wait, wait > 0 ? IORING_ENTER_GETEVENTS : 0);
+    } while (result < 0 && errno == EINTR);
+    return result < 0 ? -errno : result;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoUring::NextCompletion
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::IoUring::NextCompletion(io_uring_cqe& completion)
+--                              completion: Set to the next completion.
+--
+-- RETURN:                  True if there was a completion, false otherwise.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::IoUring::NextCompletion(io_uring_cqe& completion)
+{
+    if (!IsValid()) return false;
+
+    const unsigned head = *mCqHead;
+    if (head == __atomic_load_n(mCqTail, __ATOMIC_ACQUIRE)) return false;
+
+    completion = mCompletions[head & mCqMask];
+    __atomic_store_n(mCqHead, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoUring::RegisterBuffers
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::IoUring::RegisterBuffers(const iovec *buffers, const unsigned count)
+--                              buffers: The buffers to register.
+--                              count: The number of buffers.
+--
+-- RETURN:                  True if the buffers were registered.
+--
+-- NOTES:
+--                          Pins the buffers once so that fixed reads and writes from them do not
+--                          map the pages again every time. The kernel may refuse if it would go
+--                          over the memory the process may lock.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::IoUring::RegisterBuffers(const iovec *buffers, const unsigned count)
+{
+    if (!IsValid()) return false;
+    mSyscalls++;
+    return registerWith(mFd, IORING_REGISTER_BUFFERS, buffers, count) == 0;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoUring::RegisterEventFd
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::IoUring::RegisterEventFd(const int eventFd)
+--                              eventFd: The eventfd to signal.
+--
+-- RETURN:                  True if the eventfd was registered.
+--
+-- NOTES:
+--                          Has the kernel signal eventFd whenever it posts a completion, so that an
+--                          event loop can wait on the ring like on any other descriptor.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::IoUring::RegisterEventFd(const int eventFd)
+{
+    if (!IsValid()) return false;
+    mSyscalls++;
+    return registerWith(mFd, IORING_REGISTER_EVENTFD, &eventFd, 1) == 0;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::IoUring::release
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::IoUring::release()
+--
+-- NOTES:
+--                          Unmaps whatever part of the queues was mapped and closes the ring.
+--------------------------------------------------------------------------------------------------*/
+void kgp::IoUring::release()
+{
+    if (mEntries) munmap(mEntries, mEntriesSize);
+    if (mCqRing && mCqRing != mSqRing) munmap(mCqRing, mCqRingSize);
+    if (mSqRing) munmap(mSqRing, mSqRingSize);
+    if (mFd != -1) close(mFd);
+
+    mEntries = nullptr;
+    mSqRing = mCqRing = nullptr;
+    mFd = -1;
+}
+
+#endif
@@ -0,0 +1,112 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             IoUring.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          A thin wrapper around an io_uring submission and completion queue, set up
+--                          with the system calls directly so that liburing is not needed. Requests
+--                          are queued with GetEntry and handed to the kernel together by Submit,
+--                          completions are read from shared memory without a system call. A ring is
+--                          not safe to use from two threads at once. Only available on Linux.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#if defined(__linux__)
+
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+
+#include <QtGlobal>
+
+namespace kgp
+{
+    class IoUring
+    {
+    private:
+        int mFd;
+
+        void *mSqRing;
+        size_t mSqRingSize;
+        void *mCqRing;
+        size_t mCqRingSize;
+        io_uring_sqe *mEntries;
+        size_t mEntriesSize;
+
+        unsigned *mSqHead;
+        unsigned *mSqTail;
+        unsigned mSqMask;
+        unsigned mSqSize;
+        unsigned *mSqArray;
+        // Entries handed out by GetEntry, the kernel only sees them once Submit publishes them
+        unsigned mSqQueued;
+
+        unsigned *mCqHead;
+        unsigned *mCqTail;
+        unsigned mCqMask;
+        io_uring_cqe *mCompletions;
+
+        quint64 mSyscalls;
+
+        void release();
+
+    public:
+        IoUring(const unsigned entries);
+        ~IoUring();
+
+        static bool IsSupported();
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoUring::IsValid
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               bool kgp::IoUring::IsValid()
+        --
+        -- RETURN:                  True if the ring was set up and mapped.
+        --------------------------------------------------------------------------------------------------*/
+        inline bool IsValid() const { return mFd != -1; }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::IoUring::Syscalls
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::IoUring::Syscalls()
+        --
+        -- RETURN:                  The number of times the kernel was entered since the ring was set up.
+        --------------------------------------------------------------------------------------------------*/
+        inline quint64 Syscalls() const { return mSyscalls; }
+
+        io_uring_sqe *GetEntry();
+        unsigned Queued();
+        int Submit(const unsigned wait = 0);
+        bool NextCompletion(io_uring_cqe& completion);
+        bool RegisterBuffers(const iovec *buffers, const unsigned count);
+        bool RegisterEventFd(const int eventFd);
+    };
+}
+
+#endif
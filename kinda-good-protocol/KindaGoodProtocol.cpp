@@ -24,14 +24,23 @@
 #include <QPushButton>
 #include <QFileDialog>
 #include <QMessageBox>
-#include <QFileSystemWatcher>
+#include <QScrollBar>
 
 /*--------------------------------------------------------------------------------------------------
 -- FUNCTION:                KindaGoodProtocol::KindaGoodProtocol
 --
 -- DATE:                    November 27, 2018
 --
--- REVISIONS:               N/A
+-- REVISIONS:               October 19, 2026 - Benny Wang: Writes repaired data into the file.
+--                          October 19, 2026 - Benny Wang: Keeps the output file so a transfer can
+--                          be resumed into it.
+--                          October 19, 2026 - Benny Wang: Runs the engine on its own I/O thread
+--                          on Linux.
+--                          October 19, 2026 - Benny Wang: Uses an io_uring for the I/O thread when
+--                          KGP_IO is set to uring.
+--                          October 19, 2026 - Benny Wang: Shows the events of the logger in a
+--                          filterable list and the stats of the engine in a chart instead of
+--                          watching the log file.
 --
 -- DESIGNER:                Benny Wang, William Murphy
 --
@@ -42,35 +51,48 @@
 --
 -- NOTES:
 --                          Constructor for KindaGoodProtocol. Also serves as the main entry point
---                          of the application. Initializes the IoEngine and wires up the UI.
+--                          of the application. Initializes the IoEngine and wires up the UI. On
+--                          Linux the environment variable KGP_IO picks how the I/O thread uses the
+--                          socket and the files, uring for an io_uring and epoll otherwise.
 --------------------------------------------------------------------------------------------------*/
 KindaGoodProtocol::KindaGoodProtocol(QWidget *parent)
     : QMainWindow(parent)
+#if defined(__linux__)
+    , mIoThread(kgp::PORT, qEnvironmentVariable("KGP_IO") == "uring" ? kgp::IoThread::URING : kgp::IoThread::EPOLL)
+    , mIo(mIoThread.Engine())
+    , mWriteOffset(0)
+#else
     , mIo(this)
+#endif
+    , mEventModel(kgp::DependencyManager::Instance().Logger().Events())
 {
     ui.setupUi(this);
 
-    mLogFileWatcher.addPath(kgp::LOG_FILE);
-
     mOutputFile = new QFile("output.txt");
-    mOutputFile->open(QIODevice::WriteOnly);
+    // Not truncated here, each transfer decides how much of the file it keeps
+    mOutputFile->open(QIODevice::ReadWrite);
     Q_ASSERT(mOutputFile->isOpen() && mOutputFile->isWritable());
 
     kgp::DependencyManager::Instance().Logger().Log("Main window initialized");
 
-    // For streaming log text into the log browser
-    mLogFile.setFileName(kgp::LOG_FILE);
-    mLogFile.open(QIODevice::ReadOnly);
-    mLogStream.setDevice(&mLogFile);
-
-    ui.logBrowser->append(mLogStream.readAll());
-
-    qDebug() << mLogFileWatcher.files();
+    mEventFilter.setSourceModel(&mEventModel);
+    ui.eventList->setModel(&mEventFilter);
+    connect(ui.filterLineEdit, &QLineEdit::textChanged, &mEventFilter, &EventFilter::SetText);
+    connect(ui.errorsCheckBox, &QCheckBox::toggled, &mEventFilter, &EventFilter::SetErrorsOnly);
+    connect(&mRefreshTimer, &QTimer::timeout, this, &KindaGoodProtocol::refresh);
+    mRefreshTimer.start(kgp::Events::REFRESH);
+    refresh();
 
-    connect(&mLogFileWatcher, &QFileSystemWatcher::fileChanged, this, &KindaGoodProtocol::onLogFileUpdate);
-    connect(&mIo, &kgp::IoEngine::dataRead, this, &KindaGoodProtocol::writeBytesToFile);
+    // The data is only valid during the signal, so it is written on the thread that handles packets
+    connect(&mIo, &kgp::IoEngine::dataRead, this, &KindaGoodProtocol::writeBytesToFile, Qt::DirectConnection);
+    connect(&mIo, &kgp::IoEngine::dataRepaired, this, &KindaGoodProtocol::writeRepairedBytes, Qt::DirectConnection);
+    connect(&mIo, &kgp::IoEngine::transferStarted, this, &KindaGoodProtocol::markTransferStart, Qt::DirectConnection);
     connect(ui.buttonSend, &QPushButton::pressed, this, &KindaGoodProtocol::startSend);
     connect(ui.selectFileButton, &QPushButton::pressed, this, &KindaGoodProtocol::selectFileToSend);
+
+#if defined(__linux__)
+    mIoThread.Start();
+#endif
 }
 
 /*--------------------------------------------------------------------------------------------------
@@ -78,7 +100,7 @@ KindaGoodProtocol::KindaGoodProtocol(QWidget *parent)
 --
 -- DATE:                    November 27, 2018
 --
--- REVISIONS:               N/A
+-- REVISIONS:               October 19, 2026 - Benny Wang: Stops the I/O thread on Linux.
 --
 -- DESIGNER:                Benny Wang, William Murphy
 --
@@ -92,8 +114,13 @@ KindaGoodProtocol::KindaGoodProtocol(QWidget *parent)
 --------------------------------------------------------------------------------------------------*/
 KindaGoodProtocol::~KindaGoodProtocol()
 {
+    mRefreshTimer.stop();
     kgp::DependencyManager::Instance().Logger().Log("Program exiting");
+#if defined(__linux__)
+    mIoThread.Stop();
+#else
     mIo.Stop();
+#endif
 
     mOutputFile->close();
     delete mOutputFile;
@@ -104,7 +131,8 @@ KindaGoodProtocol::~KindaGoodProtocol()
 --
 -- DATE:                    November 27, 2018
 --
--- REVISIONS:               N/A
+-- REVISIONS:               October 19, 2026 - Benny Wang: Hands the send to the I/O thread on
+--                          Linux.
 --
 -- DESIGNER:                Benny Wang, William Murphy
 --
@@ -129,7 +157,12 @@ void KindaGoodProtocol::startSend()
         QMessageBox::warning(this, tr("Warning"), tr("No IP address specified!"));
         return;
     }
+#if defined(__linux__)
+    const std::string filename = mFileName.toStdString();
+    mIoThread.Post([this, filename, address]() { mIo.StartFileSend(filename, address, kgp::PORT); });
+#else
     mIo.StartFileSend(mFileName.toStdString(), address, kgp::PORT);
+#endif
 }
 
 /*--------------------------------------------------------------------------------------------------
@@ -137,7 +170,8 @@ void KindaGoodProtocol::startSend()
 --
 -- DATE:                    November 27, 2018
 --
--- REVISIONS:               N/A
+-- REVISIONS:               October 19, 2026 - Benny Wang: Writes through the transport of the I/O
+--                          thread on Linux.
 --
 -- DESIGNER:                Benny Wang
 --
@@ -152,8 +186,87 @@ void KindaGoodProtocol::startSend()
 --------------------------------------------------------------------------------------------------*/
 void KindaGoodProtocol::writeBytesToFile(const char *data, const size_t& size)
 {
+#if defined(__linux__)
+    const qint64 written = mIoThread.GetTransport().WriteFile(*mOutputFile, mWriteOffset, data, (qint64)size);
+    if (written > 0) mWriteOffset += written;
+#else
+    mOutputFile->write(data, size);
+    mOutputFile->flush();
+#endif
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                KindaGoodProtocol::writeRepairedBytes
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: The transfer starts at the start of the
+--                          file.
+--                          October 19, 2026 - Benny Wang: Writes through the transport of the I/O
+--                          thread on Linux.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void KindaGoodProtocol::writeRepairedBytes(const quint64& offset, const char *data, const size_t& size)
+--                              offset: Where the data starts in the transfer.
+--                              data: A pointer to the start of the data.
+--                              size: The length of data to write.
+--
+-- NOTES:
+--                          Overwrites part of the current transfer in the file with data that was
+--                          fetched again because it did not verify. Later writes still append.
+--------------------------------------------------------------------------------------------------*/
+void KindaGoodProtocol::writeRepairedBytes(const quint64& offset, const char *data, const size_t& size)
+{
+#if defined(__linux__)
+    mIoThread.GetTransport().WriteFile(*mOutputFile, (qint64)offset, data, (qint64)size);
+#else
+    const qint64 end = mOutputFile->pos();
+    mOutputFile->seek((qint64)offset);
     mOutputFile->write(data, size);
+    mOutputFile->seek(end);
     mOutputFile->flush();
+#endif
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                KindaGoodProtocol::markTransferStart
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Keeps what a resumed transfer has
+--                          already written.
+--                          October 19, 2026 - Benny Wang: Waits for the queued writes before
+--                          resizing on Linux.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void KindaGoodProtocol::markTransferStart(const quint64& offset)
+--                              offset: The number of bytes of the transfer that were received before.
+--
+-- NOTES:
+--                          The output file holds the transfer that was just accepted. A new transfer
+--                          replaces what was in the file, a resumed one keeps the bytes it committed
+--                          before and drops whatever was written after them.
+--------------------------------------------------------------------------------------------------*/
+void KindaGoodProtocol::markTransferStart(const quint64& offset)
+{
+#if defined(__linux__)
+    // Writes of the last transfer that are still queued must not land after the resize
+    mIoThread.GetTransport().Flush(true);
+    mWriteOffset = (qint64)offset;
+#endif
+
+    if ((quint64)mOutputFile->size() < offset)
+    {
+        kgp::DependencyManager::Instance().Logger().Error("The output file is shorter than the resumed transfer");
+    }
+    mOutputFile->resize((qint64)offset);
+    mOutputFile->seek((qint64)offset);
 }
 
 /*--------------------------------------------------------------------------------------------------
@@ -180,25 +293,38 @@ void KindaGoodProtocol::selectFileToSend()
 }
 
 /*--------------------------------------------------------------------------------------------------
--- FUNCTION:                KindaGoodProtocol::onLogFileUpdate
+-- FUNCTION:                KindaGoodProtocol::refresh
 --
--- DATE:                    November 27, 2018
+-- DATE:                    October 19, 2026
 --
 -- REVISIONS:               N/A
 --
--- DESIGNER:                William Murphy
+-- DESIGNER:                Benny Wang
 --
--- PROGRAMMER:              William Murphy
+-- PROGRAMMER:              Benny Wang
 --
--- INTERFACE:               void KindaGoodProtocol::onLogFileUpdate()
+-- INTERFACE:               void KindaGoodProtocol::refresh()
 --
 -- NOTES:
---                          A Qt slot, that when triggered, updates the UI based on the contents
---                          of the log file.
+--                          A Qt slot, that when triggered, adds the events logged since the last
+--                          refresh to the list and a sample of the stats to the chart. The list
+--                          follows new events only while it is scrolled to the bottom. On Linux the
+--                          stats are taken on the I/O thread, which owns the engine, and the sample
+--                          comes back to the window through its event loop.
 --------------------------------------------------------------------------------------------------*/
-void KindaGoodProtocol::onLogFileUpdate()
+void KindaGoodProtocol::refresh()
 {
-    qDebug() << "Log file changed";
-    ui.logBrowser->append(mLogStream.readAll());
-    // Add the file path again if it was removed
-}
\ No newline at end of file
+    QScrollBar *scrollBar = ui.eventList->verticalScrollBar();
+    const bool following = scrollBar->value() == scrollBar->maximum();
+    mEventModel.Refresh();
+    if (following) ui.eventList->scrollToBottom();
+
+#if defined(__linux__)
+    mIoThread.Post([this]() {
+        const kgp::IoEngine::Stats stats = mIo.GetStats();
+        QMetaObject::invokeMethod(this, [this, stats]() { ui.chart->AddSample(stats); }, Qt::QueuedConnection);
+    });
+#else
+    ui.chart->AddSample(mIo.GetStats());
+#endif
+}
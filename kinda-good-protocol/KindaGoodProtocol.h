@@ -1,28 +1,39 @@
 #pragma once
 
 #include <QtWidgets/QMainWindow>
-#include <QTextStream>
-#include <QFileSystemWatcher>
+#include <QTimer>
 
 #include "ui_KindaGoodProtocol.h"
 
 #include "Logger.h"
+#include "EventView.h"
 #include "IoEngine.h"
+#include "IoThread.h"
 
 class KindaGoodProtocol : public QMainWindow
 {
     Q_OBJECT
 
 private:
+#if defined(__linux__)
+    // Packets and timeouts are handled on a thread of their own instead of the event loop of the
+    // window
+    kgp::IoThread mIoThread;
+    kgp::IoEngine& mIo;
+    // Where the next received bytes go, the writes may still be queued on the I/O thread
+    qint64 mWriteOffset;
+#else
     kgp::IoEngine mIo;
+#endif
     
     QFile *mOutputFile;
 
     QString mFileName;
 
-	QFile mLogFile;
-	QTextStream mLogStream;
-	QFileSystemWatcher mLogFileWatcher;
+    EventModel mEventModel;
+    EventFilter mEventFilter;
+    // Takes new events and a sample of the stats at a fixed rate, however fast the engine logs
+    QTimer mRefreshTimer;
 
 public:
     KindaGoodProtocol(QWidget *parent = Q_NULLPTR);
@@ -35,8 +46,10 @@ private slots:
     void startSend();
 
     void writeBytesToFile(const char *data, const size_t& size);
+    void writeRepairedBytes(const quint64& offset, const char *data, const size_t& size);
+    void markTransferStart(const quint64& offset);
 
     void selectFileToSend();
-	
-	void onLogFileUpdate();
+
+    void refresh();
 };
@@ -19,16 +19,11 @@
 ---------------------------------------------------------------------------------------*/
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <fstream>
-#include <ctime>
-
-#ifdef _WIN32
-#include <sys/utime.h>
-#else 
-#include <utime.h>
-#endif
+#include <cstring>
 
 #include <QByteArray>
 #include <QDateTime>
@@ -39,6 +34,7 @@
 #include <QMutexLocker>
 #include <QObject>
 
+#include "EventRing.h"
 #include "res.h"
 
 namespace kgp
@@ -48,6 +44,8 @@ namespace kgp
     private:
         QFile mLogFile;
         QMutex mMutex;
+        bool mEnabled;
+        EventRing mEvents;
 
     public:
         /*--------------------------------------------------------------------------------------------------
@@ -68,6 +66,7 @@ namespace kgp
         --------------------------------------------------------------------------------------------------*/
         inline Logger()
             : mLogFile(LOG_FILE)
+            , mEnabled(true)
         {
 
             if (mLogFile.isOpen()) mLogFile.close();
@@ -95,12 +94,49 @@ namespace kgp
             if (mLogFile.isOpen()) mLogFile.close();
         }
 
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::Logger::SetEnabled
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               void kgp::Logger::SetEnabled(const bool enabled)
+        --                              enabled: Whether messages with severity "Log" are written.
+        --
+        -- NOTES:
+        --                          Turns logging of regular messages and packets on or off. Errors are
+        --                          always written. Used by tests and benchmarks that push many packets.
+        --------------------------------------------------------------------------------------------------*/
+        inline void SetEnabled(const bool enabled) { mEnabled = enabled; }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::Logger::Events
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               EventRing& kgp::Logger::Events()
+        --
+        -- RETURN:                  The last messages that were logged, for viewers of the log.
+        --------------------------------------------------------------------------------------------------*/
+        inline EventRing& Events() { return mEvents; }
+
         /*--------------------------------------------------------------------------------------------------
         -- FUNCTION:                kgp::Logger::Log
         --
         -- DATE:                    November 27, 2018
         --
-        -- REVISIONS:               N/A
+        -- REVISIONS:               October 19, 2026 - Benny Wang: Adds the message to the events.
         --
         -- DESIGNER:                Benny Wang
         --
@@ -110,11 +146,15 @@ namespace kgp
         --                              msg: The message to log.
         --
         -- NOTES:
-        --                          Logs msg with severity "Log" and the timestamp.
+        --                          Logs msg with severity "Log" and the timestamp, and adds it to the
+        --                          events.
         --------------------------------------------------------------------------------------------------*/
         inline void Log(const std::string& msg)
         {
-            QString line("[ " + QDateTime::currentDateTime().toString("dd/MM/yyyy - hh:mm:ss") + " Log ]: " + msg.c_str());
+            if (!mEnabled) return;
+            const QString text(msg.c_str());
+            mEvents.Push(false, text);
+            QString line("[ " + QDateTime::currentDateTime().toString("dd/MM/yyyy - hh:mm:ss") + " Log ]: " + text);
             emit write(line);
         }
 
@@ -123,7 +163,7 @@ namespace kgp
         --
         -- DATE:                    November 27, 2018
         --
-        -- REVISIONS:               N/A
+        -- REVISIONS:               October 19, 2026 - Benny Wang: Adds the message to the events.
         --
         -- DESIGNER:                Benny Wang
         --
@@ -133,11 +173,14 @@ namespace kgp
         --                              msg: The message to log.
         --
         -- NOTES:
-        --                          Logs msg with severity "Error" and the timestamp.
+        --                          Logs msg with severity "Error" and the timestamp, and adds it to the
+        --                          events.
         --------------------------------------------------------------------------------------------------*/
         inline void Error(const std::string& msg)
         {
-            QString line("[ " + QDateTime::currentDateTime().toString("dd/MM/yyyy - hh:mm:ss") + " Error ]: " + msg.c_str());
+            const QString text(msg.c_str());
+            mEvents.Push(true, text);
+            QString line("[ " + QDateTime::currentDateTime().toString("dd/MM/yyyy - hh:mm:ss") + " Error ]: " + text);
             emit write(line);
         }
 
@@ -146,7 +189,7 @@ namespace kgp
         --
         -- DATE:                    November 27, 2018
         --
-        -- REVISIONS:               N/A
+        -- REVISIONS:               October 19, 2026 - Benny Wang: Logs the header and data apart.
         --
         -- DESIGNER:                Benny Wang
         --
@@ -161,17 +204,43 @@ namespace kgp
         --------------------------------------------------------------------------------------------------*/
         inline void LogPacket(const Packet& packet, const QHostAddress& sender)
         {
+            LogPacket(packet.Header, packet.Data, sender);
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::Logger::LogPacket
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:                void kgp::Logger::LogPacket(const PacketHeader& header, const char *data, const QHostAddress& sender)
+        --                              header: The header of the packet.
+        --                              data: The data that follows the header.
+        --                              sender: The sender of the packet.
+        --
+        -- NOTES:
+        --                           Formats and logs a packet with severity "Log" and the timestamp. The
+        --                           data is read up to its first 0 but never past DataSize bytes.
+        --------------------------------------------------------------------------------------------------*/
+        inline void LogPacket(const PacketHeader& header, const char *data, const QHostAddress& sender)
+        {
+            if (!mEnabled) return;
             std::string address(sender.toString().toStdString());
-            std::string packetType(QString::number((int)packet.Header.PacketType).toStdString());
-            std::string ackNum(QString::number(packet.Header.AckNumber).toStdString());
-            std::string seqNum(QString::number(packet.Header.SequenceNumber).toStdString());
-            std::string windowSize(QString::number(packet.Header.WindowSize).toStdString());
-            std::string dataSize(QString::number(packet.Header.DataSize).toStdString());
-            std::string data(QString(packet.Data).toStdString());
+            std::string packetType(QString::number((int)header.PacketType).toStdString());
+            std::string ackNum(QString::number(header.AckNumber).toStdString());
+            std::string seqNum(QString::number(header.SequenceNumber).toStdString());
+            std::string windowSize(QString::number(header.WindowSize).toStdString());
+            std::string dataSize(QString::number(header.DataSize).toStdString());
+            std::string text(QString::fromUtf8(data, (int)strnlen(data, std::min<quint64>(header.DataSize, Size::MAX_DATA))).toStdString());
             Log("Address: " + address + "        Packet Type: " + packetType);
             Log("ACK #: " + ackNum + "            Sequence #: " + seqNum);
             Log("Data Size: " + dataSize + "    Window Size: " + windowSize);
-            Log("\tData: " + data);
+            Log("\tData: " + text);
         }
 
         /*--------------------------------------------------------------------------------------------------
@@ -206,48 +275,13 @@ namespace kgp
         }
 
     private:
-        /*--------------------------------------------------------------------------------------------------
-        -- FUNCTION:                kgp::Logger::updateTimestamp
-        --
-        -- DATE:                    November 27, 2018
-        --
-        -- REVISIONS:               N/A
-        --
-        -- DESIGNER:                William Murphy
-        --
-        -- PROGRAMMER:              William Murphy
-        --
-        -- INTERFACE:               bool kgp::Logger::updateTimestamp(const std::string& filename)
-        --                              filename: The name of the file whose timestamp will be updated.
-        --
-        -- NOTES:                   This function is required for QFileSystemWatcher to be properly notified
-        --                          of file updates, at least on Windows.
-        --------------------------------------------------------------------------------------------------*/
-        inline bool updateTimestamp(const std::string& filename)
-        {
-            struct stat fstat;
-            struct utimbuf new_time;
-
-            if (stat(kgp::LOG_FILE, &fstat) != 0)
-            {
-                return false;
-            }
-
-            new_time.actime = fstat.st_atime;
-            new_time.modtime = time(NULL);
-
-            if (utime(kgp::LOG_FILE, &new_time)) {
-                return false;
-            }
-            return true;
-        }
-
         /*--------------------------------------------------------------------------------------------------
         -- FUNCTION:                kgp::Logger::write
         --
         -- DATE:                    November 27, 2018
         --
-        -- REVISIONS:               N/A
+        -- REVISIONS:               October 19, 2026 - Benny Wang: No longer touches the timestamp of
+        --                          the file, the GUI reads the events instead of watching it.
         --
         -- DESIGNER:                Benny Wang
         --
@@ -266,10 +300,8 @@ namespace kgp
             qDebug() << data;
             mLogFile.write(data.toStdString().c_str());
             mLogFile.write("\n");
-            // Flushes the stream so that logs can be displayed by the log viewer widget
+            // Flushed so the file is complete if the program crashes, viewers read the events instead
             mLogFile.flush();
-            updateTimestamp(kgp::LOG_FILE);
-            // Update the file timestamp
         }
     };
 }
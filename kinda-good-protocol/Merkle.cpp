@@ -0,0 +1,605 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             Merkle.cpp
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Chunks and nodes are hashed with SHA-256, with a different byte in front
+--                          of each so a chunk can never pass for a node. A node without a sibling is
+--                          moved up a level as is, so every level is half the size of the one below.
+---------------------------------------------------------------------------------------*/
+#include "Merkle.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <QCryptographicHash>
+#include <QMutexLocker>
+#include <QRunnable>
+
+namespace
+{
+    constexpr char CHUNK_PREFIX = 0x00;
+    constexpr char NODE_PREFIX = 0x01;
+}
+
+// Hashes one chunk on the pool of a ChunkHasher
+class kgp::ChunkHasher::Job : public QRunnable
+{
+private:
+    ChunkHasher& mHasher;
+    quint64 mIndex;
+    QByteArray mChunk;
+
+public:
+    Job(ChunkHasher& hasher, const quint64 index, const QByteArray& chunk)
+        : mHasher(hasher)
+        , mIndex(index)
+        , mChunk(chunk)
+    {
+    }
+
+    void run() override
+    {
+        const QByteArray hash = MerkleTree::HashChunk(mChunk.constData(), mChunk.size());
+        QMutexLocker locker(&mHasher.mMutex);
+        mHasher.mLeaves[mIndex] = hash;
+    }
+};
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::MerkleTree::HashChunk
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               QByteArray kgp::MerkleTree::HashChunk(const char *data, const size_t size)
+--                              data: The chunk.
+--                              size: The size of the chunk.
+--
+-- RETURN:                  The hash of the chunk, a leaf of the tree.
+--------------------------------------------------------------------------------------------------*/
+QByteArray kgp::MerkleTree::HashChunk(const char *data, const size_t size)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(&CHUNK_PREFIX, 1);
+    hash.addData(data, (int)size);
+    return hash.result();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::MerkleTree::HashNodes
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               QByteArray kgp::MerkleTree::HashNodes(const QByteArray& left, const QByteArray& right)
+--                              left: The hash of the left child.
+--                              right: The hash of the right child.
+--
+-- RETURN:                  The hash of the parent of the two nodes.
+--------------------------------------------------------------------------------------------------*/
+QByteArray kgp::MerkleTree::HashNodes(const QByteArray& left, const QByteArray& right)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(&NODE_PREFIX, 1);
+    hash.addData(left);
+    hash.addData(right);
+    return hash.result();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::MerkleTree::Build
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::MerkleTree::Build(const std::vector<QByteArray>& leaves)
+--                              leaves: The hashes of the chunks in order.
+--
+-- NOTES:
+--                          Replaces the tree with one over the given leaves. Takes one hash per
+--                          pair of nodes, which is nothing next to hashing the chunks.
+--------------------------------------------------------------------------------------------------*/
+void kgp::MerkleTree::Build(const std::vector<QByteArray>& leaves)
+{
+    mLevels.clear();
+    if (leaves.empty()) return;
+
+    mLevels.push_back(leaves);
+    while (mLevels.back().size() > 1)
+    {
+        const std::vector<QByteArray>& below = mLevels.back();
+        std::vector<QByteArray> level;
+        for (size_t i = 0; i < below.size(); i += 2)
+        {
+            level.push_back(i + 1 < below.size() ? HashNodes(below[i], below[i + 1]) : below[i]);
+        }
+        mLevels.push_back(level);
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::MerkleTree::Root
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               QByteArray kgp::MerkleTree::Root()
+--
+-- RETURN:                  The root of the tree, or the hash of an empty chunk if it has no leaves.
+--------------------------------------------------------------------------------------------------*/
+QByteArray kgp::MerkleTree::Root() const
+{
+    if (mLevels.empty()) return HashChunk(nullptr, 0);
+    return mLevels.back().front();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::ChunkHasher::ChunkHasher
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::ChunkHasher::ChunkHasher()
+--
+-- NOTES:
+--                          Constructor for the ChunkHasher. The pool has a thread per core.
+--------------------------------------------------------------------------------------------------*/
+kgp::ChunkHasher::ChunkHasher()
+    : mPool()
+    , mMutex()
+    , mChunk()
+    , mLeaves()
+    , mSize(0)
+{
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::ChunkHasher::~ChunkHasher
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::ChunkHasher::~ChunkHasher()
+--
+-- NOTES:
+--                          Deconstructor for the ChunkHasher. Waits for the jobs on the pool, they
+--                          write into the hasher.
+--------------------------------------------------------------------------------------------------*/
+kgp::ChunkHasher::~ChunkHasher()
+{
+    mPool.waitForDone();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::ChunkHasher::Reset
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::ChunkHasher::Reset()
+--
+-- NOTES:
+--                          Waits for the chunks that are being hashed and forgets everything that
+--                          was added.
+--------------------------------------------------------------------------------------------------*/
+void kgp::ChunkHasher::Reset()
+{
+    mPool.waitForDone();
+    QMutexLocker locker(&mMutex);
+    mChunk.clear();
+    mLeaves.clear();
+    mSize = 0;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::ChunkHasher::Add
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::ChunkHasher::Add(const char *data, const size_t size)
+--                              data: The next bytes of the file.
+--                              size: The number of bytes.
+--
+-- NOTES:
+--                          Appends bytes to the chunk that is being filled. Every chunk that is
+--                          filled is handed to the pool, so the caller only pays for the copy.
+--------------------------------------------------------------------------------------------------*/
+void kgp::ChunkHasher::Add(const char *data, const size_t size)
+{
+    size_t added = 0;
+    while (added < size)
+    {
+        if (mChunk.isEmpty()) mChunk.reserve((int)Verify::CHUNK);
+
+        const size_t count = std::min<size_t>(size - added, Verify::CHUNK - mChunk.size());
+        mChunk.append(data + added, (int)count);
+        added += count;
+
+        if ((quint64)mChunk.size() == Verify::CHUNK) submit();
+    }
+    mSize += size;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::ChunkHasher::Finish
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               std::vector<QByteArray> kgp::ChunkHasher::Finish()
+--
+-- RETURN:                  The hashes of all chunks in order, the last one may be short.
+--
+-- NOTES:
+--                          Hashes what is left in the chunk that is being filled and waits for the
+--                          pool. Only the chunks that are still being hashed are waited for.
+--------------------------------------------------------------------------------------------------*/
+std::vector<QByteArray> kgp::ChunkHasher::Finish()
+{
+    if (!mChunk.isEmpty()) submit();
+    mPool.waitForDone();
+
+    QMutexLocker locker(&mMutex);
+    return mLeaves;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::ChunkHasher::submit
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::ChunkHasher::submit()
+--
+-- NOTES:
+--                          Hands the chunk that is being filled to the pool and starts a new one.
+--------------------------------------------------------------------------------------------------*/
+void kgp::ChunkHasher::submit()
+{
+    quint64 index;
+    {
+        QMutexLocker locker(&mMutex);
+        index = mLeaves.size();
+        mLeaves.push_back(QByteArray());
+    }
+    mPool.start(new Job(*this, index, mChunk));
+    mChunk.clear();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::MerkleVerifier::MerkleVerifier
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::MerkleVerifier::MerkleVerifier()
+--
+-- NOTES:
+--                          Constructor for the MerkleVerifier.
+--------------------------------------------------------------------------------------------------*/
+kgp::MerkleVerifier::MerkleVerifier()
+{
+    Reset();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::MerkleVerifier::Reset
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::MerkleVerifier::Reset()
+--
+-- NOTES:
+--                          Forgets the transfer that was verified.
+--------------------------------------------------------------------------------------------------*/
+void kgp::MerkleVerifier::Reset()
+{
+    mTree.Build(std::vector<QByteArray>());
+    mSize = 0;
+    mProven.clear();
+    mPending.clear();
+    mRepairs.clear();
+    mMismatched = 0;
+    mFailed = 0;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::MerkleVerifier::Start
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::MerkleVerifier::Start(const std::vector<QByteArray>& leaves, const quint64 size, const QByteArray& root, Requests& requests)
+--                              leaves: The hashes of the received chunks.
+--                              size: The number of bytes received.
+--                              root: The root the sender sent.
+--                              requests: Gets what has to be asked for.
+--
+-- NOTES:
+--                          Starts verifying a transfer. The root is trusted, every hash that is
+--                          received later has to add up to it. If the received chunks give the same
+--                          root there is nothing to ask for and the verifier is done.
+--------------------------------------------------------------------------------------------------*/
+void kgp::MerkleVerifier::Start(const std::vector<QByteArray>& leaves, const quint64 size, const QByteArray& root, Requests& requests)
+{
+    Reset();
+    mTree.Build(leaves);
+    mSize = size;
+    if (mTree.Height() == 0) return;
+
+    const quint64 top = mTree.Height() - 1;
+    mProven[std::make_pair(top, 0)] = root;
+    checkNode(top, 0, requests);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::MerkleVerifier::AddNodes
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::MerkleVerifier::AddNodes(const quint64 level, const quint64 first, const std::vector<QByteArray>& hashes, Requests& requests)
+--                              level: The level of the nodes.
+--                              first: The index of the first node.
+--                              hashes: The hashes the sender sent for the nodes.
+--                              requests: Gets what has to be asked for next.
+--
+-- NOTES:
+--                          Takes the children of a node that was asked for. They are only used if
+--                          they add up to the hash of their parent, anything else was damaged or is
+--                          a duplicate and is asked for again by Outstanding. Children that do not
+--                          match what was received are looked into further, down to the chunks.
+--------------------------------------------------------------------------------------------------*/
+void kgp::MerkleVerifier::AddNodes(const quint64 level, const quint64 first, const std::vector<QByteArray>& hashes, Requests& requests)
+{
+    const std::pair<quint64, quint64> parent(level + 1, first / 2);
+    if (first % 2 != 0 || first >= mTree.Width(level) || mPending.count(parent) == 0) return;
+
+    const quint64 count = std::min<quint64>(2, mTree.Width(level) - first);
+    if (hashes.size() != count) return;
+
+    const QByteArray sum = count == 2 ? MerkleTree::HashNodes(hashes[0], hashes[1]) : hashes[0];
+    if (sum != mProven[parent]) return;
+
+    mPending.erase(parent);
+    for (quint64 i = 0; i < count; i++)
+    {
+        mProven[std::make_pair(level, first + i)] = hashes[i];
+        checkNode(level, first + i, requests);
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::MerkleVerifier::AddFrame
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Takes frames of Size::MIN_DATA bytes.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::MerkleVerifier::AddFrame(const quint64 offset, const char *data, const size_t size, quint64& chunkOffset, QByteArray& chunk, Requests& requests)
+--                              offset: The offset of the frame in the file.
+--                              data: The frame.
+--                              size: The size of the frame.
+--                              chunkOffset: Gets the offset of the chunk if true is returned.
+--                              chunk: Gets the repaired chunk if true is returned.
+--                              requests: Gets the chunk if it has to be fetched again.
+--
+-- RETURN:                  True if the frame completed a chunk that now matches, false otherwise.
+--
+-- NOTES:
+--                          Takes a frame of a chunk that is fetched again. The sender cuts a chunk
+--                          into frames of Size::MIN_DATA bytes from its start, anything else is
+--                          ignored. A chunk that still does not match is fetched again, up to
+--                          Verify::MAX_REFETCH times.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::MerkleVerifier::AddFrame(const quint64 offset, const char *data, const size_t size, quint64& chunkOffset, QByteArray& chunk, Requests& requests)
+{
+    const quint64 index = offset / Verify::CHUNK;
+    auto it = mRepairs.find(index);
+    if (it == mRepairs.end()) return false;
+    Repair& repair = it->second;
+
+    const quint64 start = offset - index * Verify::CHUNK;
+    const quint64 frame = start / Size::MIN_DATA;
+    if (start % Size::MIN_DATA != 0 || frame >= repair.frames.size() || repair.frames[frame]) return false;
+    if (size != std::min<quint64>(Size::MIN_DATA, repair.data.size() - start)) return false;
+
+    memcpy(repair.data.data() + start, data, size);
+    repair.frames[frame] = true;
+    if (--repair.missing > 0) return false;
+
+    if (MerkleTree::HashChunk(repair.data.constData(), repair.data.size()) == mProven[std::make_pair(0, index)])
+    {
+        chunkOffset = index * Verify::CHUNK;
+        chunk = repair.data;
+        mRepairs.erase(it);
+        return true;
+    }
+
+    // Damaged again on the way
+    if (++repair.tries >= Verify::MAX_REFETCH)
+    {
+        mFailed++;
+        mRepairs.erase(it);
+        return false;
+    }
+    repair.frames.assign(repair.frames.size(), false);
+    repair.missing = repair.frames.size();
+    requests.chunks.push_back(index);
+    return false;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::MerkleVerifier::Outstanding
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::MerkleVerifier::Outstanding(Requests& requests)
+--                              requests: Gets everything that was asked for and has not arrived.
+--
+-- NOTES:
+--                          Used to ask again after a timeout.
+--------------------------------------------------------------------------------------------------*/
+void kgp::MerkleVerifier::Outstanding(Requests& requests)
+{
+    for (const auto& node : mPending) requests.nodes.push_back(node);
+    for (const auto& repair : mRepairs) requests.chunks.push_back(repair.first);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::MerkleVerifier::chunkSize
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               quint64 kgp::MerkleVerifier::chunkSize(const quint64 index)
+--                              index: The index of the chunk.
+--
+-- RETURN:                  The size of the chunk, only the last one can be short.
+--------------------------------------------------------------------------------------------------*/
+quint64 kgp::MerkleVerifier::chunkSize(const quint64 index)
+{
+    return std::min<quint64>(Verify::CHUNK, mSize - index * Verify::CHUNK);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::MerkleVerifier::checkNode
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Expects frames of Size::MIN_DATA bytes.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::MerkleVerifier::checkNode(const quint64 level, const quint64 index, Requests& requests)
+--                              level: The level of the node.
+--                              index: The index of the node.
+--                              requests: Gets the node or chunk if it has to be asked for.
+--
+-- NOTES:
+--                          Compares a proven hash of the sender with the one of what was received.
+--                          If they differ the children of a node are asked for, and a chunk is
+--                          fetched again.
+--------------------------------------------------------------------------------------------------*/
+void kgp::MerkleVerifier::checkNode(const quint64 level, const quint64 index, Requests& requests)
+{
+    const std::pair<quint64, quint64> node(level, index);
+    if (mProven[node] == mTree.Node(level, index)) return;
+
+    if (level > 0)
+    {
+        mPending.insert(node);
+        requests.nodes.push_back(node);
+        return;
+    }
+
+    Repair repair;
+    repair.data = QByteArray((int)chunkSize(index), 0);
+    repair.frames.assign((repair.data.size() + Size::MIN_DATA - 1) / Size::MIN_DATA, false);
+    repair.missing = repair.frames.size();
+    repair.tries = 0;
+    mRepairs[index] = repair;
+    mMismatched++;
+    requests.chunks.push_back(index);
+}
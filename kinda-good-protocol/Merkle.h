@@ -0,0 +1,252 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             Merkle.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Verification of a whole transfer with a Merkle tree over chunks of the
+--                          file. Both sides hash the chunks on a worker pool while the data streams
+--                          through, so the file is never read twice. The sender sends the root with
+--                          the EOT. If the receiver gets a different root it asks for the children
+--                          of every node that does not match until it reaches the chunks that are
+--                          wrong, and fetches only those again.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <QByteArray>
+#include <QMutex>
+#include <QThreadPool>
+
+#include "res.h"
+
+namespace kgp
+{
+    class MerkleTree
+    {
+    private:
+        // Level 0 holds the chunk hashes and the last level the root
+        std::vector<std::vector<QByteArray>> mLevels;
+
+    public:
+        MerkleTree() = default;
+        ~MerkleTree() = default;
+
+        static QByteArray HashChunk(const char *data, const size_t size);
+        static QByteArray HashNodes(const QByteArray& left, const QByteArray& right);
+
+        void Build(const std::vector<QByteArray>& leaves);
+        QByteArray Root() const;
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::MerkleTree::Height
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::MerkleTree::Height()
+        --
+        -- RETURN:                  The number of levels of the tree, 0 if it has no leaves.
+        --------------------------------------------------------------------------------------------------*/
+        inline quint64 Height() const { return mLevels.size(); }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::MerkleTree::Width
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::MerkleTree::Width(const quint64 level)
+        --                              level: The level, 0 for the chunks.
+        --
+        -- RETURN:                  The number of nodes on the level, 0 if there is no such level.
+        --------------------------------------------------------------------------------------------------*/
+        inline quint64 Width(const quint64 level) const { return level < mLevels.size() ? mLevels[level].size() : 0; }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::MerkleTree::Node
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               const QByteArray& kgp::MerkleTree::Node(const quint64 level, const quint64 index)
+        --                              level: The level of the node, 0 for the chunks.
+        --                              index: The index of the node on its level.
+        --
+        -- RETURN:                  The hash of the node. The node has to exist.
+        --------------------------------------------------------------------------------------------------*/
+        inline const QByteArray& Node(const quint64 level, const quint64 index) const { return mLevels[level][index]; }
+    };
+
+    class ChunkHasher
+    {
+    private:
+        class Job;
+
+        QThreadPool mPool;
+        QMutex mMutex;
+
+        // The chunk that is being filled and the hashes of the chunks before it
+        QByteArray mChunk;
+        std::vector<QByteArray> mLeaves;
+        quint64 mSize;
+
+    public:
+        ChunkHasher();
+        ~ChunkHasher();
+
+        void Reset();
+        void Add(const char *data, const size_t size);
+        std::vector<QByteArray> Finish();
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::ChunkHasher::Size
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::ChunkHasher::Size()
+        --
+        -- RETURN:                  The number of bytes added since the last Reset.
+        --------------------------------------------------------------------------------------------------*/
+        inline quint64 Size() { return mSize; }
+
+    private:
+        void submit();
+    };
+
+    class MerkleVerifier
+    {
+    public:
+        struct Requests
+        {
+            // Nodes as level and index whose children are needed
+            std::vector<std::pair<quint64, quint64>> nodes;
+            // Chunks that have to be fetched again
+            std::vector<quint64> chunks;
+        };
+
+    private:
+        struct Repair
+        {
+            QByteArray data;
+            std::vector<bool> frames;
+            quint64 missing;
+            quint64 tries;
+        };
+
+        // Tree over what was received
+        MerkleTree mTree;
+        quint64 mSize;
+
+        // Hashes of the sender that have been checked against the root
+        std::map<std::pair<quint64, quint64>, QByteArray> mProven;
+        // Nodes whose children have been asked for
+        std::set<std::pair<quint64, quint64>> mPending;
+        // Chunks that are being fetched again
+        std::map<quint64, Repair> mRepairs;
+
+        quint64 mMismatched;
+        quint64 mFailed;
+
+    public:
+        MerkleVerifier();
+        ~MerkleVerifier() = default;
+
+        void Reset();
+        void Start(const std::vector<QByteArray>& leaves, const quint64 size, const QByteArray& root, Requests& requests);
+        void AddNodes(const quint64 level, const quint64 first, const std::vector<QByteArray>& hashes, Requests& requests);
+        bool AddFrame(const quint64 offset, const char *data, const size_t size, quint64& chunkOffset, QByteArray& chunk, Requests& requests);
+        void Outstanding(Requests& requests);
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::MerkleVerifier::IsDone
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               bool kgp::MerkleVerifier::IsDone()
+        --
+        -- RETURN:                  True if nothing is being asked for, false otherwise.
+        --------------------------------------------------------------------------------------------------*/
+        inline bool IsDone() { return mPending.empty() && mRepairs.empty(); }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::MerkleVerifier::Mismatched
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::MerkleVerifier::Mismatched()
+        --
+        -- RETURN:                  The number of received chunks that did not match the sender's.
+        --------------------------------------------------------------------------------------------------*/
+        inline quint64 Mismatched() { return mMismatched; }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::MerkleVerifier::Failed
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::MerkleVerifier::Failed()
+        --
+        -- RETURN:                  The number of chunks that were given up on after Verify::MAX_REFETCH
+        --                          tries.
+        --------------------------------------------------------------------------------------------------*/
+        inline quint64 Failed() { return mFailed; }
+
+    private:
+        quint64 chunkSize(const quint64 index);
+        void checkNode(const quint64 level, const quint64 index, Requests& requests);
+    };
+}
@@ -0,0 +1,75 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             PacketView.cpp
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          A received packet read where it was received.
+---------------------------------------------------------------------------------------*/
+#include "PacketView.h"
+
+#include <cstring>
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::PacketView::Parse
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::PacketView::Status kgp::PacketView::Parse(const char *bytes, const size_t size, PacketView& view)
+--                              bytes: The datagram as it was received.
+--                              size: The number of bytes received.
+--                              view: Gets the header and where the data starts in bytes.
+--
+-- RETURN:                  Status::VALID if the packet can be handled, otherwise why it has to be
+--                          dropped.
+--
+-- NOTES:
+--                          The type is checked before the rest of the header is copied. Bytes after
+--                          DataSize are ignored, the checksum covers only what DataSize says. View
+--                          is only filled in for a valid packet.
+--------------------------------------------------------------------------------------------------*/
+kgp::PacketView::Status kgp::PacketView::Parse(const char *bytes, const size_t size, PacketView& view)
+{
+    if (size < Size::HEADER) return Status::SHORT;
+
+    switch (bytes[offsetof(PacketHeader, PacketType)])
+    {
+    case PacketType::DATA:
+    case PacketType::ACK:
+    case PacketType::EOT:
+    case PacketType::SYN:
+    case PacketType::FEC:
+    case PacketType::HASH:
+    case PacketType::REFETCH:
+    case PacketType::PROBE:
+    case PacketType::WINDOW:
+        break;
+    default:
+        return Status::TYPE;
+    }
+
+    PacketHeader header;
+    memcpy(&header, bytes, Size::HEADER);
+    if (header.DataSize > size - Size::HEADER) return Status::TRUNCATED;
+    if (header.DataSize > Size::MAX_DATA) return Status::OVERSIZED;
+
+    view.Header = header;
+    view.Data = bytes + Size::HEADER;
+    return Status::VALID;
+}
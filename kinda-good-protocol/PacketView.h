@@ -0,0 +1,56 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             PacketView.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          A received packet read where it was received. Parsing checks everything
+--                          the rest of the engine relies on before it trusts a byte of the packet:
+--                          that there is a whole header, that the type is one the protocol has and
+--                          that the data the header claims was received and fits in a packet. Only
+--                          the header is copied, so its fields can be read whatever the alignment of
+--                          the buffer, the data is read in place and stays valid for as long as the
+--                          buffer does.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cstddef>
+
+#include <QtGlobal>
+
+#include "res.h"
+
+namespace kgp
+{
+    struct PacketView
+    {
+        enum class Status
+        {
+            VALID,
+            // Less than a header was received
+            SHORT,
+            // The packet type is not one of PacketType
+            TYPE,
+            // DataSize is more than what was received after the header
+            TRUNCATED,
+            // DataSize is more than any packet carries
+            OVERSIZED
+        };
+
+        struct PacketHeader Header;
+        // The DataSize bytes of data that follow the header in the buffer
+        const char *Data;
+
+        static Status Parse(const char *bytes, const size_t size, PacketView& view);
+    };
+}
@@ -0,0 +1,326 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             PathMtu.cpp
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          The search first tries the payload of an Ethernet frame and then the
+--                          largest payload both sides can handle, which settles most paths with one
+--                          or two probes. Anything else is found by halving the range between the
+--                          largest payload that got through and the largest that still may.
+---------------------------------------------------------------------------------------*/
+#include "PathMtu.h"
+
+#include <algorithm>
+#include <limits>
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::PathMtu::PathMtu
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::PathMtu::PathMtu()
+--
+-- NOTES:
+--                          Constructor for the PathMtu. There is nothing to search until Reset is
+--                          called and the payload is Size::DATA.
+--------------------------------------------------------------------------------------------------*/
+kgp::PathMtu::PathMtu()
+{
+    Reset(Size::DATA);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::PathMtu::Reset
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::PathMtu::Reset(const quint64 max)
+--                              max: The largest payload both sides can handle.
+--
+-- NOTES:
+--                          Starts a new search up to max. Until a larger payload gets through
+--                          Size::DATA is used, or max if that is smaller.
+--------------------------------------------------------------------------------------------------*/
+void kgp::PathMtu::Reset(const quint64 max)
+{
+    mHigh = max;
+    mLow = std::min<quint64>(Size::MIN_DATA, max);
+    mCandidates.assign({ Pmtu::ETHERNET, max });
+    mProbe = 0;
+    mTries = 0;
+    mOutstanding = false;
+    mConfirming = false;
+    mProbeTimer.Start();
+    mStart = std::min<quint64>(Size::DATA, max);
+    mBlackHoles = 0;
+    update();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::PathMtu::NextProbe
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::PathMtu::NextProbe(quint64& size)
+--                              size: Gets the payload of the probe to send.
+--
+-- RETURN:                  True if a probe has to be sent, false if one is still waiting for its
+--                          answer or there is nothing left to probe.
+--
+-- NOTES:
+--                          A probe that timed out is sent again with the same size until it has
+--                          been sent Pmtu::MAX_PROBES times.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::PathMtu::NextProbe(quint64& size)
+{
+    if (mOutstanding || (!mConfirming && !IsSearching())) return false;
+
+    if (mProbe == 0)
+    {
+        while (!mCandidates.empty() && (mCandidates.front() <= mLow || mCandidates.front() > mHigh)) mCandidates.pop_front();
+        if (!mCandidates.empty())
+        {
+            mProbe = mCandidates.front();
+            mCandidates.pop_front();
+        }
+        else
+        {
+            mProbe = (mLow + mHigh + 1) / 2;
+        }
+    }
+
+    size = mProbe;
+    mTries++;
+    mOutstanding = true;
+    mProbeTimer.Start();
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::PathMtu::ProbeAcked
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::PathMtu::ProbeAcked(const quint64 size)
+--                              size: The payload the receiver got.
+--
+-- NOTES:
+--                          A payload got through whole. An answer to an earlier probe that arrives
+--                          late still counts.
+--------------------------------------------------------------------------------------------------*/
+void kgp::PathMtu::ProbeAcked(const quint64 size)
+{
+    if (size > mLow && size <= mHigh) mLow = size;
+    if (size == mProbe)
+    {
+        mProbe = 0;
+        mTries = 0;
+        mOutstanding = false;
+        mConfirming = false;
+    }
+    update();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::PathMtu::ProbeTooBig
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::PathMtu::ProbeTooBig(const quint64 size)
+--                              size: The payload of the probe.
+--
+-- NOTES:
+--                          The probe could not even leave this host, there is no need to wait for
+--                          it to time out.
+--------------------------------------------------------------------------------------------------*/
+void kgp::PathMtu::ProbeTooBig(const quint64 size)
+{
+    if (size != mProbe) return;
+
+    if (mConfirming) dropPayload();
+    else mHigh = std::min(mHigh, size - 1);
+    mProbe = 0;
+    mTries = 0;
+    mOutstanding = false;
+    update();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::PathMtu::CheckProbe
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::PathMtu::CheckProbe()
+--
+-- RETURN:                  True if the probe timed out and the next one can be sent, false otherwise.
+--
+-- NOTES:
+--                          Once a probe has timed out Pmtu::MAX_PROBES times its payload is taken to
+--                          be too large for the path. If it was confirming the payload in use, the
+--                          path has stopped carrying it and the payload is dropped.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::PathMtu::CheckProbe()
+{
+    if (!mOutstanding || mProbeTimer.Elapsed() <= Pmtu::PROBE_TIMEOUT) return false;
+
+    mOutstanding = false;
+    if (mTries >= Pmtu::MAX_PROBES)
+    {
+        if (mConfirming) dropPayload();
+        else mHigh = std::min(mHigh, mProbe - 1);
+        mProbe = 0;
+        mTries = 0;
+        update();
+    }
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::PathMtu::ProbeDeadline
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               quint64 kgp::PathMtu::ProbeDeadline()
+--
+-- RETURN:                  The clock time at which the outstanding probe times out, or the largest
+--                          quint64 if there is none.
+--------------------------------------------------------------------------------------------------*/
+quint64 kgp::PathMtu::ProbeDeadline()
+{
+    if (!mOutstanding) return std::numeric_limits<quint64>::max();
+    return mProbeTimer.Started() + Pmtu::PROBE_TIMEOUT + 1;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::PathMtu::DataTimedOut
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::PathMtu::DataTimedOut()
+--
+-- NOTES:
+--                          A receive timeout is either loss or a path that stopped carrying the
+--                          payload in use. The next probe has the size of that payload and replaces
+--                          any probe of the search, its answer tells the two apart within a couple
+--                          of probe timeouts instead of more receive timeouts.
+--------------------------------------------------------------------------------------------------*/
+void kgp::PathMtu::DataTimedOut()
+{
+    if (mConfirming || mPayload <= Size::MIN_DATA) return;
+
+    mConfirming = true;
+    mProbe = mPayload;
+    mTries = 0;
+    mOutstanding = false;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::PathMtu::dropPayload
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::PathMtu::dropPayload()
+--
+-- NOTES:
+--                          The payload in use no longer gets through. It drops to Size::MIN_DATA and
+--                          the search starts over below the payload that stopped working.
+--------------------------------------------------------------------------------------------------*/
+void kgp::PathMtu::dropPayload()
+{
+    mHigh = mPayload - 1;
+    mLow = Size::MIN_DATA;
+    mCandidates.clear();
+    mStart = Size::MIN_DATA;
+    mConfirming = false;
+    mBlackHoles++;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::PathMtu::update
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::PathMtu::update()
+--
+-- NOTES:
+--                          Picks the payload for new frames. While searching the starting payload
+--                          is kept unless a larger one got through or it may not fit anymore. Once
+--                          the search is over the largest payload that got through is used, so a
+--                          path with a small MTU no longer fragments frames.
+--------------------------------------------------------------------------------------------------*/
+void kgp::PathMtu::update()
+{
+    if (IsSearching() && mStart <= mHigh) mPayload = std::max(mLow, mStart);
+    else mPayload = mLow;
+}
@@ -0,0 +1,128 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             PathMtu.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Path MTU discovery on the sender. Probes of padding are sent next to the
+--                          data without letting the path fragment them, a probe that is answered
+--                          proves that its payload gets through whole. The largest payload that got
+--                          through is used for new frames once the search is over. A receive timeout
+--                          is confirmed with a probe of the payload in use. If the path no longer
+--                          carries it the payload drops to one every path carries and the search
+--                          starts over below the payload that stopped working.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <deque>
+
+#include "res.h"
+#include "Timer.h"
+
+namespace kgp
+{
+    class PathMtu
+    {
+    private:
+        // Largest payload that is known to get through and the largest that may
+        quint64 mLow;
+        quint64 mHigh;
+        // Sizes to probe before the search halves the range
+        std::deque<quint64> mCandidates;
+
+        // Payload of the probe that is waiting for an answer, 0 if there is none
+        quint64 mProbe;
+        // Number of times mProbe has been sent
+        quint64 mTries;
+        bool mOutstanding;
+        // Whether mProbe checks that the payload in use still gets through
+        bool mConfirming;
+        Timer mProbeTimer;
+
+        // Payload used while searching until a larger one gets through
+        quint64 mStart;
+        // Payload used for new frames
+        quint64 mPayload;
+        // Times the payload in use stopped getting through
+        quint64 mBlackHoles;
+
+    public:
+        PathMtu();
+        ~PathMtu() = default;
+
+        void Reset(const quint64 max);
+
+        bool NextProbe(quint64& size);
+        void ProbeAcked(const quint64 size);
+        void ProbeTooBig(const quint64 size);
+        bool CheckProbe();
+        quint64 ProbeDeadline();
+
+        void DataTimedOut();
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::PathMtu::Payload
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::PathMtu::Payload()
+        --
+        -- RETURN:                  The payload new frames are cut to.
+        --------------------------------------------------------------------------------------------------*/
+        inline quint64 Payload() const { return mPayload; }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::PathMtu::IsSearching
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               bool kgp::PathMtu::IsSearching()
+        --
+        -- RETURN:                  True if there are payloads left to probe, false otherwise.
+        --------------------------------------------------------------------------------------------------*/
+        inline bool IsSearching() const { return mHigh >= mLow + Pmtu::STEP; }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::PathMtu::BlackHoles
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::PathMtu::BlackHoles()
+        --
+        -- RETURN:                  The number of times the payload was dropped since the last Reset.
+        --------------------------------------------------------------------------------------------------*/
+        inline quint64 BlackHoles() const { return mBlackHoles; }
+
+    private:
+        void dropPayload();
+        void update();
+    };
+}
@@ -0,0 +1,364 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             Reactor.cpp
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          An event loop built on epoll that does not need a Qt event loop.
+---------------------------------------------------------------------------------------*/
+#include "Reactor.h"
+
+#if defined(__linux__)
+
+#include <cerrno>
+#include <cstring>
+#include <limits>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace
+{
+    // Events taken from the kernel in one wait
+    constexpr int EVENTS = 16;
+
+    // Adds socket to the sockets epoll waits on until it can be read
+    bool addReadable(const int epoll, const int socket)
+    {
+        epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.fd = socket;
+        return epoll_ctl(epoll, EPOLL_CTL_ADD, socket, &event) == 0;
+    }
+
+    // Reads the 8 byte counter of a timerfd or eventfd so that it stops being readable
+    void drain(const int descriptor)
+    {
+        quint64 count;
+        while (read(descriptor, &count, sizeof(count)) < 0 && errno == EINTR);
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::Reactor::Reactor
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::Reactor::Reactor()
+--
+-- NOTES:
+--                          Constructor for the Reactor. Creates the epoll instance along with the
+--                          timer and the wake up descriptors it always waits on. IsValid tells if
+--                          any of them could not be created.
+--------------------------------------------------------------------------------------------------*/
+kgp::Reactor::Reactor()
+    : mEpoll(epoll_create1(EPOLL_CLOEXEC))
+    , mTimer(timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC))
+    , mWake(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+    , mStopped(false)
+    , mSyscalls(0)
+{
+    if (!IsValid()) return;
+
+    addReadable(mEpoll, mTimer);
+    addReadable(mEpoll, mWake);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::Reactor::~Reactor
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::Reactor::~Reactor()
+--
+-- NOTES:
+--                          Deconstructor for the Reactor. Closes the descriptors it created, the
+--                          sockets it watched belong to whoever handed them over.
+--------------------------------------------------------------------------------------------------*/
+kgp::Reactor::~Reactor()
+{
+    if (mWake != -1) close(mWake);
+    if (mTimer != -1) close(mTimer);
+    if (mEpoll != -1) close(mEpoll);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::Reactor::Watch
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::Reactor::Watch(const int socket, const Handler& handler)
+--                              socket: The socket to wait on.
+--                              handler: Called on the loop every time the socket can be read.
+--
+-- RETURN:                  True if the socket is waited on, false otherwise.
+--
+-- NOTES:
+--                          The loop keeps calling handler for as long as something is left to read,
+--                          so handler does not have to read everything at once. Has to be called
+--                          before the loop runs or on the loop.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::Reactor::Watch(const int socket, const Handler& handler)
+{
+    if (!IsValid() || socket < 0 || mWatched.count(socket)) return false;
+    if (!addReadable(mEpoll, socket)) return false;
+
+    mWatched[socket] = handler;
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::Reactor::Unwatch
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::Reactor::Unwatch(const int socket)
+--                              socket: The socket to stop waiting on.
+--
+-- NOTES:
+--                          Has to be called before the socket is closed, and before the loop runs
+--                          or on the loop.
+--------------------------------------------------------------------------------------------------*/
+void kgp::Reactor::Unwatch(const int socket)
+{
+    if (!mWatched.erase(socket)) return;
+    epoll_ctl(mEpoll, EPOLL_CTL_DEL, socket, nullptr);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::Reactor::SetTimer
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::Reactor::SetTimer(const quint64 ms)
+--                              ms: The milliseconds from now the timer fires in, the largest quint64
+--                                  to not fire at all.
+--
+-- NOTES:
+--                          Replaces the time the timer was set to before. The timer fires once, a
+--                          timer set to 0 fires on the next turn of the loop.
+--------------------------------------------------------------------------------------------------*/
+void kgp::Reactor::SetTimer(const quint64 ms)
+{
+    itimerspec time;
+    memset(&time, 0, sizeof(time));
+    if (ms != std::numeric_limits<quint64>::max())
+    {
+        time.it_value.tv_sec = (time_t)(ms / 1000);
+        time.it_value.tv_nsec = (long)(ms % 1000) * 1000000;
+        // A value of 0 would disarm the timer instead
+        if (ms == 0) time.it_value.tv_nsec = 1;
+    }
+    mSyscalls++;
+    timerfd_settime(mTimer, 0, &time, nullptr);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::Reactor::Post
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::Reactor::Post(const Handler& task)
+--                              task: The work to run on the loop.
+--
+-- NOTES:
+--                          Hands task to the loop and wakes it up. Can be called from any thread,
+--                          tasks run in the order they were posted.
+--------------------------------------------------------------------------------------------------*/
+void kgp::Reactor::Post(const Handler& task)
+{
+    {
+        std::lock_guard<std::mutex> locker(mPostedMutex);
+        mPosted.push_back(task);
+    }
+
+    const quint64 one = 1;
+    while (write(mWake, &one, sizeof(one)) < 0 && errno == EINTR);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::Reactor::RunOnce
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::Reactor::RunOnce(const int timeout)
+--                              timeout: The milliseconds to wait for something to happen, -1 to
+--                                       wait until it does.
+--
+-- RETURN:                  False once the loop has been stopped, true otherwise.
+--
+-- NOTES:
+--                          Waits once and calls the handlers of everything that happened. Posted
+--                          tasks run first so that work handed over before a packet arrived is not
+--                          passed by it.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::Reactor::RunOnce(const int timeout)
+{
+    if (!IsValid() || mStopped) return false;
+
+    epoll_event events[EVENTS];
+    mSyscalls++;
+    const int count = epoll_wait(mEpoll, events, EVENTS, timeout);
+    if (count < 0) return !mStopped;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (events[i].data.fd != mWake) continue;
+        mSyscalls++;
+        drain(mWake);
+        runPosted();
+    }
+
+    for (int i = 0; i < count && !mStopped; i++)
+    {
+        const int descriptor = events[i].data.fd;
+        if (descriptor == mWake) continue;
+
+        if (descriptor == mTimer)
+        {
+            mSyscalls++;
+            drain(mTimer);
+            if (mTimerHandler) mTimerHandler();
+            continue;
+        }
+
+        // The handler may stop watching its own socket
+        auto watched = mWatched.find(descriptor);
+        if (watched == mWatched.end()) continue;
+        const Handler handler = watched->second;
+        handler();
+    }
+
+    return !mStopped;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::Reactor::Run
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::Reactor::Run()
+--
+-- NOTES:
+--                          Runs the loop on the calling thread until Stop is called.
+--------------------------------------------------------------------------------------------------*/
+void kgp::Reactor::Run()
+{
+    while (RunOnce());
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::Reactor::Stop
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::Reactor::Stop()
+--
+-- NOTES:
+--                          Stops the loop for good and wakes it up if it is waiting. Can be called
+--                          from any thread.
+--------------------------------------------------------------------------------------------------*/
+void kgp::Reactor::Stop()
+{
+    mStopped = true;
+
+    const quint64 one = 1;
+    while (write(mWake, &one, sizeof(one)) < 0 && errno == EINTR);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::Reactor::runPosted
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::Reactor::runPosted()
+--
+-- NOTES:
+--                          Runs the tasks that have been posted so far. Tasks posted while they
+--                          run wait for the next turn.
+--------------------------------------------------------------------------------------------------*/
+void kgp::Reactor::runPosted()
+{
+    std::vector<Handler> tasks;
+    {
+        std::lock_guard<std::mutex> locker(mPostedMutex);
+        tasks.swap(mPosted);
+    }
+
+    for (const Handler& task : tasks) task();
+}
+
+#endif
@@ -0,0 +1,124 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             Reactor.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          An event loop built on epoll that does not need a Qt event loop. It
+--                          waits on the sockets it watches, a timerfd for the next timeout and an
+--                          eventfd that other threads use to hand it work or stop it. Everything it
+--                          calls runs on the thread that runs it. Only available on Linux.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#if defined(__linux__)
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include <QtGlobal>
+
+namespace kgp
+{
+    class Reactor
+    {
+    public:
+        using Handler = std::function<void()>;
+
+    private:
+        int mEpoll;
+        int mTimer;
+        int mWake;
+        std::atomic<bool> mStopped;
+        // System calls made by the thread that runs the loop
+        quint64 mSyscalls;
+
+        // Called when the socket of the key can be read
+        std::map<int, Handler> mWatched;
+        Handler mTimerHandler;
+
+        // Work handed over by other threads, run on the next turn of the loop
+        std::mutex mPostedMutex;
+        std::vector<Handler> mPosted;
+
+        void runPosted();
+
+    public:
+        Reactor();
+        ~Reactor();
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::Reactor::IsValid
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               bool kgp::Reactor::IsValid()
+        --
+        -- RETURN:                  True if the descriptors the loop waits on were all created.
+        --------------------------------------------------------------------------------------------------*/
+        inline bool IsValid() const { return mEpoll != -1 && mTimer != -1 && mWake != -1; }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::Reactor::SetTimerHandler
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               void kgp::Reactor::SetTimerHandler(const Handler& handler)
+        --                              handler: Called when the timer set with SetTimer fires.
+        --------------------------------------------------------------------------------------------------*/
+        inline void SetTimerHandler(const Handler& handler) { mTimerHandler = handler; }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::Reactor::Syscalls
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::Reactor::Syscalls()
+        --
+        -- RETURN:                  The waits, timer changes and descriptor reads the loop made so far.
+        --                          Only read it on the loop or once the loop has stopped.
+        --------------------------------------------------------------------------------------------------*/
+        inline quint64 Syscalls() const { return mSyscalls; }
+
+        bool Watch(const int socket, const Handler& handler);
+        void Unwatch(const int socket);
+        void SetTimer(const quint64 ms);
+        void Post(const Handler& task);
+        bool RunOnce(const int timeout = -1);
+        void Run();
+        void Stop();
+    };
+}
+
+#endif
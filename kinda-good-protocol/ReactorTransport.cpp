@@ -0,0 +1,612 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             ReactorTransport.cpp
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          A transport over a native UDP socket that a Reactor waits on.
+---------------------------------------------------------------------------------------*/
+#include "ReactorTransport.h"
+
+#if defined(__linux__)
+
+#include <cerrno>
+#include <cstring>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace
+{
+    // Sets whether datagrams sent on the socket may be fragmented. A dual stack socket sends to
+    // IPv4 hosts under the IPv4 option
+    bool setDontFragment(const int socket, const int family, const bool on)
+    {
+        const int value = on ? IP_PMTUDISC_PROBE : IP_PMTUDISC_DONT;
+        bool set = setsockopt(socket, IPPROTO_IP, IP_MTU_DISCOVER, &value, sizeof(value)) == 0;
+        if (family == AF_INET6)
+        {
+            const int value6 = on ? IPV6_PMTUDISC_PROBE : IPV6_PMTUDISC_DONT;
+            set = setsockopt(socket, IPPROTO_IPV6, IPV6_MTU_DISCOVER, &value6, sizeof(value6)) == 0 || set;
+        }
+        return set;
+    }
+
+    // Fills in the native address of address and port for the family the socket was opened with
+    bool toNativeAddress(const int family, const QHostAddress& address, const short& port, sockaddr_storage& native, socklen_t& length)
+    {
+        memset(&native, 0, sizeof(native));
+        bool isIpv4 = false;
+        const quint32 ipv4 = address.toIPv4Address(&isIpv4);
+        if (family == AF_INET)
+        {
+            if (!isIpv4) return false;
+            sockaddr_in *to = (sockaddr_in *)&native;
+            to->sin_family = AF_INET;
+            to->sin_port = htons((quint16)port);
+            to->sin_addr.s_addr = htonl(ipv4);
+            length = sizeof(*to);
+            return true;
+        }
+        if (family == AF_INET6)
+        {
+            // IPv4 hosts are reached through their mapped address
+            const Q_IPV6ADDR ipv6 = address.toIPv6Address();
+            sockaddr_in6 *to = (sockaddr_in6 *)&native;
+            to->sin6_family = AF_INET6;
+            to->sin6_port = htons((quint16)port);
+            memcpy(&to->sin6_addr, ipv6.c, sizeof(ipv6.c));
+            length = sizeof(*to);
+            return true;
+        }
+        return false;
+    }
+
+    // The address a datagram came from, IPv4 hosts on a dual stack socket are given as IPv4 so that
+    // they compare equal to the address they were sent to
+    QHostAddress fromNativeAddress(const sockaddr_storage& native, quint16& port)
+    {
+        if (native.ss_family == AF_INET)
+        {
+            const sockaddr_in *from = (const sockaddr_in *)&native;
+            port = ntohs(from->sin_port);
+            return QHostAddress(ntohl(from->sin_addr.s_addr));
+        }
+
+        const sockaddr_in6 *from = (const sockaddr_in6 *)&native;
+        port = ntohs(from->sin6_port);
+        if (IN6_IS_ADDR_V4MAPPED(&from->sin6_addr))
+        {
+            quint32 ipv4;
+            memcpy(&ipv4, from->sin6_addr.s6_addr + 12, sizeof(ipv4));
+            return QHostAddress(ntohl(ipv4));
+        }
+
+        Q_IPV6ADDR ipv6;
+        memcpy(ipv6.c, &from->sin6_addr, sizeof(ipv6.c));
+        return QHostAddress(ipv6);
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::ReactorTransport::ReactorTransport
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::ReactorTransport::ReactorTransport(Reactor& reactor, QObject *parent)
+--                              reactor: The loop that waits on the socket. Must outlive the
+--                                       transport.
+--                              parent: The parent QObject.
+--
+-- NOTES:
+--                          Constructor for the ReactorTransport. No socket is opened until Bind.
+--------------------------------------------------------------------------------------------------*/
+kgp::ReactorTransport::ReactorTransport(Reactor& reactor, QObject *parent)
+    : Transport(parent)
+    , mReactor(reactor)
+    , mSocket(-1)
+    , mFamily(AF_UNSPEC)
+    , mSyscalls(0)
+    , mHasPending(false)
+    , mPending()
+{
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::ReactorTransport::~ReactorTransport
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::ReactorTransport::~ReactorTransport()
+--
+-- NOTES:
+--                          Deconstructor for the ReactorTransport. Closes the socket.
+--------------------------------------------------------------------------------------------------*/
+kgp::ReactorTransport::~ReactorTransport()
+{
+    Close();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::ReactorTransport::Bind
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::ReactorTransport::Bind(const QHostAddress& address, const short& port)
+--                              address: The local address to bind to.
+--                              port: The local port to bind to.
+--
+-- RETURN:                  True if the socket was opened, bound and handed to the reactor.
+--
+-- NOTES:
+--                          Opens a socket of the family of address. Any is bound on a dual stack
+--                          socket like Qt does, or on IPv4 alone where there is no IPv6. The socket
+--                          blocks on sends so that a full send buffer slows the sender down instead
+--                          of dropping frames, reads never block. Once bound the socket is handed
+--                          to the reactor by watch.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::ReactorTransport::Bind(const QHostAddress& address, const short& port)
+{
+    Close();
+
+    sockaddr_storage local;
+    socklen_t length = 0;
+    memset(&local, 0, sizeof(local));
+
+    bool isIpv4 = false;
+    const quint32 ipv4 = address.toIPv4Address(&isIpv4);
+    const bool any = address == QHostAddress(QHostAddress::Any);
+    if (any || !isIpv4) mSocket = socket(AF_INET6, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+
+    if (mSocket != -1)
+    {
+        mFamily = AF_INET6;
+        const int v6Only = any ? 0 : 1;
+        setsockopt(mSocket, IPPROTO_IPV6, IPV6_V6ONLY, &v6Only, sizeof(v6Only));
+
+        sockaddr_in6 *to = (sockaddr_in6 *)&local;
+        to->sin6_family = AF_INET6;
+        to->sin6_port = htons((quint16)port);
+        if (any)
+        {
+            to->sin6_addr = in6addr_any;
+        }
+        else
+        {
+            const Q_IPV6ADDR ipv6 = address.toIPv6Address();
+            memcpy(&to->sin6_addr, ipv6.c, sizeof(ipv6.c));
+        }
+        length = sizeof(*to);
+    }
+    else if (any || isIpv4)
+    {
+        mSocket = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        mFamily = AF_INET;
+
+        sockaddr_in *to = (sockaddr_in *)&local;
+        to->sin_family = AF_INET;
+        to->sin_port = htons((quint16)port);
+        to->sin_addr.s_addr = any ? htonl(INADDR_ANY) : htonl(ipv4);
+        length = sizeof(*to);
+    }
+
+    if (mSocket == -1 || bind(mSocket, (const sockaddr *)&local, length) != 0 || !watch())
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::ReactorTransport::Close
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::ReactorTransport::Close()
+--
+-- NOTES:
+--                          Takes the socket away from the reactor and closes it. Has to be called
+--                          while the reactor is not running or on its thread.
+--------------------------------------------------------------------------------------------------*/
+void kgp::ReactorTransport::Close()
+{
+    mHasPending = false;
+    mPending = QNetworkDatagram();
+    if (mSocket == -1) return;
+
+    mReactor.Unwatch(mSocket);
+    close(mSocket);
+    mSocket = -1;
+    mFamily = AF_UNSPEC;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::ReactorTransport::Send
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               qint64 kgp::ReactorTransport::Send(const char *data, const qint64 size, const QHostAddress& address, const short& port)
+--                              data: The start of the datagram.
+--                              size: The size of the datagram.
+--                              address: The address to send to.
+--                              port: The port to send to.
+--
+-- RETURN:                  The number of bytes sent or -1 on error.
+--------------------------------------------------------------------------------------------------*/
+qint64 kgp::ReactorTransport::Send(const char *data, const qint64 size, const QHostAddress& address, const short& port)
+{
+    sockaddr_storage to;
+    socklen_t length;
+    if (mSocket == -1 || !toNative(address, port, to, length)) return -1;
+
+    ssize_t result;
+    do
+    {
+        mSyscalls++;
+        result = sendto(mSocket, data, (size_t)size, 0, (const sockaddr *)&to, length);
+    } while (result < 0 && errno == EINTR);
+    return result;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::ReactorTransport::SendProbe
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               qint64 kgp::ReactorTransport::SendProbe(const char *data, const qint64 size, const QHostAddress& address, const short& port)
+--                              data: The start of the datagram.
+--                              size: The size of the datagram.
+--                              address: The address to send to.
+--                              port: The port to send to.
+--
+-- RETURN:                  The number of bytes sent or -1 on error.
+--
+-- NOTES:
+--                          Writes a single datagram with the don't fragment bit set, the same way
+--                          UdpTransport does.
+--------------------------------------------------------------------------------------------------*/
+qint64 kgp::ReactorTransport::SendProbe(const char *data, const qint64 size, const QHostAddress& address, const short& port)
+{
+    if (mSocket == -1 || !setDontFragment(mSocket, mFamily, true)) return Send(data, size, address, port);
+
+    const qint64 sent = Send(data, size, address, port);
+    setDontFragment(mSocket, mFamily, false);
+    return sent;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::ReactorTransport::SendGather
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               qint64 kgp::ReactorTransport::SendGather(const char *header, const qint64 headerSize, const char *data, const qint64 dataSize, const QHostAddress& address, const short& port, const bool probe)
+--                              header: The start of the header.
+--                              headerSize: The size of the header.
+--                              data: The start of the data that follows the header.
+--                              dataSize: The size of the data.
+--                              address: The address to send to.
+--                              port: The port to send to.
+--                              probe: Whether the datagram must not be fragmented on its way.
+--
+-- RETURN:                  The number of bytes sent or -1 on error.
+--
+-- NOTES:
+--                          Hands the header and the data to the kernel as two pieces of one
+--                          datagram so that neither is copied first.
+--------------------------------------------------------------------------------------------------*/
+qint64 kgp::ReactorTransport::SendGather(const char *header, const qint64 headerSize, const char *data, const qint64 dataSize, const QHostAddress& address, const short& port, const bool probe)
+{
+    sockaddr_storage to;
+    socklen_t length;
+    if (mSocket == -1 || !toNative(address, port, to, length)) return -1;
+
+    const bool dontFragment = probe && setDontFragment(mSocket, mFamily, true);
+
+    iovec buffers[2];
+    buffers[0].iov_base = (void *)header;
+    buffers[0].iov_len = (size_t)headerSize;
+    buffers[1].iov_base = (void *)data;
+    buffers[1].iov_len = (size_t)dataSize;
+
+    msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_name = &to;
+    message.msg_namelen = length;
+    message.msg_iov = buffers;
+    message.msg_iovlen = dataSize > 0 ? 2 : 1;
+
+    ssize_t result;
+    do
+    {
+        mSyscalls++;
+        result = sendmsg(mSocket, &message, 0);
+    } while (result < 0 && errno == EINTR);
+
+    if (dontFragment) setDontFragment(mSocket, mFamily, false);
+    return result;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::ReactorTransport::HasPendingDatagrams
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::ReactorTransport::HasPendingDatagrams()
+--
+-- RETURN:                  True if there is at least one datagram waiting to be read.
+--
+-- NOTES:
+--                          Reads the next datagram right away and keeps it for Receive, finding
+--                          out that there is one costs as much as reading it.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::ReactorTransport::HasPendingDatagrams()
+{
+    if (mHasPending) return true;
+    if (mSocket == -1) return false;
+
+    sockaddr_storage from;
+    socklen_t length = sizeof(from);
+    ssize_t size;
+    do
+    {
+        mSyscalls++;
+        size = recvfrom(mSocket, mBuffer, sizeof(mBuffer), MSG_DONTWAIT, (sockaddr *)&from, &length);
+    } while (size < 0 && errno == EINTR);
+    if (size < 0) return false;
+
+    quint16 port = 0;
+    const QHostAddress sender = fromNative(from, port);
+    mPending = QNetworkDatagram(QByteArray(mBuffer, (int)size));
+    mPending.setSender(sender, port);
+    mHasPending = true;
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::ReactorTransport::Receive
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               QNetworkDatagram kgp::ReactorTransport::Receive()
+--
+-- RETURN:                  The next pending datagram along with its sender, or an empty datagram if
+--                          there is none.
+--------------------------------------------------------------------------------------------------*/
+QNetworkDatagram kgp::ReactorTransport::Receive()
+{
+    if (!HasPendingDatagrams()) return QNetworkDatagram();
+
+    mHasPending = false;
+    QNetworkDatagram datagram = mPending;
+    mPending = QNetworkDatagram();
+    return datagram;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::ReactorTransport::ReadFile
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::ReactorTransport::ReadFile(QFile& file, QByteArray& data)
+--                              file: The open file to read.
+--                              data: The bytes from the position of file to its end are appended to
+--                                    this.
+--
+-- RETURN:                  True if the file was read, false otherwise.
+--
+-- NOTES:
+--                          Reads straight into data with as few reads as the kernel allows, so that
+--                          they can be counted.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::ReactorTransport::ReadFile(QFile& file, QByteArray& data)
+{
+    const int handle = file.handle();
+    if (handle == -1) return Transport::ReadFile(file, data);
+
+    const qint64 start = file.pos();
+    const qint64 size = file.size() - start;
+    if (size <= 0) return true;
+
+    const int before = data.size();
+    data.resize(before + (int)size);
+    qint64 done = 0;
+    ssize_t result = 0;
+    while (done < size)
+    {
+        mSyscalls++;
+        result = pread(handle, data.data() + before + done, (size_t)(size - done), (off_t)(start + done));
+        if (result < 0 && errno == EINTR) continue;
+        if (result <= 0) break;
+        done += result;
+    }
+
+    data.resize(before + (int)done);
+    file.seek(start + done);
+    return result >= 0;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::ReactorTransport::WriteFile
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               qint64 kgp::ReactorTransport::WriteFile(QFile& file, const qint64 offset, const char *data, const qint64 size)
+--                              file: The open file to write to.
+--                              offset: Where in the file to write.
+--                              data: The bytes to write.
+--                              size: The number of bytes.
+--
+-- RETURN:                  The number of bytes written, or -1 on error.
+--
+-- NOTES:
+--                          Writes at offset without moving the position of file, which saves the
+--                          seek a QFile write would take.
+--------------------------------------------------------------------------------------------------*/
+qint64 kgp::ReactorTransport::WriteFile(QFile& file, const qint64 offset, const char *data, const qint64 size)
+{
+    const int handle = file.handle();
+    if (handle == -1) return Transport::WriteFile(file, offset, data, size);
+
+    qint64 written = 0;
+    while (written < size)
+    {
+        mSyscalls++;
+        const ssize_t result = pwrite(handle, data + written, (size_t)(size - written), (off_t)(offset + written));
+        if (result < 0 && errno == EINTR) continue;
+        if (result <= 0) return written > 0 ? written : -1;
+        written += result;
+    }
+    return written;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::ReactorTransport::watch
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::ReactorTransport::watch()
+--
+-- RETURN:                  True if the reactor waits on the socket.
+--
+-- NOTES:
+--                          Called by Bind once the socket is bound. readyRead is emitted whenever
+--                          the socket can be read, a transport that reads the socket some other way
+--                          waits on something else instead.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::ReactorTransport::watch()
+{
+    return mReactor.Watch(mSocket, [this]() { emit readyRead(); });
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::ReactorTransport::toNative
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::ReactorTransport::toNative(const QHostAddress& address, const short& port, sockaddr_storage& native, socklen_t& length)
+--                              address: The address to convert.
+--                              port: The port to convert.
+--                              native: Set to the native address.
+--                              length: Set to the size of the native address.
+--
+-- RETURN:                  True if address can be reached from the socket.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::ReactorTransport::toNative(const QHostAddress& address, const short& port, sockaddr_storage& native, socklen_t& length) const
+{
+    return toNativeAddress(mFamily, address, port, native, length);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::ReactorTransport::fromNative
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               QHostAddress kgp::ReactorTransport::fromNative(const sockaddr_storage& native, quint16& port)
+--                              native: The native address a datagram came from.
+--                              port: Set to the port it came from.
+--
+-- RETURN:                  The address it came from.
+--------------------------------------------------------------------------------------------------*/
+QHostAddress kgp::ReactorTransport::fromNative(const sockaddr_storage& native, quint16& port)
+{
+    return fromNativeAddress(native, port);
+}
+
+#endif
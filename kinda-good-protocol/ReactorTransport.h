@@ -0,0 +1,88 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             ReactorTransport.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          A transport over a native UDP socket that a Reactor waits on instead of
+--                          the Qt event loop. readyRead is emitted on the thread that runs the
+--                          reactor. Only available on Linux.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#if defined(__linux__)
+
+#include <sys/socket.h>
+
+#include "Reactor.h"
+#include "Transport.h"
+
+namespace kgp
+{
+    class ReactorTransport : public Transport
+    {
+        Q_OBJECT
+
+    protected:
+        Reactor& mReactor;
+        int mSocket;
+        int mFamily;
+        // System calls made to move datagrams and file data
+        quint64 mSyscalls;
+
+        virtual bool watch();
+        bool toNative(const QHostAddress& address, const short& port, sockaddr_storage& native, socklen_t& length) const;
+        static QHostAddress fromNative(const sockaddr_storage& native, quint16& port);
+
+    private:
+        // A datagram HasPendingDatagrams read ahead of Receive, so that each one takes a single
+        // system call
+        bool mHasPending;
+        QNetworkDatagram mPending;
+        char mBuffer[65536];
+
+    public:
+        ReactorTransport(Reactor& reactor, QObject *parent = nullptr);
+        virtual ~ReactorTransport();
+
+        bool Bind(const QHostAddress& address, const short& port) override;
+        void Close() override;
+        qint64 Send(const char *data, const qint64 size, const QHostAddress& address, const short& port) override;
+        qint64 SendProbe(const char *data, const qint64 size, const QHostAddress& address, const short& port) override;
+        qint64 SendGather(const char *header, const qint64 headerSize, const char *data, const qint64 dataSize, const QHostAddress& address, const short& port, const bool probe = false) override;
+        bool HasPendingDatagrams() override;
+        QNetworkDatagram Receive() override;
+        bool ReadFile(QFile& file, QByteArray& data) override;
+        qint64 WriteFile(QFile& file, const qint64 offset, const char *data, const qint64 size) override;
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::ReactorTransport::Syscalls
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::ReactorTransport::Syscalls()
+        --
+        -- RETURN:                  The system calls made to send and receive datagrams and to read and
+        --                          write files so far.
+        --------------------------------------------------------------------------------------------------*/
+        inline quint64 Syscalls() const override { return mSyscalls; }
+    };
+}
+
+#endif
@@ -0,0 +1,111 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             ReplayFilter.cpp
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Nonces are forgotten oldest first once they are older than the replay
+--                          window, the clock of the receiver is the only one that is trusted.
+---------------------------------------------------------------------------------------*/
+#include "ReplayFilter.h"
+
+#include <random>
+
+#include "DependencyManager.h"
+#include "res.h"
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::ReplayFilter::NewNonce
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               quint64 kgp::ReplayFilter::NewNonce()
+--
+-- RETURN:                  A random nonce that is never 0.
+--
+-- NOTES:
+--                          The generator is seeded once from the system, so the nonces of two
+--                          senders that start at the same time still differ.
+--------------------------------------------------------------------------------------------------*/
+quint64 kgp::ReplayFilter::NewNonce()
+{
+    static std::mt19937_64 generator(((quint64)std::random_device()() << 32) ^ std::random_device()());
+    quint64 nonce;
+    do nonce = generator(); while (nonce == 0);
+    return nonce;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::ReplayFilter::Admit
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::ReplayFilter::Admit(const quint64 nonce)
+--                              nonce: The nonce of a SYN that carries data.
+--
+-- RETURN:                  True if the data of the SYN may be delivered, false otherwise.
+--
+-- NOTES:
+--                          Refuses a nonce that was admitted within the replay window. If every
+--                          nonce it remembers is that recent the nonce is refused as well, forgetting
+--                          one early would let its SYN through again.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::ReplayFilter::Admit(const quint64 nonce)
+{
+    const quint64 now = DependencyManager::Instance().Clock().Now();
+    while (!mEntries.empty() && now - mEntries.front().seen > Early::REPLAY_WINDOW)
+    {
+        mNonces.erase(mEntries.front().nonce);
+        mEntries.pop_front();
+    }
+
+    if (nonce == 0 || mNonces.count(nonce) > 0 || mEntries.size() >= Early::MAX_NONCES) return false;
+
+    mEntries.push_back({ nonce, now });
+    mNonces.insert(nonce);
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::ReplayFilter::Clear
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::ReplayFilter::Clear()
+--
+-- NOTES:
+--                          Forgets every nonce.
+--------------------------------------------------------------------------------------------------*/
+void kgp::ReplayFilter::Clear()
+{
+    mEntries.clear();
+    mNonces.clear();
+}
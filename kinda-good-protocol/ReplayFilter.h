@@ -0,0 +1,53 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             ReplayFilter.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          The nonces of the SYNs a receiver took data from. Data in a SYN is handed
+--                          out before the sender has answered anything, so a SYN that was duplicated
+--                          by the network or recorded and sent again would deliver the same bytes
+--                          twice. A nonce is only admitted once within Early::REPLAY_WINDOW.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <deque>
+#include <set>
+
+#include <QtGlobal>
+
+namespace kgp
+{
+    class ReplayFilter
+    {
+    private:
+        struct Entry
+        {
+            quint64 nonce;
+            quint64 seen;
+        };
+
+        // Admitted nonces in the order they were seen and the same nonces for lookups
+        std::deque<Entry> mEntries;
+        std::set<quint64> mNonces;
+
+    public:
+        ReplayFilter() = default;
+        ~ReplayFilter() = default;
+
+        static quint64 NewNonce();
+
+        bool Admit(const quint64 nonce);
+        void Clear();
+    };
+}
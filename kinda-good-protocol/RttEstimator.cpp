@@ -0,0 +1,138 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             RttEstimator.cpp
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          The clock ticks in milliseconds, which is also the granularity of the
+--                          timeout.
+---------------------------------------------------------------------------------------*/
+#include "RttEstimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "res.h"
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::RttEstimator::RttEstimator
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::RttEstimator::RttEstimator()
+--
+-- NOTES:
+--                          Constructor for the RttEstimator. The timeout is Timeout::RCV until
+--                          Reset is called.
+--------------------------------------------------------------------------------------------------*/
+kgp::RttEstimator::RttEstimator()
+{
+    Reset(Timeout::RCV, Timeout::RCV);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::RttEstimator::Reset
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::RttEstimator::Reset(const quint64 initial, const quint64 max)
+--                              initial: The timeout to use until the first sample.
+--                              max: The largest timeout, backed off or not.
+--
+-- NOTES:
+--                          Forgets every sample.
+--------------------------------------------------------------------------------------------------*/
+void kgp::RttEstimator::Reset(const quint64 initial, const quint64 max)
+{
+    mSrtt = 0;
+    mRttVar = 0;
+    mSamples = 0;
+    mMax = std::max<quint64>(max, 1);
+    mRto = std::min(initial, mMax);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::RttEstimator::AddSample
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::RttEstimator::AddSample(const quint64 rtt)
+--                              rtt: The milliseconds between sending a frame and getting its ACK.
+--
+-- NOTES:
+--                          Folds the sample into the smoothed round trip time and its variation and
+--                          sets the timeout to the one plus four of the other, but never below
+--                          Rto::MIN or above the largest timeout.
+--------------------------------------------------------------------------------------------------*/
+void kgp::RttEstimator::AddSample(const quint64 rtt)
+{
+    if (mSamples == 0)
+    {
+        mSrtt = (double)rtt;
+        mRttVar = rtt / 2.0;
+    }
+    else
+    {
+        mRttVar = 0.75 * mRttVar + 0.25 * std::fabs(mSrtt - (double)rtt);
+        mSrtt = 0.875 * mSrtt + 0.125 * (double)rtt;
+    }
+    mSamples++;
+
+    const quint64 rto = (quint64)std::ceil(mSrtt + std::max(1.0, 4 * mRttVar));
+    mRto = std::min(std::max<quint64>(rto, Rto::MIN), mMax);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::RttEstimator::Backoff
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               quint64 kgp::RttEstimator::Backoff(const quint64 retransmits)
+--                              retransmits: The number of times a frame was sent again.
+--
+-- RETURN:                  The milliseconds to wait for the ACK of the frame.
+--
+-- NOTES:
+--                          Doubles the timeout for every time the frame was sent again, up to the
+--                          largest timeout, so a path that stopped answering is not flooded.
+--------------------------------------------------------------------------------------------------*/
+quint64 kgp::RttEstimator::Backoff(const quint64 retransmits) const
+{
+    quint64 rto = mRto;
+    for (quint64 i = 0; i < retransmits && rto < mMax; i++) rto *= 2;
+    return std::min(rto, mMax);
+}
@@ -0,0 +1,98 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             RttEstimator.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Smoothed round trip time and retransmission timeout of a connection as
+--                          in RFC 6298. Samples only come from frames that were sent once, the ACK
+--                          of a frame that was sent again could be for either send.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <QtGlobal>
+
+namespace kgp
+{
+    class RttEstimator
+    {
+    private:
+        // Smoothed round trip time and its variation in milliseconds
+        double mSrtt;
+        double mRttVar;
+        quint64 mSamples;
+
+        // Largest timeout there is and the timeout of a frame that was sent once
+        quint64 mMax;
+        quint64 mRto;
+
+    public:
+        RttEstimator();
+        ~RttEstimator() = default;
+
+        void Reset(const quint64 initial, const quint64 max);
+        void AddSample(const quint64 rtt);
+        quint64 Backoff(const quint64 retransmits) const;
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::RttEstimator::Rto
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::RttEstimator::Rto()
+        --
+        -- RETURN:                  The milliseconds to wait for the ACK of a frame that was sent once.
+        --------------------------------------------------------------------------------------------------*/
+        inline quint64 Rto() const { return mRto; }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::RttEstimator::Srtt
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::RttEstimator::Srtt()
+        --
+        -- RETURN:                  The smoothed round trip time in milliseconds, 0 before the first sample.
+        --------------------------------------------------------------------------------------------------*/
+        inline quint64 Srtt() const { return (quint64)(mSrtt + 0.5); }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::RttEstimator::Samples
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::RttEstimator::Samples()
+        --
+        -- RETURN:                  The number of samples taken since the last Reset.
+        --------------------------------------------------------------------------------------------------*/
+        inline quint64 Samples() const { return mSamples; }
+    };
+}
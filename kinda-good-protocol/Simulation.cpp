@@ -0,0 +1,170 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             Simulation.cpp
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Runs engines over an emulated link on simulated time.
+---------------------------------------------------------------------------------------*/
+#include "Simulation.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "DependencyManager.h"
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::Simulation::Simulation
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::Simulation::Simulation(const EmulatedLink::Config& config)
+--                              config: The behaviour of the emulated link.
+--
+-- NOTES:
+--                          Constructor for the Simulation. Installs the simulated clock so that
+--                          everything created afterwards runs on simulated time. Only one
+--                          simulation should exist at a time.
+--------------------------------------------------------------------------------------------------*/
+kgp::Simulation::Simulation(const EmulatedLink::Config& config)
+    : mClock()
+    , mLink(config)
+{
+    DependencyManager::Instance().SetClock(&mClock);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::Simulation::~Simulation
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::Simulation::~Simulation()
+--
+-- NOTES:
+--                          Deconstructor for the Simulation. Destroys the engines and puts the real
+--                          time clock back.
+--------------------------------------------------------------------------------------------------*/
+kgp::Simulation::~Simulation()
+{
+    mEngines.clear();
+    DependencyManager::Instance().SetClock(nullptr);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::Simulation::CreateEngine
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               IoEngine *kgp::Simulation::CreateEngine(const QHostAddress& address)
+--                              address: The address of the emulated host the engine runs on.
+--
+-- RETURN:                  The new engine. It is owned by the simulation.
+--
+-- NOTES:
+--                          Creates an unthreaded engine on a new endpoint of the link. Its timers
+--                          are checked by the simulation.
+--------------------------------------------------------------------------------------------------*/
+kgp::IoEngine *kgp::Simulation::CreateEngine(const QHostAddress& address)
+{
+    mEngines.push_back(std::make_unique<IoEngine>(mLink.CreateEndpoint(address)));
+    mEngines.back()->SetThreaded(false);
+    return mEngines.back().get();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::Simulation::Step
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::Simulation::Step()
+--
+-- RETURN:                  False if nothing is left to happen, true otherwise.
+--
+-- NOTES:
+--                          Delivers everything that is due, lets every engine handle its timeouts
+--                          and then moves the clock to the next delivery or timeout, whichever
+--                          comes first. The clock always moves forward by at least a millisecond
+--                          so an engine that does not restart an expired timer cannot stall it.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::Simulation::Step()
+{
+    mLink.Poll();
+    for (auto& engine : mEngines) engine->Poll();
+    // Deliver anything sent with no delay while handling timeouts
+    mLink.Poll();
+
+    quint64 next = mLink.NextDelivery();
+    for (auto& engine : mEngines) next = std::min(next, engine->NextDeadline());
+
+    if (next == std::numeric_limits<quint64>::max()) return false;
+
+    mClock.AdvanceTo(std::max(next, mClock.Now() + 1));
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::Simulation::RunUntil
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::Simulation::RunUntil(const std::function<bool()>& done, const quint64 limit)
+--                              done: Returns true once the scenario is finished.
+--                              limit: The longest simulated time to run for in milliseconds.
+--
+-- RETURN:                  True if done returned true before the limit was reached.
+--
+-- NOTES:
+--                          Steps the simulation until done returns true, nothing is left to
+--                          happen or the time limit has passed.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::Simulation::RunUntil(const std::function<bool()>& done, const quint64 limit)
+{
+    const quint64 end = mClock.Now() + limit;
+
+    while (!done())
+    {
+        if (mClock.Now() > end || !Step()) return done();
+    }
+
+    return true;
+}
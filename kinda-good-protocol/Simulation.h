@@ -0,0 +1,56 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             Simulation.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Runs engines over an emulated link on simulated time. The simulation
+--                          installs its clock in the dependency manager and, instead of waiting,
+--                          jumps the clock straight to the next datagram delivery or timeout so
+--                          hours of lossy transfer take milliseconds to run.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <QHostAddress>
+
+#include "Clock.h"
+#include "EmulatedLink.h"
+#include "IoEngine.h"
+
+namespace kgp
+{
+    class Simulation
+    {
+    private:
+        SimulatedClock mClock;
+        EmulatedLink mLink;
+        std::vector<std::unique_ptr<IoEngine>> mEngines;
+
+    public:
+        Simulation(const EmulatedLink::Config& config);
+        ~Simulation();
+
+        IoEngine *CreateEngine(const QHostAddress& address);
+
+        bool Step();
+        bool RunUntil(const std::function<bool()>& done, const quint64 limit);
+
+        inline SimulatedClock& Clock() { return mClock; }
+        inline EmulatedLink& Link() { return mLink; }
+        inline quint64 Now() { return mClock.Now(); }
+    };
+}
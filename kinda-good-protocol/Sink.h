@@ -0,0 +1,46 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             Sink.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Where a receiver hands received data in batches instead of one dataRead
+--                          per frame. Every span of a batch shares the buffer its bytes were
+--                          received or rebuilt in, so a listener can keep a span, queue it for
+--                          another thread or forward it without copying the bytes.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include <QByteArray>
+
+namespace kgp
+{
+    // Bytes of a transfer in the buffer that holds them. The bytes stay valid for as long as a copy
+    // of the span is around, on any thread
+    struct Span
+    {
+        QByteArray owner;
+        size_t offset;
+        size_t size;
+
+        // Where the bytes start, in whichever copy of the owner this span has
+        inline const char *Data() const { return owner.constData() + offset; }
+    };
+
+    // Takes the spans delivered since the last batch, in order and without gaps. The batch is the
+    // listener's to move from
+    using BatchSink = std::function<void(std::vector<Span>& batch)>;
+}
@@ -1,6 +1,9 @@
 #include "DependencyManager.h"
 #include "SlidingWindow.h"
 
+#include <algorithm>
+#include <limits>
+
 kgp::SlidingWindow::SlidingWindow(const quint64& size)
     : mWindowSize(size)
 {
@@ -12,14 +15,19 @@ kgp::SlidingWindow::SlidingWindow(const quint64& size)
 --
 -- DATE:                    November 8, 2018
 --
--- REVISIONS:               N/A
+-- REVISIONS:               October 19, 2026 - Benny Wang: Puts a prefix in front of the file and
+--                          starts at a given sequence number.
+--                          October 19, 2026 - Benny Wang: Reads through the file reader if one is
+--                          set.
 --
 -- DESIGNER:                Benny Wang
 --
 -- PROGRAMMER:              Benny Wang
 --
--- INTERFACE:               void BufferFile(QFile& file)  
+-- INTERFACE:               void BufferFile(QFile& file, const QByteArray& prefix, const quint64 base)  
 --                              file: The file to buffer.
+--                              prefix: The bytes that are sent before the file.
+--                              base: The sequence number of the first byte.
 --
 -- RETURN:
 --                          False if the file could not be read, true otherwise.
@@ -27,12 +35,14 @@ kgp::SlidingWindow::SlidingWindow(const quint64& size)
 -- NOTES:
 --                          Reads the entire contents of the file and buffers it in memory. The
 --                          given file will be opened by this function if a closed file is passed,
---                          and the file will always be closed after it is read.
+--                          and the file will always be closed after it is read. The next file of a
+--                          session starts where the one before ended.
 --------------------------------------------------------------------------------------------------*/
-bool kgp::SlidingWindow::BufferFile(QFile& file)
+bool kgp::SlidingWindow::BufferFile(QFile& file, const QByteArray& prefix, const quint64 base)
 {
     // Reset state of window
     Reset();
+    mHead = mPointer = mBase = base;
 
     // Open the file if needed
     if (!file.isOpen())
@@ -46,7 +56,21 @@ bool kgp::SlidingWindow::BufferFile(QFile& file)
     }
 
     // Read the entire file into the buffer
-    mBuffer.append(file.readAll());
+    mBuffer.append(prefix);
+    if (mFileReader)
+    {
+        if (!mFileReader(file, mBuffer))
+        {
+            DependencyManager::Instance().Logger().Error("Could not read the file: " + file.fileName().toStdString());
+            file.close();
+            Reset();
+            return false;
+        }
+    }
+    else
+    {
+        mBuffer.append(file.readAll());
+    }
     DependencyManager::Instance().Logger().Log(QString::number(mBuffer.size()).toStdString() + " bytes were buffered");
 
     // Close the file
@@ -55,12 +79,70 @@ bool kgp::SlidingWindow::BufferFile(QFile& file)
     return true;
 }
 
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::SlidingWindow::BufferData
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::SlidingWindow::BufferData(const QByteArray& data)
+--                              data: The bytes to send.
+--
+-- NOTES:
+--                          Buffers bytes that were put together in memory, such as a directory, to
+--                          be sent from sequence number 0. The bytes are shared, not copied.
+--------------------------------------------------------------------------------------------------*/
+void kgp::SlidingWindow::BufferData(const QByteArray& data)
+{
+    Reset();
+    mBuffer = data;
+    DependencyManager::Instance().Logger().Log(QString::number(mBuffer.size()).toStdString() + " bytes were buffered");
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::SlidingWindow::BufferSource
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::SlidingWindow::BufferSource(const std::shared_ptr<Source>& source)
+--                              source: Where the bytes to send come from.
+--
+-- NOTES:
+--                          Sends what the source gives from sequence number 0. Nothing is read up
+--                          front, the buffer is filled as the window moves and the bytes the
+--                          receiver has are let go of, so the source can be larger than memory.
+--                          Nothing can be sent again once it was ACK'd.
+--------------------------------------------------------------------------------------------------*/
+void kgp::SlidingWindow::BufferSource(const std::shared_ptr<Source>& source)
+{
+    Reset();
+    mSource = source;
+}
+
 /*--------------------------------------------------------------------------------------------------
 -- FUNCTION:                kgp::SlidingWindow::GetNextFrames
 --
 -- DATE:                    November 8, 2018
 --
--- REVISIONS:               N/A
+-- REVISIONS:               October 19, 2026 - Benny Wang: Marks the last frame when the buffer is a
+--                          multiple of the frame size.
+--                          October 19, 2026 - Benny Wang: Cuts frames to the frame size and
+--                          remembers them until they are ACK'd.
+--                          October 19, 2026 - Benny Wang: Remembers when frames were sent.
+--                          October 19, 2026 - Benny Wang: Counts from the sequence number of the
+--                          first buffered byte.
+--                          October 19, 2026 - Benny Wang: Fills the window from the source first.
 --
 -- DESIGNER:                Benny Wang
 --
@@ -73,31 +155,39 @@ bool kgp::SlidingWindow::BufferFile(QFile& file)
 --                          Starts at the window head and will attempt to grab frames until an entire
 --                          window's worth has been grabbed. Will stop if the end of the buffer has
 --                          been reached. The window pointer will be at the start of the the last
---                          frame that has been read this way.
+--                          frame that has been read this way. While a source has not ended only
+--                          whole frames are handed out and its last byte is held back, which frame
+--                          is the last one is only known once it ends.
 --------------------------------------------------------------------------------------------------*/
 
 void kgp::SlidingWindow::GetNextFrames(std::vector<Frame>& list)
 {
+    const quint64 now = DependencyManager::Instance().Clock().Now();
+    // One byte past the window, so that a frame that ends with the window is not held back
+    if (mSource) pull(mHead + mWindowSize + 1);
+    const bool open = mSource && !mSource->AtEnd();
+    const quint64 end = GetEnd();
     Frame frame;
 
     // While the pointer is less than the window size and less than buffer size
-    while (mPointer < mHead + mWindowSize && mPointer < mBuffer.size())
+    while (mPointer < mHead + mWindowSize && mPointer < end)
     {
         memset(&frame, 0, sizeof(frame));
         frame.seqNum = mPointer;
-        frame.data = mBuffer.data() + mPointer;
+        frame.data = mBuffer.data() + (mPointer - mBase);
 
         // If the window does not have enough space for a whole packet
-        if (mPointer + Size::DATA > mHead + mWindowSize)
+        if (mPointer + mFrameSize > mHead + mWindowSize)
         {
             // Set the size to the remaining window size
             frame.size = (mHead + mWindowSize) - mPointer;
 
-            // Check for buffer overflow
-            if (mPointer + frame.size > mBuffer.size())
+            // Check for buffer overflow, a frame that ends exactly at the end of the buffer is the last one too
+            if (mPointer + frame.size >= end)
             {
+                if (open) break;
                 // Set the size
-                frame.size = mBuffer.size() - mPointer;
+                frame.size = end - mPointer;
                 // Remember that last packet has been sent
                 mLastPacketState.pending = true;
                 mLastPacketState.seqNum = frame.seqNum;
@@ -106,23 +196,25 @@ void kgp::SlidingWindow::GetNextFrames(std::vector<Frame>& list)
         // Normal case where the window has enough space for a whole packet
         else
         {
-            // Check for buffer overflow
-            if (mPointer + Size::DATA > mBuffer.size())
+            // Check for buffer overflow, a frame that ends exactly at the end of the buffer is the last one too
+            if (mPointer + mFrameSize >= end)
             {
+                if (open) break;
                 // Set the size
-                frame.size = mBuffer.size() - mPointer;
+                frame.size = end - mPointer;
                 // Remember that last packet has been sent
                 mLastPacketState.pending = true;
                 mLastPacketState.seqNum = frame.seqNum;            
             }
             else
             {
-                frame.size = Size::DATA;
+                frame.size = mFrameSize;
             }
         }
 
         // Increment pointer and save the frame to the list
         mPointer += frame.size;
+        mInFlight.PushBack({ frame.seqNum, frame.size, frame.data, now, now, 0, false });
         list.push_back(frame);
     }
 }
@@ -132,7 +224,11 @@ void kgp::SlidingWindow::GetNextFrames(std::vector<Frame>& list)
 --
 -- DATE:                    November 8, 2018
 --
--- REVISIONS:               N/A
+-- REVISIONS:               October 19, 2026 - Benny Wang: Terminates when the window has shrunk
+--                          below what was sent.
+--                          October 19, 2026 - Benny Wang: Sends the frames as they were cut and
+--                          splits the ones larger than the frame size.
+--                          October 19, 2026 - Benny Wang: Counts the frames as sent again.
 --
 -- DESIGNER:                Benny Wang
 --
@@ -144,33 +240,156 @@ void kgp::SlidingWindow::GetNextFrames(std::vector<Frame>& list)
 -- NOTES:
 --                          Grabs all the pending frames, that is frames between the window head
 --                          and the window pointer, and appends them to the list that was passed.
+--                          The frames are cut where they were cut when they were first sent, since
+--                          the receiver only takes a frame that starts where the last one it took
+--                          ended. A frame that is larger than the frame size, because the frame size
+--                          has shrunk since, is split into frames of the frame size. If that was the
+--                          last frame its last piece becomes the last frame.
 --------------------------------------------------------------------------------------------------*/
 void kgp::SlidingWindow::GetPendingFrames(std::vector<Frame>& list)
 {
-    quint64 tmpPointer = mHead;
-
-    while (tmpPointer <= mPointer)
+    const quint64 now = DependencyManager::Instance().Clock().Now();
+    InFlightTable frames;
+    for (size_t i = 0; i < mInFlight.Size(); i++)
     {
-        Frame frame;
-        frame.seqNum = tmpPointer;
-        frame.data = mBuffer.data() + tmpPointer;
-
-        // If reading default size of data would exceed window size
-        if (tmpPointer + Size::DATA > mHead + mWindowSize)
+        const InFlightTable::Record& sent = mInFlight.At(i);
+        quint64 last = sent.seqNum;
+        for (quint64 at = 0; at < sent.size; at += mFrameSize)
         {
-            // Size is distance between the two pointers
-            frame.size = mHead + mWindowSize - tmpPointer;
+            InFlightTable::Record record = sent;
+            record.seqNum = last = sent.seqNum + at;
+            record.data = sent.data + at;
+            record.size = std::min<quint64>(mFrameSize, sent.size - at);
+            record.acked = sent.acked && at == 0;
+            record.lastSent = now;
+            record.retransmits++;
+            frames.PushBack(record);
+            list.push_back({ record.seqNum, record.size, record.data });
         }
-        else
+
+        if (sent.size > mFrameSize && mLastPacketState.pending && sent.seqNum == mLastPacketState.seqNum)
         {
-            frame.size = Size::DATA;
+            mLastPacketState.seqNum = last;
         }
+    }
 
-        // Increment pointer
-        tmpPointer += frame.size;
-        list.push_back(frame);
+    mInFlight = std::move(frames);
+}
 
-        if (tmpPointer == mPointer) break;
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::SlidingWindow::GetExpiredFrames
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::SlidingWindow::GetExpiredFrames(const RttEstimator& rtt, std::vector<Frame>& list)
+--                              rtt: The round trip estimate of the connection.
+--                              list: The list that the frames will be put into.
+--
+-- RETURN:                  True if a frame timed out, false otherwise.
+--
+-- NOTES:
+--                          Finds the first frame in the window whose ACK is later than its
+--                          retransmission timeout, backed off for every time it was sent again.
+--                          That frame and every frame after it that is still in the window go into
+--                          the list and count as sent again now, since the receiver drops what
+--                          arrives after a frame it is missing. Frames the window shrank below are
+--                          left until it opens again.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::SlidingWindow::GetExpiredFrames(const RttEstimator& rtt, std::vector<Frame>& list)
+{
+    const quint64 now = DependencyManager::Instance().Clock().Now();
+    const quint64 end = mHead + mWindowSize;
+
+    size_t i = 0;
+    for (; i < mInFlight.Size() && mInFlight.At(i).seqNum < end; i++)
+    {
+        const InFlightTable::Record& record = mInFlight.At(i);
+        // Timeouts fire once the elapsed time is strictly greater than the timeout
+        if (!record.acked && now - record.lastSent > rtt.Backoff(record.retransmits)) break;
+    }
+    if (i == mInFlight.Size() || mInFlight.At(i).seqNum >= end) return false;
+
+    for (; i < mInFlight.Size() && mInFlight.At(i).seqNum < end; i++)
+    {
+        InFlightTable::Record& record = mInFlight.At(i);
+        if (record.acked) continue;
+        record.lastSent = now;
+        record.retransmits++;
+        list.push_back({ record.seqNum, record.size, record.data });
+    }
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::SlidingWindow::NextExpiry
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               quint64 kgp::SlidingWindow::NextExpiry(const RttEstimator& rtt)
+--                              rtt: The round trip estimate of the connection.
+--
+-- RETURN:                  The clock time at which the first frame in the window times out, or the
+--                          largest quint64 if there is none.
+--------------------------------------------------------------------------------------------------*/
+quint64 kgp::SlidingWindow::NextExpiry(const RttEstimator& rtt)
+{
+    const quint64 end = mHead + mWindowSize;
+    quint64 expiry = std::numeric_limits<quint64>::max();
+    for (size_t i = 0; i < mInFlight.Size() && mInFlight.At(i).seqNum < end; i++)
+    {
+        const InFlightTable::Record& record = mInFlight.At(i);
+        if (!record.acked) expiry = std::min(expiry, record.lastSent + rtt.Backoff(record.retransmits) + 1);
+    }
+    return expiry;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::SlidingWindow::GetRangeFrames
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Cuts frames of Size::MIN_DATA bytes.
+--                          October 19, 2026 - Benny Wang: Counts from the sequence number of the
+--                          first buffered byte.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::SlidingWindow::GetRangeFrames(const quint64 start, const quint64 end, std::vector<Frame>& list)
+--                              start: The offset of the first byte.
+--                              end: The offset after the last byte.
+--                              list: The list that the frames will be put into.
+--
+-- NOTES:
+--                          Cuts the buffered bytes from start to end into frames of Size::MIN_DATA
+--                          bytes, which every path carries, and appends them to the list whether
+--                          they have been sent or not. The window is left as it is. Used to send part
+--                          of a file again after the window has moved past it.
+--------------------------------------------------------------------------------------------------*/
+void kgp::SlidingWindow::GetRangeFrames(const quint64 start, const quint64 end, std::vector<Frame>& list)
+{
+    const quint64 last = std::min<quint64>(end, GetEnd());
+
+    for (quint64 tmpPointer = std::max(start, mBase); tmpPointer < last; tmpPointer += Size::MIN_DATA)
+    {
+        Frame frame;
+        frame.seqNum = tmpPointer;
+        frame.data = mBuffer.data() + (tmpPointer - mBase);
+        frame.size = std::min<quint64>(Size::MIN_DATA, last - tmpPointer);
+        list.push_back(frame);
     }
 }
 
@@ -179,7 +398,9 @@ void kgp::SlidingWindow::GetPendingFrames(std::vector<Frame>& list)
 --
 -- DATE:                    November 8, 2018
 --
--- REVISIONS:               N/A
+-- REVISIONS:               October 19, 2026 - Benny Wang: Forgets the frames before the head.
+--                          October 19, 2026 - Benny Wang: Takes a round trip sample from the
+--                          frame that was ACK'd.
 --
 -- DESIGNER:                Benny Wang
 --
@@ -216,6 +437,21 @@ bool kgp::SlidingWindow::AckFrame(const quint64& ackNum)
         if (ackNum > mHead)
         {
             mHead = ackNum;
+            // The frame at the head stays in flight, the receiver ACKs the start of a frame
+            while (!mInFlight.IsEmpty() && mInFlight.Front().seqNum + mInFlight.Front().size <= mHead) mInFlight.PopFront();
+        }
+
+        // The first ACK of a frame that was sent once measures the round trip
+        const qint64 at = mInFlight.Find(ackNum, mFrameSize);
+        if (at >= 0 && !mInFlight.At(at).acked)
+        {
+            InFlightTable::Record& record = mInFlight.At(at);
+            record.acked = true;
+            if (record.retransmits == 0)
+            {
+                mRttSample = DependencyManager::Instance().Clock().Now() - record.lastSent;
+                mHasRttSample = true;
+            }
         }
         DependencyManager::Instance().Logger().Log("Advancing window head to " + QString::number(ackNum).toStdString());
         return true;
@@ -226,3 +462,120 @@ bool kgp::SlidingWindow::AckFrame(const quint64& ackNum)
         return false;
     }
 }
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::SlidingWindow::TakeRttSample
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::SlidingWindow::TakeRttSample(quint64& rtt)
+--                              rtt: Set to the milliseconds between sending the frame and its ACK.
+--
+-- RETURN:                  True if an ACK measured the round trip since the last call, false
+--                          otherwise.
+--
+-- NOTES:
+--                          Only the first ACK of a frame that was sent once is a sample, the ACK of
+--                          a frame that was sent again could be for either send.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::SlidingWindow::TakeRttSample(quint64& rtt)
+{
+    if (!mHasRttSample) return false;
+    rtt = mRttSample;
+    mHasRttSample = false;
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::SlidingWindow::pull
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::SlidingWindow::pull(const quint64 end)
+--                              end: The sequence number to buffer up to.
+--
+-- NOTES:
+--                          Reads from the source until the buffer reaches end, the source has
+--                          nothing more right now or it has ended. Bytes the receiver has are
+--                          dropped first once they make up half of the buffer, so that the buffer
+--                          stays around the size of the window. Frames in flight point into the
+--                          buffer and are moved along with it.
+--------------------------------------------------------------------------------------------------*/
+void kgp::SlidingWindow::pull(const quint64 end)
+{
+    const char *before = mBuffer.constData();
+    bool moved = false;
+
+    // A frame in flight may start before the head
+    const quint64 keep = mInFlight.IsEmpty() ? mHead : std::min(mHead, mInFlight.Front().seqNum);
+    const quint64 delivered = keep - mBase;
+    if (delivered > 0 && delivered * 2 >= (quint64)mBuffer.size())
+    {
+        mBuffer.remove(0, (int)delivered);
+        mBase = keep;
+        moved = true;
+    }
+
+    while (!mSourceFailed && !mSource->AtEnd() && GetEnd() < end)
+    {
+        const int size = mBuffer.size();
+        const qint64 wanted = (qint64)(end - GetEnd());
+        mBuffer.resize(size + (int)wanted);
+        const qint64 read = mSource->Read(mBuffer.data() + size, wanted);
+        mBuffer.resize(size + (int)std::max<qint64>(read, 0));
+
+        if (read < 0)
+        {
+            DependencyManager::Instance().Logger().Error("Could not read the source");
+            mSourceFailed = true;
+        }
+        else if (mSource->AtEnd())
+        {
+            DependencyManager::Instance().Logger().Log("The source ended after " + QString::number(GetEnd()).toStdString() + " bytes");
+        }
+        else if (read == 0)
+        {
+            break;
+        }
+    }
+
+    if (moved || mBuffer.constData() != before) repoint();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::SlidingWindow::repoint
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::SlidingWindow::repoint()
+--
+-- NOTES:
+--                          Points the frames in flight at where their bytes are after the buffer
+--                          has moved.
+--------------------------------------------------------------------------------------------------*/
+void kgp::SlidingWindow::repoint()
+{
+    for (size_t i = 0; i < mInFlight.Size(); i++)
+    {
+        InFlightTable::Record& record = mInFlight.At(i);
+        record.data = mBuffer.data() + (record.seqNum - mBase);
+    }
+}
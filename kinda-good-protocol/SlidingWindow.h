@@ -18,18 +18,27 @@
 ---------------------------------------------------------------------------------------*/
 #pragma once
 
+#include <algorithm>
+#include <functional>
+#include <memory>
 #include <vector>
 
 #include <QByteArray>
 #include <QFile>
 
+#include "InFlightTable.h"
 #include "res.h"
+#include "RttEstimator.h"
+#include "Source.h"
 
 namespace kgp
 {
     class SlidingWindow
     {
     public:
+        // Appends the rest of an open file to a buffer, false if it could not be read
+        using FileReader = std::function<bool(QFile&, QByteArray&)>;
+
         struct Frame
         {
             quint64 seqNum;
@@ -49,8 +58,26 @@ namespace kgp
         quint64 mWindowSize;
         quint64 mPointer;
         EotState mLastPacketState;
+        // Payload new frames are cut to
+        quint64 mFrameSize;
+        // Frames that have been handed out and not ACK'd yet, in order. Resends keep these cuts so
+        // that a frame always starts where the receiver expects one
+        InFlightTable mInFlight;
+        // Round trip of the last frame whose ACK was a fair sample
+        quint64 mRttSample;
+        bool mHasRttSample;
 
+        // Sequence number of the first buffered byte, the files of a session follow each other
+        quint64 mBase;
         QByteArray mBuffer;
+        // Reads files into the buffer, QFile::readAll when not set
+        FileReader mFileReader;
+        // Where the buffer is filled from as the window moves, when the data was not there up front
+        std::shared_ptr<Source> mSource;
+        bool mSourceFailed;
+
+        void pull(const quint64 end);
+        void repoint();
 
     public:
         SlidingWindow(const quint64& size = Size::WINDOW);
@@ -58,14 +85,21 @@ namespace kgp
 
         inline void SetWindowSize(const quint64 size) { mWindowSize = size; }
         inline quint64 GetWindowSize() { return mWindowSize; }
-
+        inline quint64 GetHead() { return mHead; }
+        inline void SetFrameSize(const quint64 size) { mFrameSize = std::max<quint64>(size, 1); }
+        inline quint64 GetFrameSize() { return mFrameSize; }
 
         /*--------------------------------------------------------------------------------------------------
         -- FUNCTION:                kgp::SlidingWindow::Reset
         --
         -- DATE:                    November 27, 2018
         --
-        -- REVISIONS:               N/A
+        -- REVISIONS:               October 19, 2026 - Benny Wang: Forgets the frames that were cut and
+        --                          goes back to frames of Size::DATA bytes.
+        --                          October 19, 2026 - Benny Wang: Forgets the frames in flight and the
+        --                          round trip sample.
+        --                          October 19, 2026 - Benny Wang: Starts at sequence number 0 again.
+        --                          October 19, 2026 - Benny Wang: Lets go of the source.
         --
         -- DESIGNER:                Benny Wang
         --
@@ -78,9 +112,14 @@ namespace kgp
         --------------------------------------------------------------------------------------------------*/
         inline void Reset()
         {
-            mHead = mPointer = 0;
+            mHead = mPointer = mBase = 0;
             mBuffer.clear();
+            mInFlight.Clear();
+            mHasRttSample = false;
+            mFrameSize = Size::DATA;
             memset(&mLastPacketState, 0, sizeof(mLastPacketState));
+            mSource.reset();
+            mSourceFailed = false;
         }
         
         /*--------------------------------------------------------------------------------------------------
@@ -105,10 +144,271 @@ namespace kgp
             return mLastPacketState.acked;
         }
 
-        bool BufferFile(QFile& file);
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::SlidingWindow::IsAllSent
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               bool kgp::SlidingWindow::IsAllSent()
+        --
+        -- NOTES:
+        --                          Checks if the last frame of data has been handed out, whether or not
+        --                          it has been ACK'd.
+        --------------------------------------------------------------------------------------------------*/
+        inline bool IsAllSent()
+        {
+            return mLastPacketState.pending || mLastPacketState.acked;
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::SlidingWindow::IsClosed
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               bool kgp::SlidingWindow::IsClosed()
+        --
+        -- NOTES:
+        --                          Checks if the window ends where the frame at the head does. The
+        --                          receiver ACKs the start of a frame, so the frame at the head has been
+        --                          delivered and the receiver has no room for anything past it.
+        --------------------------------------------------------------------------------------------------*/
+        inline bool IsClosed()
+        {
+            quint64 end = mHead;
+            if (!mInFlight.IsEmpty() && mInFlight.Front().seqNum == mHead) end += mInFlight.Front().size;
+            return mHead + mWindowSize <= end;
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::SlidingWindow::GetOutstanding
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::SlidingWindow::GetOutstanding()
+        --
+        -- RETURN:                  The bytes that were handed out and have not been delivered as far
+        --                          as is known, the frame at the head has been once it was ACK'd.
+        --------------------------------------------------------------------------------------------------*/
+        inline quint64 GetOutstanding()
+        {
+            quint64 end = mHead;
+            if (!mInFlight.IsEmpty() && mInFlight.Front().seqNum == mHead && mInFlight.Front().acked) end += mInFlight.Front().size;
+            return mPointer > end ? mPointer - end : 0;
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::SlidingWindow::GetSize
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::SlidingWindow::GetSize()
+        --
+        -- RETURN:                  The number of bytes that have been buffered.
+        --------------------------------------------------------------------------------------------------*/
+        inline quint64 GetSize() { return mBuffer.size(); }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::SlidingWindow::GetEnd
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::SlidingWindow::GetEnd()
+        --
+        -- RETURN:                  The sequence number after the last buffered byte.
+        --------------------------------------------------------------------------------------------------*/
+        inline quint64 GetEnd() { return mBase + mBuffer.size(); }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::SlidingWindow::GetInFlight
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               const InFlightTable& kgp::SlidingWindow::GetInFlight()
+        --
+        -- RETURN:                  The frames that have been handed out and not ACK'd yet.
+        --------------------------------------------------------------------------------------------------*/
+        inline const InFlightTable& GetInFlight() const { return mInFlight; }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::SlidingWindow::StartAt
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               October 19, 2026 - Benny Wang: Forgets the frames that were sent
+        --                          before the SYN-ACK.
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               void kgp::SlidingWindow::StartAt(const quint64 offset)
+        --                              offset: The first byte that still has to be sent.
+        --
+        -- NOTES:
+        --                          Moves the window past bytes the receiver already has from an earlier
+        --                          transfer. Frames that were sent along with the SYN are forgotten, the
+        --                          receiver did not take them. The offset has to be inside the buffer so
+        --                          that there is still a last frame to send.
+        --------------------------------------------------------------------------------------------------*/
+        inline void StartAt(const quint64 offset)
+        {
+            if (offset >= (quint64)mBuffer.size()) return;
+            mHead = mPointer = offset;
+            mInFlight.Clear();
+            memset(&mLastPacketState, 0, sizeof(mLastPacketState));
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::SlidingWindow::GetPointer
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::SlidingWindow::GetPointer()
+        --
+        -- RETURN:                  The first byte that has not been handed out yet.
+        --------------------------------------------------------------------------------------------------*/
+        inline quint64 GetPointer() { return mPointer; }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::SlidingWindow::DropFront
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               void kgp::SlidingWindow::DropFront(const quint64 size)
+        --                              size: The number of bytes to drop.
+        --
+        -- NOTES:
+        --                          Drops bytes that were put in front of the file and starts the window
+        --                          over, used when the receiver turned down what they were for. Frames
+        --                          that were handed out are forgotten, their bytes have moved.
+        --------------------------------------------------------------------------------------------------*/
+        inline void DropFront(const quint64 size)
+        {
+            mBuffer.remove(0, (int)std::min<quint64>(size, mBuffer.size()));
+            mHead = mPointer = mBase;
+            mInFlight.Clear();
+            mHasRttSample = false;
+            memset(&mLastPacketState, 0, sizeof(mLastPacketState));
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::SlidingWindow::SetFileReader
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               void kgp::SlidingWindow::SetFileReader(const FileReader& reader)
+        --                              reader: Reads the files BufferFile is given.
+        --
+        -- NOTES:
+        --                          Lets the engine read files through its transport, which may read
+        --                          them faster than one blocking read.
+        --------------------------------------------------------------------------------------------------*/
+        inline void SetFileReader(const FileReader& reader) { mFileReader = reader; }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::SlidingWindow::IsWaiting
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               bool kgp::SlidingWindow::IsWaiting()
+        --
+        -- RETURN:                  True if the window has room that its source has not filled yet, so
+        --                          the source should be asked again later. A source that ended without
+        --                          giving anything is not waited on.
+        --------------------------------------------------------------------------------------------------*/
+        inline bool IsWaiting()
+        {
+            if (!mSource || mSourceFailed || IsAllSent()) return false;
+            return (!mSource->AtEnd() || mPointer < GetEnd()) && mPointer < mHead + mWindowSize;
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::SlidingWindow::HasFailed
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               bool kgp::SlidingWindow::HasFailed()
+        --
+        -- RETURN:                  True if the source could not be read, the rest of it will never come.
+        --------------------------------------------------------------------------------------------------*/
+        inline bool HasFailed() { return mSourceFailed; }
+
+        bool BufferFile(QFile& file, const QByteArray& prefix = QByteArray(), const quint64 base = 0);
+        void BufferData(const QByteArray& data);
+        void BufferSource(const std::shared_ptr<Source>& source);
 
         void GetNextFrames(std::vector<Frame>& list);
         void GetPendingFrames(std::vector<Frame>& list);
+        bool GetExpiredFrames(const RttEstimator& rtt, std::vector<Frame>& list);
+        quint64 NextExpiry(const RttEstimator& rtt);
+        void GetRangeFrames(const quint64 start, const quint64 end, std::vector<Frame>& list);
         bool AckFrame(const quint64& ackNum);
+        bool TakeRttSample(quint64& rtt);
     };
 }
@@ -0,0 +1,357 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             Source.cpp
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Where the data of a transfer comes from when it is not a file on disk.
+---------------------------------------------------------------------------------------*/
+#include "Source.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::MemorySource::MemorySource
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::MemorySource::MemorySource(const QByteArray& data)
+--                              data: The bytes to send. Shared rather than copied.
+--
+-- NOTES:
+--                          Constructor for the MemorySource.
+--------------------------------------------------------------------------------------------------*/
+kgp::MemorySource::MemorySource(const QByteArray& data)
+    : mData(data)
+    , mPosition(0)
+{
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::MemorySource::Read
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               qint64 kgp::MemorySource::Read(char *data, const qint64 size)
+--                              data: Where to put what was read.
+--                              size: The most bytes to read.
+--
+-- RETURN:                  The number of bytes read, 0 once all of them were.
+--------------------------------------------------------------------------------------------------*/
+qint64 kgp::MemorySource::Read(char *data, const qint64 size)
+{
+    const qint64 read = std::min<qint64>(size, mData.size() - mPosition);
+    memcpy(data, mData.constData() + mPosition, (size_t)read);
+    mPosition += read;
+    return read;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::MemorySource::AtEnd
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::MemorySource::AtEnd()
+--
+-- RETURN:                  True once every byte has been read.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::MemorySource::AtEnd() const
+{
+    return mPosition >= mData.size();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::DeviceSource::DeviceSource
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::DeviceSource::DeviceSource(QIODevice *device)
+--                              device: The device to read. Not owned, it must outlive the transfer
+--                                      and only be used on the thread of the engine while it runs.
+--
+-- NOTES:
+--                          Constructor for the DeviceSource. A device that is not open yet is opened
+--                          for reading.
+--------------------------------------------------------------------------------------------------*/
+kgp::DeviceSource::DeviceSource(QIODevice *device)
+    : mDevice(device)
+    , mEnded(false)
+{
+    if (!mDevice->isOpen()) mDevice->open(QIODevice::ReadOnly);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::DeviceSource::Read
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               qint64 kgp::DeviceSource::Read(char *data, const qint64 size)
+--                              data: Where to put what was read.
+--                              size: The most bytes to read.
+--
+-- RETURN:                  The number of bytes read, 0 if the device had nothing and -1 if it
+--                          could not be read.
+--
+-- NOTES:
+--                          The device has ended once it is at its end after a read, or once it is
+--                          closed. Only what is available is read from a sequential device, so
+--                          that a read does not wait on the producer.
+--------------------------------------------------------------------------------------------------*/
+qint64 kgp::DeviceSource::Read(char *data, const qint64 size)
+{
+    if (mEnded) return 0;
+    if (!mDevice->isOpen())
+    {
+        mEnded = true;
+        return 0;
+    }
+
+    const qint64 wanted = mDevice->isSequential() ? std::min(size, mDevice->bytesAvailable()) : size;
+    const qint64 read = wanted > 0 ? mDevice->read(data, wanted) : 0;
+    if (read < 0) return -1;
+    if (mDevice->atEnd()) mEnded = true;
+    return read;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::DeviceSource::AtEnd
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::DeviceSource::AtEnd()
+--
+-- RETURN:                  True once the device has ended.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::DeviceSource::AtEnd() const
+{
+    return mEnded;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::GeneratorSource::GeneratorSource
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::GeneratorSource::GeneratorSource(const Generator& generator)
+--                              generator: Produces the data, called on the thread of the engine.
+--
+-- NOTES:
+--                          Constructor for the GeneratorSource.
+--------------------------------------------------------------------------------------------------*/
+kgp::GeneratorSource::GeneratorSource(const Generator& generator)
+    : mGenerator(generator)
+    , mEnded(false)
+{
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::GeneratorSource::Read
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               qint64 kgp::GeneratorSource::Read(char *data, const qint64 size)
+--                              data: Where to put what was read.
+--                              size: The most bytes to read.
+--
+-- RETURN:                  The number of bytes the generator wrote, 0 if it had none and -1 if it
+--                          failed.
+--------------------------------------------------------------------------------------------------*/
+qint64 kgp::GeneratorSource::Read(char *data, const qint64 size)
+{
+    if (mEnded) return 0;
+
+    const qint64 written = mGenerator(data, size, mEnded);
+    return written < 0 ? -1 : std::min(written, size);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::GeneratorSource::AtEnd
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::GeneratorSource::AtEnd()
+--
+-- RETURN:                  True once the generator said that nothing more will follow.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::GeneratorSource::AtEnd() const
+{
+    return mEnded;
+}
+
+#if defined(__linux__)
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::FdSource::FdSource
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::FdSource::FdSource(const int fd, const bool owned)
+--                              fd: The file descriptor to read, such as the read end of a pipe.
+--                              owned: Whether the source closes it when it goes away.
+--
+-- NOTES:
+--                          Constructor for the FdSource. The descriptor is made non-blocking.
+--------------------------------------------------------------------------------------------------*/
+kgp::FdSource::FdSource(const int fd, const bool owned)
+    : mFd(fd)
+    , mOwned(owned)
+    , mEnded(false)
+{
+    const int flags = fcntl(mFd, F_GETFL);
+    if (flags != -1) fcntl(mFd, F_SETFL, flags | O_NONBLOCK);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::FdSource::~FdSource
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::FdSource::~FdSource()
+--
+-- NOTES:
+--                          Deconstructor for the FdSource. Closes the descriptor if it is owned.
+--------------------------------------------------------------------------------------------------*/
+kgp::FdSource::~FdSource()
+{
+    if (mOwned) close(mFd);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::FdSource::Read
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               qint64 kgp::FdSource::Read(char *data, const qint64 size)
+--                              data: Where to put what was read.
+--                              size: The most bytes to read.
+--
+-- RETURN:                  The number of bytes read, 0 if the producer has not written anything
+--                          yet and -1 if the descriptor could not be read.
+--
+-- NOTES:
+--                          The descriptor has ended once a read returns nothing, which for a pipe
+--                          is once every writer has closed it.
+--------------------------------------------------------------------------------------------------*/
+qint64 kgp::FdSource::Read(char *data, const qint64 size)
+{
+    if (mEnded) return 0;
+
+    ssize_t result;
+    do
+    {
+        result = read(mFd, data, (size_t)size);
+    } while (result == -1 && errno == EINTR);
+
+    if (result == -1) return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+    if (result == 0) mEnded = true;
+    return result;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::FdSource::AtEnd
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::FdSource::AtEnd()
+--
+-- RETURN:                  True once the descriptor has ended.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::FdSource::AtEnd() const
+{
+    return mEnded;
+}
+#endif
@@ -0,0 +1,145 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             Source.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Where the data of a transfer comes from when it is not a file on disk.
+--                          The sliding window pulls from a source as the receiver makes room, so a
+--                          transfer starts before the producer has finished and ends once the
+--                          source does. A source is only read on the thread of the engine and must
+--                          never block, a source with nothing to give right now says so and is asked
+--                          again later.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <functional>
+
+#include <QByteArray>
+#include <QIODevice>
+
+namespace kgp
+{
+    class Source
+    {
+    public:
+        virtual ~Source() = default;
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::Source::Read
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               qint64 kgp::Source::Read(char *data, const qint64 size)
+        --                              data: Where to put what was read.
+        --                              size: The most bytes to read.
+        --
+        -- RETURN:                  The number of bytes read, 0 if there is nothing to read right now or
+        --                          the source has ended, and -1 if it could not be read.
+        --------------------------------------------------------------------------------------------------*/
+        virtual qint64 Read(char *data, const qint64 size) = 0;
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::Source::AtEnd
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               bool kgp::Source::AtEnd()
+        --
+        -- RETURN:                  True once everything the source will ever give has been read.
+        --------------------------------------------------------------------------------------------------*/
+        virtual bool AtEnd() const = 0;
+    };
+
+    // Bytes that are already in memory
+    class MemorySource : public Source
+    {
+    private:
+        QByteArray mData;
+        qint64 mPosition;
+
+    public:
+        MemorySource(const QByteArray& data);
+        ~MemorySource() = default;
+
+        qint64 Read(char *data, const qint64 size) override;
+        bool AtEnd() const override;
+    };
+
+    // Any QIODevice whose atEnd means that its data has ended, such as a QFile, a QBuffer or a
+    // QProcess once it has exited. Devices that are at their end whenever nothing is buffered, such as
+    // sockets, are better read through a GeneratorSource
+    class DeviceSource : public Source
+    {
+    private:
+        QIODevice *mDevice;
+        bool mEnded;
+
+    public:
+        DeviceSource(QIODevice *device);
+        ~DeviceSource() = default;
+
+        qint64 Read(char *data, const qint64 size) override;
+        bool AtEnd() const override;
+    };
+
+    // Bytes handed over by a callback, for data that is produced as it is sent
+    class GeneratorSource : public Source
+    {
+    public:
+        // Writes up to size bytes to data and returns how many, 0 if there are none right now and -1
+        // on error. Sets done once nothing more will follow
+        using Generator = std::function<qint64(char *data, const qint64 size, bool& done)>;
+
+    private:
+        Generator mGenerator;
+        bool mEnded;
+
+    public:
+        GeneratorSource(const Generator& generator);
+        ~GeneratorSource() = default;
+
+        qint64 Read(char *data, const qint64 size) override;
+        bool AtEnd() const override;
+    };
+
+#if defined(__linux__)
+    // A file descriptor such as a pipe or stdin, read without blocking
+    class FdSource : public Source
+    {
+    private:
+        int mFd;
+        bool mOwned;
+        bool mEnded;
+
+    public:
+        FdSource(const int fd, const bool owned = false);
+        ~FdSource();
+
+        qint64 Read(char *data, const qint64 size) override;
+        bool AtEnd() const override;
+    };
+#endif
+}
@@ -0,0 +1,401 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             StreamFramer.cpp
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Events point into the bytes that were added, they are only good until
+--                          the caller is done with those bytes.
+---------------------------------------------------------------------------------------*/
+#include "StreamFramer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    // Most bytes a varint of 64 bits takes
+    constexpr int MAX_VARINT = 10;
+
+    // Appends value 7 bits at a time, the high bit of a byte is set if more bytes follow
+    void appendVarint(QByteArray& bytes, quint64 value)
+    {
+        while (value >= 0x80)
+        {
+            bytes.append((char)((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        bytes.append((char)value);
+    }
+
+    // Reads a varint at at and moves at past it, false if it runs past end or is too long
+    bool readVarint(const char *& at, const char *end, quint64& value)
+    {
+        value = 0;
+        for (int i = 0; i < MAX_VARINT && at < end; i++)
+        {
+            const quint8 byte = (quint8)*at++;
+            value |= (quint64)(byte & 0x7F) << (7 * i);
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::StreamFramer::StreamFramer
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::StreamFramer::StreamFramer()
+--
+-- NOTES:
+--                          Constructor for a framer that expects the header of the first file.
+--------------------------------------------------------------------------------------------------*/
+kgp::StreamFramer::StreamFramer()
+{
+    Reset();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::StreamFramer::Header
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               QByteArray kgp::StreamFramer::Header(const quint64 id, const QString& name, const quint64 size)
+--                              id: The ID of the file in the session.
+--                              name: The name of the file without its directory.
+--                              size: The bytes of the file.
+--
+-- RETURN:                  The header and name that go in front of the file.
+--
+-- NOTES:
+--                          Names longer than Session::MAX_NAME bytes are cut.
+--------------------------------------------------------------------------------------------------*/
+QByteArray kgp::StreamFramer::Header(const quint64 id, const QString& name, const quint64 size)
+{
+    const QByteArray utf8 = name.toUtf8().left((int)Session::MAX_NAME);
+
+    StreamHeader header;
+    header.Id = id;
+    header.Size = size;
+    header.NameSize = utf8.size();
+
+    QByteArray bytes((const char *)&header, (int)sizeof(header));
+    bytes.append(utf8);
+    return bytes;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::StreamFramer::Manifest
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               QByteArray kgp::StreamFramer::Manifest(const std::vector<FileEntry>& entries)
+--                              entries: The files of the directory in the order their data follows.
+--
+-- RETURN:                  The BatchHeader and manifest that go in front of the data of the files.
+--
+-- NOTES:
+--                          The files get the IDs 1 and up in the order of the manifest.
+--------------------------------------------------------------------------------------------------*/
+QByteArray kgp::StreamFramer::Manifest(const std::vector<FileEntry>& entries)
+{
+    QByteArray manifest;
+    for (const auto& entry : entries)
+    {
+        const QByteArray utf8 = entry.name.toUtf8();
+        appendVarint(manifest, entry.size);
+        appendVarint(manifest, utf8.size());
+        manifest.append(utf8);
+    }
+
+    BatchHeader header;
+    header.Count = entries.size();
+    header.Size = manifest.size();
+
+    QByteArray bytes((const char *)&header, (int)sizeof(header));
+    bytes.append(manifest);
+    return bytes;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::StreamFramer::Reset
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Expects a manifest for a directory.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::StreamFramer::Reset(const Layout layout)
+--                              layout: Whether the stream starts with a header or a manifest.
+--
+-- NOTES:
+--                          Forgets the file in progress, the next byte starts a header or the
+--                          manifest.
+--------------------------------------------------------------------------------------------------*/
+void kgp::StreamFramer::Reset(const Layout layout)
+{
+    mLayout = layout;
+    mHeader.clear();
+    memset(&mCurrent, 0, sizeof(mCurrent));
+    mRemaining = 0;
+    mInFile = false;
+    mEntries.clear();
+    mNextId = 1;
+    mManifestRead = false;
+    mBroken = false;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::StreamFramer::Add
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               October 19, 2026 - Benny Wang: Splits the stream of a directory by its
+--                          manifest.
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::StreamFramer::Add(const char *data, const size_t size, std::vector<Event>& events)
+--                              data: The next bytes of the stream, in order.
+--                              size: The number of bytes.
+--                              events: The list that the files that start, the data of the files and
+--                              the files that end will be put into, in the order of the stream.
+--
+-- RETURN:                  False if a header with a name longer than Session::MAX_NAME or a
+--                          manifest that could not be read was read, or if bytes followed the last
+--                          file of the manifest, true otherwise.
+--
+-- NOTES:
+--                          A file of 0 bytes starts and ends at once. Once a header could not be
+--                          read nothing more is split until Reset.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::StreamFramer::Add(const char *data, const size_t size, std::vector<Event>& events)
+{
+    if (mBroken) return false;
+
+    size_t at = 0;
+    while (at < size)
+    {
+        if (mInFile)
+        {
+            const quint64 count = std::min<quint64>(mRemaining, size - at);
+            events.push_back({ EventType::DATA, mCurrent.Id, QString(), count, data + at });
+            at += count;
+            mRemaining -= count;
+        }
+        else if (mLayout == Layout::MANIFEST)
+        {
+            if (!addManifest(data, size, at, events))
+            {
+                mBroken = true;
+                return false;
+            }
+        }
+        else
+        {
+            // The fixed part of the header tells how long the name after it is
+            quint64 needed = sizeof(StreamHeader);
+            if ((quint64)mHeader.size() >= sizeof(StreamHeader)) needed += mCurrent.NameSize;
+
+            const quint64 count = std::min<quint64>(needed - mHeader.size(), size - at);
+            mHeader.append(data + at, (int)count);
+            at += count;
+            if ((quint64)mHeader.size() < needed) continue;
+
+            if (needed == sizeof(StreamHeader))
+            {
+                memcpy(&mCurrent, mHeader.constData(), sizeof(mCurrent));
+                if (mCurrent.NameSize > Session::MAX_NAME)
+                {
+                    mBroken = true;
+                    return false;
+                }
+                if (mCurrent.NameSize > 0) continue;
+            }
+
+            const QString name = QString::fromUtf8(mHeader.constData() + sizeof(StreamHeader), (int)mCurrent.NameSize);
+            events.push_back({ EventType::START, mCurrent.Id, name, mCurrent.Size, nullptr });
+            mHeader.clear();
+            mRemaining = mCurrent.Size;
+            mInFile = true;
+        }
+
+        // A file ends with its last byte, a file of 0 bytes as soon as it starts
+        if (mInFile && mRemaining == 0)
+        {
+            events.push_back({ EventType::END, mCurrent.Id, QString(), 0, nullptr });
+            mInFile = false;
+            if (mLayout == Layout::MANIFEST) nextEntry(events);
+        }
+    }
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::StreamFramer::addManifest
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::StreamFramer::addManifest(const char *data, const size_t size, size_t& at, std::vector<Event>& events)
+--                              data: The bytes being added.
+--                              size: The number of bytes.
+--                              at: The first byte that has not been read, moved past what is taken.
+--                              events: Gets the first files once the whole manifest is read.
+--
+-- RETURN:                  False if the manifest could not be read or if it was read already, true
+--                          otherwise.
+--
+-- NOTES:
+--                          Takes the bytes of the BatchHeader and then of the manifest it announces.
+--                          Nothing is split before the whole manifest has arrived.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::StreamFramer::addManifest(const char *data, const size_t size, size_t& at, std::vector<Event>& events)
+{
+    // Everything of a directory is in the manifest, nothing may follow its last file
+    if (mManifestRead) return false;
+
+    quint64 needed = sizeof(BatchHeader);
+    BatchHeader header;
+    if ((quint64)mHeader.size() >= sizeof(BatchHeader))
+    {
+        memcpy(&header, mHeader.constData(), sizeof(header));
+        needed += header.Size;
+    }
+
+    const quint64 count = std::min<quint64>(needed - mHeader.size(), size - at);
+    mHeader.append(data + at, (int)count);
+    at += count;
+    if ((quint64)mHeader.size() < needed) return true;
+
+    if (needed == sizeof(BatchHeader))
+    {
+        memcpy(&header, mHeader.constData(), sizeof(header));
+        if (header.Size > Batch::MAX_MANIFEST) return false;
+        if (header.Size > 0) return true;
+    }
+
+    if (!readManifest()) return false;
+    mHeader.clear();
+    mManifestRead = true;
+    nextEntry(events);
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::StreamFramer::readManifest
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::StreamFramer::readManifest()
+--
+-- RETURN:                  True if the manifest holds exactly the number of entries its header
+--                          announced, false otherwise.
+--
+-- NOTES:
+--                          Reads the entries of the manifest that has fully arrived into the list of
+--                          files that have not started.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::StreamFramer::readManifest()
+{
+    BatchHeader header;
+    memcpy(&header, mHeader.constData(), sizeof(header));
+
+    const char *at = mHeader.constData() + sizeof(header);
+    const char *end = mHeader.constData() + mHeader.size();
+    for (quint64 i = 0; i < header.Count; i++)
+    {
+        quint64 fileSize;
+        quint64 pathSize;
+        if (!readVarint(at, end, fileSize) || !readVarint(at, end, pathSize)) return false;
+        if (pathSize > Batch::MAX_PATH || pathSize > (quint64)(end - at)) return false;
+
+        mEntries.push_back({ QString::fromUtf8(at, (int)pathSize), fileSize });
+        at += pathSize;
+    }
+    return at == end;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::StreamFramer::nextEntry
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::StreamFramer::nextEntry(std::vector<Event>& events)
+--                              events: Gets the files that start, and end if they are empty.
+--
+-- NOTES:
+--                          Starts the next file of the manifest. Files of 0 bytes have no data to
+--                          wait for, they start and end at once and the one after them starts.
+--------------------------------------------------------------------------------------------------*/
+void kgp::StreamFramer::nextEntry(std::vector<Event>& events)
+{
+    while (!mEntries.empty())
+    {
+        const FileEntry entry = mEntries.front();
+        mEntries.pop_front();
+
+        mCurrent.Id = mNextId++;
+        mCurrent.Size = entry.size;
+        events.push_back({ EventType::START, mCurrent.Id, entry.name, entry.size, nullptr });
+        if (entry.size > 0)
+        {
+            mRemaining = entry.size;
+            mInFile = true;
+            return;
+        }
+        events.push_back({ EventType::END, mCurrent.Id, QString(), 0, nullptr });
+    }
+}
@@ -0,0 +1,121 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             StreamFramer.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          The files of a session travel as one stream of bytes, each one after a
+--                          StreamHeader and its name. The sender puts the header in front of the
+--                          file and the receiver splits the stream back into files as it is
+--                          delivered in order. A header may be cut anywhere by the frames, so the
+--                          part of it that has arrived is kept until the rest follows. The stream
+--                          of a directory instead starts with a manifest of all of its files, after
+--                          which their data follows without any headers.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+
+#include "res.h"
+
+namespace kgp
+{
+    class StreamFramer
+    {
+    public:
+        // Headers in front of every file, or a manifest in front of all of them
+        enum class Layout
+        {
+            HEADERS,
+            MANIFEST
+        };
+
+        enum class EventType
+        {
+            START,
+            DATA,
+            END
+        };
+
+        // START carries the ID, name and size of a file, DATA points into the bytes that were added
+        // and END closes the file with the ID
+        struct Event
+        {
+            EventType type;
+            quint64 id;
+            QString name;
+            quint64 size;
+            const char *data;
+        };
+
+        // A file of a manifest, its path is relative to the directory
+        struct FileEntry
+        {
+            QString name;
+            quint64 size;
+        };
+
+    private:
+        Layout mLayout;
+        // Bytes of the header of the next file, or of the manifest, that have arrived
+        QByteArray mHeader;
+        StreamHeader mCurrent;
+        // Bytes of the current file that have not arrived yet
+        quint64 mRemaining;
+        bool mInFile;
+        // Files of the manifest that have not started yet and the ID the next one gets
+        std::deque<FileEntry> mEntries;
+        quint64 mNextId;
+        bool mManifestRead;
+        // A header could not be read, nothing after it can be split
+        bool mBroken;
+
+    public:
+        StreamFramer();
+        ~StreamFramer() = default;
+
+        static QByteArray Header(const quint64 id, const QString& name, const quint64 size);
+        static QByteArray Manifest(const std::vector<FileEntry>& entries);
+
+        void Reset(const Layout layout = Layout::HEADERS);
+        bool Add(const char *data, const size_t size, std::vector<Event>& events);
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::StreamFramer::AtBoundary
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               bool kgp::StreamFramer::AtBoundary()
+        --
+        -- RETURN:                  True if the last file that started has ended and no part of the next
+        --                          header has arrived, false otherwise.
+        --------------------------------------------------------------------------------------------------*/
+        inline bool AtBoundary() const { return !mInFile && mHeader.isEmpty(); }
+
+    private:
+        bool addManifest(const char *data, const size_t size, size_t& at, std::vector<Event>& events);
+        bool readManifest();
+        void nextEntry(std::vector<Event>& events);
+    };
+}
@@ -0,0 +1,175 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             StreamScheduler.cpp
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Streams of the same priority are interleaved by smooth weighted round
+--                          robin, so a stream with weight 3 next to one with weight 1 sends three of
+--                          every four frames without sending its three in a row. Turns are counted
+--                          in frames, which are all cut to the same size but the last of a file.
+---------------------------------------------------------------------------------------*/
+#include "StreamScheduler.h"
+
+#include <algorithm>
+#include <cstring>
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::StreamScheduler::StreamScheduler
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::StreamScheduler::StreamScheduler(const size_t streams)
+--                              streams: The number of streams.
+--
+-- NOTES:
+--                          Creates a scheduler with every stream closed.
+--------------------------------------------------------------------------------------------------*/
+kgp::StreamScheduler::StreamScheduler(const size_t streams)
+    : mStreams(streams)
+{
+    Reset();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::StreamScheduler::Reset
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::StreamScheduler::Reset()
+--
+-- NOTES:
+--                          Closes every stream.
+--------------------------------------------------------------------------------------------------*/
+void kgp::StreamScheduler::Reset()
+{
+    for (Entry& entry : mStreams) memset(&entry, 0, sizeof(entry));
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::StreamScheduler::Open
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::StreamScheduler::Open(const size_t stream, const unsigned priority, const unsigned weight)
+--                              stream: The stream a file was put on.
+--                              priority: The priority of the stream, smaller goes first.
+--                              weight: The share of the stream next to streams of the same priority.
+--
+-- NOTES:
+--                          Lets the stream take part in scheduling. It starts without any turns
+--                          owed, a weight of 0 is taken as 1.
+--------------------------------------------------------------------------------------------------*/
+void kgp::StreamScheduler::Open(const size_t stream, const unsigned priority, const unsigned weight)
+{
+    if (stream >= mStreams.size()) return;
+
+    mStreams[stream].open = true;
+    mStreams[stream].priority = priority;
+    mStreams[stream].weight = std::max(weight, 1u);
+    mStreams[stream].credit = 0;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::StreamScheduler::Close
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::StreamScheduler::Close(const size_t stream)
+--                              stream: The stream whose file is done.
+--
+-- NOTES:
+--                          Takes the stream out of scheduling until it is opened again.
+--------------------------------------------------------------------------------------------------*/
+void kgp::StreamScheduler::Close(const size_t stream)
+{
+    if (stream < mStreams.size()) mStreams[stream].open = false;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::StreamScheduler::Next
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::StreamScheduler::Next(const std::vector<bool>& ready, size_t& stream)
+--                              ready: Whether each stream has a frame to send.
+--                              stream: Set to the stream that sends the next frame.
+--
+-- RETURN:                  True if a stream was picked, false if no open stream is ready.
+--
+-- NOTES:
+--                          Picks among the open streams that are ready and have the smallest
+--                          priority. Each of them is owed its weight more, the one that is owed the
+--                          most sends and pays for the turn with the weights of all of them. Ties go
+--                          to the smaller stream. Streams of other priorities keep what they are
+--                          owed.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::StreamScheduler::Next(const std::vector<bool>& ready, size_t& stream)
+{
+    const size_t count = std::min(ready.size(), mStreams.size());
+
+    bool found = false;
+    unsigned priority = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!mStreams[i].open || !ready[i]) continue;
+        if (!found || mStreams[i].priority < priority) priority = mStreams[i].priority;
+        found = true;
+    }
+    if (!found) return false;
+
+    qint64 total = 0;
+    found = false;
+    for (size_t i = 0; i < count; i++)
+    {
+        Entry& entry = mStreams[i];
+        if (!entry.open || !ready[i] || entry.priority != priority) continue;
+        entry.credit += entry.weight;
+        total += entry.weight;
+        if (!found || entry.credit > mStreams[stream].credit) stream = i;
+        found = true;
+    }
+
+    mStreams[stream].credit -= total;
+    return true;
+}
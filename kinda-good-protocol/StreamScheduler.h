@@ -0,0 +1,91 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             StreamScheduler.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Decides which stream of a multiplexed session sends the next frame. Only
+--                          the streams of the smallest priority that have frames to send take part,
+--                          so an urgent file is never held up by a bulk one. Streams of the same
+--                          priority take turns, each getting frames in proportion to its weight.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <vector>
+
+#include <QtGlobal>
+
+#include "res.h"
+
+namespace kgp
+{
+    class StreamScheduler
+    {
+    private:
+        struct Entry
+        {
+            bool open;
+            unsigned priority;
+            unsigned weight;
+            // Turns the stream is owed, it grows by its weight every time the stream could have
+            // sent and shrinks by the weight of all streams that could have when it does
+            qint64 credit;
+        };
+
+        std::vector<Entry> mStreams;
+
+    public:
+        StreamScheduler(const size_t streams = Multiplex::STREAMS);
+        ~StreamScheduler() = default;
+
+        void Reset();
+        void Open(const size_t stream, const unsigned priority, const unsigned weight);
+        void Close(const size_t stream);
+        bool Next(const std::vector<bool>& ready, size_t& stream);
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::StreamScheduler::IsOpen
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               bool kgp::StreamScheduler::IsOpen(const size_t stream)
+        --                              stream: The stream to check.
+        --
+        -- RETURN:                  True if the stream carries a file, false otherwise.
+        --------------------------------------------------------------------------------------------------*/
+        inline bool IsOpen(const size_t stream) const { return stream < mStreams.size() && mStreams[stream].open; }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::StreamScheduler::Size
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               size_t kgp::StreamScheduler::Size()
+        --
+        -- RETURN:                  The number of streams, open or not.
+        --------------------------------------------------------------------------------------------------*/
+        inline size_t Size() const { return mStreams.size(); }
+    };
+}
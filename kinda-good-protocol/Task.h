@@ -0,0 +1,134 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             Task.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          A coroutine that produces a value, for writing transfers that wait on one
+--                          another as straight line code. A task does not run until it is awaited
+--                          or started, and resumes whatever awaited it once it returns. Suspended
+--                          tasks only cost their coroutine frame. Only built with a compiler that
+--                          supports C++20 coroutines.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#if defined(__cpp_impl_coroutine)
+
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <utility>
+
+namespace kgp
+{
+    template<typename T>
+    class Task
+    {
+    public:
+        struct promise_type
+        {
+            T value;
+            // The coroutine that awaits the task, resumed once it returns
+            std::coroutine_handle<> continuation;
+
+            // Hands control back to the coroutine that awaited the task, if any
+            struct FinalAwaiter
+            {
+                bool await_ready() noexcept { return false; }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+                {
+                    const std::coroutine_handle<> continuation = handle.promise().continuation;
+                    return continuation ? continuation : std::noop_coroutine();
+                }
+                void await_resume() noexcept {}
+            };
+
+            Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            FinalAwaiter final_suspend() noexcept { return {}; }
+            void return_value(T result) { value = std::move(result); }
+            // The protocol does not use exceptions, one escaping a task is a bug
+            void unhandled_exception() { std::terminate(); }
+        };
+
+    private:
+        // Runs a started task to the end and frees itself
+        struct Detached
+        {
+            struct promise_type
+            {
+                Detached get_return_object() { return Detached(); }
+                std::suspend_never initial_suspend() noexcept { return {}; }
+                std::suspend_never final_suspend() noexcept { return {}; }
+                void return_void() {}
+                void unhandled_exception() { std::terminate(); }
+            };
+        };
+
+        std::coroutine_handle<promise_type> mHandle;
+
+        explicit Task(std::coroutine_handle<promise_type> handle) : mHandle(handle) {}
+
+        // Awaits the task and hands its value to done
+        static Detached run(Task task, std::function<void(T)> done)
+        {
+            T value = co_await task;
+            if (done) done(std::move(value));
+        }
+
+    public:
+        Task(Task&& other) noexcept : mHandle(std::exchange(other.mHandle, nullptr)) {}
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+        ~Task()
+        {
+            if (mHandle) mHandle.destroy();
+        }
+
+        // A task is awaited by starting it and resuming the awaiting coroutine once it returns
+        bool await_ready() const noexcept { return !mHandle || mHandle.done(); }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+        {
+            mHandle.promise().continuation = awaiting;
+            return mHandle;
+        }
+        T await_resume() { return std::move(mHandle.promise().value); }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::Task::Start
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               void kgp::Task::Start(std::function<void(T)> done)
+        --                              done: Called with the value of the task once it returns, on
+        --                                    whichever thread resumed it last.
+        --
+        -- NOTES:
+        --                          Runs the task from code that is not a coroutine. The task runs
+        --                          until it first suspends before this returns, and owns itself
+        --                          from then on.
+        --------------------------------------------------------------------------------------------------*/
+        void Start(std::function<void(T)> done = nullptr) &&
+        {
+            run(std::move(*this), std::move(done));
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,157 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             ThroughputChart.cpp
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          A live chart of the throughput, round trip time and window of the
+--                          engine.
+---------------------------------------------------------------------------------------*/
+#include "ThroughputChart.h"
+
+#include <algorithm>
+
+#include <QPainter>
+#include <QPolygonF>
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                ThroughputChart::ThroughputChart
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               ThroughputChart::ThroughputChart(QWidget *parent)
+--                              parent: The parent QWidget.
+--
+-- NOTES:
+--                          Constructor for the ThroughputChart. The chart is painted whole on
+--                          every update, so Qt does not have to clear it first.
+--------------------------------------------------------------------------------------------------*/
+ThroughputChart::ThroughputChart(QWidget *parent)
+    : QWidget(parent)
+    , mLastBytes(0)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                ThroughputChart::AddSample
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void ThroughputChart::AddSample(const kgp::IoEngine::Stats& stats)
+--                              stats: The stats of the engine right now.
+--
+-- NOTES:
+--                          Adds a point to every series and drops the oldest once there are
+--                          Events::SAMPLES of them. The throughput is taken over the time since the
+--                          last sample, so samples that come late do not show as a dip. The first
+--                          sample only starts the clock.
+--------------------------------------------------------------------------------------------------*/
+void ThroughputChart::AddSample(const kgp::IoEngine::Stats& stats)
+{
+    const quint64 bytes = stats.bytesSent + stats.bytesRead;
+    if (!mClock.isValid())
+    {
+        mClock.start();
+        mLastBytes = bytes;
+        return;
+    }
+
+    const qint64 elapsed = std::max<qint64>(mClock.restart(), 1);
+    // The counters start over with a new transfer
+    const quint64 delta = bytes >= mLastBytes ? bytes - mLastBytes : bytes;
+    mLastBytes = bytes;
+
+    Sample sample;
+    sample.throughput = delta * 1000.0 / elapsed;
+    sample.rtt = (double)stats.srtt;
+    sample.window = (double)(stats.sendWindow ? stats.sendWindow : stats.receiveRoom);
+
+    mSamples.push_back(sample);
+    while (mSamples.size() > (size_t)kgp::Events::SAMPLES) mSamples.pop_front();
+    update();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                ThroughputChart::paintEvent
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void ThroughputChart::paintEvent(QPaintEvent *event)
+--                              event: The region to paint, the whole chart is painted anyway.
+--
+-- NOTES:
+--                          Draws each series as a line across the width of the chart, the newest
+--                          sample on the right, with the current values in the top left corner.
+--------------------------------------------------------------------------------------------------*/
+void ThroughputChart::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().base());
+
+    struct Series
+    {
+        double Sample::*value;
+        QColor color;
+        QString label;
+    };
+    const Series series[] = {
+        { &Sample::throughput, QColor(0, 120, 215), "KB/s" },
+        { &Sample::rtt, QColor(200, 60, 40), "ms RTT" },
+        { &Sample::window, QColor(60, 150, 60), "KB window" },
+    };
+
+    const double step = (double)width() / std::max(kgp::Events::SAMPLES - 1, 1);
+    const double left = width() - step * ((double)mSamples.size() - 1);
+    int legend = 0;
+    for (const Series& line : series)
+    {
+        double most = 1;
+        for (const Sample& sample : mSamples) most = std::max(most, sample.*line.value);
+
+        QPolygonF points;
+        points.reserve((int)mSamples.size());
+        for (size_t i = 0; i < mSamples.size(); i++)
+        {
+            const double y = (height() - 1) * (1 - mSamples[i].*line.value / most);
+            points << QPointF(left + step * i, y);
+        }
+
+        painter.setPen(line.color);
+        painter.drawPolyline(points);
+
+        const double current = mSamples.empty() ? 0 : mSamples.back().*line.value;
+        const double shown = line.value == &Sample::rtt ? current : current / 1024;
+        const QString text = QString::number(shown, 'f', 1) + " " + line.label;
+        painter.drawText(6 + legend, painter.fontMetrics().ascent() + 4, text);
+        legend += painter.fontMetrics().horizontalAdvance(text) + 12;
+    }
+}
@@ -0,0 +1,59 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             ThroughputChart.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          A live chart of the throughput, round trip time and window of the
+--                          engine. The window samples the stats of the engine at a fixed rate and
+--                          hands them to the chart, which keeps the last Events::SAMPLES of them and
+--                          paints each series scaled to its own largest value.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <deque>
+
+#include <QElapsedTimer>
+#include <QWidget>
+
+#include "IoEngine.h"
+
+class ThroughputChart : public QWidget
+{
+    Q_OBJECT
+
+private:
+    struct Sample
+    {
+        // Payload bytes sent and read per second since the last sample
+        double throughput;
+        // Smoothed round trip time in milliseconds
+        double rtt;
+        // Bytes the send window allows, or room left in the receive window
+        double window;
+    };
+
+    std::deque<Sample> mSamples;
+    // Payload bytes sent and read as of the last sample
+    quint64 mLastBytes;
+    QElapsedTimer mClock;
+
+public:
+    ThroughputChart(QWidget *parent = Q_NULLPTR);
+    ~ThroughputChart() = default;
+
+    void AddSample(const kgp::IoEngine::Stats& stats);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+};
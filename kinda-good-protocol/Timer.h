@@ -0,0 +1,42 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             Timer.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          A stopwatch that reads the clock held by the dependency manager.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#include "DependencyManager.h"
+
+namespace kgp
+{
+    class Timer
+    {
+    private:
+        quint64 mStart;
+
+    public:
+        inline Timer() : mStart(DependencyManager::Instance().Clock().Now()) {}
+
+        // Restarts the timer from the current time
+        inline void Start() { mStart = DependencyManager::Instance().Clock().Now(); }
+
+        // Milliseconds since the timer was started
+        inline quint64 Elapsed() const { return DependencyManager::Instance().Clock().Now() - mStart; }
+
+        // The time the timer was started at
+        inline quint64 Started() const { return mStart; }
+    };
+}
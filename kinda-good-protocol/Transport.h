@@ -0,0 +1,302 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             Transport.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          The interface the IoEngine uses to send and receive datagrams. This
+--                          allows the engine to run over a real UDP socket or over an emulated
+--                          link inside the same process. Files are read and written through the
+--                          transport as well, so that a transport that batches its I/O can batch
+--                          them along with the datagrams.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QHostAddress>
+#include <QNetworkDatagram>
+#include <QObject>
+
+namespace kgp
+{
+    class Transport : public QObject
+    {
+        Q_OBJECT
+
+    public:
+        inline Transport(QObject *parent = nullptr) : QObject(parent) {}
+        virtual ~Transport() = default;
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::Transport::Bind
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               bool kgp::Transport::Bind(const QHostAddress& address, const short& port)
+        --                              address: The local address to bind to.
+        --                              port: The local port to bind to.
+        --
+        -- RETURN:                  True if the transport was bound, false otherwise.
+        --
+        -- NOTES:
+        --                          Binds the transport so that datagrams sent to address and port are
+        --                          received by it.
+        --------------------------------------------------------------------------------------------------*/
+        virtual bool Bind(const QHostAddress& address, const short& port) = 0;
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::Transport::Close
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               void kgp::Transport::Close()
+        --
+        -- NOTES:
+        --                          Unbinds the transport. No more datagrams will be received.
+        --------------------------------------------------------------------------------------------------*/
+        virtual void Close() = 0;
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::Transport::Send
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               qint64 kgp::Transport::Send(const char *data, const qint64 size, const QHostAddress& address, const short& port)
+        --                              data: The start of the datagram.
+        --                              size: The size of the datagram.
+        --                              address: The address to send to.
+        --                              port: The port to send to.
+        --
+        -- RETURN:                  The number of bytes sent or -1 on error.
+        --
+        -- NOTES:
+        --                          Sends a single datagram.
+        --------------------------------------------------------------------------------------------------*/
+        virtual qint64 Send(const char *data, const qint64 size, const QHostAddress& address, const short& port) = 0;
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::Transport::SendProbe
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               qint64 kgp::Transport::SendProbe(const char *data, const qint64 size, const QHostAddress& address, const short& port)
+        --                              data: The start of the datagram.
+        --                              size: The size of the datagram.
+        --                              address: The address to send to.
+        --                              port: The port to send to.
+        --
+        -- RETURN:                  The number of bytes sent or -1 on error, such as a datagram that is
+        --                          larger than the link it has to leave on.
+        --
+        -- NOTES:
+        --                          Sends a single datagram that must not be fragmented on its way. A
+        --                          transport that cannot prevent that sends it like any other.
+        --------------------------------------------------------------------------------------------------*/
+        virtual qint64 SendProbe(const char *data, const qint64 size, const QHostAddress& address, const short& port)
+        {
+            return Send(data, size, address, port);
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::Transport::SendGather
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               qint64 kgp::Transport::SendGather(const char *header, const qint64 headerSize, const char *data, const qint64 dataSize, const QHostAddress& address, const short& port, const bool probe)
+        --                              header: The start of the header.
+        --                              headerSize: The size of the header.
+        --                              data: The start of the data that follows the header.
+        --                              dataSize: The size of the data.
+        --                              address: The address to send to.
+        --                              port: The port to send to.
+        --                              probe: Whether the datagram must not be fragmented on its way.
+        --
+        -- RETURN:                  The number of bytes sent or -1 on error.
+        --
+        -- NOTES:
+        --                          Sends a single datagram made of a header and data that do not have to
+        --                          be next to each other in memory. A transport that cannot send from
+        --                          both places at once joins them and sends them like any other.
+        --------------------------------------------------------------------------------------------------*/
+        virtual qint64 SendGather(const char *header, const qint64 headerSize, const char *data, const qint64 dataSize, const QHostAddress& address, const short& port, const bool probe = false)
+        {
+            QByteArray datagram;
+            datagram.reserve((int)(headerSize + dataSize));
+            datagram.append(header, (int)headerSize).append(data, (int)dataSize);
+            return probe ? SendProbe(datagram.constData(), datagram.size(), address, port) : Send(datagram.constData(), datagram.size(), address, port);
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::Transport::HasPendingDatagrams
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               bool kgp::Transport::HasPendingDatagrams()
+        --
+        -- RETURN:                  True if there is at least one datagram waiting to be read.
+        --------------------------------------------------------------------------------------------------*/
+        virtual bool HasPendingDatagrams() = 0;
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::Transport::Receive
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               QNetworkDatagram kgp::Transport::Receive()
+        --
+        -- RETURN:                  The next pending datagram along with its sender.
+        --------------------------------------------------------------------------------------------------*/
+        virtual QNetworkDatagram Receive() = 0;
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::Transport::Flush
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               void kgp::Transport::Flush(const bool wait)
+        --                              wait: Whether to also wait for the file writes to finish.
+        --
+        -- NOTES:
+        --                          Hands whatever the transport held back to the kernel. A transport
+        --                          that sends and writes right away has nothing to do.
+        --------------------------------------------------------------------------------------------------*/
+        virtual void Flush(const bool wait = false) { (void)wait; }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::Transport::ReadFile
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               bool kgp::Transport::ReadFile(QFile& file, QByteArray& data)
+        --                              file: The open file to read.
+        --                              data: The bytes from the position of file to its end are
+        --                                    appended to this.
+        --
+        -- RETURN:                  True if the file was read, false otherwise.
+        --------------------------------------------------------------------------------------------------*/
+        virtual bool ReadFile(QFile& file, QByteArray& data)
+        {
+            data.append(file.readAll());
+            return true;
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::Transport::WriteFile
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               qint64 kgp::Transport::WriteFile(QFile& file, const qint64 offset, const char *data, const qint64 size)
+        --                              file: The open file to write to.
+        --                              offset: Where in the file to write.
+        --                              data: The bytes to write, only valid during the call.
+        --                              size: The number of bytes.
+        --
+        -- RETURN:                  The number of bytes written or queued, or -1 on error.
+        --
+        -- NOTES:
+        --                          A transport may hold the write back until the next Flush, so the
+        --                          file is only complete once Flush has waited for it. The position of
+        --                          file is not kept.
+        --------------------------------------------------------------------------------------------------*/
+        virtual qint64 WriteFile(QFile& file, const qint64 offset, const char *data, const qint64 size)
+        {
+            if (!file.seek(offset)) return -1;
+            const qint64 written = file.write(data, size);
+            file.flush();
+            return written;
+        }
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::Transport::Syscalls
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::Transport::Syscalls()
+        --
+        -- RETURN:                  The system calls the transport made to move datagrams and file
+        --                          data so far, 0 for a transport that does not count them.
+        --------------------------------------------------------------------------------------------------*/
+        virtual quint64 Syscalls() const { return 0; }
+
+    signals:
+        // Emitted when one or more datagrams are ready to be read
+        void readyRead();
+    };
+}
@@ -0,0 +1,384 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             UdpTransport.cpp
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          A transport that sends and receives over a real UDP socket.
+---------------------------------------------------------------------------------------*/
+#include "UdpTransport.h"
+
+#include <cstring>
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <cerrno>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
+
+namespace
+{
+    // The address family the socket was opened with, AF_UNSPEC if it cannot be told
+    int socketFamily(const qintptr socket)
+    {
+        sockaddr_storage local;
+        socklen_t length = sizeof(local);
+#if defined(_WIN32)
+        if (getsockname((SOCKET)socket, (sockaddr *)&local, &length) != 0) return AF_UNSPEC;
+#else
+        if (getsockname((int)socket, (sockaddr *)&local, &length) != 0) return AF_UNSPEC;
+#endif
+        return local.ss_family;
+    }
+
+    // The socket option that keeps datagrams from being fragmented and the value it had before
+    struct FragmentMode
+    {
+        int level;
+        int name;
+        int value;
+    };
+
+    // Sets the don't fragment bit on datagrams sent on the socket, using the option of its address
+    // family. The mode it replaces is kept in previous so restoreFragment can put it back
+    bool setDontFragment(const qintptr socket, FragmentMode& previous)
+    {
+        int on = 1;
+        switch (socketFamily(socket))
+        {
+#if defined(__linux__)
+        // Probing ignores the MTU the kernel has cached for the path
+        case AF_INET:
+            previous = { IPPROTO_IP, IP_MTU_DISCOVER, 0 };
+            on = IP_PMTUDISC_PROBE;
+            break;
+        case AF_INET6:
+            previous = { IPPROTO_IPV6, IPV6_MTU_DISCOVER, 0 };
+            on = IPV6_PMTUDISC_PROBE;
+            break;
+#elif defined(_WIN32)
+        case AF_INET:
+            previous = { IPPROTO_IP, IP_DONTFRAGMENT, 0 };
+            break;
+        case AF_INET6:
+            previous = { IPPROTO_IPV6, IPV6_DONTFRAG, 0 };
+            break;
+#else
+#if defined(IP_DONTFRAG)
+        case AF_INET:
+            previous = { IPPROTO_IP, IP_DONTFRAG, 0 };
+            break;
+#endif
+#if defined(IPV6_DONTFRAG)
+        case AF_INET6:
+            previous = { IPPROTO_IPV6, IPV6_DONTFRAG, 0 };
+            break;
+#endif
+#endif
+        default:
+            return false;
+        }
+
+#if defined(_WIN32)
+        int length = sizeof(previous.value);
+        if (getsockopt((SOCKET)socket, previous.level, previous.name, (char *)&previous.value, &length) != 0) return false;
+        return setsockopt((SOCKET)socket, previous.level, previous.name, (const char *)&on, sizeof(on)) == 0;
+#else
+        socklen_t length = sizeof(previous.value);
+        if (getsockopt((int)socket, previous.level, previous.name, &previous.value, &length) != 0) return false;
+        return setsockopt((int)socket, previous.level, previous.name, &on, sizeof(on)) == 0;
+#endif
+    }
+
+    // Puts back the mode setDontFragment replaced
+    void restoreFragment(const qintptr socket, const FragmentMode& previous)
+    {
+#if defined(_WIN32)
+        setsockopt((SOCKET)socket, previous.level, previous.name, (const char *)&previous.value, sizeof(previous.value));
+#else
+        setsockopt((int)socket, previous.level, previous.name, &previous.value, sizeof(previous.value));
+#endif
+    }
+
+    // Fills in the native address of address and port for the family the socket was opened with.
+    // Fails for addresses that need a scope or do not fit the socket, Qt handles those
+    bool toNativeAddress(const qintptr socket, const QHostAddress& address, const short& port, sockaddr_storage& native, socklen_t& length)
+    {
+        const int family = socketFamily(socket);
+        if (family == AF_UNSPEC || !address.scopeId().isEmpty()) return false;
+
+        memset(&native, 0, sizeof(native));
+        bool isIpv4 = false;
+        const quint32 ipv4 = address.toIPv4Address(&isIpv4);
+        if (family == AF_INET)
+        {
+            if (!isIpv4) return false;
+            sockaddr_in *to = (sockaddr_in *)&native;
+            to->sin_family = AF_INET;
+            to->sin_port = htons((quint16)port);
+            to->sin_addr.s_addr = htonl(ipv4);
+            length = sizeof(*to);
+            return true;
+        }
+        if (family == AF_INET6)
+        {
+            // A dual stack socket reaches IPv4 hosts through their mapped address, which is what Qt
+            // hands out for them
+            const Q_IPV6ADDR ipv6 = address.toIPv6Address();
+            sockaddr_in6 *to = (sockaddr_in6 *)&native;
+            to->sin6_family = AF_INET6;
+            to->sin6_port = htons((quint16)port);
+            memcpy(&to->sin6_addr, ipv6.c, sizeof(ipv6.c));
+            length = sizeof(*to);
+            return true;
+        }
+        return false;
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::UdpTransport::UdpTransport
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::UdpTransport::UdpTransport(QObject *parent)
+--                              parent: The parent QObject.
+--
+-- NOTES:
+--                          Constructor for the UdpTransport. Forwards the readyRead signal of the
+--                          socket.
+--------------------------------------------------------------------------------------------------*/
+kgp::UdpTransport::UdpTransport(QObject *parent)
+    : Transport(parent)
+    , mSocket(this)
+{
+    connect(&mSocket, &QUdpSocket::readyRead, this, &Transport::readyRead);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::UdpTransport::~UdpTransport
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::UdpTransport::~UdpTransport()
+--
+-- NOTES:
+--                          Deconstructor for the UdpTransport. Closes the socket.
+--------------------------------------------------------------------------------------------------*/
+kgp::UdpTransport::~UdpTransport()
+{
+    Close();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::UdpTransport::Bind
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::UdpTransport::Bind(const QHostAddress& address, const short& port)
+--                              address: The local address to bind to.
+--                              port: The local port to bind to.
+--
+-- RETURN:                  True if the socket was bound, false otherwise.
+--
+-- NOTES:
+--                          Binds the UDP socket.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::UdpTransport::Bind(const QHostAddress& address, const short& port)
+{
+    return mSocket.bind(address, port);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::UdpTransport::Close
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::UdpTransport::Close()
+--
+-- NOTES:
+--                          Closes the UDP socket.
+--------------------------------------------------------------------------------------------------*/
+void kgp::UdpTransport::Close()
+{
+    mSocket.close();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::UdpTransport::Send
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               qint64 kgp::UdpTransport::Send(const char *data, const qint64 size, const QHostAddress& address, const short& port)
+--                              data: The start of the datagram.
+--                              size: The size of the datagram.
+--                              address: The address to send to.
+--                              port: The port to send to.
+--
+-- RETURN:                  The number of bytes sent or -1 on error.
+--
+-- NOTES:
+--                          Writes a single datagram to the socket.
+--------------------------------------------------------------------------------------------------*/
+qint64 kgp::UdpTransport::Send(const char *data, const qint64 size, const QHostAddress& address, const short& port)
+{
+    return mSocket.writeDatagram(data, size, address, port);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::UdpTransport::SendProbe
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               qint64 kgp::UdpTransport::SendProbe(const char *data, const qint64 size, const QHostAddress& address, const short& port)
+--                              data: The start of the datagram.
+--                              size: The size of the datagram.
+--                              address: The address to send to.
+--                              port: The port to send to.
+--
+-- RETURN:                  The number of bytes sent or -1 on error.
+--
+-- NOTES:
+--                          Writes a single datagram with the don't fragment bit set, so a router it
+--                          does not fit through drops it. On Linux the probe ignores the MTU the
+--                          kernel has cached for the path, which is what is being measured. IPv6
+--                          sockets use their own option. The mode the socket had is put back
+--                          afterwards since data is cut to a payload that is known to fit anyway,
+--                          and the handshake is not.
+--------------------------------------------------------------------------------------------------*/
+qint64 kgp::UdpTransport::SendProbe(const char *data, const qint64 size, const QHostAddress& address, const short& port)
+{
+    const qintptr socket = mSocket.socketDescriptor();
+    FragmentMode previous;
+    if (socket == -1 || !setDontFragment(socket, previous)) return Send(data, size, address, port);
+
+    const qint64 sent = mSocket.writeDatagram(data, size, address, port);
+    restoreFragment(socket, previous);
+    return sent;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::UdpTransport::SendGather
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               qint64 kgp::UdpTransport::SendGather(const char *header, const qint64 headerSize, const char *data, const qint64 dataSize, const QHostAddress& address, const short& port, const bool probe)
+--                              header: The start of the header.
+--                              headerSize: The size of the header.
+--                              data: The start of the data that follows the header.
+--                              dataSize: The size of the data.
+--                              address: The address to send to.
+--                              port: The port to send to.
+--                              probe: Whether the datagram must not be fragmented on its way.
+--
+-- RETURN:                  The number of bytes sent or -1 on error.
+--
+-- NOTES:
+--                          Hands the header and data to the socket as two buffers of a single
+--                          datagram, so neither is copied before the kernel copies them. Qt has no
+--                          call for that, the native socket is written directly. Until the socket is
+--                          bound, or for addresses the native socket cannot be given, the datagram
+--                          is joined and written through Qt.
+--------------------------------------------------------------------------------------------------*/
+qint64 kgp::UdpTransport::SendGather(const char *header, const qint64 headerSize, const char *data, const qint64 dataSize, const QHostAddress& address, const short& port, const bool probe)
+{
+    const qintptr socket = mSocket.socketDescriptor();
+    sockaddr_storage to;
+    socklen_t length;
+    if (socket == -1 || !toNativeAddress(socket, address, port, to, length))
+    {
+        return Transport::SendGather(header, headerSize, data, dataSize, address, port, probe);
+    }
+
+    FragmentMode previous;
+    const bool dontFragment = probe && setDontFragment(socket, previous);
+
+#if defined(_WIN32)
+    WSABUF buffers[2];
+    buffers[0].buf = (CHAR *)header;
+    buffers[0].len = (ULONG)headerSize;
+    buffers[1].buf = (CHAR *)data;
+    buffers[1].len = (ULONG)dataSize;
+
+    DWORD sent = 0;
+    const qint64 result = WSASendTo((SOCKET)socket, buffers, dataSize > 0 ? 2 : 1, &sent, 0, (const sockaddr *)&to, length, nullptr, nullptr) == 0 ? (qint64)sent : -1;
+#else
+    iovec buffers[2];
+    buffers[0].iov_base = (void *)header;
+    buffers[0].iov_len = (size_t)headerSize;
+    buffers[1].iov_base = (void *)data;
+    buffers[1].iov_len = (size_t)dataSize;
+
+    msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_name = &to;
+    message.msg_namelen = length;
+    message.msg_iov = buffers;
+    message.msg_iovlen = dataSize > 0 ? 2 : 1;
+
+    ssize_t result;
+    do
+    {
+        result = sendmsg((int)socket, &message, 0);
+    } while (result < 0 && errno == EINTR);
+#endif
+
+    if (dontFragment) restoreFragment(socket, previous);
+    return result;
+}
@@ -0,0 +1,47 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             UdpTransport.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          A transport that sends and receives over a real UDP socket.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <QUdpSocket>
+
+#include "Transport.h"
+
+namespace kgp
+{
+    class UdpTransport : public Transport
+    {
+        Q_OBJECT
+
+    private:
+        QUdpSocket mSocket;
+
+    public:
+        UdpTransport(QObject *parent = nullptr);
+        virtual ~UdpTransport();
+
+        bool Bind(const QHostAddress& address, const short& port) override;
+        void Close() override;
+        qint64 Send(const char *data, const qint64 size, const QHostAddress& address, const short& port) override;
+        qint64 SendProbe(const char *data, const qint64 size, const QHostAddress& address, const short& port) override;
+        qint64 SendGather(const char *header, const qint64 headerSize, const char *data, const qint64 dataSize, const QHostAddress& address, const short& port, const bool probe = false) override;
+
+        inline bool HasPendingDatagrams() override { return mSocket.hasPendingDatagrams(); }
+        inline QNetworkDatagram Receive() override { return mSocket.receiveDatagram(); }
+    };
+}
@@ -0,0 +1,866 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             UringTransport.cpp
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Datagrams and file data moved through one io_uring.
+---------------------------------------------------------------------------------------*/
+#include "UringTransport.h"
+
+#if defined(__linux__)
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "DependencyManager.h"
+
+namespace
+{
+    // Requests that can be queued before the ring has to be submitted
+    constexpr unsigned RING_ENTRIES = 256;
+    // Receives kept posted on the ring
+    constexpr unsigned RECEIVES = 64;
+    // Sends that can be in flight at once
+    constexpr unsigned SENDS = 128;
+    // Room for one datagram, the largest the protocol sends is 9000 bytes less the IP and UDP headers
+    constexpr size_t MESSAGE_SIZE = 9216;
+    // Registered buffers file writes are gathered in
+    constexpr unsigned WRITES = 8;
+    constexpr size_t WRITE_SIZE = 256 * 1024;
+    // Reads of a file that can be in flight at once, and the bytes each one reads
+    constexpr unsigned READS = 32;
+    constexpr size_t READ_SIZE = 1024 * 1024;
+
+    // What a completion belongs to, kept in the upper half of its user data
+    enum Kind : quint64
+    {
+        RECEIVE = 1,
+        SEND,
+        WRITE,
+        READ,
+        CANCEL
+    };
+
+    // The user data of a request of kind for the slot at index
+    quint64 tag(const Kind kind, const unsigned index)
+    {
+        return (kind << 32) | index;
+    }
+
+    // Points message at its buffer and its address
+    void prepare(msghdr& header, iovec& buffer, sockaddr_storage& address, char *memory)
+    {
+        memset(&header, 0, sizeof(header));
+        buffer.iov_base = memory;
+        buffer.iov_len = MESSAGE_SIZE;
+        header.msg_name = &address;
+        header.msg_namelen = sizeof(address);
+        header.msg_iov = &buffer;
+        header.msg_iovlen = 1;
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::UringTransport::UringTransport
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::UringTransport::UringTransport(Reactor& reactor, QObject *parent)
+--                              reactor: The loop that waits on the ring. Must outlive the transport.
+--                              parent: The parent QObject.
+--
+-- NOTES:
+--                          Constructor for the UringTransport. Sets up the ring and the buffers the
+--                          datagrams and file writes go through, and registers the write buffers
+--                          with the kernel. Writes fall back to plain buffers if they could not be
+--                          registered. IsValid tells if the ring could not be set up.
+--------------------------------------------------------------------------------------------------*/
+kgp::UringTransport::UringTransport(Reactor& reactor, QObject *parent)
+    : ReactorTransport(reactor, parent)
+    , mRing(RING_ENTRIES)
+    , mEvent(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+    , mFixed(false)
+    , mReceiveMemory(RECEIVES * MESSAGE_SIZE)
+    , mReceives(RECEIVES)
+    , mReceived()
+    , mSendMemory(SENDS * MESSAGE_SIZE)
+    , mSends(SENDS)
+    , mFreeSends()
+    , mWriteMemory(WRITES * WRITE_SIZE)
+    , mWrites(WRITES)
+    , mOpenWrite(-1)
+    , mWritesBusy(0)
+    , mReads(READS)
+    , mReadsBusy(0)
+    , mReadFailed(false)
+    , mReadEnd(0)
+    , mClosing(false)
+{
+    for (unsigned i = 0; i < RECEIVES; i++)
+    {
+        Message& message = mReceives[i];
+        prepare(message.header, message.buffer, message.address, mReceiveMemory.data() + i * MESSAGE_SIZE);
+        message.busy = false;
+    }
+    for (unsigned i = 0; i < SENDS; i++)
+    {
+        Message& message = mSends[i];
+        prepare(message.header, message.buffer, message.address, mSendMemory.data() + i * MESSAGE_SIZE);
+        message.busy = false;
+        mFreeSends.push_back(SENDS - 1 - i);
+    }
+    for (unsigned i = 0; i < WRITES; i++)
+    {
+        memset(&mWrites[i], 0, sizeof(mWrites[i]));
+        mWrites[i].data = mWriteMemory.data() + i * WRITE_SIZE;
+    }
+    for (FileOp& read : mReads) memset(&read, 0, sizeof(read));
+
+    if (!IsValid())
+    {
+        DependencyManager::Instance().Logger().Error("Could not set up the io_uring of the transport");
+        return;
+    }
+    if (!mRing.RegisterEventFd(mEvent))
+    {
+        DependencyManager::Instance().Logger().Error("Could not register the eventfd of the io_uring");
+        close(mEvent);
+        mEvent = -1;
+        return;
+    }
+
+    iovec buffers[WRITES];
+    for (unsigned i = 0; i < WRITES; i++)
+    {
+        buffers[i].iov_base = mWrites[i].data;
+        buffers[i].iov_len = WRITE_SIZE;
+    }
+    mFixed = mRing.RegisterBuffers(buffers, WRITES);
+    if (!mFixed) DependencyManager::Instance().Logger().Log("The io_uring write buffers could not be registered, writes are not fixed");
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::UringTransport::~UringTransport
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               kgp::UringTransport::~UringTransport()
+--
+-- NOTES:
+--                          Deconstructor for the UringTransport. Waits for everything in flight so
+--                          that the kernel is done with the buffers before they go away.
+--------------------------------------------------------------------------------------------------*/
+kgp::UringTransport::~UringTransport()
+{
+    Close();
+    if (mEvent != -1) close(mEvent);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::UringTransport::Close
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::UringTransport::Close()
+--
+-- NOTES:
+--                          Cancels the posted receives, waits for them along with the sends and
+--                          writes still in flight and closes the socket. Datagrams that were
+--                          received and not read are dropped. Has to be called while the reactor is
+--                          not running or on its thread.
+--------------------------------------------------------------------------------------------------*/
+void kgp::UringTransport::Close()
+{
+    if (IsValid())
+    {
+        mClosing = true;
+        for (unsigned i = 0; i < RECEIVES; i++)
+        {
+            if (!mReceives[i].busy) continue;
+            io_uring_sqe *cancel = entry();
+            if (!cancel) break;
+            cancel->opcode = IORING_OP_ASYNC_CANCEL;
+            cancel->addr = tag(RECEIVE, i);
+            cancel->user_data = tag(CANCEL, i);
+        }
+
+        Flush();
+        waitFor([this]()
+        {
+            const bool receiving = std::any_of(mReceives.begin(), mReceives.end(), [](const Message& message) { return message.busy; });
+            return !receiving && mFreeSends.size() == SENDS && mWritesBusy == 0;
+        });
+        mReactor.Unwatch(mEvent);
+        mClosing = false;
+    }
+
+    mReceived.clear();
+    ReactorTransport::Close();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::UringTransport::Send
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               qint64 kgp::UringTransport::Send(const char *data, const qint64 size, const QHostAddress& address, const short& port)
+--                              data: The start of the datagram.
+--                              size: The size of the datagram.
+--                              address: The address to send to.
+--                              port: The port to send to.
+--
+-- RETURN:                  The number of bytes queued or -1 on error.
+--
+-- NOTES:
+--                          Copies the datagram and queues it, it is sent on the next Flush. When
+--                          every send buffer is taken this waits for one to be free, so a sender
+--                          that outpaces the socket is slowed down like a blocking send would.
+--------------------------------------------------------------------------------------------------*/
+qint64 kgp::UringTransport::Send(const char *data, const qint64 size, const QHostAddress& address, const short& port)
+{
+    return SendGather(data, size, nullptr, 0, address, port);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::UringTransport::SendProbe
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               qint64 kgp::UringTransport::SendProbe(const char *data, const qint64 size, const QHostAddress& address, const short& port)
+--                              data: The start of the datagram.
+--                              size: The size of the datagram.
+--                              address: The address to send to.
+--                              port: The port to send to.
+--
+-- RETURN:                  The number of bytes sent or -1 on error.
+--------------------------------------------------------------------------------------------------*/
+qint64 kgp::UringTransport::SendProbe(const char *data, const qint64 size, const QHostAddress& address, const short& port)
+{
+    return SendGather(data, size, nullptr, 0, address, port, true);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::UringTransport::SendGather
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               qint64 kgp::UringTransport::SendGather(const char *header, const qint64 headerSize, const char *data, const qint64 dataSize, const QHostAddress& address, const short& port, const bool probe)
+--                              header: The start of the header.
+--                              headerSize: The size of the header.
+--                              data: The start of the data that follows the header.
+--                              dataSize: The size of the data.
+--                              address: The address to send to.
+--                              port: The port to send to.
+--                              probe: Whether the datagram must not be fragmented on its way.
+--
+-- RETURN:                  The number of bytes queued or sent, or -1 on error.
+--
+-- NOTES:
+--                          The header and the data are copied into one send buffer and queued.
+--                          Probes are rare and turn the don't fragment bit on for the whole socket,
+--                          so they are sent right away once the datagrams queued before them are
+--                          out. Datagrams too large for a send buffer are sent right away as well.
+--------------------------------------------------------------------------------------------------*/
+qint64 kgp::UringTransport::SendGather(const char *header, const qint64 headerSize, const char *data, const qint64 dataSize, const QHostAddress& address, const short& port, const bool probe)
+{
+    if (mSocket == -1 || headerSize < 0 || dataSize < 0) return -1;
+
+    const qint64 size = headerSize + dataSize;
+    if (probe || (size_t)size > MESSAGE_SIZE || !IsValid())
+    {
+        Flush();
+        if (probe) waitFor([this]() { return mFreeSends.size() == SENDS; });
+        return ReactorTransport::SendGather(header, headerSize, data, dataSize, address, port, probe);
+    }
+
+    sockaddr_storage to;
+    socklen_t length;
+    if (!toNative(address, port, to, length)) return -1;
+
+    if (mFreeSends.empty()) waitFor([this]() { return !mFreeSends.empty(); });
+    io_uring_sqe *send = mFreeSends.empty() ? nullptr : entry();
+    if (!send) return -1;
+
+    const unsigned index = mFreeSends.back();
+    mFreeSends.pop_back();
+    Message& message = mSends[index];
+    if (headerSize > 0) memcpy(message.buffer.iov_base, header, (size_t)headerSize);
+    if (dataSize > 0) memcpy((char *)message.buffer.iov_base + headerSize, data, (size_t)dataSize);
+    message.buffer.iov_len = (size_t)size;
+    message.address = to;
+    message.header.msg_namelen = length;
+    message.busy = true;
+
+    send->opcode = IORING_OP_SENDMSG;
+    send->fd = mSocket;
+    send->addr = (quint64)&message.header;
+    send->len = 1;
+    send->user_data = tag(SEND, index);
+    return size;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::UringTransport::HasPendingDatagrams
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::UringTransport::HasPendingDatagrams()
+--
+-- RETURN:                  True if at least one datagram was received and not read yet.
+--
+-- NOTES:
+--                          Picks up the receives that completed since the ring was last looked at,
+--                          which does not take a system call.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::UringTransport::HasPendingDatagrams()
+{
+    if (mReceived.empty()) reap();
+    return !mReceived.empty();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::UringTransport::Receive
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               QNetworkDatagram kgp::UringTransport::Receive()
+--
+-- RETURN:                  The next pending datagram along with its sender, or an empty datagram if
+--                          there is none.
+--------------------------------------------------------------------------------------------------*/
+QNetworkDatagram kgp::UringTransport::Receive()
+{
+    if (!HasPendingDatagrams()) return QNetworkDatagram();
+
+    QNetworkDatagram datagram = mReceived.front();
+    mReceived.pop_front();
+    return datagram;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::UringTransport::Flush
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::UringTransport::Flush(const bool wait)
+--                              wait: Whether to also wait for the file writes to finish.
+--
+-- NOTES:
+--                          Queues the write that was left open and any receive that could not be
+--                          posted again, and submits everything queued in one system call. Nothing
+--                          is entered if nothing was queued.
+--------------------------------------------------------------------------------------------------*/
+void kgp::UringTransport::Flush(const bool wait)
+{
+    if (!IsValid()) return;
+
+    if (mOpenWrite != -1)
+    {
+        queueWrite((unsigned)mOpenWrite);
+        mOpenWrite = -1;
+    }
+    if (mSocket != -1 && !mClosing)
+    {
+        for (unsigned i = 0; i < RECEIVES; i++)
+        {
+            if (!mReceives[i].busy) postReceive(i);
+        }
+    }
+
+    mRing.Submit();
+    if (wait) waitFor([this]() { return mWritesBusy == 0; });
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::UringTransport::ReadFile
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::UringTransport::ReadFile(QFile& file, QByteArray& data)
+--                              file: The open file to read.
+--                              data: The bytes from the position of file to its end are appended to
+--                                    this.
+--
+-- RETURN:                  True if the file was read, false otherwise.
+--
+-- NOTES:
+--                          Reads the file in pieces that are all in flight at once, straight into
+--                          data. A file that turns out shorter than its size said is cut where it
+--                          ends. Returns once the whole file is read, datagrams that arrive in the
+--                          meantime are kept for Receive.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::UringTransport::ReadFile(QFile& file, QByteArray& data)
+{
+    const int handle = file.handle();
+    if (!IsValid() || handle == -1) return ReactorTransport::ReadFile(file, data);
+
+    const qint64 start = file.pos();
+    const qint64 size = file.size() - start;
+    if (size <= 0) return true;
+
+    const int before = data.size();
+    data.resize(before + (int)size);
+    char *into = data.data() + before;
+    mReadFailed = false;
+    mReadEnd = start + size;
+
+    qint64 next = 0;
+    while (true)
+    {
+        for (unsigned i = 0; i < READS && next < mReadEnd - start; i++)
+        {
+            FileOp& read = mReads[i];
+            if (read.busy) continue;
+
+            read.file = handle;
+            read.offset = start + next;
+            read.data = into + next;
+            read.size = (size_t)std::min<qint64>(READ_SIZE, mReadEnd - start - next);
+            read.done = 0;
+            read.busy = true;
+            mReadsBusy++;
+            queueRead(i);
+            next += (qint64)read.size;
+        }
+
+        if (mReadsBusy == 0) break;
+        if (mRing.Submit(1) < 0) return false;
+        reap();
+    }
+
+    data.resize(before + (int)(mReadEnd - start));
+    file.seek(mReadEnd);
+    return !mReadFailed;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::UringTransport::WriteFile
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               qint64 kgp::UringTransport::WriteFile(QFile& file, const qint64 offset, const char *data, const qint64 size)
+--                              file: The open file to write to.
+--                              offset: Where in the file to write.
+--                              data: The bytes to write, only valid during the call.
+--                              size: The number of bytes.
+--
+-- RETURN:                  The number of bytes queued, or -1 on error.
+--
+-- NOTES:
+--                          Copies data into a registered buffer. Writes that continue where the
+--                          last one ended are gathered in the same buffer, so a transfer written a
+--                          frame at a time reaches the kernel a buffer at a time. A buffer is
+--                          queued when it is full, when a write goes somewhere else or on Flush.
+--                          The file must not be written through QFile while writes are in flight.
+--------------------------------------------------------------------------------------------------*/
+qint64 kgp::UringTransport::WriteFile(QFile& file, const qint64 offset, const char *data, const qint64 size)
+{
+    const int handle = file.handle();
+    if (!IsValid() || handle == -1) return ReactorTransport::WriteFile(file, offset, data, size);
+    if (size < 0) return -1;
+
+    qint64 written = 0;
+    while (written < size)
+    {
+        if (mOpenWrite != -1)
+        {
+            const FileOp& open = mWrites[mOpenWrite];
+            if (open.file != handle || open.offset + (qint64)open.size != offset + written || open.size == WRITE_SIZE)
+            {
+                queueWrite((unsigned)mOpenWrite);
+                mOpenWrite = -1;
+            }
+        }
+
+        if (mOpenWrite == -1)
+        {
+            waitFor([this]() { return mWritesBusy < WRITES; });
+            const auto free = std::find_if(mWrites.begin(), mWrites.end(), [](const FileOp& write) { return !write.busy; });
+            if (free == mWrites.end()) return -1;
+
+            free->file = handle;
+            free->offset = offset + written;
+            free->size = 0;
+            free->done = 0;
+            free->busy = true;
+            mWritesBusy++;
+            mOpenWrite = (int)(free - mWrites.begin());
+        }
+
+        FileOp& open = mWrites[mOpenWrite];
+        const size_t piece = (size_t)std::min<qint64>(size - written, (qint64)(WRITE_SIZE - open.size));
+        memcpy(open.data + open.size, data + written, piece);
+        open.size += piece;
+        written += (qint64)piece;
+    }
+    return size;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::UringTransport::watch
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               bool kgp::UringTransport::watch()
+--
+-- RETURN:                  True if the reactor waits on the ring.
+--
+-- NOTES:
+--                          Posts the receives on the socket that was just bound and has the reactor
+--                          wait on the eventfd of the ring instead of the socket. Whenever the ring
+--                          signals, the completions are picked up, readyRead is emitted if a
+--                          datagram came in and whatever the handlers queued is submitted at once.
+--------------------------------------------------------------------------------------------------*/
+bool kgp::UringTransport::watch()
+{
+    if (!IsValid()) return false;
+
+    const bool watched = mReactor.Watch(mEvent, [this]()
+    {
+        quint64 count;
+        mSyscalls++;
+        while (read(mEvent, &count, sizeof(count)) < 0 && errno == EINTR);
+
+        reap();
+        if (!mReceived.empty()) emit readyRead();
+        Flush();
+    });
+    if (!watched) return false;
+
+    for (unsigned i = 0; i < RECEIVES; i++) postReceive(i);
+    mRing.Submit();
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::UringTransport::entry
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               io_uring_sqe *kgp::UringTransport::entry()
+--
+-- RETURN:                  A request to fill in, or nullptr if the ring is full even after it was
+--                          submitted.
+--------------------------------------------------------------------------------------------------*/
+io_uring_sqe *kgp::UringTransport::entry()
+{
+    io_uring_sqe *request = mRing.GetEntry();
+    if (request) return request;
+
+    mRing.Submit();
+    return mRing.GetEntry();
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::UringTransport::postReceive
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::UringTransport::postReceive(const unsigned index)
+--                              index: The receive to post.
+--
+-- NOTES:
+--                          Queues a receive of the next datagram into the buffer at index. A
+--                          receive that cannot be queued is tried again on the next Flush.
+--------------------------------------------------------------------------------------------------*/
+void kgp::UringTransport::postReceive(const unsigned index)
+{
+    Message& message = mReceives[index];
+    io_uring_sqe *receive = entry();
+    if (!receive) return;
+
+    message.header.msg_namelen = sizeof(message.address);
+    message.header.msg_flags = 0;
+    message.busy = true;
+
+    receive->opcode = IORING_OP_RECVMSG;
+    receive->fd = mSocket;
+    receive->addr = (quint64)&message.header;
+    receive->len = 1;
+    receive->user_data = tag(RECEIVE, index);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::UringTransport::queueWrite
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::UringTransport::queueWrite(const unsigned index)
+--                              index: The write buffer to queue.
+--
+-- NOTES:
+--                          Queues the part of the buffer at index that has not been written yet.
+--------------------------------------------------------------------------------------------------*/
+void kgp::UringTransport::queueWrite(const unsigned index)
+{
+    FileOp& write = mWrites[index];
+    io_uring_sqe *request = entry();
+    if (!request)
+    {
+        DependencyManager::Instance().Logger().Error("Could not queue a file write, the io_uring is full");
+        write.busy = false;
+        mWritesBusy--;
+        return;
+    }
+
+    request->opcode = mFixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+    request->fd = write.file;
+    request->addr = (quint64)(write.data + write.done);
+    request->len = (quint32)(write.size - write.done);
+    request->off = (quint64)(write.offset + (qint64)write.done);
+    if (mFixed) request->buf_index = (quint16)index;
+    request->user_data = tag(WRITE, index);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::UringTransport::queueRead
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::UringTransport::queueRead(const unsigned index)
+--                              index: The read to queue.
+--
+-- NOTES:
+--                          Queues the part of the read at index that has not been read yet.
+--------------------------------------------------------------------------------------------------*/
+void kgp::UringTransport::queueRead(const unsigned index)
+{
+    FileOp& read = mReads[index];
+    io_uring_sqe *request = entry();
+    if (!request)
+    {
+        mReadFailed = true;
+        read.busy = false;
+        mReadsBusy--;
+        return;
+    }
+
+    request->opcode = IORING_OP_READ;
+    request->fd = read.file;
+    request->addr = (quint64)(read.data + read.done);
+    request->len = (quint32)(read.size - read.done);
+    request->off = (quint64)(read.offset + (qint64)read.done);
+    request->user_data = tag(READ, index);
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::UringTransport::reap
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::UringTransport::reap()
+--
+-- NOTES:
+--                          Handles every completion the ring holds. Received datagrams are kept for
+--                          Receive and their buffers posted again, truncated ones are dropped since
+--                          no frame of the protocol is that large. Short file reads and writes are
+--                          queued again for the rest.
+--------------------------------------------------------------------------------------------------*/
+void kgp::UringTransport::reap()
+{
+    io_uring_cqe completion;
+    while (mRing.NextCompletion(completion))
+    {
+        const quint64 kind = completion.user_data >> 32;
+        const unsigned index = (unsigned)(completion.user_data & 0xffffffff);
+        const int result = completion.res;
+
+        if (kind == RECEIVE)
+        {
+            Message& message = mReceives[index];
+            message.busy = false;
+            if (result >= 0 && !(message.header.msg_flags & MSG_TRUNC))
+            {
+                quint16 port = 0;
+                const QHostAddress sender = fromNative(message.address, port);
+                QNetworkDatagram datagram(QByteArray((const char *)message.buffer.iov_base, result));
+                datagram.setSender(sender, port);
+                mReceived.push_back(datagram);
+            }
+            if (result != -ECANCELED && mSocket != -1 && !mClosing) postReceive(index);
+        }
+        else if (kind == SEND)
+        {
+            // A datagram that could not be sent is lost like on the wire
+            mSends[index].busy = false;
+            mFreeSends.push_back(index);
+        }
+        else if (kind == WRITE)
+        {
+            FileOp& write = mWrites[index];
+            if (result > 0) write.done += (size_t)result;
+            if (result > 0 && write.done < write.size)
+            {
+                queueWrite(index);
+                continue;
+            }
+
+            if (result <= 0) DependencyManager::Instance().Logger().Error("A file write failed: " + std::string(strerror(-result)));
+            write.busy = false;
+            mWritesBusy--;
+        }
+        else if (kind == READ)
+        {
+            FileOp& read = mReads[index];
+            if (result > 0) read.done += (size_t)result;
+            if (result > 0 && read.done < read.size)
+            {
+                queueRead(index);
+                continue;
+            }
+
+            // The file ended early
+            if (result == 0) mReadEnd = std::min(mReadEnd, read.offset + (qint64)read.done);
+            if (result < 0) mReadFailed = true;
+            read.busy = false;
+            mReadsBusy--;
+        }
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------
+-- FUNCTION:                kgp::UringTransport::waitFor
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNER:                Benny Wang
+--
+-- PROGRAMMER:              Benny Wang
+--
+-- INTERFACE:               void kgp::UringTransport::waitFor(const std::function<bool()>& done)
+--                              done: Tells when to stop waiting, has to turn true once what is in
+--                                    flight completes.
+--
+-- NOTES:
+--                          Submits what is queued and handles completions until done is true.
+--------------------------------------------------------------------------------------------------*/
+void kgp::UringTransport::waitFor(const std::function<bool()>& done)
+{
+    reap();
+    while (!done())
+    {
+        if (mRing.Submit(1) < 0) return;
+        reap();
+    }
+}
+
+#endif
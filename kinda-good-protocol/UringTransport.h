@@ -0,0 +1,154 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             UringTransport.h
+--
+-- PROGRAM:                 KindaGoodProtocol
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          A ReactorTransport that moves its datagrams and file data through one
+--                          io_uring. Receives are kept posted on the ring, sends and file writes are
+--                          copied into buffers of the transport and queued, and everything queued is
+--                          handed to the kernel in one system call on Flush. The reactor waits on an
+--                          eventfd the ring signals when something completes. Only available on
+--                          Linux, IoUring::IsSupported tells if the kernel can run it.
+---------------------------------------------------------------------------------------*/
+#pragma once
+
+#if defined(__linux__)
+
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include <sys/uio.h>
+
+#include "IoUring.h"
+#include "ReactorTransport.h"
+
+namespace kgp
+{
+    class UringTransport : public ReactorTransport
+    {
+        Q_OBJECT
+
+    private:
+        // A datagram being received or sent, along with the message that describes it to the kernel
+        struct Message
+        {
+            msghdr header;
+            iovec buffer;
+            sockaddr_storage address;
+            bool busy;
+        };
+
+        // File data being read or written
+        struct FileOp
+        {
+            int file;
+            qint64 offset;
+            char *data;
+            size_t size;
+            size_t done;
+            bool busy;
+        };
+
+        IoUring mRing;
+        int mEvent;
+        bool mFixed;
+
+        std::vector<char> mReceiveMemory;
+        std::vector<Message> mReceives;
+        std::deque<QNetworkDatagram> mReceived;
+
+        std::vector<char> mSendMemory;
+        std::vector<Message> mSends;
+        std::vector<unsigned> mFreeSends;
+
+        // Writes go through registered buffers. The last one is left open while the writes that
+        // follow it continue where it ends
+        std::vector<char> mWriteMemory;
+        std::vector<FileOp> mWrites;
+        int mOpenWrite;
+        unsigned mWritesBusy;
+
+        // Reads go straight into the buffer of the caller, a registered buffer would only add a copy
+        std::vector<FileOp> mReads;
+        unsigned mReadsBusy;
+        bool mReadFailed;
+        // Where the file being read was found to end
+        qint64 mReadEnd;
+
+        // Set while Close waits for the ring, so that receives are not posted again
+        bool mClosing;
+
+        io_uring_sqe *entry();
+        void postReceive(const unsigned index);
+        void queueWrite(const unsigned index);
+        void queueRead(const unsigned index);
+        void reap();
+        void waitFor(const std::function<bool()>& done);
+
+    protected:
+        bool watch() override;
+
+    public:
+        UringTransport(Reactor& reactor, QObject *parent = nullptr);
+        virtual ~UringTransport();
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::UringTransport::IsValid
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               bool kgp::UringTransport::IsValid()
+        --
+        -- RETURN:                  True if the ring and the eventfd it signals were set up.
+        --------------------------------------------------------------------------------------------------*/
+        inline bool IsValid() const { return mRing.IsValid() && mEvent != -1; }
+
+        void Close() override;
+        qint64 Send(const char *data, const qint64 size, const QHostAddress& address, const short& port) override;
+        qint64 SendProbe(const char *data, const qint64 size, const QHostAddress& address, const short& port) override;
+        qint64 SendGather(const char *header, const qint64 headerSize, const char *data, const qint64 dataSize, const QHostAddress& address, const short& port, const bool probe = false) override;
+        bool HasPendingDatagrams() override;
+        QNetworkDatagram Receive() override;
+        void Flush(const bool wait = false) override;
+        bool ReadFile(QFile& file, QByteArray& data) override;
+        qint64 WriteFile(QFile& file, const qint64 offset, const char *data, const qint64 size) override;
+
+        /*--------------------------------------------------------------------------------------------------
+        -- FUNCTION:                kgp::UringTransport::Syscalls
+        --
+        -- DATE:                    October 19, 2026
+        --
+        -- REVISIONS:               N/A
+        --
+        -- DESIGNER:                Benny Wang
+        --
+        -- PROGRAMMER:              Benny Wang
+        --
+        -- INTERFACE:               quint64 kgp::UringTransport::Syscalls()
+        --
+        -- RETURN:                  The system calls made to move datagrams and file data so far, the
+        --                          times the ring was entered and the eventfd read included.
+        --------------------------------------------------------------------------------------------------*/
+        inline quint64 Syscalls() const override { return mSyscalls + mRing.Syscalls(); }
+    };
+}
+
+#endif
@@ -14,12 +14,76 @@ namespace kgp
         constexpr char ACK = 0x05;
         constexpr char EOT = 0x04;
         constexpr char SYN = 0x15;
+        // Parity of a block of DATA frames, SequenceNumber is the first byte covered, AckNumber is
+        // the end of the block and WindowSize is the number of frames in the block
+        constexpr char FEC = 0x1A;
+        // Hashes of the Merkle tree of a transfer. The receiver sends one without data to ask for
+        // WindowSize nodes starting at node AckNumber of level SequenceNumber, where level 0 are
+        // the chunks. The sender answers with the same header and the hashes followed by their
+        // CRC32C as data
+        constexpr char HASH = 0x1B;
+        // Asks the sender to send the chunk with index SequenceNumber again
+        constexpr char REFETCH = 0x1C;
+        // DataSize bytes of padding the sender sends without letting the path fragment them. The
+        // receiver answers with a PROBE without data whose AckNumber is the DataSize it got
+        constexpr char PROBE = 0x1D;
+        // Sent by the sender while the receive window is closed, the receiver answers with an ACK
+        // of the last frame it delivered that carries its current window
+        constexpr char WINDOW = 0x1E;
+    }
+
+    // Optional features, the SYN carries the ones the sender wants and the SYN-ACK the ones both
+    // sides support
+    namespace Feature
+    {
+        // Parity frames so lost frames can be rebuilt without a resend. The SequenceNumber of an
+        // ACK carries the number of frames the receiver has rebuilt
+        constexpr quint64 FEC = 0x01;
+        // DATA frames may be compressed with zlib. The AckNumber of a compressed DATA frame carries
+        // its uncompressed size, 0 means the frame is stored as is
+        constexpr quint64 COMPRESS = 0x02;
+        // Every packet carries a checksum in its header. Once both sides support it a packet with
+        // a wrong checksum is dropped, before that only packets with a checksum are checked
+        constexpr quint64 CHECKSUM = 0x04;
+        // The EOT carries the root of a Merkle tree over the chunks of the file followed by its
+        // CRC32C, and its SequenceNumber the number of chunks. The receiver hashes chunks as they
+        // arrive and only fetches the chunks that do not match again before it answers with an EOT
+        constexpr quint64 VERIFY = 0x08;
+        // The SYN carries ResumeOptions after its SynOptions and the SYN-ACK answers with the offset
+        // the receiver has already committed for that transfer. The sender starts its window there
+        constexpr quint64 RESUME = 0x10;
+        // The SYN and SYN-ACK carry PathOptions after the ResumeOptions, or after the SynOptions if
+        // resuming is not offered. The sender probes the path for the largest payload up to the
+        // smaller of both and cuts its frames to it
+        constexpr quint64 PMTU = 0x20;
+        // The SYN carries EarlyOptions after the PathOptions, or after whichever options come last,
+        // followed by the first frame of the file. The sender goes on with the rest of the initial
+        // window before the SYN-ACK arrives, which tells it whether the first frame was delivered
+        constexpr quint64 EARLY = 0x40;
+        // The connection stays open after a file so more files can follow without a handshake. Every
+        // file is preceded in the stream of DATA bytes by a StreamHeader and its name, the sequence
+        // numbers go on from the end of the file before. Not negotiated with RESUME or VERIFY, which
+        // keep per transfer state
+        constexpr quint64 SESSION = 0x80;
+        // Only offered in the SYN of a directory. The stream of DATA bytes starts with a BatchHeader
+        // and the manifest of the files, followed by the data of every file in the order of the
+        // manifest without anything between them. Not negotiated with SESSION, RESUME or VERIFY
+        constexpr quint64 BATCH = 0x100;
+        // Files of a session may be sent at the same time, each on a stream with sequence numbers of
+        // its own that go on from the file the stream carried before. The WindowSize of a DATA frame
+        // and the SequenceNumber of an ACK carry the stream, the WindowSize of an ACK is the room the
+        // receiver has for all streams together. Only negotiated with SESSION and not with FEC, whose
+        // ACKs use the SequenceNumber and whose parity covers a single stream
+        constexpr quint64 MULTIPLEX = 0x200;
     }
 
     // Packet header
     struct PacketHeader
     {
         char PacketType;
+        // CRC32C of the header and data with this field set to 0. It sits in what used to be
+        // padding so the header keeps its size, peers that do not checksum leave it 0
+        quint32 Checksum;
         quint64 SequenceNumber;
         quint64 AckNumber;
         quint64 WindowSize;
@@ -30,27 +94,208 @@ namespace kgp
     namespace Size
     {
         constexpr size_t HEADER = sizeof(struct PacketHeader);
+        static_assert(HEADER == 40, "The header has to keep its size on the wire");
         constexpr size_t PACKET = 1500;
+        // Payload of a frame unless a larger or smaller one was discovered
         constexpr size_t DATA = PACKET - HEADER;
         constexpr size_t WINDOW = DATA * 10;
+        // Payload of a datagram every path is assumed to carry whole
+        constexpr size_t MIN_DATA = 1200 - HEADER;
+        // Payload of a datagram that fills a jumbo frame of 9000 bytes after the IP and UDP headers
+        constexpr size_t MAX_DATA = 9000 - 28 - HEADER;
     }
 
-    // Packet
+    // Packet, only the header and DataSize bytes of data go on the wire
     struct Packet
     {
         struct PacketHeader Header;
-        char Data[Size::DATA];
+        char Data[Size::MAX_DATA];
+    };
+
+    // Data of a SYN and its ACK, peers that send no data support no features
+    struct SynOptions
+    {
+        quint64 Features;
+    };
+
+    // Follows SynOptions in a SYN and its ACK when Feature::RESUME is offered. The SYN leaves the
+    // Offset 0, the SYN-ACK echoes the TransferId and Size and fills it in
+    struct ResumeOptions
+    {
+        quint64 TransferId;
+        quint64 Size;
+        quint64 Offset;
+    };
+
+    // Follows the ResumeOptions in a SYN and its ACK when Feature::PMTU is offered. The SYN carries
+    // the largest payload the sender can send, the SYN-ACK the largest both sides can handle
+    struct PathOptions
+    {
+        quint64 MaxPayload;
+    };
+
+    // Follows the last of the other options in a SYN and its ACK when Feature::EARLY is offered. The
+    // SYN carries a nonce that is new for every transfer and the size of the file, leaves Accepted 0
+    // and is followed by the first frame. The SYN-ACK echoes the Nonce and Size and fills in the bytes
+    // of the frame it delivered, 0 if it refused them
+    struct EarlyOptions
+    {
+        quint64 Nonce;
+        quint64 Size;
+        quint64 Accepted;
+    };
+
+    // Starts every file of a session in the stream of DATA bytes, followed by NameSize bytes of the
+    // UTF-8 name of the file and then by Size bytes of its data
+    struct StreamHeader
+    {
+        quint64 Id;
+        quint64 Size;
+        quint64 NameSize;
+    };
+
+    // Starts the stream of a directory, followed by Size bytes of manifest. Every entry of the
+    // manifest is the size of a file and the length of its path as varints and then the UTF-8 path
+    // relative to the directory with / between its parts
+    struct BatchHeader
+    {
+        quint64 Count;
+        quint64 Size;
     };
 
+    // Forward error correction
+    namespace Fec
+    {
+        // Number of frames per group, each group gets between 1 and GROUP / 2 parity frames
+        constexpr quint64 GROUP = 16;
+        // Loss rate assumed before any loss has been observed
+        constexpr double INITIAL_LOSS = 0.01;
+        // Number of frames the initial loss rate counts for
+        constexpr quint64 PRIOR_FRAMES = 20;
+    }
+
+    // Compression of DATA frames
+    namespace Compression
+    {
+        // zlib level, 1 is the fastest
+        constexpr int LEVEL = 1;
+        // A frame is only sent compressed if that saves at least this many bytes
+        constexpr size_t MIN_SAVING = 64;
+        // Most frames that are sent as is without trying after frames that did not compress
+        constexpr quint64 MAX_SKIP = 64;
+    }
+
+    // Verification of whole transfers
+    namespace Verify
+    {
+        // Bytes per chunk, the leaves of the tree
+        constexpr quint64 CHUNK = 64 * 1024;
+        // Size of a hash
+        constexpr size_t HASH = 32;
+        // Number of times a chunk is fetched again before it is given up on
+        constexpr quint64 MAX_REFETCH = 3;
+    }
+
+    // Resuming transfers that were cut off
+    namespace Resume
+    {
+        // Bytes at the start of a file that go into its transfer ID
+        constexpr quint64 ID_BYTES = 64 * 1024;
+        // Bytes delivered between two saves of the checkpoint
+        constexpr quint64 INTERVAL = 1024 * 1024;
+        // Number of transfers the checkpoint remembers
+        constexpr quint64 MAX_TRANSFERS = 16;
+    }
+
+    // Path MTU discovery
+    namespace Pmtu
+    {
+        // Payload that fills an Ethernet frame of 1500 bytes, the first size that is probed
+        constexpr quint64 ETHERNET = 1500 - 28 - Size::HEADER;
+        // The search stops once the largest and smallest payload that may fit are this close
+        constexpr quint64 STEP = 32;
+        // Number of times a probe is sent before its size is taken to be too large
+        constexpr quint64 MAX_PROBES = 2;
+        // Milliseconds to wait for the answer to a probe
+        constexpr quint64 PROBE_TIMEOUT = 1000;
+    }
+
+    // Data in the SYN
+    namespace Early
+    {
+        // Milliseconds a receiver remembers the nonce of a SYN, a SYN that comes again within them
+        // has its data refused
+        constexpr quint64 REPLAY_WINDOW = 10 * 60 * 1000;
+        // Number of nonces a receiver remembers, once they are all recent early data is refused
+        constexpr size_t MAX_NONCES = 4096;
+    }
+
+    // Several files over one connection
+    namespace Session
+    {
+        // Longest name of a file in a session, longer names are cut
+        constexpr quint64 MAX_NAME = 255;
+    }
+
+    // Directories sent as one stream
+    namespace Batch
+    {
+        // Largest manifest a receiver reads, a larger one is taken to be damaged
+        constexpr quint64 MAX_MANIFEST = 64 * 1024 * 1024;
+        // Longest path of a file in a directory
+        constexpr quint64 MAX_PATH = 4096;
+        // Number of threads that read the files of a directory
+        constexpr unsigned READERS = 4;
+        // Files smaller than this are buffered and created together, larger ones are written as
+        // they arrive. The buffered files are created once they hold this many bytes or WRITE_FILES
+        constexpr quint64 WRITE_BYTES = 4 * 1024 * 1024;
+        constexpr quint64 WRITE_FILES = 1024;
+    }
+
+    // Streams of a multiplexed session
+    namespace Multiplex
+    {
+        // Number of streams, stream 0 is the one every session has
+        constexpr quint64 STREAMS = 8;
+        // Priorities of a stream, a stream only sends while no stream of a smaller priority has
+        // frames to send. Streams of the same priority share what is left by their weight
+        constexpr unsigned URGENT = 0;
+        constexpr unsigned NORMAL = 1;
+        constexpr unsigned BULK = 2;
+        constexpr unsigned WEIGHT = 1;
+    }
+
     // Timeouts in milliseconds
     namespace Timeout
     {
         constexpr int IDLE = 10 * 1000;
         constexpr int RCV = 5 * 1000;
+        // How often a source that had nothing to give is asked again
+        constexpr int SOURCE = 5;
+    }
+
+    // Retransmission of DATA frames, the receive timeout is the largest timeout a frame waits
+    namespace Rto
+    {
+        // Smallest timeout in milliseconds, so a round trip that grows a little is not taken for loss
+        constexpr quint64 MIN = 200;
+    }
+
+    // The log kept in memory for the GUI and its live chart
+    namespace Events
+    {
+        // Events kept, older ones are overwritten
+        constexpr size_t CAPACITY = 20000;
+        // Milliseconds between the times the GUI takes new events and a sample for the chart
+        constexpr int REFRESH = 100;
+        // Samples the chart shows, a minute at REFRESH
+        constexpr int SAMPLES = 600;
     }
 
     // Logging
-    constexpr char *LOG_FILE = "kgp.log";
+    constexpr const char *LOG_FILE = "kgp.log";
+    // Committed byte ranges of unfinished transfers
+    constexpr const char *CHECKPOINT_FILE = "kgp.checkpoint";
 
     // Program state
     struct State
@@ -61,6 +306,37 @@ namespace kgp
 
         // Size of local receive window
         quint64 rcvWindowSize;
+        // Bytes handed to dataRead that the listener has not released yet, and the room the last
+        // ACK left past the last byte delivered
+        quint64 rcvHeld;
+        quint64 rcvAdvertised;
+
+        // Features offered in the SYN of this side and the ones negotiated for this connection
+        quint64 offered;
+        quint64 features;
+        // Frames sent and the number of times pending frames were resent on this connection
+        quint64 framesSent;
+        quint64 resends;
+        // Number of frames the receiver has rebuilt from parity
+        quint64 fecRecovered;
+        // Transfer being resumed, the byte it was resumed at and the end of what has been saved in
+        // the checkpoint. All 0 unless resuming was negotiated
+        quint64 transferId;
+        quint64 transferSize;
+        quint64 offset;
+        quint64 checkpointed;
+        // Largest payload both sides can handle, 0 unless path MTU discovery was negotiated
+        quint64 maxPayload;
+        // Nonce of the SYN and the bytes of the first frame it carried, on the receiver the bytes of
+        // it that were delivered. All 0 unless data was sent in the SYN
+        quint64 earlyNonce;
+        quint64 earlyData;
+        // Sequence number the next file of a session starts at and the ID it gets, both 0 unless a
+        // session was negotiated
+        quint64 streamBase;
+        quint64 streamId;
+        // Room the receiver of a multiplexed session last advertised for all streams together
+        quint64 streamRoom;
 
         // Waiting for SYN
         bool idle;
@@ -70,6 +346,14 @@ namespace kgp
         bool wait;
         // Waiting for ACK for Data or timeout
         bool dataSent;
+        // EOT sent, waiting for the receiver to verify the transfer
+        bool waitVerify;
+        // EOT received, fetching the chunks that did not verify
+        bool verifying;
+        // Session kept open after a file, waiting for the next file or the receive timeout
+        bool open;
+        // Everything was delivered, the transfer ends in success rather than being dropped
+        bool complete;
         // Has receive timeout been reached
         bool timeoutRcv;
         // Has idle timeout been reached
@@ -0,0 +1,252 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             AsyncEngineTest.cpp
+--
+-- PROGRAM:                 kgp_tests
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Unit tests for the coroutines that send and receive over engines run by
+--                          I/O threads. These use real sockets on the loopback address and only run
+--                          on Linux with a compiler that supports C++20 coroutines.
+---------------------------------------------------------------------------------------*/
+#include <gtest/gtest.h>
+
+#if defined(__linux__) && defined(__cpp_impl_coroutine)
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <QByteArray>
+#include <QFile>
+
+#include "IoThread.h"
+#include "res.h"
+#include "AsyncEngine.h"
+#include "Task.h"
+
+namespace
+{
+    // Ports of the engines, away from the protocol port and the ports of the other tests
+    const short SENDER_PORT = 18001;
+    const short RECEIVER_PORTS = 18011;
+    const short SENDER_PORTS = 18021;
+    // Time after which a transfer is taken to be lost
+    const auto TIME_LIMIT = std::chrono::seconds(10);
+    // Features of the engines, the defaults without resuming so a checkpoint cannot shorten a transfer
+    const quint64 FEATURES = kgp::Feature::CHECKSUM | kgp::Feature::PMTU;
+
+    // Writes a file of bytes that differ from one offset to the next, seeded so files differ
+    QByteArray writeFile(const std::string& name, const int size, const int seed)
+    {
+        QByteArray data;
+        for (int i = 0; i < size; i++) data.append((char)((i + seed) % 251));
+        QFile file(name.c_str());
+        file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+        file.write(data);
+        file.close();
+        return data;
+    }
+
+    kgp::Task<kgp::TransferResult> send(kgp::AsyncEngine& async, const std::string& filename, const short port)
+    {
+        co_return co_await async.Send(filename, "127.0.0.1", port);
+    }
+
+    kgp::Task<kgp::TransferResult> receive(kgp::AsyncEngine& async, QByteArray& received)
+    {
+        co_return co_await async.Receive([&received](const char *data, const size_t size) { received.append(data, (int)size); });
+    }
+
+    // Sends the files one after the other, each once the one before has arrived
+    kgp::Task<std::vector<kgp::TransferResult>> sendAll(kgp::AsyncEngine& async, const std::vector<std::string> filenames, const short port)
+    {
+        std::vector<kgp::TransferResult> results;
+        for (const std::string& filename : filenames) results.push_back(co_await async.Send(filename, "127.0.0.1", port));
+        co_return results;
+    }
+
+    // Receives count transfers into one buffer each
+    kgp::Task<std::vector<kgp::TransferResult>> receiveAll(kgp::AsyncEngine& async, std::vector<QByteArray>& received, const size_t count)
+    {
+        std::vector<kgp::TransferResult> results;
+        for (size_t i = 0; i < count; i++)
+        {
+            received.emplace_back();
+            QByteArray& into = received.back();
+            results.push_back(co_await async.Receive([&into](const char *data, const size_t size) { into.append(data, (int)size); }));
+        }
+        co_return results;
+    }
+
+    // Starts a task and hands back a future of its value
+    template<typename T>
+    std::future<T> start(kgp::Task<T>&& task)
+    {
+        std::shared_ptr<std::promise<T>> promise = std::make_shared<std::promise<T>>();
+        std::future<T> future = promise->get_future();
+        std::move(task).Start([promise](T value) { promise->set_value(std::move(value)); });
+        return future;
+    }
+}
+
+TEST(AsyncEngine, SendsAndReceivesFile)
+{
+    const QByteArray data = writeFile("async_one.bin", 300 * 1000, 0);
+
+    kgp::IoThread receiver(kgp::PORT);
+    kgp::IoThread sender(SENDER_PORT);
+    receiver.Engine().SetFeatures(FEATURES);
+    sender.Engine().SetFeatures(FEATURES);
+    kgp::AsyncEngine receiving(receiver);
+    kgp::AsyncEngine sending(sender);
+    receiver.Start();
+    sender.Start();
+
+    QByteArray received;
+    std::future<kgp::TransferResult> receiveDone = start(receive(receiving, received));
+    std::future<kgp::TransferResult> sendDone = start(send(sending, "async_one.bin", kgp::PORT));
+
+    ASSERT_EQ(sendDone.wait_for(TIME_LIMIT), std::future_status::ready);
+    ASSERT_EQ(receiveDone.wait_for(TIME_LIMIT), std::future_status::ready);
+    const kgp::TransferResult sendResult = sendDone.get();
+    const kgp::TransferResult receiveResult = receiveDone.get();
+
+    EXPECT_EQ(sendResult.error, kgp::TransferError::NONE);
+    EXPECT_GE(sendResult.bytes, (quint64)data.size());
+    EXPECT_EQ(receiveResult.error, kgp::TransferError::NONE);
+    EXPECT_EQ(receiveResult.bytes, (quint64)data.size());
+    EXPECT_EQ(received, data);
+
+    sender.Stop();
+    receiver.Stop();
+}
+
+TEST(AsyncEngine, AwaitsTransfersInOrder)
+{
+    const std::vector<std::string> filenames = { "async_first.bin", "async_second.bin", "async_third.bin" };
+    std::vector<QByteArray> data;
+    for (size_t i = 0; i < filenames.size(); i++) data.push_back(writeFile(filenames[i], 50 * 1000 * (int)(i + 1), (int)i));
+
+    kgp::IoThread receiver(kgp::PORT);
+    kgp::IoThread sender(SENDER_PORT);
+    receiver.Engine().SetFeatures(FEATURES);
+    sender.Engine().SetFeatures(FEATURES);
+    kgp::AsyncEngine receiving(receiver);
+    kgp::AsyncEngine sending(sender);
+    receiver.Start();
+    sender.Start();
+
+    std::vector<QByteArray> received;
+    std::future<std::vector<kgp::TransferResult>> receivedAll = start(receiveAll(receiving, received, filenames.size()));
+    std::future<std::vector<kgp::TransferResult>> sentAll = start(sendAll(sending, filenames, kgp::PORT));
+
+    ASSERT_EQ(sentAll.wait_for(TIME_LIMIT), std::future_status::ready);
+    ASSERT_EQ(receivedAll.wait_for(TIME_LIMIT), std::future_status::ready);
+    for (const kgp::TransferResult& result : sentAll.get()) EXPECT_EQ(result.error, kgp::TransferError::NONE);
+    for (const kgp::TransferResult& result : receivedAll.get()) EXPECT_EQ(result.error, kgp::TransferError::NONE);
+    EXPECT_EQ(received, data);
+
+    sender.Stop();
+    receiver.Stop();
+}
+
+TEST(AsyncEngine, RunsManyTransfersOnOneThread)
+{
+    const int count = 4;
+
+    // Every engine of a thread is on a port of its own
+    kgp::IoThread receiver(RECEIVER_PORTS);
+    kgp::IoThread sender(SENDER_PORTS);
+    for (int i = 1; i < count; i++)
+    {
+        receiver.AddEngine(RECEIVER_PORTS + i);
+        sender.AddEngine(SENDER_PORTS + i);
+    }
+    ASSERT_EQ(receiver.Engines(), (size_t)count);
+
+    std::vector<std::unique_ptr<kgp::AsyncEngine>> asyncs;
+    std::vector<QByteArray> data(count);
+    std::vector<QByteArray> received(count);
+    std::vector<std::future<kgp::TransferResult>> results;
+    for (int i = 0; i < count; i++)
+    {
+        const std::string filename = "async_many_" + std::to_string(i) + ".bin";
+        data[i] = writeFile(filename, 100 * 1000, i);
+        receiver.Engine(i).SetFeatures(FEATURES);
+        sender.Engine(i).SetFeatures(FEATURES);
+        asyncs.emplace_back(new kgp::AsyncEngine(receiver, i));
+        results.push_back(start(receive(*asyncs.back(), received[i])));
+        asyncs.emplace_back(new kgp::AsyncEngine(sender, i));
+        results.push_back(start(send(*asyncs.back(), filename, RECEIVER_PORTS + i)));
+    }
+    receiver.Start();
+    sender.Start();
+
+    for (std::future<kgp::TransferResult>& result : results)
+    {
+        ASSERT_EQ(result.wait_for(TIME_LIMIT), std::future_status::ready);
+        EXPECT_EQ(result.get().error, kgp::TransferError::NONE);
+    }
+    EXPECT_EQ(received, data);
+
+    sender.Stop();
+    receiver.Stop();
+}
+
+TEST(AsyncEngine, CancelsPendingReceive)
+{
+    kgp::IoThread receiver(kgp::PORT);
+    kgp::AsyncEngine receiving(receiver);
+    receiver.Start();
+
+    QByteArray received;
+    std::future<kgp::TransferResult> result = start(receive(receiving, received));
+    receiving.Cancel();
+
+    ASSERT_EQ(result.wait_for(TIME_LIMIT), std::future_status::ready);
+    const kgp::TransferResult cancelled = result.get();
+    EXPECT_EQ(cancelled.error, kgp::TransferError::CANCELLED);
+    EXPECT_EQ(cancelled.bytes, 0u);
+    EXPECT_TRUE(receiver.Engine().IsIdle());
+
+    receiver.Stop();
+}
+
+TEST(AsyncEngine, RefusesSecondOperationWhileBusy)
+{
+    kgp::IoThread thread(SENDER_PORT);
+    kgp::AsyncEngine async(thread);
+    thread.Start();
+
+    // The receive is awaited first and is still pending when the send is
+    QByteArray received;
+    std::future<kgp::TransferResult> pending = start(receive(async, received));
+    std::future<kgp::TransferResult> busy = start(send(async, "async_one.bin", kgp::PORT));
+    ASSERT_EQ(busy.wait_for(TIME_LIMIT), std::future_status::ready);
+    EXPECT_EQ(busy.get().error, kgp::TransferError::BUSY);
+
+    async.Cancel();
+    ASSERT_EQ(pending.wait_for(TIME_LIMIT), std::future_status::ready);
+    EXPECT_EQ(pending.get().error, kgp::TransferError::CANCELLED);
+
+    // A file that cannot be read never starts
+    std::future<kgp::TransferResult> failed = start(send(async, "async_missing.bin", kgp::PORT));
+    ASSERT_EQ(failed.wait_for(TIME_LIMIT), std::future_status::ready);
+    EXPECT_EQ(failed.get().error, kgp::TransferError::START_FAILED);
+
+    thread.Stop();
+}
+
+#endif
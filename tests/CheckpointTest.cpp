@@ -0,0 +1,100 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             CheckpointTest.cpp
+--
+-- PROGRAM:                 kgp_tests
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Unit tests for the checkpoint of resumable transfers.
+---------------------------------------------------------------------------------------*/
+#include <gtest/gtest.h>
+
+#include <QByteArray>
+#include <QFile>
+
+#include "Checkpoint.h"
+
+namespace
+{
+    const char *CHECKPOINT = "checkpoint_test.checkpoint";
+
+    kgp::Checkpoint emptyCheckpoint()
+    {
+        QFile::remove(CHECKPOINT);
+        kgp::Checkpoint checkpoint(CHECKPOINT);
+        checkpoint.Load();
+        return checkpoint;
+    }
+}
+
+TEST(Checkpoint, OffsetIsTheCommittedPrefix)
+{
+    kgp::Checkpoint checkpoint = emptyCheckpoint();
+
+    checkpoint.Commit(7, 1000, 200, 300);
+    EXPECT_EQ(checkpoint.Offset(7, 1000), 0u);
+
+    checkpoint.Commit(7, 1000, 0, 100);
+    checkpoint.Commit(7, 1000, 100, 200);
+    EXPECT_EQ(checkpoint.Offset(7, 1000), 300u);
+
+    // A file of another size is another transfer
+    EXPECT_EQ(checkpoint.Offset(7, 999), 0u);
+    EXPECT_EQ(checkpoint.Offset(8, 1000), 0u);
+}
+
+TEST(Checkpoint, SurvivesReload)
+{
+    kgp::Checkpoint checkpoint = emptyCheckpoint();
+    checkpoint.Commit(1, 5000, 0, 4096);
+    checkpoint.Commit(2, 300, 0, 10);
+    ASSERT_TRUE(checkpoint.Save());
+
+    kgp::Checkpoint loaded(CHECKPOINT);
+    ASSERT_TRUE(loaded.Load());
+    EXPECT_EQ(loaded.Offset(1, 5000), 4096u);
+    EXPECT_EQ(loaded.Offset(2, 300), 10u);
+
+    loaded.Remove(1);
+    ASSERT_TRUE(loaded.Save());
+    ASSERT_TRUE(checkpoint.Load());
+    EXPECT_EQ(checkpoint.Offset(1, 5000), 0u);
+    EXPECT_EQ(checkpoint.Offset(2, 300), 10u);
+}
+
+TEST(Checkpoint, SkipsDamagedLines)
+{
+    QFile file(CHECKPOINT);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write(QByteArray("3 100 0 50\ngarbage\n4 100 0\n5 100 0 60\n"));
+    file.close();
+
+    kgp::Checkpoint checkpoint(CHECKPOINT);
+    ASSERT_TRUE(checkpoint.Load());
+    EXPECT_EQ(checkpoint.Offset(3, 100), 50u);
+    EXPECT_EQ(checkpoint.Offset(4, 100), 0u);
+    EXPECT_EQ(checkpoint.Offset(5, 100), 60u);
+}
+
+TEST(Checkpoint, ForgetsLeastRecentlyUsed)
+{
+    kgp::Checkpoint checkpoint = emptyCheckpoint();
+    for (quint64 id = 1; id <= kgp::Resume::MAX_TRANSFERS; id++) checkpoint.Commit(id, 100, 0, id);
+
+    // Looking a transfer up counts as using it
+    EXPECT_EQ(checkpoint.Offset(1, 100), 1u);
+    checkpoint.Commit(kgp::Resume::MAX_TRANSFERS + 1, 100, 0, 50);
+
+    EXPECT_EQ(checkpoint.Offset(1, 100), 1u);
+    EXPECT_EQ(checkpoint.Offset(2, 100), 0u);
+    EXPECT_EQ(checkpoint.Offset(kgp::Resume::MAX_TRANSFERS + 1, 100), 50u);
+}
@@ -0,0 +1,107 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             CompressionTest.cpp
+--
+-- PROGRAM:                 kgp_tests
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Unit tests for the compression of DATA frames.
+---------------------------------------------------------------------------------------*/
+#include <gtest/gtest.h>
+
+#include <QByteArray>
+
+#include "Compression.h"
+
+namespace
+{
+    QByteArray text(const int size)
+    {
+        const QByteArray line("2026-10-19 12:00:00,INFO,kgp,frame sent\n");
+        QByteArray data;
+        while (data.size() < size) data.append(line);
+        data.truncate(size);
+        return data;
+    }
+
+    // xorshift so the data does not compress
+    QByteArray noise(const int size, quint32 state)
+    {
+        QByteArray data;
+        for (int i = 0; i < size; i++)
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            data.append((char)state);
+        }
+        return data;
+    }
+
+    kgp::SlidingWindow::Frame frameOf(QByteArray& data)
+    {
+        kgp::SlidingWindow::Frame frame;
+        frame.seqNum = 0;
+        frame.size = data.size();
+        frame.data = data.data();
+        return frame;
+    }
+}
+
+TEST(Compression, TextRoundTrips)
+{
+    QByteArray data = text(kgp::Size::DATA);
+    kgp::Compressor compressor;
+
+    QByteArray compressed;
+    ASSERT_TRUE(compressor.Compress(frameOf(data), compressed));
+    EXPECT_LT((size_t)compressed.size(), kgp::Size::DATA / 2);
+
+    QByteArray uncompressed;
+    ASSERT_TRUE(kgp::Compressor::Decompress(compressed.constData(), compressed.size(), data.size(), uncompressed));
+    EXPECT_EQ(uncompressed, data);
+}
+
+TEST(Compression, IncompressibleFramesBackOff)
+{
+    kgp::Compressor compressor;
+    QByteArray compressed;
+
+    // The first frame is tried and skips one frame, the next one tried skips two
+    QByteArray data = noise(kgp::Size::DATA, 1);
+    EXPECT_FALSE(compressor.Compress(frameOf(data), compressed));
+    EXPECT_FALSE(compressor.Compress(frameOf(data), compressed));
+    EXPECT_FALSE(compressor.Compress(frameOf(data), compressed));
+
+    // Text that follows is sent as is until the skipped frames are used up
+    QByteArray lines = text(kgp::Size::DATA);
+    EXPECT_FALSE(compressor.Compress(frameOf(lines), compressed));
+    EXPECT_FALSE(compressor.Compress(frameOf(lines), compressed));
+    EXPECT_TRUE(compressor.Compress(frameOf(lines), compressed));
+
+    compressor.Reset();
+    EXPECT_TRUE(compressor.Compress(frameOf(lines), compressed));
+}
+
+TEST(Compression, RejectsWrongSize)
+{
+    QByteArray data = text(1000);
+    kgp::Compressor compressor;
+    QByteArray compressed;
+    ASSERT_TRUE(compressor.Compress(frameOf(data), compressed));
+
+    QByteArray uncompressed;
+    EXPECT_FALSE(kgp::Compressor::Decompress(compressed.constData(), compressed.size(), 999, uncompressed));
+    EXPECT_FALSE(kgp::Compressor::Decompress(compressed.constData(), compressed.size(), kgp::Size::DATA + 1, uncompressed));
+    EXPECT_FALSE(kgp::Compressor::Decompress(compressed.constData(), 2, 1000, uncompressed));
+    EXPECT_FALSE(kgp::Compressor::Decompress(compressed.constData(), compressed.size() / 2, 1000, uncompressed));
+}
@@ -0,0 +1,88 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             Crc32cTest.cpp
+--
+-- PROGRAM:                 kgp_tests
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Unit tests for the CRC32C checksums.
+---------------------------------------------------------------------------------------*/
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include <QByteArray>
+
+#include "Crc32c.h"
+
+TEST(Crc32c, KnownValue)
+{
+    EXPECT_EQ(kgp::Crc32c::Compute("123456789", 9), 0xE3069283u);
+    EXPECT_EQ(kgp::Crc32c::ComputeTable("123456789", 9), 0xE3069283u);
+    EXPECT_EQ(kgp::Crc32c::Compute("", 0), 0u);
+}
+
+TEST(Crc32c, AcceleratedMatchesTable)
+{
+    QByteArray data;
+    for (int i = 0; i < 10000; i++) data.append((char)(i * 31 + i / 7));
+
+    // Every alignment and every tail length, up to past a jumbo payload so every block size is used
+    for (int offset = 0; offset < 8; offset++)
+    {
+        for (int size = 0; size < 9100; size += 13)
+        {
+            const char *bytes = data.constData() + offset;
+            const quint32 whole = kgp::Crc32c::Compute(bytes, size);
+            EXPECT_EQ(whole, kgp::Crc32c::ComputeTable(bytes, size));
+            EXPECT_EQ(whole, kgp::Crc32c::Compute(bytes + size / 3, size - size / 3, kgp::Crc32c::Compute(bytes, size / 3)));
+        }
+    }
+}
+
+TEST(Crc32c, PacketChecksumSkipsItself)
+{
+    kgp::Packet packet;
+    memset(&packet, 0, sizeof(packet));
+    packet.Header.PacketType = kgp::PacketType::DATA;
+    packet.Header.SequenceNumber = 1460;
+    packet.Header.DataSize = 100;
+    memset(packet.Data, 'k', 100);
+
+    const quint32 checksum = kgp::Crc32c::ComputePacket(packet);
+    packet.Header.Checksum = checksum;
+    EXPECT_EQ(kgp::Crc32c::ComputePacket(packet), checksum);
+
+    // Only the bytes that are sent count
+    packet.Data[100] = 'x';
+    EXPECT_EQ(kgp::Crc32c::ComputePacket(packet), checksum);
+
+    packet.Data[99] = 'x';
+    EXPECT_NE(kgp::Crc32c::ComputePacket(packet), checksum);
+}
+
+TEST(Crc32c, HeaderAndDataApartMatchPacket)
+{
+    kgp::Packet packet;
+    memset(&packet, 0, sizeof(packet));
+    packet.Header.PacketType = kgp::PacketType::DATA;
+    packet.Header.SequenceNumber = 2920;
+    packet.Header.WindowSize = kgp::Size::WINDOW;
+    packet.Header.DataSize = 1000;
+    for (int i = 0; i < 1000; i++) packet.Data[i] = (char)(i * 7);
+
+    // The data of a frame is sent from wherever it is kept, not from behind its header
+    const QByteArray data(packet.Data, 1000);
+    kgp::PacketHeader header = packet.Header;
+    header.Checksum = 0xFFFFFFFF;
+    EXPECT_EQ(kgp::Crc32c::ComputePacket(header, data.constData()), kgp::Crc32c::ComputePacket(packet));
+}
@@ -0,0 +1,173 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             DirectoryBatchTest.cpp
+--
+-- PROGRAM:                 kgp_tests
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Unit tests for packing a directory into one stream and writing it back.
+---------------------------------------------------------------------------------------*/
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <QByteArray>
+#include <QDir>
+#include <QFile>
+#include <QString>
+
+#include "DirectoryBatch.h"
+#include "StreamFramer.h"
+#include "res.h"
+
+namespace
+{
+    const char *SOURCE = "directory_batch_source";
+    const char *TARGET = "directory_batch_target";
+
+    QByteArray writeFile(const QString& path, const int size)
+    {
+        QByteArray data;
+        for (int i = 0; i < size; i++) data.append((char)((i * 7 + path.size()) % 251));
+        const int slash = path.lastIndexOf('/');
+        if (slash > 0) QDir().mkpath(path.left(slash));
+        QFile file(path);
+        file.open(QIODevice::WriteOnly);
+        file.write(data);
+        file.close();
+        return data;
+    }
+
+    QByteArray readFile(const QString& path)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) return QByteArray();
+        return file.readAll();
+    }
+
+    // Splits the stream in frames of the given size and writes the files below the target
+    quint64 unpack(const QByteArray& stream, const int piece)
+    {
+        kgp::DirectoryWriter writer(TARGET);
+        kgp::StreamFramer framer;
+        framer.Reset(kgp::StreamFramer::Layout::MANIFEST);
+        for (int at = 0; at < stream.size(); at += piece)
+        {
+            std::vector<kgp::StreamFramer::Event> events;
+            EXPECT_TRUE(framer.Add(stream.constData() + at, std::min(piece, stream.size() - at), events));
+            for (const auto& event : events)
+            {
+                switch (event.type)
+                {
+                case kgp::StreamFramer::EventType::START:
+                    EXPECT_TRUE(writer.StartFile(event.name, event.size));
+                    break;
+                case kgp::StreamFramer::EventType::DATA:
+                    EXPECT_TRUE(writer.Write(event.data, event.size));
+                    break;
+                case kgp::StreamFramer::EventType::END:
+                    EXPECT_TRUE(writer.FinishFile());
+                    break;
+                }
+            }
+        }
+        EXPECT_TRUE(writer.Flush());
+        EXPECT_FALSE(writer.Failed());
+        return writer.Written();
+    }
+}
+
+TEST(DirectoryBatch, PacksATreeAndWritesItBack)
+{
+    QDir(SOURCE).removeRecursively();
+    QDir(TARGET).removeRecursively();
+
+    const std::vector<std::pair<QString, int>> files = {
+        { "a.txt", 100 },
+        { "sub/b.bin", 5000 },
+        { "sub/deep/c", 0 },
+        { ".hidden", 10 },
+        // Written as it arrives instead of being kept
+        { "big/large.bin", (int)kgp::Batch::WRITE_BYTES + 100 },
+    };
+    std::vector<QByteArray> contents;
+    for (const auto& file : files) contents.push_back(writeFile(QString(SOURCE) + "/" + file.first, file.second));
+
+    QByteArray stream;
+    std::vector<kgp::StreamFramer::FileEntry> entries;
+    ASSERT_TRUE(kgp::DirectoryReader::Pack(SOURCE, stream, entries));
+    ASSERT_EQ(entries.size(), files.size());
+
+    // The manifest is in the order of the paths and the data follows in the same order
+    quint64 total = 0;
+    for (size_t i = 1; i < entries.size(); i++) EXPECT_TRUE(entries[i - 1].name < entries[i].name);
+    for (const auto& entry : entries) total += entry.size;
+    EXPECT_EQ((quint64)stream.size(), kgp::StreamFramer::Manifest(entries).size() + total);
+
+    EXPECT_EQ(unpack(stream, (int)kgp::Size::DATA), files.size());
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        EXPECT_EQ(readFile(QString(TARGET) + "/" + files[i].first), contents[i]) << files[i].first.toStdString();
+    }
+}
+
+TEST(DirectoryBatch, SmallFilesAreCreatedTogether)
+{
+    QDir(TARGET).removeRecursively();
+
+    kgp::DirectoryWriter writer(TARGET);
+    ASSERT_TRUE(writer.StartFile("one/small.txt", 5));
+    ASSERT_TRUE(writer.Write("hello", 5));
+    ASSERT_TRUE(writer.FinishFile());
+    ASSERT_TRUE(writer.StartFile("two/small.txt", 3));
+    ASSERT_TRUE(writer.Write("abc", 3));
+
+    // Nothing is created until enough is kept or the writer is flushed, a file that has not ended
+    // stays kept
+    EXPECT_FALSE(QFile::exists(QString(TARGET) + "/one/small.txt"));
+    ASSERT_TRUE(writer.Flush());
+    EXPECT_EQ(readFile(QString(TARGET) + "/one/small.txt"), QByteArray("hello"));
+    EXPECT_FALSE(QFile::exists(QString(TARGET) + "/two/small.txt"));
+    EXPECT_EQ(writer.Written(), 1u);
+
+    ASSERT_TRUE(writer.FinishFile());
+    ASSERT_TRUE(writer.Flush());
+    EXPECT_EQ(readFile(QString(TARGET) + "/two/small.txt"), QByteArray("abc"));
+    EXPECT_EQ(writer.Written(), 2u);
+}
+
+TEST(DirectoryBatch, UnsafePathsAreRefused)
+{
+    for (const char *path : { "", "/etc/passwd", "../escape", "a/../../escape", "a//b", "a/./b", "a/", "C:/x", "a\\b" })
+    {
+        EXPECT_FALSE(kgp::DirectoryWriter::IsSafePath(path)) << path;
+    }
+    for (const char *path : { "a", ".hidden", "a/b/c.txt", "a..b" })
+    {
+        EXPECT_TRUE(kgp::DirectoryWriter::IsSafePath(path)) << path;
+    }
+
+    QDir(TARGET).removeRecursively();
+    kgp::DirectoryWriter writer(TARGET);
+    EXPECT_FALSE(writer.StartFile("../escape", 3));
+    EXPECT_FALSE(writer.Write("abc", 3));
+    EXPECT_TRUE(writer.Failed());
+    EXPECT_FALSE(QFile::exists("escape"));
+}
+
+TEST(DirectoryBatch, MissingDirectoryIsRefused)
+{
+    QByteArray stream;
+    std::vector<kgp::StreamFramer::FileEntry> entries;
+    EXPECT_FALSE(kgp::DirectoryReader::Pack("directory_batch_missing", stream, entries));
+}
@@ -0,0 +1,222 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             EmulatedLinkTest.cpp
+--
+-- PROGRAM:                 kgp_tests
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Tests for the emulated link and for complete transfers between two
+--                          engines running over it in the same process.
+---------------------------------------------------------------------------------------*/
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+#include <vector>
+
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHostAddress>
+
+#include "EmulatedLink.h"
+#include "IoEngine.h"
+
+namespace
+{
+    const QHostAddress HOST_A(QString("10.0.0.1"));
+    const QHostAddress HOST_B(QString("10.0.0.2"));
+
+    kgp::EmulatedLink::Config idealLink()
+    {
+        kgp::EmulatedLink::Config config;
+        memset(&config, 0, sizeof(config));
+        config.seed = 1;
+        return config;
+    }
+
+    // Sends count numbered datagrams from A to B and returns the numbers B received, in order
+    std::vector<int> sendNumbered(const kgp::EmulatedLink::Config& config, const int count, const int timeout = 2000)
+    {
+        kgp::EmulatedLink link(config);
+        kgp::EmulatedTransport *a = link.CreateEndpoint(HOST_A);
+        kgp::EmulatedTransport *b = link.CreateEndpoint(HOST_B);
+        a->Bind(QHostAddress::Any, kgp::PORT);
+        b->Bind(QHostAddress::Any, kgp::PORT);
+
+        for (int i = 0; i < count; i++) a->Send((const char *)&i, sizeof(i), HOST_B, kgp::PORT);
+
+        QElapsedTimer timer;
+        timer.start();
+        while (link.InFlightCount() > 0 && timer.elapsed() < timeout) link.Poll();
+
+        std::vector<int> received;
+        while (b->HasPendingDatagrams())
+        {
+            int value;
+            memcpy(&value, b->Receive().data().data(), sizeof(value));
+            received.push_back(value);
+        }
+        return received;
+    }
+}
+
+TEST(EmulatedLink, IdealLinkDeliversInOrder)
+{
+    std::vector<int> received = sendNumbered(idealLink(), 100);
+    ASSERT_EQ(received.size(), 100u);
+    for (int i = 0; i < 100; i++) EXPECT_EQ(received[i], i);
+}
+
+TEST(EmulatedLink, LossIsReproducible)
+{
+    kgp::EmulatedLink::Config config = idealLink();
+    config.seed = 42;
+    config.lossRate = 0.3;
+
+    std::vector<int> first = sendNumbered(config, 1000);
+    std::vector<int> second = sendNumbered(config, 1000);
+    EXPECT_EQ(first, second);
+    EXPECT_GT(first.size(), 600u);
+    EXPECT_LT(first.size(), 800u);
+
+    config.seed = 43;
+    EXPECT_NE(sendNumbered(config, 1000), first);
+}
+
+TEST(EmulatedLink, DuplicatesEveryDatagram)
+{
+    kgp::EmulatedLink::Config config = idealLink();
+    config.duplicateRate = 1.0;
+
+    std::vector<int> received = sendNumbered(config, 10);
+    ASSERT_EQ(received.size(), 20u);
+    for (int i = 0; i < 10; i++)
+    {
+        EXPECT_EQ(received[i * 2], i);
+        EXPECT_EQ(received[i * 2 + 1], i);
+    }
+}
+
+TEST(EmulatedLink, CorruptionFlipsOneBit)
+{
+    kgp::EmulatedLink::Config config = idealLink();
+    config.corruptRate = 1.0;
+
+    std::vector<int> received = sendNumbered(config, 100);
+    ASSERT_EQ(received.size(), 100u);
+    for (int i = 0; i < 100; i++) EXPECT_EQ(std::bitset<32>(received[i] ^ i).count(), 1u);
+}
+
+TEST(EmulatedLink, ReorderedDatagramsAreOvertaken)
+{
+    kgp::EmulatedLink::Config config = idealLink();
+    config.reorderRate = 0.5;
+    config.reorderDelay = 20;
+
+    std::vector<int> received = sendNumbered(config, 100);
+    ASSERT_EQ(received.size(), 100u);
+    EXPECT_FALSE(std::is_sorted(received.begin(), received.end()));
+}
+
+TEST(EmulatedLink, DelayAndBandwidthHoldDatagrams)
+{
+    kgp::EmulatedLink::Config config = idealLink();
+    config.delay = 20;
+    // 10 datagrams of 1000 bytes take 100ms to serialize
+    config.bandwidth = 100 * 1000;
+
+    kgp::EmulatedLink link(config);
+    kgp::EmulatedTransport *a = link.CreateEndpoint(HOST_A);
+    kgp::EmulatedTransport *b = link.CreateEndpoint(HOST_B);
+    a->Bind(QHostAddress::Any, kgp::PORT);
+    b->Bind(QHostAddress::Any, kgp::PORT);
+
+    QElapsedTimer timer;
+    timer.start();
+    const QByteArray payload(1000, 'k');
+    for (int i = 0; i < 10; i++) a->Send(payload.data(), payload.size(), HOST_B, kgp::PORT);
+
+    link.Poll();
+    EXPECT_FALSE(b->HasPendingDatagrams());
+
+    while (link.InFlightCount() > 0 && timer.elapsed() < 2000) link.Poll();
+    EXPECT_GE(timer.elapsed(), 115);
+    EXPECT_EQ(link.GetStats().delivered, 10u);
+}
+
+TEST(EmulatedLink, LargeDatagramsAreFragmented)
+{
+    kgp::EmulatedLink::Config config = idealLink();
+    config.mtu = 1500;
+
+    kgp::EmulatedLink link(config);
+    kgp::EmulatedTransport *a = link.CreateEndpoint(HOST_A);
+    kgp::EmulatedTransport *b = link.CreateEndpoint(HOST_B);
+    a->Bind(QHostAddress::Any, kgp::PORT);
+    b->Bind(QHostAddress::Any, kgp::PORT);
+
+    const QByteArray fits(1500 - kgp::Link::IP_UDP, 'k');
+    const QByteArray large(fits.size() + 1, 'k');
+    a->Send(fits.data(), fits.size(), HOST_B, kgp::PORT);
+    a->Send(large.data(), large.size(), HOST_B, kgp::PORT);
+    a->SendProbe(fits.data(), fits.size(), HOST_B, kgp::PORT);
+    // A probe is dropped rather than fragmented
+    a->SendProbe(large.data(), large.size(), HOST_B, kgp::PORT);
+
+    // A path that filters fragments drops every large datagram
+    config.dropFragments = true;
+    kgp::EmulatedLink filtered(config);
+    kgp::EmulatedTransport *c = filtered.CreateEndpoint(HOST_A);
+    filtered.CreateEndpoint(HOST_B)->Bind(QHostAddress::Any, kgp::PORT);
+    c->Send(large.data(), large.size(), HOST_B, kgp::PORT);
+
+    link.Poll();
+    filtered.Poll();
+    EXPECT_EQ(link.GetStats().delivered, 3u);
+    EXPECT_EQ(link.GetStats().fragmented, 1u);
+    EXPECT_EQ(link.GetStats().dropped, 1u);
+    EXPECT_EQ(filtered.GetStats().dropped, 1u);
+}
+
+TEST(EmulatedLink, EnginesTransferFile)
+{
+    QByteArray data;
+    for (int i = 0; i < 100 * 1000; i++) data.append((char)(i % 251));
+    QFile file("emulated_link_transfer.bin");
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write(data);
+    file.close();
+
+    kgp::EmulatedLink link(idealLink());
+    kgp::IoEngine sender(link.CreateEndpoint(HOST_A));
+    kgp::IoEngine receiver(link.CreateEndpoint(HOST_B));
+
+    QByteArray received;
+    QObject::connect(&receiver, &kgp::IoEngine::dataRead, [&](const char *bytes, const size_t& size) { received.append(bytes, (int)size); });
+
+    ASSERT_TRUE(sender.StartFileSend(file.fileName().toStdString(), HOST_B.toString().toStdString(), kgp::PORT));
+
+    QElapsedTimer timer;
+    timer.start();
+    while ((received.size() < data.size() || link.InFlightCount() > 0) && timer.elapsed() < 10000)
+    {
+        link.Poll();
+        QCoreApplication::processEvents();
+    }
+
+    EXPECT_EQ(received, data);
+    sender.wait();
+    receiver.wait();
+}
@@ -0,0 +1,109 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             EventRingTest.cpp
+--
+-- PROGRAM:                 kgp_tests
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Tests for the ring that keeps the last messages of the logger.
+---------------------------------------------------------------------------------------*/
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include <QString>
+
+#include "EventRing.h"
+
+TEST(EventRing, ReadsEventsInOrder)
+{
+    kgp::EventRing ring(8);
+    ring.Push(false, "first");
+    ring.Push(true, "second");
+
+    std::vector<kgp::EventRing::Event> events;
+    EXPECT_EQ(ring.Read(0, events), 2u);
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].id, 0u);
+    EXPECT_FALSE(events[0].error);
+    EXPECT_EQ(events[0].text, QString("first"));
+    EXPECT_EQ(events[1].id, 1u);
+    EXPECT_TRUE(events[1].error);
+    EXPECT_EQ(events[1].text, QString("second"));
+    EXPECT_LE(events[0].time, events[1].time);
+
+    // Nothing new since the last read
+    events.clear();
+    EXPECT_EQ(ring.Read(2, events), 2u);
+    EXPECT_TRUE(events.empty());
+}
+
+TEST(EventRing, SkipsOverwrittenEvents)
+{
+    kgp::EventRing ring(4);
+    for (int i = 0; i < 10; i++) ring.Push(false, QString::number(i));
+
+    // A reader that stopped at 3 lost events 3 to 5 and sees the gap in the IDs
+    std::vector<kgp::EventRing::Event> events;
+    EXPECT_EQ(ring.Read(3, events), 10u);
+    ASSERT_EQ(events.size(), ring.Capacity());
+    for (size_t i = 0; i < events.size(); i++)
+    {
+        EXPECT_EQ(events[i].id, 6 + i);
+        EXPECT_EQ(events[i].text, QString::number(6 + i));
+    }
+}
+
+TEST(EventRing, TakesAtMostWhatIsAsked)
+{
+    kgp::EventRing ring(16);
+    for (int i = 0; i < 10; i++) ring.Push(false, QString::number(i));
+
+    std::vector<kgp::EventRing::Event> events;
+    quint64 next = 0;
+    while ((next = ring.Read(next, events, 3)) < 10) {}
+    ASSERT_EQ(events.size(), 10u);
+    for (size_t i = 0; i < events.size(); i++) EXPECT_EQ(events[i].id, i);
+}
+
+TEST(EventRing, KeepsEveryPushFromManyThreads)
+{
+    const int threads = 4;
+    const int pushes = 1000;
+    kgp::EventRing ring(threads * pushes);
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; t++)
+    {
+        writers.emplace_back([&ring, t]() {
+            for (int i = 0; i < pushes; i++) ring.Push(t % 2 == 0, QString::number(t));
+        });
+    }
+
+    // Reads while the writers push must never see an event twice or out of order
+    std::vector<kgp::EventRing::Event> events;
+    quint64 next = 0;
+    while (next < (quint64)(threads * pushes)) next = ring.Read(next, events);
+    for (std::thread& writer : writers) writer.join();
+
+    ASSERT_EQ(events.size(), (size_t)(threads * pushes));
+    std::vector<int> counts(threads, 0);
+    for (size_t i = 0; i < events.size(); i++)
+    {
+        EXPECT_EQ(events[i].id, i);
+        const int t = events[i].text.toInt();
+        EXPECT_EQ(events[i].error, t % 2 == 0);
+        counts[t]++;
+    }
+    for (int count : counts) EXPECT_EQ(count, pushes);
+}
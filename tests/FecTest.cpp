@@ -0,0 +1,147 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             FecTest.cpp
+--
+-- PROGRAM:                 kgp_tests
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Unit tests for the XOR parity encoder and decoder.
+---------------------------------------------------------------------------------------*/
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <QByteArray>
+
+#include "Fec.h"
+
+namespace
+{
+    // Cuts data into frames of at most Size::DATA bytes
+    std::vector<kgp::SlidingWindow::Frame> cutFrames(QByteArray& data)
+    {
+        std::vector<kgp::SlidingWindow::Frame> frames;
+        for (quint64 seqNum = 0; seqNum < (quint64)data.size(); seqNum += kgp::Size::DATA)
+        {
+            kgp::SlidingWindow::Frame frame;
+            frame.seqNum = seqNum;
+            frame.size = std::min<quint64>(kgp::Size::DATA, data.size() - seqNum);
+            frame.data = data.data() + seqNum;
+            frames.push_back(frame);
+        }
+        return frames;
+    }
+
+    QByteArray pattern(const int size)
+    {
+        QByteArray data;
+        for (int i = 0; i < size; i++) data.append((char)((i * 7) % 253));
+        return data;
+    }
+
+    // Encodes the frames as a single block and hands everything but the skipped frames to decoder
+    void transmit(kgp::FecDecoder& decoder, QByteArray& data, const std::vector<size_t>& skipped)
+    {
+        std::vector<kgp::SlidingWindow::Frame> frames = cutFrames(data);
+        kgp::FecEncoder encoder;
+        encoder.SetGroupSize(frames.size());
+
+        std::vector<kgp::Packet> parity;
+        encoder.Encode(frames, parity);
+        encoder.Flush(parity);
+        ASSERT_EQ(parity.size(), 1u);
+
+        for (size_t i = 0; i < frames.size(); i++)
+        {
+            if (std::find(skipped.begin(), skipped.end(), i) != skipped.end()) continue;
+            decoder.AddFrame(frames[i].seqNum, frames[i].data, frames[i].size);
+        }
+        decoder.AddParity(parity[0], 0);
+    }
+}
+
+TEST(Fec, RebuildsSingleLostFrame)
+{
+    QByteArray data = pattern(kgp::Size::DATA * 4);
+    kgp::FecDecoder decoder;
+    transmit(decoder, data, { 1 });
+
+    EXPECT_EQ(decoder.Find(kgp::Size::DATA), nullptr);
+    EXPECT_EQ(decoder.Recover(), 1u);
+
+    const QByteArray *frame = decoder.Find(kgp::Size::DATA);
+    ASSERT_NE(frame, nullptr);
+    EXPECT_EQ(*frame, data.mid(kgp::Size::DATA, kgp::Size::DATA));
+    EXPECT_EQ(decoder.Recovered(), 1u);
+}
+
+TEST(Fec, RebuildsShortLastFrame)
+{
+    QByteArray data = pattern(kgp::Size::DATA * 2 + 500);
+    kgp::FecDecoder decoder;
+    transmit(decoder, data, { 2 });
+
+    EXPECT_EQ(decoder.Recover(), 1u);
+
+    const QByteArray *frame = decoder.Find(kgp::Size::DATA * 2);
+    ASSERT_NE(frame, nullptr);
+    EXPECT_EQ(*frame, data.mid(kgp::Size::DATA * 2));
+}
+
+TEST(Fec, TwoLostFramesAreNotRebuilt)
+{
+    QByteArray data = pattern(kgp::Size::DATA * 4);
+    kgp::FecDecoder decoder;
+    transmit(decoder, data, { 0, 3 });
+
+    EXPECT_EQ(decoder.Recover(), 0u);
+    EXPECT_EQ(decoder.Find(0), nullptr);
+    EXPECT_EQ(decoder.Find(kgp::Size::DATA * 3), nullptr);
+
+    // The resend of one of them makes the other one rebuildable
+    decoder.AddFrame(0, data.data(), kgp::Size::DATA);
+    EXPECT_EQ(decoder.Recover(), 1u);
+    ASSERT_NE(decoder.Find(kgp::Size::DATA * 3), nullptr);
+    EXPECT_EQ(*decoder.Find(kgp::Size::DATA * 3), data.mid(kgp::Size::DATA * 3));
+}
+
+TEST(Fec, ParityFollowsObservedLoss)
+{
+    kgp::FecEncoder encoder(kgp::Fec::GROUP);
+    const quint64 initial = encoder.ParityCount();
+    EXPECT_GE(initial, 1u);
+
+    encoder.SetLoss(1000, 100);
+    EXPECT_GT(encoder.ParityCount(), initial);
+    EXPECT_LE(encoder.ParityCount(), kgp::Fec::GROUP / 2);
+
+    encoder.SetLoss(100000, 0);
+    EXPECT_EQ(encoder.ParityCount(), 1u);
+}
+
+TEST(Fec, BlocksSpanEncodeCalls)
+{
+    QByteArray data = pattern(kgp::Size::DATA * 8);
+    std::vector<kgp::SlidingWindow::Frame> frames = cutFrames(data);
+    kgp::FecEncoder encoder(8);
+
+    // One frame at a time, the way frames go out once ACKs are flowing
+    std::vector<kgp::Packet> parity;
+    for (const auto& frame : frames) encoder.Encode({ frame }, parity);
+    encoder.Flush(parity);
+
+    ASSERT_EQ(parity.size(), encoder.ParityCount());
+    EXPECT_EQ(parity[0].Header.PacketType, kgp::PacketType::FEC);
+    EXPECT_EQ(parity[0].Header.SequenceNumber, 0u);
+    EXPECT_EQ(parity.back().Header.AckNumber, (quint64)data.size());
+}
@@ -0,0 +1,172 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             MerkleTest.cpp
+--
+-- PROGRAM:                 kgp_tests
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Unit tests for the Merkle tree, the chunk hasher and the verifier.
+---------------------------------------------------------------------------------------*/
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <QByteArray>
+
+#include "Merkle.h"
+
+namespace
+{
+    QByteArray pattern(const int size)
+    {
+        QByteArray data;
+        for (int i = 0; i < size; i++) data.append((char)((i * 7) % 253));
+        return data;
+    }
+
+    std::vector<QByteArray> leavesOf(const QByteArray& data)
+    {
+        std::vector<QByteArray> leaves;
+        for (quint64 at = 0; at < (quint64)data.size(); at += kgp::Verify::CHUNK)
+        {
+            leaves.push_back(kgp::MerkleTree::HashChunk(data.constData() + at, std::min<quint64>(kgp::Verify::CHUNK, data.size() - at)));
+        }
+        return leaves;
+    }
+
+    // Answers every node request from the sender's tree and returns the chunks that are asked for
+    std::vector<quint64> descend(const kgp::MerkleTree& tree, kgp::MerkleVerifier& verifier, kgp::MerkleVerifier::Requests requests)
+    {
+        std::vector<quint64> chunks = requests.chunks;
+        while (!requests.nodes.empty())
+        {
+            const std::pair<quint64, quint64> node = requests.nodes.back();
+            requests.nodes.pop_back();
+
+            const quint64 level = node.first - 1;
+            const quint64 first = node.second * 2;
+            std::vector<QByteArray> children;
+            for (quint64 i = first; i < std::min<quint64>(first + 2, tree.Width(level)); i++) children.push_back(tree.Node(level, i));
+
+            kgp::MerkleVerifier::Requests next;
+            verifier.AddNodes(level, first, children, next);
+            requests.nodes.insert(requests.nodes.end(), next.nodes.begin(), next.nodes.end());
+            chunks.insert(chunks.end(), next.chunks.begin(), next.chunks.end());
+        }
+        return chunks;
+    }
+}
+
+TEST(Merkle, LoneNodeMovesUp)
+{
+    const std::vector<QByteArray> leaves = leavesOf(pattern(3 * kgp::Verify::CHUNK));
+    kgp::MerkleTree tree;
+    tree.Build(leaves);
+
+    ASSERT_EQ(tree.Height(), 3u);
+    EXPECT_EQ(tree.Width(1), 2u);
+    EXPECT_EQ(tree.Node(1, 1), leaves[2]);
+    EXPECT_EQ(tree.Root(), kgp::MerkleTree::HashNodes(kgp::MerkleTree::HashNodes(leaves[0], leaves[1]), leaves[2]));
+}
+
+TEST(Merkle, HasherCutsChunksAcrossFrames)
+{
+    const QByteArray data = pattern(3 * kgp::Verify::CHUNK + 1000);
+    kgp::ChunkHasher hasher;
+
+    // Frames do not line up with chunks
+    for (int at = 0; at < data.size(); at += kgp::Size::DATA)
+    {
+        hasher.Add(data.constData() + at, std::min<int>(kgp::Size::DATA, data.size() - at));
+    }
+
+    EXPECT_EQ(hasher.Finish(), leavesOf(data));
+    EXPECT_EQ(hasher.Size(), (quint64)data.size());
+
+    hasher.Reset();
+    EXPECT_TRUE(hasher.Finish().empty());
+}
+
+TEST(Merkle, VerifierFetchesOnlyDamagedChunk)
+{
+    const QByteArray sent = pattern(5 * kgp::Verify::CHUNK + 300);
+    kgp::MerkleTree tree;
+    tree.Build(leavesOf(sent));
+
+    QByteArray received = sent;
+    received[(int)(3 * kgp::Verify::CHUNK + 17)] = received[(int)(3 * kgp::Verify::CHUNK + 17)] ^ 0x10;
+
+    kgp::MerkleVerifier verifier;
+    kgp::MerkleVerifier::Requests requests;
+    verifier.Start(leavesOf(received), received.size(), tree.Root(), requests);
+    ASSERT_EQ(requests.nodes.size(), 1u);
+
+    EXPECT_EQ(descend(tree, verifier, requests), std::vector<quint64>(1, 3));
+    EXPECT_EQ(verifier.Mismatched(), 1u);
+    EXPECT_FALSE(verifier.IsDone());
+
+    // The sender cuts the chunk into frames from its start
+    quint64 offset = 0;
+    QByteArray chunk;
+    bool repaired = false;
+    for (quint64 at = 3 * kgp::Verify::CHUNK; at < 4 * kgp::Verify::CHUNK; at += kgp::Size::MIN_DATA)
+    {
+        kgp::MerkleVerifier::Requests more;
+        repaired = verifier.AddFrame(at, sent.constData() + at, std::min<quint64>(kgp::Size::MIN_DATA, 4 * kgp::Verify::CHUNK - at), offset, chunk, more);
+        EXPECT_TRUE(more.chunks.empty());
+    }
+
+    EXPECT_TRUE(repaired);
+    EXPECT_EQ(offset, 3 * kgp::Verify::CHUNK);
+    EXPECT_EQ(chunk, sent.mid((int)(3 * kgp::Verify::CHUNK), (int)kgp::Verify::CHUNK));
+    EXPECT_TRUE(verifier.IsDone());
+}
+
+TEST(Merkle, VerifierIgnoresHashesThatDoNotAddUp)
+{
+    const QByteArray sent = pattern(2 * kgp::Verify::CHUNK);
+    kgp::MerkleTree tree;
+    tree.Build(leavesOf(sent));
+
+    QByteArray received = sent;
+    received[0] = received[0] ^ 0x01;
+
+    kgp::MerkleVerifier verifier;
+    kgp::MerkleVerifier::Requests requests;
+    verifier.Start(leavesOf(received), received.size(), tree.Root(), requests);
+
+    // Children that do not hash to the root are dropped and asked for again
+    kgp::MerkleVerifier::Requests next;
+    verifier.AddNodes(0, 0, leavesOf(received), next);
+    EXPECT_TRUE(next.nodes.empty() && next.chunks.empty());
+
+    kgp::MerkleVerifier::Requests outstanding;
+    verifier.Outstanding(outstanding);
+    EXPECT_EQ(outstanding.nodes, requests.nodes);
+
+    EXPECT_EQ(descend(tree, verifier, outstanding), std::vector<quint64>(1, 0));
+}
+
+TEST(Merkle, MatchingTransferNeedsNothing)
+{
+    const QByteArray data = pattern(4 * kgp::Verify::CHUNK);
+    kgp::MerkleTree tree;
+    tree.Build(leavesOf(data));
+
+    kgp::MerkleVerifier verifier;
+    kgp::MerkleVerifier::Requests requests;
+    verifier.Start(leavesOf(data), data.size(), tree.Root(), requests);
+
+    EXPECT_TRUE(requests.nodes.empty() && requests.chunks.empty());
+    EXPECT_TRUE(verifier.IsDone());
+}
@@ -0,0 +1,134 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             PacketViewTest.cpp
+--
+-- PROGRAM:                 kgp_tests
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Tests for parsing received packets in place and for the engine dropping
+--                          the ones that do not parse.
+---------------------------------------------------------------------------------------*/
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include <QByteArray>
+#include <QHostAddress>
+
+#include "EmulatedLink.h"
+#include "IoEngine.h"
+#include "PacketView.h"
+#include "Simulation.h"
+
+namespace
+{
+    // A packet as it goes on the wire, with size bytes of data and extra bytes after them
+    QByteArray wirePacket(const char type, const quint64 dataSize, const int size, const int extra = 0)
+    {
+        kgp::PacketHeader header;
+        memset(&header, 0, sizeof(header));
+        header.PacketType = type;
+        header.SequenceNumber = 7;
+        header.DataSize = dataSize;
+
+        QByteArray bytes((const char *)&header, (int)sizeof(header));
+        for (int i = 0; i < size + extra; i++) bytes.append((char)('a' + i % 26));
+        return bytes;
+    }
+}
+
+TEST(PacketView, ReadsDataInPlace)
+{
+    const QByteArray bytes = wirePacket(kgp::PacketType::DATA, 100, 100, 20);
+
+    kgp::PacketView view;
+    ASSERT_EQ(kgp::PacketView::Parse(bytes.constData(), bytes.size(), view), kgp::PacketView::Status::VALID);
+    EXPECT_EQ(view.Header.PacketType, kgp::PacketType::DATA);
+    EXPECT_EQ(view.Header.SequenceNumber, 7u);
+    EXPECT_EQ(view.Header.DataSize, 100u);
+    // Nothing is copied, the data is where it was received
+    EXPECT_EQ(view.Data, bytes.constData() + kgp::Size::HEADER);
+}
+
+TEST(PacketView, ReadsPacketWithoutData)
+{
+    const QByteArray bytes = wirePacket(kgp::PacketType::ACK, 0, 0);
+
+    kgp::PacketView view;
+    EXPECT_EQ(kgp::PacketView::Parse(bytes.constData(), bytes.size(), view), kgp::PacketView::Status::VALID);
+    EXPECT_EQ(view.Header.DataSize, 0u);
+}
+
+TEST(PacketView, RejectsLessThanHeader)
+{
+    const QByteArray bytes = wirePacket(kgp::PacketType::ACK, 0, 0);
+
+    kgp::PacketView view;
+    EXPECT_EQ(kgp::PacketView::Parse(bytes.constData(), kgp::Size::HEADER - 1, view), kgp::PacketView::Status::SHORT);
+    EXPECT_EQ(kgp::PacketView::Parse(bytes.constData(), 0, view), kgp::PacketView::Status::SHORT);
+}
+
+TEST(PacketView, RejectsUnknownType)
+{
+    const QByteArray bytes = wirePacket(0x7F, 0, 0);
+
+    kgp::PacketView view;
+    EXPECT_EQ(kgp::PacketView::Parse(bytes.constData(), bytes.size(), view), kgp::PacketView::Status::TYPE);
+}
+
+TEST(PacketView, RejectsDataThatWasNotReceived)
+{
+    // The header claims a byte more than came after it
+    const QByteArray bytes = wirePacket(kgp::PacketType::DATA, 101, 100);
+
+    kgp::PacketView view;
+    EXPECT_EQ(kgp::PacketView::Parse(bytes.constData(), bytes.size(), view), kgp::PacketView::Status::TRUNCATED);
+
+    // A size that wraps around when added to the header is not received either
+    const QByteArray huge = wirePacket(kgp::PacketType::DATA, ~0ull, 100);
+    EXPECT_EQ(kgp::PacketView::Parse(huge.constData(), huge.size(), view), kgp::PacketView::Status::TRUNCATED);
+}
+
+TEST(PacketView, RejectsMoreDataThanAnyFrame)
+{
+    const QByteArray bytes = wirePacket(kgp::PacketType::DATA, kgp::Size::MAX_DATA + 1, kgp::Size::MAX_DATA + 1);
+
+    kgp::PacketView view;
+    EXPECT_EQ(kgp::PacketView::Parse(bytes.constData(), bytes.size(), view), kgp::PacketView::Status::OVERSIZED);
+}
+
+TEST(PacketView, EngineCountsMalformedPackets)
+{
+    kgp::EmulatedLink::Config config;
+    memset(&config, 0, sizeof(config));
+    config.seed = 1;
+    config.delay = 1;
+
+    kgp::Simulation simulation(config);
+    kgp::IoEngine *receiver = simulation.CreateEngine(QHostAddress(QString("10.0.0.2")));
+    kgp::EmulatedTransport *peer = simulation.Link().CreateEndpoint(QHostAddress(QString("10.0.0.1")));
+    peer->Bind(QHostAddress::Any, 18001);
+
+    const QByteArray packets[] = {
+        wirePacket(kgp::PacketType::SYN, 0, 0).left(10),
+        wirePacket(0x7F, 0, 0),
+        wirePacket(kgp::PacketType::DATA, 50, 10),
+        wirePacket(kgp::PacketType::FEC, kgp::Size::MAX_DATA + 1, kgp::Size::MAX_DATA + 1),
+    };
+    for (const QByteArray& packet : packets) peer->Send(packet.constData(), packet.size(), QHostAddress(QString("10.0.0.2")), kgp::PORT);
+    simulation.RunUntil([&]() { return receiver->GetStats().malformed == 4; }, 1000);
+
+    const kgp::IoEngine::Stats stats = receiver->GetStats();
+    EXPECT_EQ(stats.malformed, 4u);
+    EXPECT_EQ(stats.packetsReceived, 0u);
+    EXPECT_TRUE(receiver->IsIdle());
+}
@@ -0,0 +1,142 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             PathMtuTest.cpp
+--
+-- PROGRAM:                 kgp_tests
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Unit tests for the path MTU search.
+---------------------------------------------------------------------------------------*/
+#include <gtest/gtest.h>
+
+#include "Clock.h"
+#include "DependencyManager.h"
+#include "PathMtu.h"
+
+namespace
+{
+    // Runs the search against a path that carries payloads up to limit, probes that are too large
+    // are never answered
+    quint64 search(kgp::PathMtu& pmtu, kgp::SimulatedClock& clock, const quint64 limit)
+    {
+        quint64 size;
+        for (int i = 0; i < 1000 && pmtu.IsSearching(); i++)
+        {
+            if (pmtu.NextProbe(size))
+            {
+                if (size <= limit) pmtu.ProbeAcked(size);
+                continue;
+            }
+            clock.Advance(kgp::Pmtu::PROBE_TIMEOUT + 1);
+            pmtu.CheckProbe();
+        }
+        return pmtu.Payload();
+    }
+
+    class PathMtuTest : public ::testing::Test
+    {
+    protected:
+        kgp::SimulatedClock mClock;
+
+        void SetUp() override { kgp::DependencyManager::Instance().SetClock(&mClock); }
+        void TearDown() override { kgp::DependencyManager::Instance().SetClock(nullptr); }
+    };
+}
+
+TEST_F(PathMtuTest, EthernetIsFoundWithoutHalving)
+{
+    kgp::PathMtu pmtu;
+    pmtu.Reset(kgp::Size::MAX_DATA);
+    EXPECT_EQ(pmtu.Payload(), kgp::Size::DATA);
+
+    quint64 size;
+    ASSERT_TRUE(pmtu.NextProbe(size));
+    EXPECT_EQ(size, kgp::Pmtu::ETHERNET);
+    // Only one probe is out at a time
+    EXPECT_FALSE(pmtu.NextProbe(size));
+
+    pmtu.ProbeAcked(size);
+    ASSERT_TRUE(pmtu.NextProbe(size));
+    EXPECT_EQ(size, kgp::Size::MAX_DATA);
+    pmtu.ProbeAcked(size);
+
+    EXPECT_FALSE(pmtu.IsSearching());
+    EXPECT_EQ(pmtu.Payload(), kgp::Size::MAX_DATA);
+}
+
+TEST_F(PathMtuTest, SearchSettlesBelowTheLimit)
+{
+    for (const quint64 limit : { (quint64)1300, (quint64)kgp::Pmtu::ETHERNET, (quint64)4000 })
+    {
+        kgp::PathMtu pmtu;
+        pmtu.Reset(kgp::Size::MAX_DATA);
+        const quint64 payload = search(pmtu, mClock, limit);
+        EXPECT_LE(payload, limit);
+        EXPECT_GT(payload + kgp::Pmtu::STEP, limit);
+    }
+}
+
+TEST_F(PathMtuTest, ProbeIsRetriedBeforeItCountsAsTooLarge)
+{
+    kgp::PathMtu pmtu;
+    pmtu.Reset(kgp::Size::MAX_DATA);
+
+    quint64 first, second;
+    ASSERT_TRUE(pmtu.NextProbe(first));
+    EXPECT_FALSE(pmtu.CheckProbe());
+    mClock.Advance(kgp::Pmtu::PROBE_TIMEOUT + 1);
+    EXPECT_TRUE(pmtu.CheckProbe());
+    ASSERT_TRUE(pmtu.NextProbe(second));
+    EXPECT_EQ(first, second);
+
+    // A late answer to the first try still counts
+    pmtu.ProbeAcked(first);
+    ASSERT_TRUE(pmtu.NextProbe(second));
+    EXPECT_EQ(second, kgp::Size::MAX_DATA);
+
+    pmtu.ProbeTooBig(second);
+    EXPECT_EQ(pmtu.Payload(), kgp::Size::DATA);
+    EXPECT_TRUE(pmtu.IsSearching());
+}
+
+TEST_F(PathMtuTest, BlackHoleDropsToMinimum)
+{
+    kgp::PathMtu pmtu;
+    pmtu.Reset(kgp::Size::MAX_DATA);
+    ASSERT_EQ(search(pmtu, mClock, kgp::Size::MAX_DATA), kgp::Size::MAX_DATA);
+    EXPECT_FALSE(pmtu.IsSearching());
+
+    // Loss is not a black hole, the payload in use still gets through
+    quint64 size;
+    pmtu.DataTimedOut();
+    ASSERT_TRUE(pmtu.NextProbe(size));
+    EXPECT_EQ(size, kgp::Size::MAX_DATA);
+    pmtu.ProbeAcked(size);
+    EXPECT_EQ(pmtu.Payload(), kgp::Size::MAX_DATA);
+    EXPECT_EQ(pmtu.BlackHoles(), 0u);
+
+    pmtu.DataTimedOut();
+    for (quint64 i = 0; i < kgp::Pmtu::MAX_PROBES; i++)
+    {
+        ASSERT_TRUE(pmtu.NextProbe(size));
+        EXPECT_EQ(size, kgp::Size::MAX_DATA);
+        mClock.Advance(kgp::Pmtu::PROBE_TIMEOUT + 1);
+        EXPECT_TRUE(pmtu.CheckProbe());
+    }
+    EXPECT_EQ(pmtu.Payload(), kgp::Size::MIN_DATA);
+    EXPECT_EQ(pmtu.BlackHoles(), 1u);
+
+    // The search starts over below the payload that stopped working
+    const quint64 payload = search(pmtu, mClock, kgp::Pmtu::ETHERNET);
+    EXPECT_LE(payload, kgp::Pmtu::ETHERNET);
+    EXPECT_GT(payload + kgp::Pmtu::STEP, kgp::Pmtu::ETHERNET);
+}
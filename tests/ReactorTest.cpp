@@ -0,0 +1,188 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             ReactorTest.cpp
+--
+-- PROGRAM:                 kgp_tests
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Unit tests for the epoll event loop, the transport it waits on and the
+--                          I/O thread that runs an engine on them. These use real sockets on the
+--                          loopback address and only run on Linux.
+---------------------------------------------------------------------------------------*/
+#include <gtest/gtest.h>
+
+#if defined(__linux__)
+
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <QByteArray>
+#include <QFile>
+
+#include "IoThread.h"
+#include "Reactor.h"
+#include "ReactorTransport.h"
+#include "res.h"
+
+namespace
+{
+    // Ports of the transports that talk to each other, away from the protocol port
+    const short PORT_A = 18001;
+    const short PORT_B = 18002;
+
+    // Runs the reactor until done is true or a second has passed
+    bool runUntil(kgp::Reactor& reactor, const std::function<bool()>& done)
+    {
+        const auto end = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (!done() && std::chrono::steady_clock::now() < end) reactor.RunOnce(10);
+        return done();
+    }
+}
+
+TEST(Reactor, PostedTasksRunInOrderOnTheLoop)
+{
+    kgp::Reactor reactor;
+    ASSERT_TRUE(reactor.IsValid());
+
+    std::vector<int> ran;
+    std::thread poster([&]()
+    {
+        reactor.Post([&]() { ran.push_back(1); });
+        reactor.Post([&]() { ran.push_back(2); });
+    });
+    poster.join();
+
+    EXPECT_TRUE(runUntil(reactor, [&]() { return ran.size() == 2; }));
+    EXPECT_EQ(ran, std::vector<int>({ 1, 2 }));
+}
+
+TEST(Reactor, TimerFiresOnce)
+{
+    kgp::Reactor reactor;
+    int fired = 0;
+    reactor.SetTimerHandler([&]() { fired++; });
+
+    const auto start = std::chrono::steady_clock::now();
+    reactor.SetTimer(20);
+    EXPECT_TRUE(runUntil(reactor, [&]() { return fired == 1; }));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+
+    reactor.RunOnce(50);
+    EXPECT_EQ(fired, 1);
+
+    // A timer that is replaced before it fires does not fire
+    reactor.SetTimer(10);
+    reactor.SetTimer(std::numeric_limits<quint64>::max());
+    reactor.RunOnce(50);
+    EXPECT_EQ(fired, 1);
+}
+
+TEST(Reactor, StopWakesTheLoop)
+{
+    kgp::Reactor reactor;
+    std::thread loop([&]() { reactor.Run(); });
+
+    reactor.Stop();
+    loop.join();
+    EXPECT_FALSE(reactor.RunOnce(0));
+}
+
+TEST(ReactorTransport, DatagramsArriveWithTheirSender)
+{
+    kgp::Reactor reactor;
+    kgp::ReactorTransport a(reactor);
+    kgp::ReactorTransport b(reactor);
+    ASSERT_TRUE(a.Bind(QHostAddress(QHostAddress::LocalHost), PORT_A));
+    ASSERT_TRUE(b.Bind(QHostAddress(QHostAddress::LocalHost), PORT_B));
+
+    std::vector<QNetworkDatagram> received;
+    QObject::connect(&b, &kgp::Transport::readyRead, [&]() {
+        while (b.HasPendingDatagrams()) received.push_back(b.Receive());
+    });
+
+    const QByteArray header("head");
+    const QByteArray data("data");
+    ASSERT_EQ(a.Send("ping", 4, QHostAddress(QHostAddress::LocalHost), PORT_B), 4);
+    ASSERT_EQ(a.SendGather(header.constData(), header.size(), data.constData(), data.size(), QHostAddress(QHostAddress::LocalHost), PORT_B), 8);
+
+    ASSERT_TRUE(runUntil(reactor, [&]() { return received.size() == 2; }));
+    EXPECT_EQ(received[0].data(), QByteArray("ping"));
+    EXPECT_EQ(received[1].data(), QByteArray("headdata"));
+    EXPECT_EQ(received[0].senderAddress(), QHostAddress(QHostAddress::LocalHost));
+    EXPECT_EQ(received[0].senderPort(), PORT_A);
+    EXPECT_FALSE(b.HasPendingDatagrams());
+}
+
+TEST(ReactorTransport, ClosedTransportIsNotWaitedOn)
+{
+    kgp::Reactor reactor;
+    kgp::ReactorTransport a(reactor);
+    kgp::ReactorTransport b(reactor);
+    ASSERT_TRUE(a.Bind(QHostAddress(QHostAddress::LocalHost), PORT_A));
+    ASSERT_TRUE(b.Bind(QHostAddress(QHostAddress::LocalHost), PORT_B));
+
+    int ready = 0;
+    QObject::connect(&b, &kgp::Transport::readyRead, [&]() { ready++; });
+    b.Close();
+
+    a.Send("ping", 4, QHostAddress(QHostAddress::LocalHost), PORT_B);
+    reactor.RunOnce(50);
+    EXPECT_EQ(ready, 0);
+    EXPECT_EQ(b.Send("ping", 4, QHostAddress(QHostAddress::LocalHost), PORT_A), -1);
+}
+
+TEST(IoThread, TransfersFileOverLoopback)
+{
+    QByteArray data;
+    for (int i = 0; i < 300 * 1000; i++) data.append((char)(i % 251));
+    QFile file("io_thread_transfer.bin");
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write(data);
+    file.close();
+
+    kgp::IoThread receiver(kgp::PORT);
+    kgp::IoThread sender(PORT_A);
+    // A checkpoint left by an earlier run must not shorten the transfer
+    receiver.Engine().SetFeatures(kgp::Feature::CHECKSUM | kgp::Feature::PMTU);
+
+    // Data is handed over on the thread of the receiver
+    std::mutex mutex;
+    QByteArray received;
+    QObject::connect(&receiver.Engine(), &kgp::IoEngine::dataRead, [&](const char *bytes, const size_t& size) {
+        std::lock_guard<std::mutex> locker(mutex);
+        received.append(bytes, (int)size);
+    });
+
+    receiver.Start();
+    sender.Start();
+    sender.Post([&]() { sender.Engine().StartFileSend("io_thread_transfer.bin", "127.0.0.1", kgp::PORT); });
+
+    const auto end = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (std::chrono::steady_clock::now() < end)
+    {
+        {
+            std::lock_guard<std::mutex> locker(mutex);
+            if (received.size() >= data.size()) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    sender.Stop();
+    receiver.Stop();
+    EXPECT_EQ(received, data);
+}
+
+#endif
@@ -0,0 +1,65 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             ReplayFilterTest.cpp
+--
+-- PROGRAM:                 kgp_tests
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Unit tests for the filter that refuses the data of replayed SYNs.
+---------------------------------------------------------------------------------------*/
+#include <gtest/gtest.h>
+
+#include "Clock.h"
+#include "DependencyManager.h"
+#include "ReplayFilter.h"
+#include "res.h"
+
+namespace
+{
+    class ReplayFilterTest : public ::testing::Test
+    {
+    protected:
+        kgp::SimulatedClock mClock;
+
+        void SetUp() override { kgp::DependencyManager::Instance().SetClock(&mClock); }
+        void TearDown() override { kgp::DependencyManager::Instance().SetClock(nullptr); }
+    };
+}
+
+TEST_F(ReplayFilterTest, NonceIsAdmittedOnce)
+{
+    kgp::ReplayFilter filter;
+    const quint64 nonce = kgp::ReplayFilter::NewNonce();
+    ASSERT_NE(nonce, 0u);
+    EXPECT_NE(kgp::ReplayFilter::NewNonce(), nonce);
+
+    EXPECT_TRUE(filter.Admit(nonce));
+    EXPECT_FALSE(filter.Admit(nonce));
+    EXPECT_FALSE(filter.Admit(0));
+
+    // Once the replay window has passed the nonce may be used again
+    mClock.Advance(kgp::Early::REPLAY_WINDOW + 1);
+    EXPECT_TRUE(filter.Admit(nonce));
+}
+
+TEST_F(ReplayFilterTest, FullFilterRefusesNewNonces)
+{
+    kgp::ReplayFilter filter;
+    for (quint64 nonce = 1; nonce <= kgp::Early::MAX_NONCES; nonce++) ASSERT_TRUE(filter.Admit(nonce));
+
+    // None of the remembered nonces may be forgotten before its window is over
+    EXPECT_FALSE(filter.Admit(kgp::Early::MAX_NONCES + 1));
+    EXPECT_FALSE(filter.Admit(1));
+
+    mClock.Advance(kgp::Early::REPLAY_WINDOW + 1);
+    EXPECT_TRUE(filter.Admit(kgp::Early::MAX_NONCES + 1));
+}
@@ -0,0 +1,62 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             RttEstimatorTest.cpp
+--
+-- PROGRAM:                 kgp_tests
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Unit tests for the round trip estimate and retransmission timeout.
+---------------------------------------------------------------------------------------*/
+#include <gtest/gtest.h>
+
+#include "res.h"
+#include "RttEstimator.h"
+
+TEST(RttEstimator, InitialTimeoutUntilFirstSample)
+{
+    kgp::RttEstimator rtt;
+    rtt.Reset(3000, kgp::Timeout::RCV);
+    EXPECT_EQ(rtt.Rto(), 3000u);
+    EXPECT_EQ(rtt.Samples(), 0u);
+
+    // The first sample sets the variation to half the round trip
+    rtt.AddSample(400);
+    EXPECT_EQ(rtt.Srtt(), 400u);
+    EXPECT_EQ(rtt.Rto(), 400u + 4 * 200u);
+}
+
+TEST(RttEstimator, SteadyPathSettlesAtFloor)
+{
+    kgp::RttEstimator rtt;
+    rtt.Reset(kgp::Timeout::RCV, kgp::Timeout::RCV);
+    for (int i = 0; i < 100; i++) rtt.AddSample(20);
+
+    EXPECT_EQ(rtt.Srtt(), 20u);
+    EXPECT_EQ(rtt.Rto(), kgp::Rto::MIN);
+}
+
+TEST(RttEstimator, BackoffDoublesUpToMax)
+{
+    kgp::RttEstimator rtt;
+    rtt.Reset(kgp::Timeout::RCV, 2000);
+    rtt.AddSample(200);
+    ASSERT_EQ(rtt.Rto(), 600u);
+
+    EXPECT_EQ(rtt.Backoff(0), 600u);
+    EXPECT_EQ(rtt.Backoff(1), 1200u);
+    EXPECT_EQ(rtt.Backoff(2), 2000u);
+    EXPECT_EQ(rtt.Backoff(64), 2000u);
+
+    // A slow path never times out later than the largest timeout
+    rtt.AddSample(10000);
+    EXPECT_EQ(rtt.Rto(), 2000u);
+}
@@ -0,0 +1,298 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             SlidingWindowTest.cpp
+--
+-- PROGRAM:                 kgp_tests
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Unit tests for the framing and ACK logic of the sliding window.
+---------------------------------------------------------------------------------------*/
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <QByteArray>
+#include <QFile>
+
+#include "Clock.h"
+#include "DependencyManager.h"
+#include "RttEstimator.h"
+#include "SlidingWindow.h"
+
+namespace
+{
+    // Writes size bytes of a repeating pattern to a scratch file and buffers it in window
+    void bufferPattern(kgp::SlidingWindow& window, const size_t size)
+    {
+        QByteArray data;
+        for (size_t i = 0; i < size; i++) data.append((char)(i % 251));
+
+        QFile file("sliding_window_test.bin");
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        file.write(data);
+        file.close();
+
+        ASSERT_TRUE(window.BufferFile(file));
+    }
+
+    class SlidingWindowTimerTest : public ::testing::Test
+    {
+    protected:
+        kgp::SimulatedClock mClock;
+        kgp::RttEstimator mRtt;
+
+        void SetUp() override
+        {
+            kgp::DependencyManager::Instance().SetClock(&mClock);
+            mRtt.Reset(1000, kgp::Timeout::RCV);
+        }
+        void TearDown() override { kgp::DependencyManager::Instance().SetClock(nullptr); }
+    };
+}
+
+TEST(SlidingWindow, NextFramesFillOneWindow)
+{
+    kgp::SlidingWindow window;
+    bufferPattern(window, kgp::Size::WINDOW * 3);
+
+    std::vector<kgp::SlidingWindow::Frame> frames;
+    window.GetNextFrames(frames);
+
+    ASSERT_EQ(frames.size(), kgp::Size::WINDOW / kgp::Size::DATA);
+    quint64 expected = 0;
+    for (const auto& frame : frames)
+    {
+        EXPECT_EQ(frame.seqNum, expected);
+        EXPECT_EQ(frame.size, kgp::Size::DATA);
+        expected += frame.size;
+    }
+
+    // The window is full so nothing more is handed out until an ACK arrives
+    frames.clear();
+    window.GetNextFrames(frames);
+    EXPECT_TRUE(frames.empty());
+}
+
+TEST(SlidingWindow, AckAdvancesHead)
+{
+    kgp::SlidingWindow window;
+    bufferPattern(window, kgp::Size::WINDOW * 3);
+
+    std::vector<kgp::SlidingWindow::Frame> frames;
+    window.GetNextFrames(frames);
+
+    EXPECT_TRUE(window.AckFrame(kgp::Size::DATA));
+    frames.clear();
+    window.GetNextFrames(frames);
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0].seqNum, kgp::Size::WINDOW);
+
+    // ACKs past the window pointer are rejected
+    EXPECT_FALSE(window.AckFrame(kgp::Size::WINDOW * 3));
+}
+
+TEST(SlidingWindow, PendingFramesCoverUnackedRange)
+{
+    kgp::SlidingWindow window;
+    bufferPattern(window, kgp::Size::WINDOW * 3);
+
+    std::vector<kgp::SlidingWindow::Frame> frames;
+    window.GetNextFrames(frames);
+    window.AckFrame(kgp::Size::DATA * 4);
+
+    std::vector<kgp::SlidingWindow::Frame> pending;
+    window.GetPendingFrames(pending);
+    ASSERT_FALSE(pending.empty());
+    EXPECT_EQ(pending.front().seqNum, kgp::Size::DATA * 4);
+}
+
+TEST(SlidingWindow, LastFrameAckSetsEot)
+{
+    kgp::SlidingWindow window;
+    bufferPattern(window, kgp::Size::DATA + 10);
+
+    std::vector<kgp::SlidingWindow::Frame> frames;
+    window.GetNextFrames(frames);
+    ASSERT_EQ(frames.size(), 2u);
+    EXPECT_EQ(frames[1].size, 10u);
+
+    EXPECT_FALSE(window.IsEot());
+    window.AckFrame(frames[1].seqNum);
+    EXPECT_TRUE(window.IsEot());
+}
+
+TEST(SlidingWindow, PendingFramesStopAtLastSentByte)
+{
+    kgp::SlidingWindow window;
+    bufferPattern(window, kgp::Size::DATA + 10);
+
+    std::vector<kgp::SlidingWindow::Frame> frames;
+    window.GetNextFrames(frames);
+
+    std::vector<kgp::SlidingWindow::Frame> pending;
+    window.GetPendingFrames(pending);
+    ASSERT_EQ(pending.size(), 2u);
+    EXPECT_EQ(pending[0].size, kgp::Size::DATA);
+    EXPECT_EQ(pending[1].size, 10u);
+}
+
+TEST(SlidingWindow, FullSizedLastFrameSetsEot)
+{
+    kgp::SlidingWindow window;
+    bufferPattern(window, kgp::Size::DATA * 3);
+
+    std::vector<kgp::SlidingWindow::Frame> frames;
+    window.GetNextFrames(frames);
+    ASSERT_EQ(frames.size(), 3u);
+    EXPECT_EQ(frames.back().size, kgp::Size::DATA);
+    EXPECT_TRUE(window.IsAllSent());
+
+    EXPECT_TRUE(window.AckFrame(frames.back().seqNum));
+    EXPECT_TRUE(window.IsEot());
+}
+
+TEST(SlidingWindow, PendingFramesSurviveShrunkWindow)
+{
+    kgp::SlidingWindow window;
+    bufferPattern(window, kgp::Size::WINDOW * 2);
+
+    std::vector<kgp::SlidingWindow::Frame> frames;
+    window.GetNextFrames(frames);
+
+    // The receiver advertises a smaller window after the frames went out
+    window.SetWindowSize(kgp::Size::DATA / 2);
+
+    std::vector<kgp::SlidingWindow::Frame> pending;
+    window.GetPendingFrames(pending);
+    quint64 covered = 0;
+    for (const auto& frame : pending)
+    {
+        EXPECT_GT(frame.size, 0u);
+        covered += frame.size;
+    }
+    EXPECT_EQ(covered, kgp::Size::WINDOW);
+}
+
+TEST(SlidingWindow, StartAtSkipsResumedBytes)
+{
+    kgp::SlidingWindow window;
+    bufferPattern(window, kgp::Size::WINDOW * 2);
+
+    const quint64 offset = kgp::Size::WINDOW + 100;
+    window.StartAt(offset);
+
+    std::vector<kgp::SlidingWindow::Frame> frames;
+    window.GetNextFrames(frames);
+    ASSERT_FALSE(frames.empty());
+    EXPECT_EQ(frames.front().seqNum, offset);
+    EXPECT_EQ(frames.front().data[0], (char)(offset % 251));
+    EXPECT_TRUE(window.IsAllSent());
+
+    // An offset past the end would leave nothing to end the transfer with
+    kgp::SlidingWindow other;
+    bufferPattern(other, 100);
+    other.StartAt(100);
+    frames.clear();
+    other.GetNextFrames(frames);
+    ASSERT_FALSE(frames.empty());
+    EXPECT_EQ(frames.front().seqNum, 0u);
+}
+
+TEST(SlidingWindow, ClosesAtAckedFrame)
+{
+    kgp::SlidingWindow window;
+    bufferPattern(window, kgp::Size::WINDOW * 3);
+
+    std::vector<kgp::SlidingWindow::Frame> frames;
+    window.GetNextFrames(frames);
+    EXPECT_FALSE(window.IsClosed());
+
+    // The receiver delivered the second frame and has no room past it
+    ASSERT_TRUE(window.AckFrame(kgp::Size::DATA));
+    window.SetWindowSize(kgp::Size::DATA);
+    EXPECT_TRUE(window.IsClosed());
+    frames.clear();
+    window.GetNextFrames(frames);
+    EXPECT_TRUE(frames.empty());
+
+    window.SetWindowSize(kgp::Size::DATA * 2);
+    EXPECT_FALSE(window.IsClosed());
+}
+
+TEST(SlidingWindow, OutstandingEndsAtAckedFrame)
+{
+    kgp::SlidingWindow window;
+    bufferPattern(window, kgp::Size::WINDOW * 3);
+    EXPECT_EQ(window.GetOutstanding(), 0u);
+
+    std::vector<kgp::SlidingWindow::Frame> frames;
+    window.GetNextFrames(frames);
+    EXPECT_EQ(window.GetOutstanding(), kgp::Size::WINDOW);
+
+    // The ACK'd frame was delivered, only the frames after it are still outstanding
+    ASSERT_TRUE(window.AckFrame(kgp::Size::DATA));
+    EXPECT_EQ(window.GetOutstanding(), kgp::Size::WINDOW - kgp::Size::DATA * 2);
+}
+
+TEST_F(SlidingWindowTimerTest, ExpiredFramesGoBackFromFirstTimeout)
+{
+    kgp::SlidingWindow window;
+    bufferPattern(window, kgp::Size::WINDOW * 3);
+
+    std::vector<kgp::SlidingWindow::Frame> frames;
+    window.GetNextFrames(frames);
+    ASSERT_TRUE(window.AckFrame(kgp::Size::DATA * 2));
+    EXPECT_EQ(window.NextExpiry(mRtt), 1001u);
+
+    // Nothing times out until the timeout has passed
+    std::vector<kgp::SlidingWindow::Frame> expired;
+    mClock.Advance(1000);
+    EXPECT_FALSE(window.GetExpiredFrames(mRtt, expired));
+    EXPECT_TRUE(expired.empty());
+
+    // The ACK'd frame at the head is not sent again
+    mClock.Advance(1);
+    ASSERT_TRUE(window.GetExpiredFrames(mRtt, expired));
+    ASSERT_EQ(expired.size(), frames.size() - 3);
+    EXPECT_EQ(expired.front().seqNum, kgp::Size::DATA * 3);
+    EXPECT_EQ(expired.back().seqNum, frames.back().seqNum);
+
+    // Frames that were sent again wait twice as long
+    EXPECT_EQ(window.NextExpiry(mRtt), 1001u + 2001u);
+    expired.clear();
+    mClock.Advance(2000);
+    EXPECT_FALSE(window.GetExpiredFrames(mRtt, expired));
+}
+
+TEST_F(SlidingWindowTimerTest, OnlyFramesSentOnceAreRttSamples)
+{
+    kgp::SlidingWindow window;
+    bufferPattern(window, kgp::Size::WINDOW * 3);
+
+    std::vector<kgp::SlidingWindow::Frame> frames;
+    window.GetNextFrames(frames);
+
+    quint64 sample;
+    mClock.Advance(40);
+    ASSERT_TRUE(window.AckFrame(0));
+    ASSERT_TRUE(window.TakeRttSample(sample));
+    EXPECT_EQ(sample, 40u);
+    EXPECT_FALSE(window.TakeRttSample(sample));
+
+    // The ACK of a frame sent twice could be for either send
+    std::vector<kgp::SlidingWindow::Frame> expired;
+    mClock.Advance(1000);
+    ASSERT_TRUE(window.GetExpiredFrames(mRtt, expired));
+    mClock.Advance(40);
+    ASSERT_TRUE(window.AckFrame(kgp::Size::DATA));
+    EXPECT_FALSE(window.TakeRttSample(sample));
+}
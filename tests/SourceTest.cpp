@@ -0,0 +1,299 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             SourceTest.cpp
+--
+-- PROGRAM:                 kgp_tests
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Unit tests for the sources a window is filled from as it moves, and a
+--                          transfer from a pipe whose producer is still writing when it starts.
+---------------------------------------------------------------------------------------*/
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include <QBuffer>
+#include <QByteArray>
+
+#include "SlidingWindow.h"
+#include "Source.h"
+#include "res.h"
+
+#if defined(__linux__)
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+
+#include <unistd.h>
+
+#include "IoThread.h"
+#endif
+
+namespace
+{
+    QByteArray pattern(const int size)
+    {
+        QByteArray data;
+        for (int i = 0; i < size; i++) data.append((char)(i % 251));
+        return data;
+    }
+
+    // Hands out frames and ACKs each of them until the window has nothing more, checking that every
+    // frame carries the bytes of data at its sequence number
+    quint64 drain(kgp::SlidingWindow& window, const QByteArray& data)
+    {
+        quint64 sent = 0;
+        std::vector<kgp::SlidingWindow::Frame> frames;
+        for (window.GetNextFrames(frames); !frames.empty(); window.GetNextFrames(frames))
+        {
+            for (const auto& frame : frames)
+            {
+                EXPECT_EQ(QByteArray(frame.data, (int)frame.size), data.mid((int)frame.seqNum, (int)frame.size));
+                sent += frame.size;
+            }
+            window.AckFrame(frames.back().seqNum);
+            frames.clear();
+        }
+        return sent;
+    }
+}
+
+TEST(Source, MemoryIsFramedAsTheWindowMoves)
+{
+    const QByteArray data = pattern((int)kgp::Size::WINDOW * 5 + 10);
+    kgp::SlidingWindow window;
+    window.BufferSource(std::make_shared<kgp::MemorySource>(data));
+
+    // Nothing is read until frames are asked for, and then only about a window's worth
+    EXPECT_EQ(window.GetSize(), 0u);
+    std::vector<kgp::SlidingWindow::Frame> frames;
+    window.GetNextFrames(frames);
+    ASSERT_EQ(frames.size(), kgp::Size::WINDOW / kgp::Size::DATA);
+    EXPECT_LE(window.GetSize(), kgp::Size::WINDOW + 1);
+
+    window.AckFrame(frames.back().seqNum);
+    frames.clear();
+    EXPECT_EQ(drain(window, data), (quint64)data.size() - kgp::Size::WINDOW);
+    EXPECT_TRUE(window.IsAllSent());
+    EXPECT_TRUE(window.IsEot());
+    // What the receiver has was let go of along the way
+    EXPECT_LT(window.GetSize(), kgp::Size::WINDOW * 2);
+}
+
+TEST(Source, LastFrameWaitsForTheEnd)
+{
+    bool ended = false;
+    int given = 0;
+    const int size = (int)kgp::Size::DATA + 10;
+    kgp::SlidingWindow window;
+    window.BufferSource(std::make_shared<kgp::GeneratorSource>([&](char *data, const qint64 wanted, bool& done) -> qint64
+    {
+        const qint64 count = std::min<qint64>(wanted, size - given);
+        for (qint64 i = 0; i < count; i++) data[i] = (char)(given + i);
+        given += (int)count;
+        done = ended && given == size;
+        return count;
+    }));
+
+    // Only whole frames go out while more may follow
+    std::vector<kgp::SlidingWindow::Frame> frames;
+    window.GetNextFrames(frames);
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0].size, kgp::Size::DATA);
+    EXPECT_FALSE(window.IsAllSent());
+    EXPECT_TRUE(window.IsWaiting());
+
+    frames.clear();
+    window.GetNextFrames(frames);
+    EXPECT_TRUE(frames.empty());
+
+    // Once the producer is done the rest is the last frame
+    ended = true;
+    window.GetNextFrames(frames);
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0].seqNum, kgp::Size::DATA);
+    EXPECT_EQ(frames[0].size, 10u);
+    EXPECT_TRUE(window.IsAllSent());
+    EXPECT_FALSE(window.IsWaiting());
+
+    window.AckFrame(frames[0].seqNum);
+    EXPECT_TRUE(window.IsEot());
+}
+
+TEST(Source, WholeFrameIsHeldUntilTheEnd)
+{
+    bool ended = false;
+    bool given = false;
+    kgp::SlidingWindow window;
+    window.BufferSource(std::make_shared<kgp::GeneratorSource>([&](char *data, const qint64 wanted, bool& done) -> qint64
+    {
+        done = ended;
+        if (given || wanted < (qint64)kgp::Size::DATA) return 0;
+        memset(data, 'x', kgp::Size::DATA);
+        given = true;
+        return kgp::Size::DATA;
+    }));
+
+    // A frame that ends with the data could be the last one or not
+    std::vector<kgp::SlidingWindow::Frame> frames;
+    window.GetNextFrames(frames);
+    EXPECT_TRUE(frames.empty());
+
+    ended = true;
+    window.GetNextFrames(frames);
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0].size, kgp::Size::DATA);
+    EXPECT_TRUE(window.IsAllSent());
+}
+
+TEST(Source, PendingFramesSurviveTheBufferMoving)
+{
+    const QByteArray data = pattern((int)kgp::Size::WINDOW * 4);
+    kgp::SlidingWindow window;
+    window.BufferSource(std::make_shared<kgp::MemorySource>(data));
+
+    std::vector<kgp::SlidingWindow::Frame> frames;
+    window.GetNextFrames(frames);
+    ASSERT_GT(frames.size(), 2u);
+
+    // More than half of the window is delivered, which lets go of the front of the buffer on the
+    // next pull
+    const quint64 ack = frames[frames.size() / 2 + 1].seqNum;
+    window.AckFrame(ack);
+    frames.clear();
+    window.GetNextFrames(frames);
+
+    std::vector<kgp::SlidingWindow::Frame> pending;
+    window.GetPendingFrames(pending);
+    ASSERT_FALSE(pending.empty());
+    EXPECT_EQ(pending.front().seqNum, ack);
+    for (const auto& frame : pending)
+    {
+        EXPECT_EQ(QByteArray(frame.data, (int)frame.size), data.mid((int)frame.seqNum, (int)frame.size));
+    }
+}
+
+TEST(Source, FailedSourceStopsTheWindow)
+{
+    int calls = 0;
+    kgp::SlidingWindow window;
+    window.BufferSource(std::make_shared<kgp::GeneratorSource>([&](char *data, const qint64 wanted, bool&) -> qint64
+    {
+        if (calls++ > 0) return -1;
+        memset(data, 'x', (size_t)wanted);
+        return kgp::Size::DATA * 2;
+    }));
+
+    std::vector<kgp::SlidingWindow::Frame> frames;
+    window.GetNextFrames(frames);
+    EXPECT_TRUE(window.HasFailed());
+    EXPECT_FALSE(window.IsWaiting());
+    // What was given before is still whole frames, nothing is the last frame
+    EXPECT_FALSE(window.IsAllSent());
+
+    // Reset lets go of the source and its failure
+    window.Reset();
+    EXPECT_FALSE(window.HasFailed());
+}
+
+TEST(Source, DeviceEndsWithItsData)
+{
+    QByteArray data = pattern((int)kgp::Size::DATA * 3 + 5);
+    QBuffer buffer(&data);
+    kgp::SlidingWindow window;
+    window.BufferSource(std::make_shared<kgp::DeviceSource>(&buffer));
+
+    EXPECT_EQ(drain(window, data), (quint64)data.size());
+    EXPECT_TRUE(window.IsEot());
+}
+
+TEST(Source, EmptySourceIsNotWaitedOn)
+{
+    kgp::SlidingWindow window;
+    window.BufferSource(std::make_shared<kgp::MemorySource>(QByteArray()));
+
+    std::vector<kgp::SlidingWindow::Frame> frames;
+    window.GetNextFrames(frames);
+    EXPECT_TRUE(frames.empty());
+    EXPECT_FALSE(window.IsWaiting());
+}
+
+#if defined(__linux__)
+TEST(Source, SendsFromAPipeWhileItIsWritten)
+{
+    // Ports of the engines, away from the protocol port and the ports of the other tests
+    const short senderPort = 18001;
+    const auto timeLimit = std::chrono::seconds(10);
+    const QByteArray data = pattern(400 * 1000);
+    const int first = 16 * 1000;
+
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    // Less than a pipe holds, so the producer is not stuck before the transfer starts
+    ASSERT_EQ(write(fds[1], data.constData(), first), first);
+
+    kgp::IoThread receiver(kgp::PORT);
+    kgp::IoThread sender(senderPort);
+    receiver.Engine().SetFeatures(kgp::Feature::CHECKSUM | kgp::Feature::PMTU);
+    sender.Engine().SetFeatures(kgp::Feature::CHECKSUM | kgp::Feature::PMTU);
+
+    // The sink runs on the thread of the receiver
+    QByteArray received;
+    std::atomic<int> arrived(0);
+    std::promise<bool> finished;
+    bool once = false;
+    QObject context;
+    QObject::connect(&receiver.Engine(), &kgp::IoEngine::dataRead, &context, [&](const char *chunk, const size_t& size)
+    {
+        received.append(chunk, (int)size);
+        arrived += (int)size;
+    }, Qt::DirectConnection);
+    QObject::connect(&receiver.Engine(), &kgp::IoEngine::transferFinished, &context, [&](const bool& complete)
+    {
+        if (!once) finished.set_value(complete);
+        once = true;
+    }, Qt::DirectConnection);
+    receiver.Start();
+    sender.Start();
+
+    std::shared_ptr<kgp::Source> source = std::make_shared<kgp::FdSource>(fds[0], true);
+    sender.Post([&sender, source]() { sender.Engine().StartSourceSend(source, "127.0.0.1", kgp::PORT); });
+
+    // Frames of what was written so far arrive before the producer is done
+    const auto start = std::chrono::steady_clock::now();
+    while (arrived == 0 && std::chrono::steady_clock::now() - start < timeLimit) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    ASSERT_GT(arrived.load(), 0);
+    EXPECT_LT(arrived.load(), first);
+
+    std::thread producer([&]()
+    {
+        for (int at = first; at < data.size(); at += 50 * 1000)
+        {
+            const int size = std::min(50 * 1000, data.size() - at);
+            EXPECT_EQ(write(fds[1], data.constData() + at, size), size);
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        close(fds[1]);
+    });
+
+    std::future<bool> done = finished.get_future();
+    ASSERT_EQ(done.wait_for(timeLimit), std::future_status::ready);
+    producer.join();
+    EXPECT_TRUE(done.get());
+    EXPECT_EQ(received, data);
+
+    sender.Stop();
+    receiver.Stop();
+}
+#endif
@@ -0,0 +1,231 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             StreamFramerTest.cpp
+--
+-- PROGRAM:                 kgp_tests
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Unit tests for splitting the bytes of a session or directory into its
+--                          files.
+---------------------------------------------------------------------------------------*/
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+#include <QByteArray>
+#include <QString>
+
+#include "res.h"
+#include "StreamFramer.h"
+
+namespace
+{
+    struct File
+    {
+        quint64 id;
+        QString name;
+        quint64 size;
+        QByteArray data;
+        bool ended;
+    };
+
+    // Feeds the stream in pieces of the given size and collects the files from the events
+    bool split(const QByteArray& stream, const int piece, std::vector<File>& files,
+        const kgp::StreamFramer::Layout layout = kgp::StreamFramer::Layout::HEADERS)
+    {
+        kgp::StreamFramer framer;
+        framer.Reset(layout);
+        for (int at = 0; at < stream.size(); at += piece)
+        {
+            std::vector<kgp::StreamFramer::Event> events;
+            if (!framer.Add(stream.constData() + at, std::min(piece, stream.size() - at), events)) return false;
+            for (const auto& event : events)
+            {
+                switch (event.type)
+                {
+                case kgp::StreamFramer::EventType::START:
+                    files.push_back({ event.id, event.name, event.size, QByteArray(), false });
+                    break;
+                case kgp::StreamFramer::EventType::DATA:
+                    EXPECT_EQ(event.id, files.back().id);
+                    files.back().data.append(event.data, (int)event.size);
+                    break;
+                case kgp::StreamFramer::EventType::END:
+                    EXPECT_EQ(event.id, files.back().id);
+                    files.back().ended = true;
+                    break;
+                }
+            }
+        }
+        return framer.AtBoundary();
+    }
+}
+
+TEST(StreamFramer, SplitsFilesCutAnywhere)
+{
+    const QByteArray first(3000, 'a');
+    const QByteArray third(10, 'c');
+    QByteArray stream = kgp::StreamFramer::Header(1, "first.bin", first.size());
+    stream.append(first);
+    stream.append(kgp::StreamFramer::Header(2, "", 0));
+    stream.append(kgp::StreamFramer::Header(3, "third.txt", third.size()));
+    stream.append(third);
+
+    // Headers are cut by frames of any size, down to a byte
+    for (const int piece : { 1, 7, 24, 1000, stream.size() })
+    {
+        std::vector<File> files;
+        ASSERT_TRUE(split(stream, piece, files)) << piece;
+        ASSERT_EQ(files.size(), 3u) << piece;
+
+        EXPECT_EQ(files[0].id, 1u);
+        EXPECT_EQ(files[0].name, QString("first.bin"));
+        EXPECT_EQ(files[0].size, (quint64)first.size());
+        EXPECT_EQ(files[0].data, first);
+        EXPECT_TRUE(files[0].ended);
+
+        // A file of 0 bytes starts and ends at once
+        EXPECT_EQ(files[1].id, 2u);
+        EXPECT_TRUE(files[1].name.isEmpty());
+        EXPECT_TRUE(files[1].data.isEmpty());
+        EXPECT_TRUE(files[1].ended);
+
+        EXPECT_EQ(files[2].name, QString("third.txt"));
+        EXPECT_EQ(files[2].data, third);
+        EXPECT_TRUE(files[2].ended);
+    }
+}
+
+TEST(StreamFramer, WaitsForTheRestOfAHeader)
+{
+    const QByteArray stream = kgp::StreamFramer::Header(1, "name", 5);
+
+    kgp::StreamFramer framer;
+    std::vector<kgp::StreamFramer::Event> events;
+    ASSERT_TRUE(framer.Add(stream.constData(), stream.size() - 1, events));
+    EXPECT_TRUE(events.empty());
+    EXPECT_FALSE(framer.AtBoundary());
+
+    ASSERT_TRUE(framer.Add(stream.constData() + stream.size() - 1, 1, events));
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].type, kgp::StreamFramer::EventType::START);
+    EXPECT_FALSE(framer.AtBoundary());
+}
+
+TEST(StreamFramer, LongNamesAreCut)
+{
+    const QString name((int)kgp::Session::MAX_NAME + 10, QChar('n'));
+    const QByteArray stream = kgp::StreamFramer::Header(1, name, 0);
+    EXPECT_EQ((quint64)stream.size(), sizeof(kgp::StreamHeader) + kgp::Session::MAX_NAME);
+
+    std::vector<File> files;
+    ASSERT_TRUE(split(stream, stream.size(), files));
+    ASSERT_EQ(files.size(), 1u);
+    EXPECT_EQ((quint64)files[0].name.size(), kgp::Session::MAX_NAME);
+}
+
+TEST(StreamFramer, DamagedHeaderStopsTheStream)
+{
+    kgp::StreamHeader header;
+    header.Id = 1;
+    header.Size = 10;
+    header.NameSize = kgp::Session::MAX_NAME + 1;
+    const QByteArray stream((const char *)&header, (int)sizeof(header));
+
+    kgp::StreamFramer framer;
+    std::vector<kgp::StreamFramer::Event> events;
+    EXPECT_FALSE(framer.Add(stream.constData(), stream.size(), events));
+    EXPECT_FALSE(framer.Add("more", 4, events));
+    EXPECT_TRUE(events.empty());
+
+    framer.Reset();
+    const QByteArray next = kgp::StreamFramer::Header(2, "next", 0);
+    EXPECT_TRUE(framer.Add(next.constData(), next.size(), events));
+    EXPECT_EQ(events.size(), 2u);
+    EXPECT_TRUE(framer.AtBoundary());
+}
+
+TEST(StreamFramer, SplitsADirectoryByItsManifest)
+{
+    const QByteArray first(3000, 'a');
+    const QByteArray third(10, 'c');
+    const std::vector<kgp::StreamFramer::FileEntry> entries = {
+        { "a/first.bin", (quint64)first.size() },
+        { "a/empty", 0 },
+        { "b/c/third.txt", (quint64)third.size() },
+        { "last", 0 },
+    };
+    QByteArray stream = kgp::StreamFramer::Manifest(entries);
+    stream.append(first);
+    stream.append(third);
+
+    for (const int piece : { 1, 7, 16, 1000, stream.size() })
+    {
+        std::vector<File> files;
+        ASSERT_TRUE(split(stream, piece, files, kgp::StreamFramer::Layout::MANIFEST)) << piece;
+        ASSERT_EQ(files.size(), entries.size()) << piece;
+
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            EXPECT_EQ(files[i].id, i + 1);
+            EXPECT_EQ(files[i].name, entries[i].name);
+            EXPECT_EQ(files[i].size, entries[i].size);
+            EXPECT_TRUE(files[i].ended);
+        }
+        EXPECT_EQ(files[0].data, first);
+        EXPECT_TRUE(files[1].data.isEmpty());
+        EXPECT_EQ(files[2].data, third);
+        EXPECT_TRUE(files[3].data.isEmpty());
+    }
+}
+
+TEST(StreamFramer, EmptyDirectoryHasNoFiles)
+{
+    const QByteArray stream = kgp::StreamFramer::Manifest({});
+    EXPECT_EQ((quint64)stream.size(), sizeof(kgp::BatchHeader));
+
+    std::vector<File> files;
+    ASSERT_TRUE(split(stream, stream.size(), files, kgp::StreamFramer::Layout::MANIFEST));
+    EXPECT_TRUE(files.empty());
+}
+
+TEST(StreamFramer, DamagedManifestStopsTheStream)
+{
+    std::vector<kgp::StreamFramer::Event> events;
+    kgp::StreamFramer framer;
+
+    // A manifest larger than any directory that is taken
+    kgp::BatchHeader header;
+    header.Count = 1;
+    header.Size = kgp::Batch::MAX_MANIFEST + 1;
+    framer.Reset(kgp::StreamFramer::Layout::MANIFEST);
+    EXPECT_FALSE(framer.Add((const char *)&header, sizeof(header), events));
+    EXPECT_FALSE(framer.Add("more", 4, events));
+
+    // A manifest with fewer entries than its header counts
+    QByteArray stream = kgp::StreamFramer::Manifest({ { "one", 1 } });
+    memcpy(&header, stream.constData(), sizeof(header));
+    header.Count = 2;
+    memcpy(stream.data(), &header, sizeof(header));
+    framer.Reset(kgp::StreamFramer::Layout::MANIFEST);
+    EXPECT_FALSE(framer.Add(stream.constData(), stream.size(), events));
+
+    // Nothing may follow the last file
+    stream = kgp::StreamFramer::Manifest({ { "one", 1 } });
+    stream.append("xy");
+    framer.Reset(kgp::StreamFramer::Layout::MANIFEST);
+    EXPECT_FALSE(framer.Add(stream.constData(), stream.size(), events));
+    // The file before the stray bytes is still whole
+    ASSERT_EQ(events.size(), 3u);
+    EXPECT_EQ(events.back().type, kgp::StreamFramer::EventType::END);
+}
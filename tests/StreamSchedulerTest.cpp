@@ -0,0 +1,101 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             StreamSchedulerTest.cpp
+--
+-- PROGRAM:                 kgp_tests
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Unit tests for the order the streams of a multiplexed session send in.
+---------------------------------------------------------------------------------------*/
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "res.h"
+#include "StreamScheduler.h"
+
+namespace
+{
+    // Picks count frames with every stream ready and counts the frames of each stream
+    std::vector<int> pick(kgp::StreamScheduler& scheduler, const int count)
+    {
+        std::vector<int> frames(scheduler.Size(), 0);
+        const std::vector<bool> ready(scheduler.Size(), true);
+        for (int i = 0; i < count; i++)
+        {
+            size_t stream;
+            EXPECT_TRUE(scheduler.Next(ready, stream));
+            frames[stream]++;
+        }
+        return frames;
+    }
+}
+
+TEST(StreamScheduler, NothingIsPickedWithoutAReadyStream)
+{
+    kgp::StreamScheduler scheduler(4);
+    size_t stream;
+    EXPECT_FALSE(scheduler.Next(std::vector<bool>(4, true), stream));
+
+    scheduler.Open(2, kgp::Multiplex::NORMAL, 1);
+    EXPECT_FALSE(scheduler.Next(std::vector<bool>(4, false), stream));
+    ASSERT_TRUE(scheduler.Next(std::vector<bool>(4, true), stream));
+    EXPECT_EQ(stream, 2u);
+
+    scheduler.Close(2);
+    EXPECT_FALSE(scheduler.IsOpen(2));
+    EXPECT_FALSE(scheduler.Next(std::vector<bool>(4, true), stream));
+}
+
+TEST(StreamScheduler, SmallerPriorityGoesFirst)
+{
+    kgp::StreamScheduler scheduler(3);
+    scheduler.Open(0, kgp::Multiplex::BULK, 10);
+    scheduler.Open(1, kgp::Multiplex::URGENT, 1);
+    scheduler.Open(2, kgp::Multiplex::NORMAL, 1);
+
+    EXPECT_EQ(pick(scheduler, 5), std::vector<int>({ 0, 5, 0 }));
+
+    // Once the urgent stream has nothing to send the next priority takes over
+    size_t stream;
+    ASSERT_TRUE(scheduler.Next({ true, false, true }, stream));
+    EXPECT_EQ(stream, 2u);
+    ASSERT_TRUE(scheduler.Next({ true, false, false }, stream));
+    EXPECT_EQ(stream, 0u);
+}
+
+TEST(StreamScheduler, SamePriorityIsSharedByWeight)
+{
+    kgp::StreamScheduler scheduler(3);
+    scheduler.Open(0, kgp::Multiplex::NORMAL, 3);
+    scheduler.Open(1, kgp::Multiplex::NORMAL, 1);
+    scheduler.Open(2, kgp::Multiplex::NORMAL, 0);
+
+    // A weight of 0 counts as 1
+    EXPECT_EQ(pick(scheduler, 500), std::vector<int>({ 300, 100, 100 }));
+
+    // The heavy stream does not send all of its turns in a row
+    const std::vector<bool> ready(3, true);
+    size_t last = 3;
+    int run = 0;
+    int longest = 0;
+    for (int i = 0; i < 50; i++)
+    {
+        size_t stream;
+        ASSERT_TRUE(scheduler.Next(ready, stream));
+        run = stream == last ? run + 1 : 1;
+        longest = std::max(longest, run);
+        last = stream;
+    }
+    EXPECT_LE(longest, 2);
+}
@@ -0,0 +1,34 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             TestMain.cpp
+--
+-- PROGRAM:                 kgp_tests
+--
+-- FUNCTIONS:               int main(int argc, char *argv[])
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Entry point of the unit tests. A QCoreApplication is created so that
+--                          tests can run engines that rely on signals and the event loop.
+--                          Regular log messages are turned off to keep transfers fast.
+---------------------------------------------------------------------------------------*/
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+
+#include "DependencyManager.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    kgp::DependencyManager::Instance().Logger().SetEnabled(false);
+
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,217 @@
+/*---------------------------------------------------------------------------------------
+-- SOURCE FILE:             UringTransportTest.cpp
+--
+-- PROGRAM:                 kgp_tests
+--
+-- FUNCTIONS:               N/A
+--
+-- DATE:                    October 19, 2026
+--
+-- REVISIONS:               N/A
+--
+-- DESIGNERS:               Benny Wang
+--
+-- PROGRAMMERS:             Benny Wang
+--
+-- NOTES:
+--                          Unit tests for the transport that moves datagrams and file data through
+--                          an io_uring. These use real sockets on the loopback address, only run on
+--                          Linux and are skipped where the kernel cannot run a ring.
+---------------------------------------------------------------------------------------*/
+#include <gtest/gtest.h>
+
+#if defined(__linux__)
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <QByteArray>
+#include <QFile>
+
+#include "IoThread.h"
+#include "IoUring.h"
+#include "Reactor.h"
+#include "res.h"
+#include "UringTransport.h"
+
+namespace
+{
+    // Ports of the transports that talk to each other, away from the protocol port
+    const short PORT_A = 18001;
+    const short PORT_B = 18002;
+
+    // Runs the reactor until done is true or a second has passed
+    bool runUntil(kgp::Reactor& reactor, const std::function<bool()>& done)
+    {
+        const auto end = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (!done() && std::chrono::steady_clock::now() < end) reactor.RunOnce(10);
+        return done();
+    }
+
+    // Bytes that differ from one offset to the next
+    QByteArray pattern(const int size)
+    {
+        QByteArray data;
+        for (int i = 0; i < size; i++) data.append((char)(i % 251));
+        return data;
+    }
+}
+
+TEST(UringTransport, QueuedDatagramsGoOutTogether)
+{
+    if (!kgp::IoUring::IsSupported()) GTEST_SKIP() << "io_uring is not supported here";
+
+    kgp::Reactor reactor;
+    kgp::UringTransport a(reactor);
+    kgp::UringTransport b(reactor);
+    ASSERT_TRUE(a.IsValid());
+    ASSERT_TRUE(a.Bind(QHostAddress(QHostAddress::LocalHost), PORT_A));
+    ASSERT_TRUE(b.Bind(QHostAddress(QHostAddress::LocalHost), PORT_B));
+
+    std::vector<QNetworkDatagram> received;
+    QObject::connect(&b, &kgp::Transport::readyRead, [&]() {
+        while (b.HasPendingDatagrams()) received.push_back(b.Receive());
+    });
+
+    // Nothing is sent until the queue is flushed, and then all of it in one system call
+    const quint64 before = a.Syscalls();
+    const int count = 32;
+    for (int i = 0; i < count; i++)
+    {
+        const QByteArray header = QByteArray::number(i);
+        ASSERT_EQ(a.SendGather(header.constData(), header.size(), ":data", 5, QHostAddress(QHostAddress::LocalHost), PORT_B), header.size() + 5);
+    }
+    EXPECT_EQ(a.Syscalls(), before);
+    a.Flush();
+    EXPECT_EQ(a.Syscalls(), before + 1);
+
+    ASSERT_TRUE(runUntil(reactor, [&]() { return received.size() == (size_t)count; }));
+    for (int i = 0; i < count; i++) EXPECT_EQ(received[i].data(), QByteArray::number(i) + ":data");
+    EXPECT_EQ(received[0].senderAddress(), QHostAddress(QHostAddress::LocalHost));
+    EXPECT_EQ(received[0].senderPort(), PORT_A);
+    EXPECT_LT(b.Syscalls(), (quint64)count);
+}
+
+TEST(UringTransport, ProbesAreSentRightAway)
+{
+    if (!kgp::IoUring::IsSupported()) GTEST_SKIP() << "io_uring is not supported here";
+
+    kgp::Reactor reactor;
+    kgp::UringTransport a(reactor);
+    kgp::UringTransport b(reactor);
+    ASSERT_TRUE(a.Bind(QHostAddress(QHostAddress::LocalHost), PORT_A));
+    ASSERT_TRUE(b.Bind(QHostAddress(QHostAddress::LocalHost), PORT_B));
+
+    std::vector<QByteArray> received;
+    QObject::connect(&b, &kgp::Transport::readyRead, [&]() {
+        while (b.HasPendingDatagrams()) received.push_back(b.Receive().data());
+    });
+
+    // The datagram queued first still goes out first
+    a.Send("queued", 6, QHostAddress(QHostAddress::LocalHost), PORT_B);
+    ASSERT_EQ(a.SendProbe("probe", 5, QHostAddress(QHostAddress::LocalHost), PORT_B), 5);
+
+    ASSERT_TRUE(runUntil(reactor, [&]() { return received.size() == 2; }));
+    EXPECT_EQ(received, std::vector<QByteArray>({ "queued", "probe" }));
+}
+
+TEST(UringTransport, ReadsWholeFile)
+{
+    if (!kgp::IoUring::IsSupported()) GTEST_SKIP() << "io_uring is not supported here";
+
+    // Larger than one read so that several are in flight at once
+    const QByteArray data = pattern(3 * 1024 * 1024 + 17);
+    QFile file("uring_read.bin");
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(data);
+    file.close();
+
+    kgp::Reactor reactor;
+    kgp::UringTransport transport(reactor);
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+    file.seek(5);
+
+    QByteArray read("prefix");
+    ASSERT_TRUE(transport.ReadFile(file, read));
+    EXPECT_EQ(read, QByteArray("prefix") + data.mid(5));
+    EXPECT_EQ(file.pos(), data.size());
+}
+
+TEST(UringTransport, WritesLandOnceFlushed)
+{
+    if (!kgp::IoUring::IsSupported()) GTEST_SKIP() << "io_uring is not supported here";
+
+    const QByteArray data = pattern(600 * 1000);
+    QFile file("uring_write.bin");
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite | QIODevice::Truncate));
+
+    kgp::Reactor reactor;
+    kgp::UringTransport transport(reactor);
+
+    // Written a frame at a time like received data, then part of it written over
+    const int frame = (int)kgp::Size::DATA;
+    for (int offset = 0; offset < data.size(); offset += frame)
+    {
+        const int size = std::min(frame, data.size() - offset);
+        ASSERT_EQ(transport.WriteFile(file, offset, data.constData() + offset, size), size);
+    }
+    const QByteArray repair(100, 'r');
+    ASSERT_EQ(transport.WriteFile(file, 1000, repair.constData(), repair.size()), repair.size());
+    transport.Flush(true);
+
+    // Gathered into a few writes instead of one per frame
+    EXPECT_LT(transport.Syscalls(), (quint64)(data.size() / frame) / 10);
+
+    QByteArray expected = data;
+    expected.replace(1000, repair.size(), repair);
+    file.seek(0);
+    EXPECT_EQ(file.readAll(), expected);
+}
+
+TEST(IoThread, TransfersFileOverUring)
+{
+    if (!kgp::IoUring::IsSupported()) GTEST_SKIP() << "io_uring is not supported here";
+
+    const QByteArray data = pattern(300 * 1000);
+    QFile file("io_thread_uring.bin");
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write(data);
+    file.close();
+
+    kgp::IoThread receiver(kgp::PORT, kgp::IoThread::URING);
+    kgp::IoThread sender(PORT_A, kgp::IoThread::URING);
+    // A checkpoint left by an earlier run must not shorten the transfer
+    receiver.Engine().SetFeatures(kgp::Feature::CHECKSUM | kgp::Feature::PMTU);
+
+    // Data is handed over on the thread of the receiver
+    std::mutex mutex;
+    QByteArray received;
+    QObject::connect(&receiver.Engine(), &kgp::IoEngine::dataRead, [&](const char *bytes, const size_t& size) {
+        std::lock_guard<std::mutex> locker(mutex);
+        received.append(bytes, (int)size);
+    });
+
+    receiver.Start();
+    sender.Start();
+    sender.Post([&]() { sender.Engine().StartFileSend("io_thread_uring.bin", "127.0.0.1", kgp::PORT); });
+
+    const auto end = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (std::chrono::steady_clock::now() < end)
+    {
+        {
+            std::lock_guard<std::mutex> locker(mutex);
+            if (received.size() >= data.size()) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    sender.Stop();
+    receiver.Stop();
+    EXPECT_EQ(received, data);
+}
+
+#endif